@@ -3,10 +3,13 @@
 #include "file_logger.h"
 
 #include "StringUtils.h"
+#include "clPosixSpawn.hpp"
 #include "cl_command_event.h"
 #include "processreaderthread.h"
 #include <signal.h>
 #include <string.h>
+#include <string>
+#include <vector>
 #include <sys/select.h>
 #include <sys/types.h>
 #include <sys/syscall.h>
@@ -22,7 +25,34 @@ UnixProcess::UnixProcess(wxEvtHandler* owner, const wxArrayString& args)
         return;
     }
 
+    // build the arguments before starting the child
+    std::vector<std::string> cstr_args;
+    cstr_args.reserve(args.size());
+    for(size_t i = 0; i < args.size(); ++i) {
+        wxString wx_arg = args[i];
+        wx_arg.Trim();
+        if(wx_arg.StartsWith("\"") && wx_arg.EndsWith("\"") && wx_arg.size() >= 2) {
+            wx_arg.Remove(0, 1).RemoveLast();
+        }
+        cstr_args.push_back(StringUtils::ToStdString(wx_arg));
+    }
+    std::vector<char*> argv;
+    argv.reserve(cstr_args.size() + 1);
+    for(auto& cstr_arg : cstr_args) {
+        argv.push_back(cstr_arg.data());
+    }
+    argv.push_back(nullptr);
+
+#if CL_USE_POSIX_SPAWN
+    clPosixSpawn::Options options;
+    options.stdin_fd = m_childStdin.GetReadFd();
+    options.stdout_fd = m_childStdout.GetWriteFd();
+    options.stderr_fd = m_childStderr.GetWriteFd();
+    options.new_process_group = false;
+    child_pid = clPosixSpawn::Spawn(argv.data(), options);
+#else
     child_pid = fork();
+#endif
     if(child_pid == -1) {
         clERROR() << _("Failed to start child process") << strerror(errno) << endl;
     }
@@ -47,21 +77,7 @@ UnixProcess::UnixProcess(wxEvtHandler* owner, const wxArrayString& args)
         }
 #endif
 
-        char** argv = new char*[args.size() + 1];
-        for(size_t i = 0; i < args.size(); ++i) {
-            wxString wx_arg = args[i];
-            wx_arg.Trim();
-            if(wx_arg.StartsWith("\"") && wx_arg.EndsWith("\"") && wx_arg.size() >= 2) {
-                wx_arg.Remove(0, 1).RemoveLast();
-            }
-
-            std::string cstr_arg = StringUtils::ToStdString(wx_arg);
-            argv[i] = new char[cstr_arg.length() + 1];
-            strcpy(argv[i], cstr_arg.c_str());
-            argv[i][cstr_arg.length()] = 0;
-        }
-        argv[args.size()] = 0;
-        int result = execvp(argv[0], const_cast<char* const*>(argv));
+        int result = execvp(argv[0], argv.data());
         int errNo = errno;
         if(result == -1) {
             // Note: no point writing to stdout here, it has been redirected
@@ -75,8 +91,10 @@ UnixProcess::UnixProcess(wxEvtHandler* owner, const wxArrayString& args)
         m_childStderr.CloseWriteFd();
 
         // Start the reader and writer threads
-        StartWriterThread();
-        StartReaderThread();
+        if(!StartReactor()) {
+            StartWriterThread();
+            StartReaderThread();
+        }
     }
 }
 
@@ -163,12 +181,35 @@ void UnixProcess::Stop()
 
 void UnixProcess::Write(const std::string& message)
 {
+#if CL_USE_PROCESS_REACTOR
+    if(m_reactorId != 0) {
+        clProcessReactor::Get().Write(m_reactorId, message);
+        return;
+    }
+#endif
     if(!m_writerThread) {
         return;
     }
     m_outgoingQueue.Post(message);
 }
 
+bool UnixProcess::StartReactor()
+{
+#if CL_USE_PROCESS_REACTOR
+    clProcessReactor::Registration registration;
+    registration.pid = child_pid;
+    registration.stdout_fd = m_childStdout.GetReadFd();
+    registration.stderr_fd = m_childStderr.GetReadFd();
+    registration.stdin_fd = m_childStdin.GetWriteFd();
+    registration.owner = m_owner;
+    registration.wait = [this]() { return Wait(); };
+    m_reactorId = clProcessReactor::Get().Add(registration);
+    return m_reactorId != 0;
+#else
+    return false;
+#endif
+}
+
 void UnixProcess::StartWriterThread()
 {
     m_writerThread = new std::thread(
@@ -226,6 +267,12 @@ void UnixProcess::StartReaderThread()
 
 void UnixProcess::Detach()
 {
+#if CL_USE_PROCESS_REACTOR
+    if(m_reactorId != 0) {
+        clProcessReactor::Get().Remove(m_reactorId);
+        m_reactorId = 0;
+    }
+#endif
     m_goingDown.store(true);
     if(m_writerThread) {
         m_writerThread->join();
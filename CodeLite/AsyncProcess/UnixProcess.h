@@ -12,6 +12,7 @@
 #include <wx/msgqueue.h>
 #include <atomic>
 #include <wx/event.h>
+#include "clProcessReactor.hpp"
 
 // Wrapping pipe in a class makes sure they are closed when we leave scope
 #define CLOSE_FD(fd)        \
@@ -61,6 +62,10 @@ private:
     wxMessageQueue<std::string> m_outgoingQueue;
     std::atomic_bool m_goingDown;
     wxEvtHandler* m_owner = nullptr;
+#if CL_USE_PROCESS_REACTOR
+    // our id in clProcessReactor, 0 if we use the reader and writer threads
+    uint64_t m_reactorId = 0;
+#endif
 
 protected:
     // sync operations
@@ -69,6 +74,8 @@ protected:
 
     void StartWriterThread();
     void StartReaderThread();
+    /// let clProcessReactor read and write, return false if it can't
+    bool StartReactor();
 
 public:
     int child_pid = -1;
@@ -0,0 +1,77 @@
+#include "clPosixSpawn.hpp"
+
+#if CL_USE_POSIX_SPAWN
+#include "StringUtils.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+#include <utility>
+
+extern char** environ;
+
+int clPosixSpawn::Spawn(char* const* argv, const Options& options)
+{
+    posix_spawn_file_actions_t actions;
+    posix_spawnattr_t attr;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawnattr_init(&attr);
+
+    // the file actions and the attributes copy what the fork() code did in the child
+    int rc = 0;
+    short flags = 0;
+    std::string tty = StringUtils::ToStdString(options.tty);
+    if (!tty.empty()) {
+        // the child is a session leader without a controlling terminal: opening the terminal makes it its
+        // controlling terminal
+        flags |= POSIX_SPAWN_SETSID;
+        rc = posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, tty.c_str(), O_RDWR, 0);
+        if (rc == 0) {
+            rc = posix_spawn_file_actions_adddup2(&actions, STDIN_FILENO, STDOUT_FILENO);
+        }
+        if (rc == 0) {
+            rc = posix_spawn_file_actions_adddup2(&actions, STDIN_FILENO, STDERR_FILENO);
+        }
+    } else if (options.new_process_group) {
+        flags |= POSIX_SPAWN_SETPGROUP;
+        rc = posix_spawnattr_setpgroup(&attr, 0);
+    }
+
+    const std::pair<int, int> redirections[] = {
+        { options.stdin_fd, STDIN_FILENO },
+        { options.stdout_fd, STDOUT_FILENO },
+        { options.stderr_fd, STDERR_FILENO },
+    };
+    for (const auto& [fd, target] : redirections) {
+        if (rc == 0 && fd != wxNOT_FOUND) {
+            rc = posix_spawn_file_actions_adddup2(&actions, fd, target);
+        }
+    }
+
+    std::string working_directory = StringUtils::ToStdString(options.working_directory);
+    if (rc == 0 && !working_directory.empty()) {
+        rc = posix_spawn_file_actions_addchdir_np(&actions, working_directory.c_str());
+    }
+    if (rc == 0) {
+        rc = posix_spawn_file_actions_addclosefrom_np(&actions, STDERR_FILENO + 1);
+    }
+    if (rc == 0) {
+        rc = posix_spawnattr_setflags(&attr, flags);
+    }
+
+    pid_t pid = wxNOT_FOUND;
+    if (rc == 0) {
+        // unlike fork() + exec, an exec error (e.g. ENOENT) is reported here
+        rc = posix_spawnp(&pid, argv[0], &actions, &attr, argv, environ);
+    }
+
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attr);
+    if (rc != 0) {
+        errno = rc;
+        return wxNOT_FOUND;
+    }
+    return pid;
+}
+#endif // CL_USE_POSIX_SPAWN
@@ -0,0 +1,50 @@
+#ifndef CLPOSIXSPAWN_HPP
+#define CLPOSIXSPAWN_HPP
+
+#include "codelite_exports.h"
+
+#if defined(__linux__)
+#include <spawn.h>
+#endif
+
+// posix_spawn_file_actions_addclosefrom_np() is available since glibc 2.34. Without it, the child would inherit all
+// our file descriptors, so older systems keep using fork()
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 34))
+#define CL_USE_POSIX_SPAWN 1
+#else
+#define CL_USE_POSIX_SPAWN 0
+#endif
+
+#if CL_USE_POSIX_SPAWN
+#include <wx/string.h>
+
+/**
+ * @class clPosixSpawn
+ * @brief start a child process with posix_spawn. Unlike fork(), it does not copy the page tables of this (large)
+ * process: glibc implements it with clone(CLONE_VM | CLONE_VFORK)
+ */
+class WXDLLIMPEXP_CL clPosixSpawn
+{
+public:
+    struct Options {
+        wxString working_directory;
+        /// when set, the child starts a new session with this terminal as its stdin, stdout, stderr and controlling
+        /// terminal (like forkpty)
+        wxString tty;
+        /// the child stdin, stdout and stderr (applied after `tty`), wxNOT_FOUND to keep the inherited ones
+        int stdin_fd = wxNOT_FOUND;
+        int stdout_fd = wxNOT_FOUND;
+        int stderr_fd = wxNOT_FOUND;
+        /// make the child a process group leader (ignored when `tty` is set: the child is a session leader)
+        bool new_process_group = true;
+    };
+
+    /**
+     * @brief start argv[0], searching the PATH. All the file descriptors other than stdin, stdout and stderr are closed
+     * in the child
+     * @return the child pid, or wxNOT_FOUND with errno set
+     */
+    static int Spawn(char* const* argv, const Options& options);
+};
+#endif // CL_USE_POSIX_SPAWN
+#endif // CLPOSIXSPAWN_HPP
@@ -0,0 +1,476 @@
+#include "clProcessReactor.hpp"
+
+#if CL_USE_PROCESS_REACTOR
+#include "StringUtils.h"
+#include "asyncprocess.h"
+#include "cl_command_event.h"
+#include "file_logger.h"
+#include "processreaderthread.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace
+{
+constexpr size_t READ_BUFFER_SIZE = 64 * 1024;
+constexpr int MAX_EVENTS = 64;
+
+// the output is sent once the process was quiet for FLUSH_DELAY_MS or once FLUSH_SIZE bytes are pending
+constexpr int FLUSH_DELAY_MS = 5;
+constexpr size_t FLUSH_SIZE = 256 * 1024;
+
+// when a process exits, read at most this number of buffers that it left behind
+constexpr int MAX_DRAIN_READS = 64;
+
+// the wakeup fd uses the epoll data 0, the process channels use (id << 2 | channel) with id > 0
+constexpr uint64_t WAKEUP_DATA = 0;
+
+wxString to_wx_string(const std::string& output)
+{
+    wxString str = wxString(output.c_str(), wxConvUTF8, output.length());
+    if(str.empty()) {
+        str = wxString::From8BitData(output.c_str(), output.length());
+    }
+    return str;
+}
+
+bool has_input(int fd)
+{
+    pollfd pfd = { fd, POLLIN, 0 };
+    return ::poll(&pfd, 1, 0) > 0 && (pfd.revents & POLLIN);
+}
+} // namespace
+
+clProcessReactor::clProcessReactor() {}
+
+clProcessReactor::~clProcessReactor()
+{
+    if(m_thread) {
+        {
+            std::lock_guard<std::mutex> lock{ m_mutex };
+            m_shutdown = true;
+        }
+        Wakeup();
+        m_thread->join();
+        wxDELETE(m_thread);
+    }
+
+    for(auto& [_, process] : m_processes) {
+        if(process->pidfd != wxNOT_FOUND) {
+            ::close(process->pidfd);
+        }
+    }
+    m_processes.clear();
+
+    if(m_wakeupFd != wxNOT_FOUND) {
+        ::close(m_wakeupFd);
+    }
+    if(m_epollFd != wxNOT_FOUND) {
+        ::close(m_epollFd);
+    }
+}
+
+clProcessReactor& clProcessReactor::Get()
+{
+    static clProcessReactor reactor;
+    return reactor;
+}
+
+void clProcessReactor::Wakeup()
+{
+    uint64_t value = 1;
+    if(::write(m_wakeupFd, &value, sizeof(value)) < 0) {
+        clDEBUG() << "Process reactor: failed to wake up the reactor thread." << strerror(errno) << endl;
+    }
+}
+
+bool clProcessReactor::Start()
+{
+    m_epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    if(m_epollFd == wxNOT_FOUND) {
+        clWARNING() << "Process reactor: epoll_create1 error:" << strerror(errno) << endl;
+        return false;
+    }
+
+    m_wakeupFd = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.u64 = WAKEUP_DATA;
+    if(m_wakeupFd == wxNOT_FOUND || ::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeupFd, &ev) < 0) {
+        clWARNING() << "Process reactor: failed to create the wakeup fd:" << strerror(errno) << endl;
+        if(m_wakeupFd != wxNOT_FOUND) {
+            ::close(m_wakeupFd);
+            m_wakeupFd = wxNOT_FOUND;
+        }
+        ::close(m_epollFd);
+        m_epollFd = wxNOT_FOUND;
+        return false;
+    }
+
+    m_thread = new std::thread(&clProcessReactor::ThreadMain, this);
+    return true;
+}
+
+void clProcessReactor::ThreadMain()
+{
+    epoll_event events[MAX_EVENTS];
+    int timeout = -1;
+    while(true) {
+        int count = ::epoll_wait(m_epollFd, events, MAX_EVENTS, timeout);
+        if(count < 0 && errno != EINTR) {
+            clERROR() << "Process reactor: epoll_wait error:" << strerror(errno) << endl;
+            break;
+        }
+
+        std::lock_guard<std::mutex> lock{ m_mutex };
+        if(m_shutdown) {
+            break;
+        }
+
+        for(int i = 0; i < count; ++i) {
+            uint64_t data = events[i].data.u64;
+            if(data == WAKEUP_DATA) {
+                uint64_t value = 0;
+                while(::read(m_wakeupFd, &value, sizeof(value)) > 0) {
+                }
+                continue;
+            }
+
+            // the process may have been removed (or suspended) after epoll_wait() returned
+            auto where = m_processes.find(data >> 2);
+            if(where == m_processes.end()) {
+                continue;
+            }
+
+            Process& process = *where->second;
+            eChannel channel = static_cast<eChannel>(data & 3);
+            if(channel == kStdin) {
+                WriteInput(process);
+                continue;
+            }
+
+            if(process.suspended || process.terminated) {
+                continue;
+            }
+
+            if(channel == kPidFd) {
+                process.terminated = true;
+            } else if(!ReadOutput(process, channel)) {
+                process.terminated = true;
+            }
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        for(auto iter = m_processes.begin(); iter != m_processes.end();) {
+            Process& process = *iter->second;
+            if(process.terminated) {
+                DrainOutput(process);
+                Flush(process);
+                UnwatchOutput(process);
+                if(process.stdin_armed) {
+                    Unwatch(process.reg.stdin_fd);
+                }
+                if(process.pidfd != wxNOT_FOUND) {
+                    ::close(process.pidfd);
+                }
+                NotifyTerminated(process);
+                iter = m_processes.erase(iter);
+                continue;
+            }
+
+            size_t pending = process.pending_stdout.size() + process.pending_stderr.size();
+            if(pending >= FLUSH_SIZE ||
+               (pending > 0 && now - process.pending_since >= std::chrono::milliseconds(FLUSH_DELAY_MS))) {
+                Flush(process);
+            }
+            ++iter;
+        }
+        timeout = GetFlushTimeout();
+    }
+    clDEBUG() << "Process reactor: going down" << endl;
+}
+
+int clProcessReactor::GetFlushTimeout() const
+{
+    int timeout = -1;
+    auto now = std::chrono::steady_clock::now();
+    for(const auto& [_, process] : m_processes) {
+        if(process->pending_stdout.empty() && process->pending_stderr.empty()) {
+            continue;
+        }
+        auto elapsed =
+            std::chrono::duration_cast<std::chrono::milliseconds>(now - process->pending_since).count();
+        int remaining = std::max(0, FLUSH_DELAY_MS - static_cast<int>(elapsed));
+        timeout = (timeout == -1) ? remaining : std::min(timeout, remaining);
+    }
+    return timeout;
+}
+
+bool clProcessReactor::Watch(uint64_t id, eChannel channel, int fd, uint32_t events)
+{
+    epoll_event ev = {};
+    ev.events = events;
+    ev.data.u64 = (id << 2) | channel;
+    if(::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        clWARNING() << "Process reactor: failed to watch fd" << fd << ":" << strerror(errno) << endl;
+        return false;
+    }
+    return true;
+}
+
+void clProcessReactor::Unwatch(int fd)
+{
+    if(fd != wxNOT_FOUND) {
+        ::epoll_ctl(m_epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    }
+}
+
+bool clProcessReactor::WatchOutput(uint64_t id, Process& process)
+{
+    // a fd that is not watched is not reported, not even its EPOLLHUP: we use EPOLL_CTL_DEL to suspend a process
+    if(process.reg.stdout_fd != wxNOT_FOUND && !Watch(id, kStdout, process.reg.stdout_fd, EPOLLIN)) {
+        return false;
+    }
+    if(process.reg.stderr_fd != wxNOT_FOUND && !Watch(id, kStderr, process.reg.stderr_fd, EPOLLIN)) {
+        return false;
+    }
+    if(process.pidfd != wxNOT_FOUND && !Watch(id, kPidFd, process.pidfd, EPOLLIN)) {
+        return false;
+    }
+    return true;
+}
+
+void clProcessReactor::UnwatchOutput(Process& process)
+{
+    Unwatch(process.reg.stdout_fd);
+    Unwatch(process.reg.stderr_fd);
+    Unwatch(process.pidfd);
+}
+
+bool clProcessReactor::ReadOutput(Process& process, eChannel channel)
+{
+    int fd = (channel == kStdout) ? process.reg.stdout_fd : process.reg.stderr_fd;
+    char buffer[READ_BUFFER_SIZE];
+    ssize_t bytes_read = ::read(fd, buffer, sizeof(buffer));
+    if(bytes_read < 0 && (errno == EINTR || errno == EAGAIN)) {
+        return true;
+    }
+
+    if(bytes_read <= 0) {
+        // EOF, or EIO once the other side of the pty was closed
+        return false;
+    }
+
+    // send the output of the other channel first, so the events keep the order in which the output was read. This
+    // way, at most one of the channels has pending output
+    const std::string& other_pending = (channel == kStdout) ? process.pending_stderr : process.pending_stdout;
+    if(!other_pending.empty()) {
+        Flush(process);
+    }
+
+    if(process.pending_stdout.empty() && process.pending_stderr.empty()) {
+        process.pending_since = std::chrono::steady_clock::now();
+    }
+
+    std::string& pending = (channel == kStdout) ? process.pending_stdout : process.pending_stderr;
+    if(process.reg.strip_colours) {
+        std::string stripped_buffer;
+        StringUtils::StripTerminalColouring(std::string(buffer, bytes_read), stripped_buffer);
+        pending.append(stripped_buffer);
+    } else {
+        pending.append(buffer, bytes_read);
+    }
+    return true;
+}
+
+void clProcessReactor::DrainOutput(Process& process)
+{
+    for(eChannel channel : { kStdout, kStderr }) {
+        int fd = (channel == kStdout) ? process.reg.stdout_fd : process.reg.stderr_fd;
+        if(fd == wxNOT_FOUND) {
+            continue;
+        }
+        for(int i = 0; i < MAX_DRAIN_READS && has_input(fd); ++i) {
+            if(!ReadOutput(process, channel)) {
+                break;
+            }
+        }
+    }
+}
+
+void clProcessReactor::WriteInput(Process& process)
+{
+    while(!process.outgoing.empty()) {
+        ssize_t bytes_written = ::write(process.reg.stdin_fd, process.outgoing.data(), process.outgoing.length());
+        if(bytes_written < 0 && errno == EINTR) {
+            continue;
+        }
+        if(bytes_written < 0 && errno == EAGAIN) {
+            // wait for the next EPOLLOUT
+            return;
+        }
+        if(bytes_written <= 0) {
+            clDEBUG() << "Process reactor: failed to write to process" << process.reg.pid << ":" << strerror(errno)
+                      << endl;
+            process.outgoing.clear();
+            break;
+        }
+        process.outgoing.erase(0, bytes_written);
+    }
+    Unwatch(process.reg.stdin_fd);
+    process.stdin_armed = false;
+}
+
+void clProcessReactor::Flush(Process& process)
+{
+    if(!process.pending_stdout.empty()) {
+        if(process.reg.callback) {
+            process.reg.callback->CallAfter(&IProcessCallback::OnProcessOutput,
+                                            to_wx_string(process.pending_stdout));
+        } else if(process.reg.owner) {
+            clProcessEvent e(wxEVT_ASYNC_PROCESS_OUTPUT);
+            e.SetOutputFromRaw(std::move(process.pending_stdout));
+            e.SetProcess(process.reg.process);
+            process.reg.owner->QueueEvent(e.Clone());
+        }
+    }
+
+    // like the reader thread, the callback gets only stdout
+    if(!process.pending_stderr.empty() && !process.reg.callback && process.reg.owner) {
+        clProcessEvent e(wxEVT_ASYNC_PROCESS_STDERR);
+        e.SetOutputFromRaw(std::move(process.pending_stderr));
+        e.SetProcess(process.reg.process);
+        process.reg.owner->QueueEvent(e.Clone());
+    }
+    process.pending_stdout.clear();
+    process.pending_stderr.clear();
+}
+
+void clProcessReactor::NotifyTerminated(Process& process)
+{
+    if(process.reg.callback) {
+        process.reg.callback->CallAfter(&IProcessCallback::OnProcessTerminated);
+
+    } else if(process.reg.owner) {
+        clProcessEvent e(wxEVT_ASYNC_PROCESS_TERMINATED);
+        e.SetProcess(process.reg.process);
+        if(process.reg.wait) {
+            int exit_code = process.reg.wait();
+            e.SetString(wxString() << "Process exit code (" << exit_code << "):" << strerror(exit_code));
+        }
+        process.reg.owner->AddPendingEvent(e);
+    }
+}
+
+uint64_t clProcessReactor::Add(const Registration& registration)
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    if(!m_thread && !Start()) {
+        return 0;
+    }
+
+    auto process = std::make_unique<Process>();
+    process->reg = registration;
+#ifdef SYS_pidfd_open
+    // Linux 5.3 and later
+    process->pidfd = static_cast<int>(::syscall(SYS_pidfd_open, registration.pid, 0));
+#endif
+    if(process->pidfd == wxNOT_FOUND && registration.stdout_fd == wxNOT_FOUND &&
+       registration.stderr_fd == wxNOT_FOUND) {
+        // nothing tells us when the process exits
+        return 0;
+    }
+
+    if(registration.stdin_fd != wxNOT_FOUND) {
+        int flags = ::fcntl(registration.stdin_fd, F_GETFL);
+        ::fcntl(registration.stdin_fd, F_SETFL, flags | O_NONBLOCK);
+    }
+
+    uint64_t id = m_nextId++;
+    if(!WatchOutput(id, *process)) {
+        UnwatchOutput(*process);
+        if(process->pidfd != wxNOT_FOUND) {
+            ::close(process->pidfd);
+        }
+        return 0;
+    }
+    m_processes.insert({ id, std::move(process) });
+    return id;
+}
+
+void clProcessReactor::Remove(uint64_t id)
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    auto where = m_processes.find(id);
+    if(where == m_processes.end()) {
+        // already terminated
+        return;
+    }
+
+    Process& process = *where->second;
+    if(!process.suspended) {
+        UnwatchOutput(process);
+    }
+    if(process.stdin_armed) {
+        Unwatch(process.reg.stdin_fd);
+    }
+    if(process.pidfd != wxNOT_FOUND) {
+        ::close(process.pidfd);
+    }
+    m_processes.erase(where);
+}
+
+void clProcessReactor::Suspend(uint64_t id)
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    auto where = m_processes.find(id);
+    if(where == m_processes.end() || where->second->suspended) {
+        return;
+    }
+
+    Process& process = *where->second;
+    Flush(process);
+    UnwatchOutput(process);
+    process.suspended = true;
+}
+
+void clProcessReactor::Resume(uint64_t id)
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    auto where = m_processes.find(id);
+    if(where == m_processes.end() || !where->second->suspended) {
+        return;
+    }
+
+    Process& process = *where->second;
+    process.suspended = false;
+    if(!WatchOutput(id, process)) {
+        // we can't tell when the process exits anymore
+        UnwatchOutput(process);
+        process.terminated = true;
+        Wakeup();
+    }
+}
+
+bool clProcessReactor::Write(uint64_t id, const std::string& data)
+{
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    auto where = m_processes.find(id);
+    if(where == m_processes.end() || where->second->reg.stdin_fd == wxNOT_FOUND) {
+        return false;
+    }
+
+    Process& process = *where->second;
+    process.outgoing.append(data);
+    if(!process.stdin_armed) {
+        process.stdin_armed = Watch(id, kStdin, process.reg.stdin_fd, EPOLLOUT);
+    }
+    return process.stdin_armed;
+}
+#endif // CL_USE_PROCESS_REACTOR
@@ -0,0 +1,137 @@
+#ifndef CLPROCESSREACTOR_HPP
+#define CLPROCESSREACTOR_HPP
+
+#include "codelite_exports.h"
+
+#if defined(__linux__)
+#define CL_USE_PROCESS_REACTOR 1
+#else
+#define CL_USE_PROCESS_REACTOR 0
+#endif
+
+#if CL_USE_PROCESS_REACTOR
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <wx/event.h>
+
+class IProcess;
+class IProcessCallback;
+
+/**
+ * @class clProcessReactor
+ * @brief a single thread that reads the output of all the child processes, using epoll.
+ * The process exit is detected with a pidfd (when the kernel supports it) or when its output is closed. The output
+ * is delivered in batches: what a process writes within FLUSH_DELAY_MS is sent as a single clProcessEvent (or a single
+ * IProcessCallback::OnProcessOutput() call). The events carry the raw output, it is converted to wxString by
+ * clProcessEvent::GetOutput(), only if needed.
+ *
+ * The reactor does not own the file descriptors: the process must call Remove() before closing them
+ */
+class WXDLLIMPEXP_CL clProcessReactor
+{
+public:
+    struct Registration {
+        int pid = wxNOT_FOUND;
+        int stdout_fd = wxNOT_FOUND;
+        int stderr_fd = wxNOT_FOUND;
+        /// when set, Write() queues the data and the reactor writes it to this fd. The fd is made non-blocking
+        int stdin_fd = wxNOT_FOUND;
+        /// receives the wxEVT_ASYNC_PROCESS_* events
+        wxEvtHandler* owner = nullptr;
+        /// passed in the events
+        IProcess* process = nullptr;
+        /// when set, the stdout output and the termination are reported to the callback instead of `owner`
+        IProcessCallback* callback = nullptr;
+        /// remove the terminal colours from the output
+        bool strip_colours = false;
+        /// when set, called once the process terminated. The exit code it returns is reported in the
+        /// wxEVT_ASYNC_PROCESS_TERMINATED event string
+        std::function<int()> wait;
+    };
+
+private:
+    enum eChannel {
+        kStdout = 0,
+        kStderr = 1,
+        kStdin = 2,
+        kPidFd = 3,
+    };
+
+    struct Process {
+        Registration reg;
+        int pidfd = wxNOT_FOUND;
+        std::string pending_stdout;
+        std::string pending_stderr;
+        /// when the oldest pending output was read
+        std::chrono::steady_clock::time_point pending_since;
+        std::string outgoing;
+        bool stdin_armed = false;
+        bool suspended = false;
+        /// the output was closed or the process exited
+        bool terminated = false;
+    };
+
+    std::mutex m_mutex;
+    int m_epollFd = wxNOT_FOUND;
+    int m_wakeupFd = wxNOT_FOUND;
+    std::thread* m_thread = nullptr;
+    bool m_shutdown = false;
+    uint64_t m_nextId = 1;
+    std::unordered_map<uint64_t, std::unique_ptr<Process>> m_processes;
+
+private:
+    clProcessReactor();
+    ~clProcessReactor();
+
+    bool Start();
+    void Wakeup();
+    void ThreadMain();
+    bool Watch(uint64_t id, eChannel channel, int fd, uint32_t events);
+    void Unwatch(int fd);
+    bool WatchOutput(uint64_t id, Process& process);
+    void UnwatchOutput(Process& process);
+    /// read from the stdout/stderr fd, return false when the fd is closed
+    bool ReadOutput(Process& process, eChannel channel);
+    /// read whatever the process left in its output, without blocking
+    void DrainOutput(Process& process);
+    void WriteInput(Process& process);
+    void Flush(Process& process);
+    void NotifyTerminated(Process& process);
+    /// the time to wait for new events before the pending output must be flushed, -1 if there is nothing pending
+    int GetFlushTimeout() const;
+
+public:
+    static clProcessReactor& Get();
+
+    /**
+     * @brief start reading the process output
+     * @return the process id in the reactor, or 0 if the process can not be watched (the caller should fall back to a
+     * reader thread)
+     */
+    uint64_t Add(const Registration& registration);
+
+    /**
+     * @brief stop watching a process. No event is sent for the process once this function returns
+     */
+    void Remove(uint64_t id);
+
+    /**
+     * @brief stop reading the process output, so it can be read synchronously. The output that was already read is
+     * sent before this function returns
+     */
+    void Suspend(uint64_t id);
+    void Resume(uint64_t id);
+
+    /**
+     * @brief queue `data` to be written to the process stdin (see Registration::stdin_fd)
+     */
+    bool Write(uint64_t id, const std::string& data);
+};
+#endif // CL_USE_PROCESS_REACTOR
+#endif // CLPROCESSREACTOR_HPP
@@ -26,6 +26,7 @@
 #include "unixprocess_impl.h"
 
 #include "SocketAPI/clSocketBase.h"
+#include "clPosixSpawn.hpp"
 #include "StringUtils.h"
 #include "cl_exception.h"
 #include "file_logger.h"
@@ -139,18 +140,21 @@ UnixProcessImpl::~UnixProcessImpl() { Cleanup(); }
 
 void UnixProcessImpl::Cleanup()
 {
+#if CL_USE_PROCESS_REACTOR
+    // the reactor must stop watching the handles before we close them
+    if (m_reactorId != 0) {
+        clProcessReactor::Get().Remove(m_reactorId);
+        m_reactorId = 0;
+    }
+#endif
+
     close(GetReadHandle());
     close(GetWriteHandle());
     if (GetStderrHandle() != wxNOT_FOUND) {
         close(GetStderrHandle());
     }
 
-    if (m_thr) {
-        // Stop the reader thread
-        m_thr->Stop();
-        delete m_thr;
-    }
-    m_thr = NULL;
+    StopReaderThread();
 
     if (GetPid() != wxNOT_FOUND) {
         wxKill(GetPid(), GetHardKill() ? wxSIGKILL : wxSIGTERM, NULL, wxKILL_CHILDREN);
@@ -331,6 +335,41 @@ IProcess* UnixProcessImpl::Execute(wxEvtHandler* parent, const wxArrayString& ar
         if (!create_pipe(stdout_read, stdout_write) || !create_pipe(stdin_read, stdin_write)) {
             return nullptr;
         }
+    }
+
+#if CL_USE_POSIX_SPAWN
+    // do not fork() the IDE: copying its page tables takes longer than running most of the commands we launch
+    clPosixSpawn::Options options;
+    options.working_directory = workingDirectory;
+    options.stderr_fd = stderr_write;
+    if (flags & IProcessNoPty) {
+        options.stdin_fd = stdin_read;
+        options.stdout_fd = stdout_write;
+        rc = clPosixSpawn::Spawn(argv, options);
+    } else {
+        int slave = wxNOT_FOUND;
+        if (openpty(&master, &slave, pts_name, nullptr, nullptr) < 0) {
+            rc = -1;
+        } else {
+            // the child opens the terminal by name, so it becomes its controlling terminal
+            options.tty = pts_name;
+            rc = clPosixSpawn::Spawn(argv, options);
+            close(slave);
+        }
+    }
+
+    if (rc < 0) {
+        clERROR() << "Failed to execute" << args << "." << strerror(errno) << endl;
+        freeargv(argv);
+        for (int fd : { master, stderr_read, stderr_write, stdout_read, stdout_write, stdin_read, stdin_write }) {
+            if (fd != wxNOT_FOUND) {
+                close(fd);
+            }
+        }
+        return nullptr;
+    }
+#else
+    if (flags & IProcessNoPty) {
         rc = fork();
     } else {
         rc = forkpty(&master, pts_name, nullptr, nullptr);
@@ -397,8 +436,10 @@ IProcess* UnixProcessImpl::Execute(wxEvtHandler* parent, const wxArrayString& ar
         wxSetWorkingDirectory(curdir);
 
         return NULL;
+    }
+#endif
 
-    } else {
+    {
         //===-------------------------------------------------------
         // Parent
         //===-------------------------------------------------------
@@ -472,6 +513,24 @@ IProcess* UnixProcessImpl::Execute(wxEvtHandler* parent, const wxString& cmd, si
 
 void UnixProcessImpl::StartReaderThread()
 {
+#if CL_USE_PROCESS_REACTOR
+    // a single thread reads the output of all the processes
+    clProcessReactor::Registration registration;
+    registration.pid = GetPid();
+    if (IsRedirect()) {
+        registration.stdout_fd = GetReadHandle();
+        registration.stderr_fd = GetStderrHandle();
+    }
+    registration.owner = m_parent;
+    registration.process = this;
+    registration.callback = m_callback;
+    registration.strip_colours = !(m_flags & IProcessRawOutput);
+    m_reactorId = clProcessReactor::Get().Add(registration);
+    if (m_reactorId != 0) {
+        return;
+    }
+#endif
+
     // Launch the 'Reader' thread
     m_thr = new ProcessReaderThread();
     m_thr->SetProcess(this);
@@ -499,8 +558,15 @@ bool UnixProcessImpl::WriteToConsole(const wxString& buff)
     return do_write(GetWriteHandle(), mb);
 }
 
-void UnixProcessImpl::Detach()
+void UnixProcessImpl::StopReaderThread()
 {
+#if CL_USE_PROCESS_REACTOR
+    if (m_reactorId != 0) {
+        clProcessReactor::Get().Remove(m_reactorId);
+        m_reactorId = 0;
+    }
+#endif
+
     if (m_thr) {
         // Stop the reader thread
         m_thr->Stop();
@@ -509,6 +575,30 @@ void UnixProcessImpl::Detach()
     m_thr = NULL;
 }
 
+void UnixProcessImpl::Detach() { StopReaderThread(); }
+
+void UnixProcessImpl::SuspendAsyncReads()
+{
+#if CL_USE_PROCESS_REACTOR
+    if (m_reactorId != 0) {
+        clProcessReactor::Get().Suspend(m_reactorId);
+        return;
+    }
+#endif
+    IProcess::SuspendAsyncReads();
+}
+
+void UnixProcessImpl::ResumeAsyncReads()
+{
+#if CL_USE_PROCESS_REACTOR
+    if (m_reactorId != 0) {
+        clProcessReactor::Get().Resume(m_reactorId);
+        return;
+    }
+#endif
+    IProcess::ResumeAsyncReads();
+}
+
 void UnixProcessImpl::Signal(wxSignal sig) { wxKill(GetPid(), sig, NULL, wxKILL_CHILDREN); }
 
 #endif // #if defined(__WXMAC )||defined(__WXGTK__)
@@ -27,6 +27,7 @@
 
 #if defined(__WXMAC__) || defined(__WXGTK__)
 #include "asyncprocess.h"
+#include "clProcessReactor.hpp"
 #include "codelite_exports.h"
 #include "processreaderthread.h"
 
@@ -38,10 +39,15 @@ class WXDLLIMPEXP_CL UnixProcessImpl : public IProcess
     int m_stderrHandle = wxNOT_FOUND;
     int m_writeHandle;
     wxString m_tty;
+#if CL_USE_PROCESS_REACTOR
+    // our id in clProcessReactor, 0 if the output is read by m_thr
+    uint64_t m_reactorId = 0;
+#endif
     friend class wxTerminal;
 
 private:
     void StartReaderThread();
+    void StopReaderThread();
     bool ReadFromFd(int fd, fd_set& rset, wxString& output, std::string& raw_output);
 
 public:
@@ -76,5 +82,7 @@ public:
     bool WriteToConsole(const wxString& buff) override;
     void Detach() override;
     void Signal(wxSignal sig) override;
+    void SuspendAsyncReads() override;
+    void ResumeAsyncReads() override;
 };
 #endif // #if defined(__WXMAC )||defined(__WXGTK__)
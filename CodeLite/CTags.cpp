@@ -1,18 +1,25 @@
 #include "CTags.hpp"
 
 #include "AsyncProcess/asyncprocess.h"
+#include "JSONReader.hpp"
 #include "cl_standard_paths.h"
 #include "clTempFile.hpp"
 #include "file_logger.h"
 #include "fileutils.h"
 #include "procutils.h"
 
+#include <atomic>
+#include <chrono>
+#include <memory>
 #include <set>
+#include <unordered_map>
 #include <wx/stopwatch.h>
 #include <wx/tokenzr.h>
 
 thread_local bool is_initialised = false;
 thread_local bool is_macrodef_supported = false;
+thread_local bool is_interactive_supported = false;
+std::atomic_bool is_resident_indexer_enabled{ true };
 
 wxString CTags::WrapSpaces(const wxString& file)
 {
@@ -31,16 +38,24 @@ wxString fix_macro_entry(const wxString& macro)
     //fixed.Replace("\"", "\\\"");
     return fixed;
 }
-} // namespace
 
-bool CTags::DoGenerate(const wxString& filesContent, const wxString& codelite_indexer, const wxStringMap_t& macro_table,
-                       const wxString& ctags_kinds, wxString* output)
+std::string_view trim(std::string_view str)
 {
-    Initialise(codelite_indexer);
-    clDEBUG() << "Generating ctags files" << clEndl;
+    auto is_space = [](char ch) {
+        return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n' || ch == '\v' || ch == '\f';
+    };
+    while(!str.empty() && is_space(str.front())) {
+        str.remove_prefix(1);
+    }
+    while(!str.empty() && is_space(str.back())) {
+        str.remove_suffix(1);
+    }
+    return str;
+}
 
-    // prepare the options file
-    // one option per line
+/// the content of the ctags options file, one option per line
+wxString build_options(const wxStringMap_t& macro_table)
+{
     std::vector<wxString> options_arr;
     options_arr.reserve(500);
     wxString fields_cxx = "--fields-c++=+{template}+{properties}";
@@ -51,14 +66,6 @@ bool CTags::DoGenerate(const wxString& filesContent, const wxString& codelite_in
     options_arr = { "--extras=-p",       "--excmd=pattern",      "--sort=no",
                     "--fields=aKmSsnit", "--language-force=c++", fields_cxx };
 
-    wxString kinds_string;
-    if(ctags_kinds.empty()) {
-        // default
-        kinds_string << " --c-kinds=+pxz --C++-kinds=+pxz ";
-    } else {
-        kinds_string << " --c-kinds=" << ctags_kinds << " --C++-kinds=" << ctags_kinds << " ";
-    }
-
     // we want the macros ordered, so we push them into std::set
     std::set<wxString> macros;
     for(const auto& vt : macro_table) {
@@ -70,18 +77,11 @@ bool CTags::DoGenerate(const wxString& filesContent, const wxString& codelite_in
             // simple -D
             macro_replacements << "-D" << fixed_macro_name;
         } else {
-            wxString fixed_macro_name = fix_macro_entry(vt.first);
-            wxString fixed_macro_value = fix_macro_entry(vt.second);
             macro_replacements << "-D" << fixed_macro_name << "=" << fixed_macro_value;
         }
         macros.insert(macro_replacements);
     }
 
-    // write the options into a file
-    wxFileName ctags_options_file(clStandardPaths::Get().GetUserDataDir(),
-                                  wxString() << "options-" << wxThread::GetCurrentId() << ".ctags");
-    FileUtils::Deleter d{ ctags_options_file };
-
     wxString ctags_options_file_content;
     for(const wxString& option : options_arr) {
         ctags_options_file_content << option << "\n";
@@ -92,65 +92,200 @@ bool CTags::DoGenerate(const wxString& filesContent, const wxString& codelite_in
         ctags_options_file_content << macro << "\n";
     }
     ctags_options_file_content.Trim();
-    FileUtils::WriteFileContent(ctags_options_file.GetFullPath(), ctags_options_file_content);
+    return ctags_options_file_content;
+}
 
-    // start timer
-    wxStopWatch sw;
+std::vector<wxString> build_kinds_args(const wxString& ctags_kinds)
+{
+    if(ctags_kinds.empty()) {
+        // default
+        return { "--c-kinds=+pxz", "--C++-kinds=+pxz" };
+    }
+    return { "--c-kinds=" + ctags_kinds, "--C++-kinds=" + ctags_kinds };
+}
 
-    sw.Start();
-    // Split the list of files
-    wxFileName file_list(clStandardPaths::Get().GetTempDir(),
-                         wxString() << "file-list-" << wxThread::GetCurrentId() << ".txt");
-    FileUtils::WriteFileContent(file_list, filesContent);
+/**
+ * @class ResidentIndexer
+ * @brief a long lived codelite-indexer process, driven with the ctags interactive protocol (`--_interactive`). Each
+ * request writes the buffer to the indexer stdin and reads back the tags as JSON lines, so parsing a buffer does not
+ * require starting a process nor writing temporary files
+ */
+class ResidentIndexer
+{
+    // how long to wait for the indexer to reply
+    static constexpr long TIMEOUT_MS = 10000;
 
-    wxString command_to_run;
-    command_to_run << WrapSpaces(codelite_indexer) << " --options=" << WrapSpaces(ctags_options_file.GetFullPath())
-                   << kinds_string << " -L " << WrapSpaces(file_list.GetFullPath()) << " -f - ";
-    ProcUtils::WrapInShell(command_to_run);
-    clDEBUG() << "Running command:" << command_to_run << endl;
+    IProcess::Ptr_t m_process;
+    std::string m_output;
+    size_t m_offset = 0;
 
-    *output = ProcUtils::SafeExecuteCommand(command_to_run);
+private:
+    /// read the next line written by the indexer
+    bool read_line(std::string_view* line, const wxStopWatch& sw)
+    {
+        while(true) {
+            size_t eol = m_output.find('\n', m_offset);
+            if(eol != std::string::npos) {
+                *line = std::string_view{ m_output.data() + m_offset, eol - m_offset };
+                m_offset = eol + 1;
+                return true;
+            }
 
-    long elapsed = sw.Time();
+            // the consumed lines are no longer needed
+            m_output.erase(0, m_offset);
+            m_offset = 0;
+            if(!m_process || sw.Time() > TIMEOUT_MS) {
+                return false;
+            }
 
-    clDEBUG() << "Parsing took:" << (elapsed / 1000) << "secs," << (elapsed % 1000) << "ms" << endl;
-    clDEBUG() << "Generating ctags files... Success" << endl;
-    return true;
-}
+            wxString buff, buff_err;
+            std::string raw_buff, raw_buff_err;
+            if(!m_process->Read(buff, buff_err, raw_buff, raw_buff_err) && !m_process->IsAlive()) {
+                return false;
+            }
+            if(raw_buff.empty()) {
+                wxThread::Sleep(1);
+            }
+            m_output.append(raw_buff);
+        }
+    }
 
-size_t CTags::ParseFiles(const std::vector<wxString>& files, const wxString& codelite_indexer,
-                         const wxStringMap_t& macro_table, std::vector<TagEntryPtr>& tags)
-{
-    wxString filesList;
-    for(const auto& file : files) {
-        filesList << file << "\n";
+public:
+    ResidentIndexer() = default;
+    ~ResidentIndexer() { Stop(); }
+
+    bool IsRunning() const { return m_process && m_process->IsAlive(); }
+
+    bool Start(const wxString& codelite_indexer, const wxString& options, const std::vector<wxString>& kinds_args)
+    {
+        Stop();
+        wxFileName ctags_options_file(clStandardPaths::Get().GetUserDataDir(),
+                                      wxString() << "options-interactive-" << wxThread::GetCurrentId() << ".ctags");
+        FileUtils::Deleter d{ ctags_options_file };
+        FileUtils::WriteFileContent(ctags_options_file.GetFullPath(), options);
+
+        std::vector<wxString> command = { codelite_indexer, "--options=" + ctags_options_file.GetFullPath() };
+        command.insert(command.end(), kinds_args.begin(), kinds_args.end());
+        command.push_back("--_interactive");
+        clDEBUG() << "Starting resident indexer:" << command << endl;
+
+        m_process.reset(::CreateAsyncProcess(nullptr, command,
+                                             IProcessCreateSync | IProcessNoPty | IProcessStderrEvent |
+                                                 IProcessRawOutput,
+                                             wxEmptyString, nullptr, wxEmptyString));
+        if(!m_process) {
+            clWARNING() << "Resident indexer: failed to launch" << codelite_indexer << endl;
+            return false;
+        }
+
+        // the indexer is ready (and it no longer needs the options file) once it introduced itself
+        wxStopWatch sw;
+        std::string_view line;
+        JSONReader reader;
+        while(read_line(&line, sw)) {
+            if(reader.Parse(line) && reader.toElement()["_type"].toStringView() == "program") {
+                return true;
+            }
+        }
+        clWARNING() << "Resident indexer did not start: it exited or did not introduce itself within" << TIMEOUT_MS
+                    << "ms" << endl;
+        Stop();
+        return false;
     }
-    wxString content;
-    if(!DoGenerate(filesList, codelite_indexer, macro_table, wxEmptyString, &content)) {
-        return 0;
+
+    void Stop()
+    {
+        if(m_process) {
+            m_process->Terminate();
+            m_process.reset();
+        }
+        m_output.clear();
+        m_offset = 0;
     }
 
-    tags.clear();
-    wxArrayString lines = ::wxStringTokenize(content, "\n", wxTOKEN_STRTOK);
-    tags.reserve(lines.size());
-
-    // convert the lines into tags
-    TagEntryPtr prev_scoped_tag = nullptr;
-    for(wxString& line : lines) {
-        line.Trim(false).Trim();
-        if(line.empty()) {
-            continue;
+    bool Parse(std::string_view content, CTagsOutputParser& parser)
+    {
+        std::string request = R"({"command":"generate-tags","filename":"buffer.cpp","size":)";
+        request += std::to_string(content.length());
+        request += "}\n";
+        request.append(content);
+        if(!IsRunning() || !m_process->WriteRaw(request)) {
+            Stop();
+            return false;
+        }
+
+        wxStopWatch sw;
+        std::string_view line;
+        JSONReader reader;
+        while(read_line(&line, sw)) {
+            if(!reader.Parse(line)) {
+                continue;
+            }
+
+            auto json = reader.toElement();
+            std::string_view type = json["_type"].toStringView();
+            if(type == "tag") {
+                TagEntryPtr tag(new TagEntry());
+                if(tag->FromCTagsJSON(json)) {
+                    parser.AddTag(tag);
+                }
+            } else if(type == "completed") {
+                return true;
+            } else if(type == "error") {
+                clWARNING() << "Resident indexer error:" << json["message"].toString() << endl;
+                break;
+            }
+        }
+
+        // we can no longer tell where the reply ends, start over
+        Stop();
+        return false;
+    }
+};
+
+/// resident indexers of the current thread, by command line
+thread_local std::unordered_map<wxString, std::unique_ptr<ResidentIndexer>> resident_indexers;
+constexpr size_t MAX_RESIDENT_INDEXERS = 4;
+
+/// after the resident indexer failed to start, the buffers are parsed by a new process until the retry time. The delay
+/// doubles with each consecutive failure, up to MAX_RESIDENT_INDEXER_RETRY_DELAY
+constexpr std::chrono::seconds RESIDENT_INDEXER_RETRY_DELAY{ 30 };
+constexpr std::chrono::seconds MAX_RESIDENT_INDEXER_RETRY_DELAY{ 600 };
+thread_local size_t resident_indexer_failures = 0;
+thread_local std::chrono::steady_clock::time_point resident_indexer_retry_time;
+} // namespace
+
+void CTagsOutputParser::AddLine(std::string_view line)
+{
+    ++m_lines;
+    line = trim(line);
+    if(line.empty()) {
+        return;
+    }
+
+    // construct a tag from the line
+    TagEntryPtr tag(new TagEntry());
+    if(!tag->FromLine(line, &m_cache)) {
+        LOG_IF_TRACE
+        {
+            clDEBUG1() << "Ignoring invalid ctags line:" << wxString::FromUTF8(line.data(), line.length()) << endl;
         }
+        return;
+    }
+    AddTag(std::move(tag));
+}
 
-        // construct a tag from the line
-        tags.emplace_back(new TagEntry());
-        auto tag = tags.back();
-        tag->FromLine(line);
+void CTagsOutputParser::AddTag(TagEntryPtr tag)
+{
+    if(m_cache.fixed && tag->GetFile() != m_cache.fullpath) {
+        tag->SetFile(m_cache.fullpath);
+    }
 
-        if(tag->IsEnumerator()                                // looking at an enumerator
-           && prev_scoped_tag                                 // we have a previously seen scope
-           && prev_scoped_tag->GetFile() == tag->GetFile()    /// and they are on the same file
-           && prev_scoped_tag->GetName() == tag->GetParent()) // and it belongs to it
+    if(m_fix_enumerators) {
+        if(tag->IsEnumerator()                                  // looking at an enumerator
+           && m_prev_scoped_tag                                 // we have a previously seen scope
+           && m_prev_scoped_tag->GetFile() == tag->GetFile()    /// and they are on the same file
+           && m_prev_scoped_tag->GetName() == tag->GetParent()) // and it belongs to it
         {
             // remove one part of the scope
             wxArrayString scopes = ::wxStringTokenize(tag->GetScope(), ":", wxTOKEN_STRTOK);
@@ -169,12 +304,79 @@ size_t CTags::ParseFiles(const std::vector<wxString>& files, const wxString& cod
         }
 
         if(tag->IsEnum()) {
-            prev_scoped_tag = tag;
+            m_prev_scoped_tag = tag;
         }
     }
+    m_tags.push_back(std::move(tag));
+}
+
+void CTagsOutputParser::AddOutput(std::string_view output)
+{
+    while(!output.empty()) {
+        size_t eol = output.find('\n');
+        AddLine(output.substr(0, eol));
+        output.remove_prefix(eol == std::string_view::npos ? output.length() : eol + 1);
+    }
+}
+
+bool CTags::DoGenerate(const wxString& filesContent, const wxString& codelite_indexer, const wxStringMap_t& macro_table,
+                       const wxString& ctags_kinds, const std::function<void(std::string_view)>& on_line)
+{
+    Initialise(codelite_indexer);
+    clDEBUG() << "Generating ctags files" << clEndl;
+
+    wxString kinds_string = " ";
+    for(const wxString& arg : build_kinds_args(ctags_kinds)) {
+        kinds_string << arg << " ";
+    }
+
+    // write the options into a file
+    wxFileName ctags_options_file(clStandardPaths::Get().GetUserDataDir(),
+                                  wxString() << "options-" << wxThread::GetCurrentId() << ".ctags");
+    FileUtils::Deleter d{ ctags_options_file };
+    FileUtils::WriteFileContent(ctags_options_file.GetFullPath(), build_options(macro_table));
+
+    // start timer
+    wxStopWatch sw;
+
+    sw.Start();
+    // Split the list of files
+    wxFileName file_list(clStandardPaths::Get().GetTempDir(),
+                         wxString() << "file-list-" << wxThread::GetCurrentId() << ".txt");
+    FileUtils::WriteFileContent(file_list, filesContent);
+
+    wxString command_to_run;
+    command_to_run << WrapSpaces(codelite_indexer) << " --options=" << WrapSpaces(ctags_options_file.GetFullPath())
+                   << kinds_string << " -L " << WrapSpaces(file_list.GetFullPath()) << " -f - ";
+    ProcUtils::WrapInShell(command_to_run);
+    clDEBUG() << "Running command:" << command_to_run << endl;
+
+    // the tags are constructed while codelite-indexer is still running
+    ProcUtils::SafeExecuteCommand(command_to_run, on_line);
+
+    long elapsed = sw.Time();
+
+    clDEBUG() << "Parsing took:" << (elapsed / 1000) << "secs," << (elapsed % 1000) << "ms" << endl;
+    clDEBUG() << "Generating ctags files... Success" << endl;
+    return true;
+}
+
+size_t CTags::ParseFiles(const std::vector<wxString>& files, const wxString& codelite_indexer,
+                         const wxStringMap_t& macro_table, std::vector<TagEntryPtr>& tags)
+{
+    wxString filesList;
+    for(const auto& file : files) {
+        filesList << file << "\n";
+    }
+    tags.clear();
+    CTagsOutputParser parser(tags);
+    if(!DoGenerate(filesList, codelite_indexer, macro_table, wxEmptyString,
+                   [&parser](std::string_view line) { parser.AddLine(line); })) {
+        return 0;
+    }
 
     if(tags.empty()) {
-        clDEBUG() << "0 tags, ctags output:" << content << endl;
+        clDEBUG() << "0 tags, ctags output lines:" << parser.GetLinesCount() << endl;
     }
     return tags.size();
 }
@@ -188,14 +390,22 @@ size_t CTags::ParseFile(const wxString& file, const wxString& codelite_indexer,
 size_t CTags::ParseBuffer(const wxFileName& filename, const wxString& buffer, const wxString& codelite_indexer,
                           const wxStringMap_t& macro_table, std::vector<TagEntryPtr>& tags)
 {
-    // create a temporary file with the content we want to parse
-    clTempFile temp_file("cpp");
-    temp_file.Write(buffer);
-    // parse the file
-    ParseFile(temp_file.GetFileName().GetFullPath(), codelite_indexer, macro_table, tags);
-    // set the file name to the correct file
-    for(TagEntryPtr tag : tags) {
-        tag->SetFile(filename.GetFullPath());
+    tags.clear();
+    CTagsOutputParser parser(tags);
+    // the tags are in `filename`, not in the file that ctags parses
+    parser.SetFile(filename.GetFullPath());
+    if(!DoParseInteractive(buffer, codelite_indexer, macro_table, wxEmptyString, parser)) {
+        tags.clear();
+        // create a temporary file with the content we want to parse
+        clTempFile temp_file("cpp");
+        temp_file.Write(buffer);
+
+        wxString filesList;
+        filesList << temp_file.GetFullPath() << "\n";
+        if(!DoGenerate(filesList, codelite_indexer, macro_table, wxEmptyString,
+                       [&parser](std::string_view line) { parser.AddLine(line); })) {
+            return 0;
+        }
     }
     return tags.size();
 }
@@ -203,44 +413,87 @@ size_t CTags::ParseBuffer(const wxFileName& filename, const wxString& buffer, co
 size_t CTags::ParseLocals(const wxFileName& filename, const wxString& buffer, const wxString& codelite_indexer,
                           const wxStringMap_t& macro_table, std::vector<TagEntryPtr>& tags)
 {
-    wxString content;
-    {
+    tags.clear();
+    // we want locals + functions (to resolve the scope)
+    CTagsOutputParser parser(tags, false);
+    // the tags are in `filename`, not in the file that ctags parses
+    parser.SetFile(filename.GetFullPath());
+    if(!DoParseInteractive(buffer, codelite_indexer, macro_table, "lzpvfm", parser)) {
+        tags.clear();
         clTempFile temp_file("cpp");
         temp_file.Write(buffer);
 
         wxString filesList;
         filesList << temp_file.GetFullPath() << "\n";
 
-        // we want locals + functions (to resolve the scope)
-        if(!DoGenerate(filesList, codelite_indexer, macro_table, "lzpvfm", &content)) {
+        if(!DoGenerate(filesList, codelite_indexer, macro_table, "lzpvfm",
+                       [&parser](std::string_view line) { parser.AddLine(line); })) {
             return 0;
         }
-    }
 
-    tags.clear();
-    wxArrayString lines = ::wxStringTokenize(content, "\n", wxTOKEN_STRTOK);
-    tags.reserve(lines.size());
-
-    // convert the lines into tags
-    for(auto& line : lines) {
-        line.Trim().Trim(false);
-        if(line.empty()) {
-            continue;
+        if(tags.empty()) {
+            clDEBUG() << "0 local tags, ctags output lines:" << parser.GetLinesCount() << endl;
         }
+    }
+    return tags.size();
+}
 
-        // construct a tag from the line
-        tags.emplace_back(new TagEntry());
-        auto tag = tags.back();
-        tag->FromLine(line);
-        tag->SetFile(filename.GetFullPath());
+bool CTags::DoParseInteractive(const wxString& buffer, const wxString& codelite_indexer,
+                               const wxStringMap_t& macro_table, const wxString& ctags_kinds,
+                               CTagsOutputParser& parser)
+{
+    Initialise(codelite_indexer);
+    if(!is_interactive_supported || !is_resident_indexer_enabled) {
+        return false;
     }
 
-    if(tags.empty()) {
-        clDEBUG() << "0 local tags, ctags output:" << content << endl;
+    if(resident_indexer_failures > 0 && std::chrono::steady_clock::now() < resident_indexer_retry_time) {
+        return false;
     }
-    return tags.size();
+
+    wxString options = build_options(macro_table);
+    std::vector<wxString> kinds_args = build_kinds_args(ctags_kinds);
+    wxString key;
+    key << codelite_indexer << "\n" << options;
+    for(const wxString& arg : kinds_args) {
+        key << "\n" << arg;
+    }
+
+    if(resident_indexers.count(key) == 0 && resident_indexers.size() >= MAX_RESIDENT_INDEXERS) {
+        // the macros were changed, the old indexers are no longer needed
+        resident_indexers.clear();
+    }
+
+    auto& indexer = resident_indexers[key];
+    if(!indexer || !indexer->IsRunning()) {
+        indexer.reset(new ResidentIndexer());
+        if(!indexer->Start(codelite_indexer, options, kinds_args)) {
+            resident_indexers.erase(key);
+            auto delay = RESIDENT_INDEXER_RETRY_DELAY * (1 << std::min<size_t>(resident_indexer_failures, 5));
+            delay = std::min(delay, MAX_RESIDENT_INDEXER_RETRY_DELAY);
+            resident_indexer_retry_time = std::chrono::steady_clock::now() + delay;
+            ++resident_indexer_failures;
+            clWARNING() << "Resident indexer failed to start (" << resident_indexer_failures
+                        << "consecutive failures). Using a codelite-indexer process per request for the next"
+                        << (int)delay.count() << "seconds" << endl;
+            return false;
+        }
+        resident_indexer_failures = 0;
+    }
+
+    wxStopWatch sw;
+    const wxScopedCharBuffer utf8 = buffer.utf8_str();
+    if(!indexer->Parse(std::string_view{ utf8.data(), utf8.length() }, parser)) {
+        clWARNING() << "Resident indexer failed, falling back to a new codelite-indexer process" << endl;
+        resident_indexers.erase(key);
+        return false;
+    }
+    LOG_IF_DEBUG { clDEBUG() << "Resident indexer parsed buffer in" << sw.Time() << "ms" << endl; }
+    return true;
 }
 
+void CTags::SetResidentIndexerEnabled(bool enabled) { is_resident_indexer_enabled = enabled; }
+
 void CTags::Initialise(const wxString& codelite_indexer)
 {
     if(is_initialised) {
@@ -248,19 +501,32 @@ void CTags::Initialise(const wxString& codelite_indexer)
     }
 
     is_initialised = true;
-    // check whether we have `macrodef` supported
-    wxString output;
-    std::vector<wxString> command = { codelite_indexer, "--list-fields=c++" };
-    auto process = ::CreateAsyncProcess(nullptr, command, IProcessCreateSync, wxEmptyString, nullptr, wxEmptyString);
-    if(process) {
-        process->WaitForTerminate(output);
-    }
+    auto get_output = [&codelite_indexer](const wxString& arg) -> wxArrayString {
+        wxString output;
+        std::vector<wxString> command = { codelite_indexer, arg };
+        IProcess::Ptr_t process(
+            ::CreateAsyncProcess(nullptr, command, IProcessCreateSync, wxEmptyString, nullptr, wxEmptyString));
+        if(process) {
+            process->WaitForTerminate(output);
+        }
+        return ::wxStringTokenize(output, "\n", wxTOKEN_STRTOK);
+    };
 
-    wxArrayString lines = ::wxStringTokenize(output, "\n", wxTOKEN_STRTOK);
-    for(const auto& line : lines) {
+    // check whether we have `macrodef` supported
+    for(const auto& line : get_output("--list-fields=c++")) {
         if(line.Contains("macrodef")) {
             is_macrodef_supported = true;
             break;
         }
     }
+
+    // the resident indexer requires the interactive mode, which talks JSON
+    bool has_interactive = false;
+    bool has_json = false;
+    for(const auto& line : get_output("--list-features")) {
+        has_interactive = has_interactive || line.StartsWith("interactive");
+        has_json = has_json || line.StartsWith("json");
+    }
+    is_interactive_supported = has_interactive && has_json;
+    clDEBUG() << "codelite-indexer interactive mode supported:" << is_interactive_supported << endl;
 }
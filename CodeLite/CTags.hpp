@@ -5,10 +5,68 @@
 #include "database/entry.h"
 #include "tag_tree.h"
 
+#include <functional>
+#include <string_view>
 #include <vector>
 #include <wx/filename.h>
 #include <wx/textfile.h>
 
+/**
+ * @class CTagsOutputParser
+ * @brief converts ctags output into tags one line at a time, so the output can be parsed while the indexer is still
+ * writing it. The lines are tokenized in place, see TagEntry::FromLine(std::string_view)
+ */
+class WXDLLIMPEXP_CL CTagsOutputParser
+{
+    std::vector<TagEntryPtr>& m_tags;
+    TagEntryPtr m_prev_scoped_tag;
+    TagEntry::LineCache m_cache;
+    size_t m_lines = 0;
+    bool m_fix_enumerators = true;
+
+public:
+    /**
+     * @param tags the parsed tags are appended to this vector
+     * @param fix_enumerators move enumerators to the scope of their enum, as done for regular (non local) tags
+     */
+    CTagsOutputParser(std::vector<TagEntryPtr>& tags, bool fix_enumerators = true)
+        : m_tags(tags)
+        , m_fix_enumerators(fix_enumerators)
+    {
+    }
+    ~CTagsOutputParser() = default;
+
+    /**
+     * @brief set the file of all the tags, instead of the file written by ctags. Used when ctags parses a temporary
+     * copy of the file, so the temporary path is never stored in the tags
+     */
+    void SetFile(const wxString& fullpath)
+    {
+        m_cache.fullpath = fullpath;
+        m_cache.fixed = true;
+    }
+
+    /**
+     * @brief parse a single line of UTF-8 ctags output
+     */
+    void AddLine(std::string_view line);
+
+    /**
+     * @brief add a tag that was already parsed
+     */
+    void AddTag(TagEntryPtr tag);
+
+    /**
+     * @brief parse a block of complete lines
+     */
+    void AddOutput(std::string_view output);
+
+    /**
+     * @brief number of lines seen so far (including empty and invalid lines)
+     */
+    size_t GetLinesCount() const { return m_lines; }
+};
+
 class WXDLLIMPEXP_CL CTags
 {
 protected:
@@ -19,12 +77,22 @@ protected:
      * @param path location for the output ctags file. The output is written into `wxFileName(path, "ctags")`;
      * @param codelite_indexer path to `codelite_indexer`
      * @param ctags_args arguments to pass to ctags executable. Leave empty for the defaults
-     * @param output if provided, holds the ctags content
+     * @param on_line called with each line of the ctags output while it is being read, see
+     * ProcUtils::SafeExecuteCommand
      * @return true on success, false otherwise
      */
     static bool DoGenerate(const wxString& filesContent, const wxString& codelite_indexer,
-                           const wxStringMap_t& macro_table, const wxString& ctags_kinds = wxEmptyString,
-                           wxString* output = nullptr);
+                           const wxStringMap_t& macro_table, const wxString& ctags_kinds,
+                           const std::function<void(std::string_view)>& on_line);
+
+    /**
+     * @brief parse `buffer` with a resident codelite-indexer process (one per thread and options), started on demand
+     * @return false if the indexer does not support the interactive mode or if it failed. The caller should fallback
+     * to DoGenerate()
+     */
+    static bool DoParseInteractive(const wxString& buffer, const wxString& codelite_indexer,
+                                   const wxStringMap_t& macro_table, const wxString& ctags_kinds,
+                                   CTagsOutputParser& parser);
 
     static void Initialise(const wxString& codelite_indexer);
 
@@ -51,6 +119,12 @@ public:
      */
     static size_t ParseLocals(const wxFileName& filename, const wxString& buffer, const wxString& codelite_indexer,
                               const wxStringMap_t& macro_table, std::vector<TagEntryPtr>& tags);
+
+    /**
+     * @brief ParseBuffer and ParseLocals use a resident codelite-indexer when it supports the interactive mode. This
+     * is enabled by default
+     */
+    static void SetResidentIndexerEnabled(bool enabled);
 };
 
 #endif // CTAGSGENERATOR_HPP
@@ -0,0 +1,628 @@
+#include "JSONReader.hpp"
+
+#include <climits>
+#include <locale>
+#include <sstream>
+
+namespace
+{
+constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+// same as cJSON's CJSON_NESTING_LIMIT
+constexpr size_t MAX_DEPTH = 1000;
+
+bool read_hex4(const char* data, size_t length, size_t pos, uint32_t* value)
+{
+    if (pos + 4 > length) {
+        return false;
+    }
+
+    *value = 0;
+    for (size_t i = pos; i < pos + 4; ++i) {
+        char ch = data[i];
+        *value <<= 4;
+        if (ch >= '0' && ch <= '9') {
+            *value |= ch - '0';
+        } else if (ch >= 'a' && ch <= 'f') {
+            *value |= ch - 'a' + 10;
+        } else if (ch >= 'A' && ch <= 'F') {
+            *value |= ch - 'A' + 10;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+void append_utf8(std::string& str, uint32_t codepoint)
+{
+    if (codepoint < 0x80) {
+        str.push_back(static_cast<char>(codepoint));
+    } else if (codepoint < 0x800) {
+        str.push_back(static_cast<char>(0xC0 | (codepoint >> 6)));
+        str.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+    } else if (codepoint < 0x10000) {
+        str.push_back(static_cast<char>(0xE0 | (codepoint >> 12)));
+        str.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+        str.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+    } else {
+        str.push_back(static_cast<char>(0xF0 | (codepoint >> 18)));
+        str.push_back(static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F)));
+        str.push_back(static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F)));
+        str.push_back(static_cast<char>(0x80 | (codepoint & 0x3F)));
+    }
+}
+} // namespace
+
+JSONReader::JSONReader(std::string_view text) { Parse(text); }
+
+bool JSONReader::Parse(std::string_view text)
+{
+    m_text.assign(text.data(), text.length());
+    m_strings.clear();
+    m_nodes.clear();
+    m_pos = 0;
+    m_ok = false;
+
+    if (m_text.length() >= INVALID_INDEX) {
+        return false;
+    }
+
+    // avoid most of the re-allocations, a value takes at least 2 bytes ("0,")
+    m_nodes.reserve(m_text.length() / 8 + 1);
+
+    // like cJSON, trailing data is ignored
+    m_ok = parse_value(0) != INVALID_INDEX;
+    if (!m_ok) {
+        m_nodes.clear();
+        m_strings.clear();
+    }
+    return m_ok;
+}
+
+JSONReaderItem JSONReader::toElement() const
+{
+    if (!m_ok) {
+        return JSONReaderItem{};
+    }
+    return JSONReaderItem{ this, 0 };
+}
+
+std::string_view JSONReader::GetKey(const Node& node) const
+{
+    const std::string& buffer = node.key_decoded ? m_strings : m_text;
+    return std::string_view{ buffer.data() + node.key_offset, node.key_length };
+}
+
+std::string_view JSONReader::GetString(const Node& node) const
+{
+    const std::string& buffer = node.value_decoded ? m_strings : m_text;
+    return std::string_view{ buffer.data() + node.value_offset, node.value_length };
+}
+
+void JSONReader::skip_whitespace()
+{
+    while (m_pos < m_text.length()) {
+        char ch = m_text[m_pos];
+        if (ch != ' ' && ch != '\t' && ch != '\r' && ch != '\n') {
+            break;
+        }
+        ++m_pos;
+    }
+}
+
+bool JSONReader::parse_literal(std::string_view literal)
+{
+    if (m_text.compare(m_pos, literal.length(), literal) != 0) {
+        return false;
+    }
+    m_pos += literal.length();
+    return true;
+}
+
+bool JSONReader::parse_string(uint32_t* offset, uint32_t* length, bool* decoded)
+{
+    // m_pos is on the opening quote
+    const char* data = m_text.data();
+    size_t text_length = m_text.length();
+    size_t start = m_pos + 1;
+    size_t i = start;
+    while (i < text_length && data[i] != '"' && data[i] != '\\') {
+        ++i;
+    }
+
+    if (i >= text_length) {
+        return false;
+    }
+
+    if (data[i] == '"') {
+        // the common case: no escape sequences, point into the text
+        *offset = start;
+        *length = i - start;
+        *decoded = false;
+        m_pos = i + 1;
+        return true;
+    }
+
+    *offset = m_strings.length();
+    *decoded = true;
+    m_strings.append(data + start, i - start);
+    while (i < text_length) {
+        char ch = data[i];
+        if (ch == '"') {
+            *length = m_strings.length() - *offset;
+            m_pos = i + 1;
+            return true;
+        }
+
+        if (ch != '\\') {
+            m_strings.push_back(ch);
+            ++i;
+            continue;
+        }
+
+        if (i + 1 >= text_length) {
+            return false;
+        }
+
+        char escaped = data[i + 1];
+        i += 2;
+        switch (escaped) {
+        case '"':
+        case '\\':
+        case '/':
+            m_strings.push_back(escaped);
+            break;
+        case 'b':
+            m_strings.push_back('\b');
+            break;
+        case 'f':
+            m_strings.push_back('\f');
+            break;
+        case 'n':
+            m_strings.push_back('\n');
+            break;
+        case 'r':
+            m_strings.push_back('\r');
+            break;
+        case 't':
+            m_strings.push_back('\t');
+            break;
+        case 'u': {
+            uint32_t codepoint = 0;
+            if (!read_hex4(data, text_length, i, &codepoint)) {
+                return false;
+            }
+            i += 4;
+
+            if (codepoint >= 0xD800 && codepoint <= 0xDBFF) {
+                // UTF-16 surrogate pair
+                uint32_t low = 0;
+                if (i + 6 <= text_length && data[i] == '\\' && data[i + 1] == 'u' &&
+                    read_hex4(data, text_length, i + 2, &low) && low >= 0xDC00 && low <= 0xDFFF) {
+                    codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+                    i += 6;
+                } else {
+                    codepoint = 0xFFFD;
+                }
+            } else if (codepoint >= 0xDC00 && codepoint <= 0xDFFF) {
+                codepoint = 0xFFFD;
+            }
+            append_utf8(m_strings, codepoint);
+        } break;
+        default:
+            return false;
+        }
+    }
+    return false;
+}
+
+bool JSONReader::parse_number(double* number)
+{
+    const char* data = m_text.data();
+    size_t text_length = m_text.length();
+    size_t start = m_pos;
+    size_t i = m_pos;
+
+    bool negative = false;
+    if (i < text_length && data[i] == '-') {
+        negative = true;
+        ++i;
+    }
+
+    // most of the numbers in the LSP messages are integers, convert them as we go
+    uint64_t integer = 0;
+    size_t digits_start = i;
+    while (i < text_length && data[i] >= '0' && data[i] <= '9') {
+        integer = integer * 10 + (data[i] - '0');
+        ++i;
+    }
+
+    if (i == digits_start) {
+        return false;
+    }
+
+    // 18 digits always fit into uint64_t
+    bool is_integer = (i - digits_start) <= 18;
+    if (i < text_length && data[i] == '.') {
+        is_integer = false;
+        ++i;
+        while (i < text_length && data[i] >= '0' && data[i] <= '9') {
+            ++i;
+        }
+    }
+
+    if (i < text_length && (data[i] == 'e' || data[i] == 'E')) {
+        is_integer = false;
+        ++i;
+        if (i < text_length && (data[i] == '+' || data[i] == '-')) {
+            ++i;
+        }
+        while (i < text_length && data[i] >= '0' && data[i] <= '9') {
+            ++i;
+        }
+    }
+
+    if (is_integer) {
+        *number = negative ? -static_cast<double>(integer) : static_cast<double>(integer);
+    } else {
+        // strtod() depends on the current locale's decimal point
+        std::istringstream ss(std::string(data + start, i - start));
+        ss.imbue(std::locale::classic());
+        ss >> *number;
+        if (ss.fail()) {
+            return false;
+        }
+    }
+    m_pos = i;
+    return true;
+}
+
+uint32_t JSONReader::parse_value(size_t depth)
+{
+    if (depth > MAX_DEPTH) {
+        return INVALID_INDEX;
+    }
+
+    skip_whitespace();
+    if (m_pos >= m_text.length()) {
+        return INVALID_INDEX;
+    }
+
+    // nodes are referenced by their index: the vector may grow while parsing the children
+    uint32_t index = m_nodes.size();
+    m_nodes.emplace_back();
+
+    char ch = m_text[m_pos];
+    switch (ch) {
+    case '{':
+    case '[': {
+        bool is_object = ch == '{';
+        char close_char = is_object ? '}' : ']';
+        m_nodes[index].type = is_object ? kObject : kArray;
+        ++m_pos;
+
+        skip_whitespace();
+        if (m_pos < m_text.length() && m_text[m_pos] == close_char) {
+            ++m_pos;
+            return index;
+        }
+
+        uint32_t last_child = INVALID_INDEX;
+        while (true) {
+            uint32_t key_offset = 0;
+            uint32_t key_length = 0;
+            bool key_decoded = false;
+            if (is_object) {
+                skip_whitespace();
+                if (m_pos >= m_text.length() || m_text[m_pos] != '"' ||
+                    !parse_string(&key_offset, &key_length, &key_decoded)) {
+                    return INVALID_INDEX;
+                }
+                skip_whitespace();
+                if (m_pos >= m_text.length() || m_text[m_pos] != ':') {
+                    return INVALID_INDEX;
+                }
+                ++m_pos;
+            }
+
+            uint32_t child = parse_value(depth + 1);
+            if (child == INVALID_INDEX) {
+                return INVALID_INDEX;
+            }
+
+            if (is_object) {
+                m_nodes[child].key_offset = key_offset;
+                m_nodes[child].key_length = key_length;
+                m_nodes[child].key_decoded = key_decoded;
+            }
+
+            if (last_child == INVALID_INDEX) {
+                m_nodes[index].first_child = child;
+            } else {
+                m_nodes[last_child].next = child;
+            }
+            last_child = child;
+            m_nodes[index].children_count++;
+
+            skip_whitespace();
+            if (m_pos >= m_text.length()) {
+                return INVALID_INDEX;
+            }
+
+            if (m_text[m_pos] == ',') {
+                ++m_pos;
+            } else if (m_text[m_pos] == close_char) {
+                ++m_pos;
+                return index;
+            } else {
+                return INVALID_INDEX;
+            }
+        }
+    } break;
+    case '"': {
+        uint32_t offset = 0;
+        uint32_t length = 0;
+        bool decoded = false;
+        if (!parse_string(&offset, &length, &decoded)) {
+            return INVALID_INDEX;
+        }
+        m_nodes[index].type = kString;
+        m_nodes[index].value_offset = offset;
+        m_nodes[index].value_length = length;
+        m_nodes[index].value_decoded = decoded;
+    } break;
+    case 't':
+        if (!parse_literal("true")) {
+            return INVALID_INDEX;
+        }
+        m_nodes[index].type = kTrue;
+        break;
+    case 'f':
+        if (!parse_literal("false")) {
+            return INVALID_INDEX;
+        }
+        m_nodes[index].type = kFalse;
+        break;
+    case 'n':
+        if (!parse_literal("null")) {
+            return INVALID_INDEX;
+        }
+        m_nodes[index].type = kNull;
+        break;
+    default: {
+        double number = 0.0;
+        if (!parse_number(&number)) {
+            return INVALID_INDEX;
+        }
+        m_nodes[index].type = kNumber;
+        m_nodes[index].number = number;
+    } break;
+    }
+    return index;
+}
+
+///////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////
+
+JSONReaderItem JSONReaderItem::firstChild() const
+{
+    auto node = get_node();
+    if (!node) {
+        return JSONReaderItem{};
+    }
+    return JSONReaderItem{ m_reader, node->first_child };
+}
+
+JSONReaderItem JSONReaderItem::nextSibling() const
+{
+    auto node = get_node();
+    if (!node) {
+        return JSONReaderItem{};
+    }
+    return JSONReaderItem{ m_reader, node->next };
+}
+
+JSONReaderItem JSONReaderItem::namedObject(std::string_view name) const
+{
+    if (!isObject()) {
+        return JSONReaderItem{};
+    }
+
+    for (auto child = firstChild(); child.isOk(); child = child.nextSibling()) {
+        if (m_reader->GetKey(*child.get_node()) == name) {
+            return child;
+        }
+    }
+    return JSONReaderItem{};
+}
+
+bool JSONReaderItem::hasNamedObject(std::string_view name) const { return namedObject(name).isOk(); }
+
+JSONReaderItem JSONReaderItem::arrayItem(int pos) const
+{
+    if (!isArray() || pos < 0) {
+        return JSONReaderItem{};
+    }
+
+    auto child = firstChild();
+    for (int i = 0; i < pos && child.isOk(); ++i) {
+        child = child.nextSibling();
+    }
+    return child;
+}
+
+int JSONReaderItem::arraySize() const
+{
+    if (!isArray()) {
+        return 0;
+    }
+    return get_node()->children_count;
+}
+
+std::vector<JSONReaderItem> JSONReaderItem::GetAsVector() const
+{
+    if (!isArray()) {
+        return {};
+    }
+
+    std::vector<JSONReaderItem> res;
+    res.reserve(arraySize());
+    for (auto child = firstChild(); child.isOk(); child = child.nextSibling()) {
+        res.push_back(child);
+    }
+    return res;
+}
+
+wxString JSONReaderItem::GetPropertyName() const
+{
+    auto key = GetPropertyNameView();
+    if (key.empty()) {
+        return wxEmptyString;
+    }
+    return wxString::FromUTF8(key.data(), key.length());
+}
+
+std::string_view JSONReaderItem::GetPropertyNameView() const
+{
+    auto node = get_node();
+    if (!node) {
+        return {};
+    }
+    return m_reader->GetKey(*node);
+}
+
+bool JSONReaderItem::toBool(bool defaultValue) const
+{
+    if (!isBool()) {
+        return defaultValue;
+    }
+    return get_node()->type == JSONReader::kTrue;
+}
+
+wxString JSONReaderItem::toString(const wxString& defaultValue) const
+{
+    if (!isString()) {
+        return defaultValue;
+    }
+    auto str = m_reader->GetString(*get_node());
+    return wxString::FromUTF8(str.data(), str.length());
+}
+
+std::string_view JSONReaderItem::toStringView() const
+{
+    if (!isString()) {
+        return {};
+    }
+    return m_reader->GetString(*get_node());
+}
+
+wxArrayString JSONReaderItem::toArrayString(const wxArrayString& defaultValue) const
+{
+    if (arraySize() == 0) {
+        return defaultValue;
+    }
+
+    wxArrayString arr;
+    arr.reserve(arraySize());
+    for (auto child = firstChild(); child.isOk(); child = child.nextSibling()) {
+        arr.push_back(child.toString());
+    }
+    return arr;
+}
+
+std::vector<double> JSONReaderItem::toDoubleArray(const std::vector<double>& defaultValue) const
+{
+    if (arraySize() == 0) {
+        return defaultValue;
+    }
+
+    std::vector<double> arr;
+    arr.reserve(arraySize());
+    for (auto child = firstChild(); child.isOk(); child = child.nextSibling()) {
+        arr.push_back(child.toDouble(0.0));
+    }
+    return arr;
+}
+
+std::vector<int> JSONReaderItem::toIntArray(const std::vector<int>& defaultValue) const
+{
+    if (arraySize() == 0) {
+        return defaultValue;
+    }
+
+    std::vector<int> arr;
+    arr.reserve(arraySize());
+    for (auto child = firstChild(); child.isOk(); child = child.nextSibling()) {
+        arr.push_back(child.toInt(0));
+    }
+    return arr;
+}
+
+int JSONReaderItem::toInt(int defaultVal) const
+{
+    if (!isNumber()) {
+        return defaultVal;
+    }
+
+    // saturate, like cJSON does
+    double number = get_node()->number;
+    if (number >= INT_MAX) {
+        return INT_MAX;
+    } else if (number <= (double)INT_MIN) {
+        return INT_MIN;
+    }
+    return static_cast<int>(number);
+}
+
+size_t JSONReaderItem::toSize_t(size_t defaultVal) const
+{
+    if (!isNumber()) {
+        return defaultVal;
+    }
+    return (size_t)toInt();
+}
+
+double JSONReaderItem::toDouble(double defaultVal) const
+{
+    if (!isNumber()) {
+        return defaultVal;
+    }
+    return get_node()->number;
+}
+
+bool JSONReaderItem::isNull() const
+{
+    auto node = get_node();
+    return node && node->type == JSONReader::kNull;
+}
+
+bool JSONReaderItem::isBool() const
+{
+    auto node = get_node();
+    return node && (node->type == JSONReader::kTrue || node->type == JSONReader::kFalse);
+}
+
+bool JSONReaderItem::isString() const
+{
+    auto node = get_node();
+    return node && node->type == JSONReader::kString;
+}
+
+bool JSONReaderItem::isNumber() const
+{
+    auto node = get_node();
+    return node && node->type == JSONReader::kNumber;
+}
+
+bool JSONReaderItem::isArray() const
+{
+    auto node = get_node();
+    return node && node->type == JSONReader::kArray;
+}
+
+bool JSONReaderItem::isObject() const
+{
+    auto node = get_node();
+    return node && node->type == JSONReader::kObject;
+}
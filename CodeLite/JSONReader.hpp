@@ -0,0 +1,186 @@
+#ifndef JSONREADER_HPP
+#define JSONREADER_HPP
+
+#include "codelite_exports.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include <wx/arrstr.h>
+#include <wx/string.h>
+
+class JSONReaderItem;
+
+/**
+ * @class JSONReader
+ * @brief a read only JSON parser for large documents (e.g. LSP messages).
+ * Unlike `JSON`, which allocates a cJSON node (and a copy of every string) per value, the parsed values are stored in a
+ * single vector and strings are kept as UTF-8 views into the input text. Only strings containing escape sequences are
+ * decoded (into a single buffer). Values are converted into wxString only when requested
+ */
+class WXDLLIMPEXP_CL JSONReader
+{
+public:
+    enum eType : uint8_t {
+        kInvalid,
+        kNull,
+        kFalse,
+        kTrue,
+        kNumber,
+        kString,
+        kArray,
+        kObject,
+    };
+
+    struct Node {
+        eType type = kInvalid;
+        // the strings were decoded into m_strings (they contain escape sequences)
+        bool key_decoded = false;
+        bool value_decoded = false;
+        uint32_t key_offset = 0;
+        uint32_t key_length = 0;
+        uint32_t value_offset = 0;
+        uint32_t value_length = 0;
+        uint32_t first_child = UINT32_MAX;
+        uint32_t next = UINT32_MAX;
+        uint32_t children_count = 0;
+        double number = 0.0;
+    };
+
+private:
+    std::string m_text;
+    std::string m_strings;
+    std::vector<Node> m_nodes;
+    size_t m_pos = 0;
+    bool m_ok = false;
+
+private:
+    void skip_whitespace();
+    uint32_t parse_value(size_t depth);
+    bool parse_string(uint32_t* offset, uint32_t* length, bool* decoded);
+    bool parse_number(double* number);
+    bool parse_literal(std::string_view literal);
+
+public:
+    JSONReader() = default;
+    explicit JSONReader(std::string_view text);
+    ~JSONReader() = default;
+
+    JSONReader(const JSONReader&) = delete;
+    JSONReader& operator=(const JSONReader&) = delete;
+
+    /**
+     * @brief parse `text`, replacing any previously parsed document
+     */
+    bool Parse(std::string_view text);
+    bool isOk() const { return m_ok; }
+
+    JSONReaderItem toElement() const;
+
+    /**
+     * @brief the text that was parsed
+     */
+    const std::string& GetText() const { return m_text; }
+
+    const Node& GetNode(uint32_t index) const { return m_nodes[index]; }
+    std::string_view GetKey(const Node& node) const;
+    std::string_view GetString(const Node& node) const;
+};
+
+/**
+ * @class JSONReaderItem
+ * @brief a read only handle to a value parsed by JSONReader. The handle is valid as long as the reader is alive.
+ * Provides the same read API as JSONItem
+ */
+class WXDLLIMPEXP_CL JSONReaderItem
+{
+    const JSONReader* m_reader = nullptr;
+    uint32_t m_index = UINT32_MAX;
+
+private:
+    const JSONReader::Node* get_node() const { return isOk() ? &m_reader->GetNode(m_index) : nullptr; }
+
+public:
+    JSONReaderItem(const JSONReader* reader, uint32_t index)
+        : m_reader(reader)
+        , m_index(index)
+    {
+    }
+    JSONReaderItem() = default;
+    ~JSONReaderItem() = default;
+
+    bool isOk() const { return m_reader != nullptr && m_index != UINT32_MAX; }
+
+    // Walkers
+    ////////////////////////////////////////////////
+    /// the first element of this array / object
+    JSONReaderItem firstChild() const;
+    /// the element that follows this one in its parent array / object
+    JSONReaderItem nextSibling() const;
+
+    // Readers
+    ////////////////////////////////////////////////
+    JSONReaderItem namedObject(std::string_view name) const;
+    bool hasNamedObject(std::string_view name) const;
+
+    /// accessing an array item by index is `O(index)`, use `GetAsVector` or the walkers for big arrays
+    JSONReaderItem operator[](int index) const { return arrayItem(index); }
+    JSONReaderItem operator[](std::string_view name) const { return namedObject(name); }
+    JSONReaderItem arrayItem(int pos) const;
+    int arraySize() const;
+    std::vector<JSONReaderItem> GetAsVector() const;
+    wxString GetPropertyName() const;
+    /// the property name as UTF-8, without converting it into wxString
+    std::string_view GetPropertyNameView() const;
+
+    bool toBool(bool defaultValue = false) const;
+    wxString toString(const wxString& defaultValue = wxEmptyString) const;
+    /// return the string value as UTF-8, without converting it into wxString
+    std::string_view toStringView() const;
+    wxArrayString toArrayString(const wxArrayString& defaultValue = wxArrayString()) const;
+    std::vector<double> toDoubleArray(const std::vector<double>& defaultValue = {}) const;
+    std::vector<int> toIntArray(const std::vector<int>& defaultValue = {}) const;
+    int toInt(int defaultVal = -1) const;
+    size_t toSize_t(size_t defaultVal = 0) const;
+    double toDouble(double defaultVal = -1.0) const;
+
+    template <typename T>
+    T fromNumber(T default_value) const
+    {
+        return static_cast<T>(toInt((int)default_value));
+    }
+
+    template <typename T>
+    inline T GetValue() const
+    {
+        if constexpr (std::is_same_v<T, bool>) {
+            return toBool();
+        } else if constexpr (std::is_same_v<T, int>) {
+            return toInt();
+        } else if constexpr (std::is_same_v<T, size_t>) {
+            return toSize_t();
+        } else if constexpr (std::is_same_v<T, double>) {
+            return toDouble();
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            return std::string{ toStringView() };
+        } else if constexpr (std::is_same_v<T, wxString>) {
+            return toString();
+        } else if constexpr (std::is_same_v<T, wxArrayString>) {
+            return toArrayString();
+        } else {
+            static_assert(!std::is_same_v<T, T>, "GetValue called with unsupported type.");
+        }
+    }
+
+    // Return the object type
+    bool isNull() const;
+    bool isBool() const;
+    bool isString() const;
+    bool isNumber() const;
+    bool isArray() const;
+    bool isObject() const;
+};
+
+#endif // JSONREADER_HPP
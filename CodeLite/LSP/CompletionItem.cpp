@@ -3,7 +3,8 @@
 
 JSONItem LSP::CompletionItem::ToJSON(const wxString& name) const { return JSONItem(NULL); }
 
-void LSP::CompletionItem::FromJSON(const JSONItem& json)
+template <typename JSON_ITEM>
+void LSP::CompletionItem::DoFromJSON(const JSON_ITEM& json)
 {
     m_label = json.namedObject("label").toString();
     m_kind = json.namedObject("kind").toInt(m_kind);
@@ -27,7 +28,7 @@ void LSP::CompletionItem::FromJSON(const JSONItem& json)
     m_insertTextFormat = json.namedObject("insertTextFormat").toString();
     m_vAdditionalText.clear();
     if(json.hasNamedObject("additionalTextEdits")) {
-        JSONItem additionalTextEdits = json.namedObject("additionalTextEdits");
+        auto additionalTextEdits = json.namedObject("additionalTextEdits");
         int count = additionalTextEdits.arraySize();
         for(int i = 0; i < count; ++i) {
             wxSharedPtr<TextEdit> edit(new TextEdit());
@@ -45,3 +46,7 @@ void LSP::CompletionItem::FromJSON(const JSONItem& json)
         m_textEdit->FromJSON(json.namedObject("textEdit"));
     }
 }
+
+void LSP::CompletionItem::FromJSON(const JSONItem& json) { DoFromJSON(json); }
+
+void LSP::CompletionItem::FromJSON(const JSONReaderItem& json) { DoFromJSON(json); }
@@ -20,6 +20,10 @@ class WXDLLIMPEXP_CL CompletionItem : public Serializable
     wxSharedPtr<LSP::TextEdit> m_textEdit;
     std::vector<wxSharedPtr<TextEdit>> m_vAdditionalText;
 
+private:
+    template <typename JSON_ITEM>
+    void DoFromJSON(const JSON_ITEM& json);
+
 public:
     enum eTriggerKind {
         kTriggerUnknown = -1,
@@ -66,6 +70,7 @@ public:
     virtual ~CompletionItem() = default;
     virtual JSONItem ToJSON(const wxString& name) const;
     virtual void FromJSON(const JSONItem& json);
+    void FromJSON(const JSONReaderItem& json);
     void SetDetail(const wxString& detail) { this->m_detail = detail; }
     void SetDocumentation(const MarkupContent& documentation) { this->m_documentation = documentation; }
     void SetFilterText(const wxString& filterText) { this->m_filterText = filterText; }
@@ -16,21 +16,21 @@ LSP::CompletionRequest::CompletionRequest(const LSP::TextDocumentIdentifier& tex
 
 void LSP::CompletionRequest::OnResponse(const LSP::ResponseMessage& response, wxEvtHandler* owner)
 {
-    JSONItem result = response.Get("result");
+    JSONReaderItem result = response.Read("result");
     if(!result.isOk()) {
         LSP_WARNING() << "LSP::CompletionRequest::OnResponse(): invalid 'result' object";
         return;
     }
 
     // We now accept the 'items' array
-    JSONItem items = result.namedObject("items");
+    JSONReaderItem items = result.namedObject("items");
     if(!items.isOk()) {
         LSP_WARNING() << "LSP::CompletionRequest::OnResponse(): invalid 'items' object";
         // LSP_WARNING() << result.format() << clEndl;
         // return;
     }
 
-    JSONItem* pItems = items.isOk() ? &items : &result;
+    JSONReaderItem* pItems = items.isOk() ? &items : &result;
     if(!pItems->isArray()) {
         LSP_WARNING() << "LSP::CompletionRequest::OnResponse(): items is not of type array";
         return;
@@ -39,9 +39,10 @@ void LSP::CompletionRequest::OnResponse(const LSP::ResponseMessage& response, wx
     CompletionItem::Vec_t completions;
     const int itemsCount = pItems->arraySize();
     LSP_DEBUG() << "Read" << itemsCount << "completion items";
-    for(int i = 0; i < itemsCount; ++i) {
+    completions.reserve(itemsCount);
+    for(auto item = pItems->firstChild(); item.isOk(); item = item.nextSibling()) {
         CompletionItem::Ptr_t completionItem(new CompletionItem());
-        completionItem->FromJSON(pItems->arrayItem(i));
+        completionItem->FromJSON(item);
         if(completionItem->GetInsertText().IsEmpty()) {
             completionItem->SetInsertText(completionItem->GetLabel());
         }
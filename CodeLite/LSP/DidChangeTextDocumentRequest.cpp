@@ -3,6 +3,12 @@
 static int counter = 0;
 
 LSP::DidChangeTextDocumentRequest::DidChangeTextDocumentRequest(const wxString& filename, const wxString& fileContent)
+    : DidChangeTextDocumentRequest(filename, std::vector<TextDocumentContentChangeEvent>{ fileContent })
+{
+}
+
+LSP::DidChangeTextDocumentRequest::DidChangeTextDocumentRequest(
+    const wxString& filename, const std::vector<TextDocumentContentChangeEvent>& changes)
 {
     SetMethod("textDocument/didChange");
     m_params.reset(new DidChangeTextDocumentParams());
@@ -11,8 +17,5 @@ LSP::DidChangeTextDocumentRequest::DidChangeTextDocumentRequest(const wxString&
     id.SetVersion(++counter);
     id.SetFilename(filename);
     m_params->As<DidChangeTextDocumentParams>()->SetTextDocument(id);
-
-    TextDocumentContentChangeEvent changeEvent;
-    changeEvent.SetText(fileContent);
-    m_params->As<DidChangeTextDocumentParams>()->SetContentChanges({ changeEvent });
+    m_params->As<DidChangeTextDocumentParams>()->SetContentChanges(changes);
 }
@@ -1,6 +1,7 @@
 #ifndef DIDCHANGE_TEXTDOCUMENTREQUEST_H
 #define DIDCHANGE_TEXTDOCUMENTREQUEST_H
 
+#include <vector>
 #include <wx/filename.h>
 #include "LSP/Notification.h"
 
@@ -11,6 +12,8 @@ class WXDLLIMPEXP_CL DidChangeTextDocumentRequest : public LSP::Notification
 {
 public:
     explicit DidChangeTextDocumentRequest(const wxString& filename, const wxString& fileContent);
+    /// incremental change: send only the modified ranges
+    DidChangeTextDocumentRequest(const wxString& filename, const std::vector<TextDocumentContentChangeEvent>& changes);
     virtual ~DidChangeTextDocumentRequest() = default;
 };
 
@@ -28,12 +28,6 @@ public:
      */
     virtual std::string ToString() const = 0;
 
-    /**
-     * @brief return the **first** JSON payload from the network buffer
-     * @param network_buffer - network buffer (may contain multiple messages)
-     */
-    static std::unique_ptr<JSON> GetJSONPayload(std::string& network_buffer);
-
     template <typename T> T* As() const { return dynamic_cast<T*>(const_cast<Message*>(this)); }
 };
 
@@ -0,0 +1,154 @@
+#include "MessageFramer.hpp"
+
+#include "LSP/basic_types.h"
+
+#include <charconv>
+
+namespace
+{
+constexpr std::string_view HEADERS_END = "\r\n\r\n";
+constexpr std::string_view HEADER_CONTENT_LENGTH = "content-length";
+
+// don't bother moving less than this many bytes
+constexpr size_t MIN_COMPACT_SIZE = 64 * 1024;
+
+std::string_view trim(std::string_view str)
+{
+    while (!str.empty() && (str.front() == ' ' || str.front() == '\t' || str.front() == '\r' || str.front() == '\n')) {
+        str.remove_prefix(1);
+    }
+    while (!str.empty() && (str.back() == ' ' || str.back() == '\t' || str.back() == '\r' || str.back() == '\n')) {
+        str.remove_suffix(1);
+    }
+    return str;
+}
+
+bool iequals(std::string_view a, std::string_view b)
+{
+    if (a.length() != b.length()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.length(); ++i) {
+        char ch = a[i];
+        if (ch >= 'A' && ch <= 'Z') {
+            ch += 'a' - 'A';
+        }
+        if (ch != b[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+void LSP::MessageFramer::Append(const char* data, size_t length)
+{
+    compact();
+    m_buffer.append(data, length);
+}
+
+void LSP::MessageFramer::Clear()
+{
+    m_buffer.clear();
+    m_offset = 0;
+    m_has_header = false;
+    m_payload_offset = 0;
+    m_content_length = 0;
+}
+
+void LSP::MessageFramer::compact()
+{
+    if (m_offset == 0) {
+        return;
+    }
+
+    if (m_offset == m_buffer.length()) {
+        // everything was consumed, this is the common case
+        m_buffer.clear();
+    } else if (m_offset >= MIN_COMPACT_SIZE && m_offset * 2 >= m_buffer.length()) {
+        m_buffer.erase(0, m_offset);
+    } else {
+        return;
+    }
+
+    if (m_has_header) {
+        m_payload_offset -= m_offset;
+    }
+    m_offset = 0;
+}
+
+bool LSP::MessageFramer::parse_header()
+{
+    while (!m_has_header) {
+        std::string_view pending = GetPendingData();
+        size_t headers_end = pending.find(HEADERS_END);
+        if (headers_end == std::string_view::npos) {
+            return false;
+        }
+
+        // the headers are "Name: Value" lines, we only care about Content-Length
+        std::string_view headers = pending.substr(0, headers_end);
+        bool found = false;
+        size_t content_length = 0;
+        while (!headers.empty()) {
+            size_t eol = headers.find('\n');
+            std::string_view line = headers.substr(0, eol);
+            headers.remove_prefix(eol == std::string_view::npos ? headers.length() : eol + 1);
+
+            size_t colon = line.find(':');
+            if (colon == std::string_view::npos || !iequals(trim(line.substr(0, colon)), HEADER_CONTENT_LENGTH)) {
+                continue;
+            }
+            std::string_view value = trim(line.substr(colon + 1));
+            auto res = std::from_chars(value.data(), value.data() + value.length(), content_length);
+            found = (res.ec == std::errc() && res.ptr == value.data() + value.length());
+            break;
+        }
+
+        if (!found) {
+            // skip the broken headers, otherwise we will never recover
+            LSP_WARNING() << "LSP message header does not contain a valid Content-Length header!" << endl;
+            LSP_WARNING() << wxString::FromUTF8(pending.data(), headers_end) << endl;
+            m_offset += headers_end + HEADERS_END.length();
+            continue;
+        }
+
+        m_has_header = true;
+        m_payload_offset = m_offset + headers_end + HEADERS_END.length();
+        m_content_length = content_length;
+    }
+    return true;
+}
+
+bool LSP::MessageFramer::Next(std::string_view* payload)
+{
+    compact();
+    if (!parse_header()) {
+        return false;
+    }
+
+    if (m_buffer.length() - m_payload_offset < m_content_length) {
+        // incomplete payload, wait for more data
+        return false;
+    }
+
+    *payload = std::string_view{ m_buffer.data() + m_payload_offset, m_content_length };
+    m_offset = m_payload_offset + m_content_length;
+    m_has_header = false;
+    return true;
+}
+
+std::unique_ptr<JSON> LSP::MessageFramer::NextJSON()
+{
+    std::string_view payload;
+    if (!Next(&payload)) {
+        return nullptr;
+    }
+
+    std::unique_ptr<JSON> json(new JSON(cJSON_ParseWithLength(payload.data(), payload.length())));
+    if (!json->isOk()) {
+        LSP_ERROR() << "Unable to parse JSON object from response!" << endl;
+        LOG_IF_TRACE { LSP_TRACE() << "Payload:" << wxString::FromUTF8(payload.data(), payload.length()) << endl; }
+    }
+    return json;
+}
@@ -0,0 +1,71 @@
+#ifndef LSP_MESSAGEFRAMER_HPP
+#define LSP_MESSAGEFRAMER_HPP
+
+#include "JSON.h"
+#include "codelite_exports.h"
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace LSP
+{
+/**
+ * @class MessageFramer
+ * @brief split a stream of bytes into JSON-RPC messages ("Content-Length: <N>\r\n\r\n<payload>").
+ * Incoming data is appended to an internal buffer and the messages are parsed in place: the headers are parsed once
+ * per message, the payload is not copied and the consumed data is discarded lazily, only when it makes up most of the
+ * buffer
+ */
+class WXDLLIMPEXP_CL MessageFramer
+{
+    std::string m_buffer;
+    // start of the data that was not consumed yet
+    size_t m_offset = 0;
+    // the headers of the current message were parsed, but its payload is incomplete
+    bool m_has_header = false;
+    size_t m_payload_offset = 0;
+    size_t m_content_length = 0;
+
+private:
+    void compact();
+    bool parse_header();
+
+public:
+    MessageFramer() = default;
+    ~MessageFramer() = default;
+
+    /**
+     * @brief append data received from the network
+     */
+    void Append(const char* data, size_t length);
+    void Append(std::string_view data) { Append(data.data(), data.length()); }
+
+    /**
+     * @brief extract the next complete message payload
+     * @param payload [output] points into the internal buffer, it remains valid until the next call to `Append` or
+     * `Next`
+     * @return false if no complete message is available
+     */
+    bool Next(std::string_view* payload);
+
+    /**
+     * @brief extract and parse the next complete message
+     * @return nullptr if no complete message is available
+     */
+    std::unique_ptr<JSON> NextJSON();
+
+    /**
+     * @brief return the data that was received but not consumed yet
+     */
+    std::string_view GetPendingData() const
+    {
+        return std::string_view{ m_buffer.data() + m_offset, m_buffer.length() - m_offset };
+    }
+
+    bool IsEmpty() const { return m_offset == m_buffer.length(); }
+    void Clear();
+};
+} // namespace LSP
+
+#endif // LSP_MESSAGEFRAMER_HPP
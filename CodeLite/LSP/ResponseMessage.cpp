@@ -1,20 +1,34 @@
 #include "ResponseMessage.h"
-#include "StringUtils.h"
 #include <wx/tokenzr.h>
 
-LSP::ResponseMessage::ResponseMessage(std::unique_ptr<JSON>&& json)
+LSP::ResponseMessage::ResponseMessage(std::unique_ptr<JSONReader>&& reader)
 {
     // a valid JSON-RPC response
-    m_json = std::move(json);
-    FromJSON(m_json->toElement());
+    m_reader = std::move(reader);
+    m_id = Read("id").toInt();
 }
 
 std::string LSP::ResponseMessage::ToString() const
 {
-    if(!m_json || !m_json->isOk()) {
+    if(!IsOk()) {
         return "";
     }
-    return StringUtils::ToStdString(m_json->toElement().format(false));
+    return m_reader->GetText();
+}
+
+JSON* LSP::ResponseMessage::get_json() const
+{
+    if(!m_json && IsOk()) {
+        const std::string& text = m_reader->GetText();
+        m_json.reset(new JSON(cJSON_ParseWithLength(text.c_str(), text.length())));
+    }
+    return m_json.get();
+}
+
+std::unique_ptr<JSON> LSP::ResponseMessage::take()
+{
+    get_json();
+    return std::move(m_json);
 }
 
 // we don't really serialise response messages
@@ -28,7 +42,7 @@ void LSP::ResponseMessage::FromJSON(const JSONItem& json)
 
 bool LSP::ResponseMessage::Has(const wxString& property) const
 {
-    return m_json && m_json->toElement().hasNamedObject(property);
+    return IsOk() && m_reader->toElement().hasNamedObject(property.ToStdString(wxConvUTF8));
 }
 
 JSONItem LSP::ResponseMessage::Get(const wxString& property) const
@@ -36,7 +50,15 @@ JSONItem LSP::ResponseMessage::Get(const wxString& property) const
     if(!Has(property)) {
         return JSONItem(nullptr);
     }
-    return m_json->toElement().namedObject(property);
+    return get_json()->toElement().namedObject(property);
+}
+
+JSONReaderItem LSP::ResponseMessage::Read(std::string_view property) const
+{
+    if(!IsOk()) {
+        return JSONReaderItem{};
+    }
+    return m_reader->toElement().namedObject(property);
 }
 
 std::vector<LSP::Diagnostic> LSP::ResponseMessage::GetDiagnostics() const
@@ -59,7 +81,7 @@ std::vector<LSP::Diagnostic> LSP::ResponseMessage::GetDiagnostics() const
 
 wxString LSP::ResponseMessage::GetDiagnosticsUri() const
 {
-    JSONItem params = Get("params");
+    JSONReaderItem params = Read("params");
     if(!params.isOk()) {
         return "";
     }
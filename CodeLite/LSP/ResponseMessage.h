@@ -2,6 +2,7 @@
 #define RESPONSEMESSAGE_H
 
 #include "JSON.h"
+#include "JSONReader.hpp"
 #include "LSP/Message.h"
 #include "LSP/basic_types.h"
 #include "macros.h"
@@ -14,10 +15,15 @@ namespace LSP
 class WXDLLIMPEXP_CL ResponseMessage : public LSP::Message
 {
     int m_id = wxNOT_FOUND;
-    std::unique_ptr<JSON> m_json;
+    std::unique_ptr<JSONReader> m_reader;
+    // a cJSON representation of the message, built on demand by `Get()`
+    mutable std::unique_ptr<JSON> m_json;
+
+private:
+    JSON* get_json() const;
 
 public:
-    ResponseMessage(std::unique_ptr<JSON>&& json);
+    ResponseMessage(std::unique_ptr<JSONReader>&& reader);
     ~ResponseMessage() override = default;
     JSONItem ToJSON(const wxString& name) const override;
     void FromJSON(const JSONItem& json) override;
@@ -29,19 +35,24 @@ public:
         return *this;
     }
     int GetId() const { return m_id; }
-    bool IsOk() const { return m_json && m_json->isOk(); }
-    std::unique_ptr<JSON> take() { return std::move(m_json); }
+    bool IsOk() const { return m_reader && m_reader->isOk(); }
+    std::unique_ptr<JSON> take();
 
     bool IsErrorResponse() const;
     bool Has(const wxString& property) const;
     JSONItem Get(const wxString& property) const;
 
+    /**
+     * @brief read a property without building a cJSON tree for the message. Use this for large responses
+     */
+    JSONReaderItem Read(std::string_view property) const;
+
     JSONItem operator[](const wxString& name) const { return Get(name); }
 
     /**
      * @brief is this a "textDocument/publishDiagnostics" message?
      */
-    bool IsPushDiagnostics() const { return Get("method").toString() == "textDocument/publishDiagnostics"; }
+    bool IsPushDiagnostics() const { return Read("method").toStringView() == "textDocument/publishDiagnostics"; }
 
     /**
      * @brief return list of diagnostics
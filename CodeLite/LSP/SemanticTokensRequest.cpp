@@ -23,7 +23,7 @@ void LSP::SemanticTokensRequest::OnResponse(const LSP::ResponseMessage& response
     }
 
     std::vector<int> encoded_types;
-    encoded_types = response["result"]["data"].toIntArray();
+    encoded_types = response.Read("result")["data"].toIntArray();
 
     // since this is CPU heavy processing, spawn a thread to do the job
     wxString filename = m_filename;
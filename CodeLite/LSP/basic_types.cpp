@@ -76,6 +76,12 @@ void Position::FromJSON(const JSONItem& json)
     m_character = json.namedObject("character").toInt(wxNOT_FOUND);
 }
 
+void Position::FromJSON(const JSONReaderItem& json)
+{
+    m_line = json.namedObject("line").toInt(wxNOT_FOUND);
+    m_character = json.namedObject("character").toInt(wxNOT_FOUND);
+}
+
 JSONItem Position::ToJSON(const wxString& name) const
 {
     JSONItem json = JSONItem::createObject(name);
@@ -132,6 +138,12 @@ void Range::FromJSON(const JSONItem& json)
     m_end.FromJSON(json["end"]);
 }
 
+void Range::FromJSON(const JSONReaderItem& json)
+{
+    m_start.FromJSON(json["start"]);
+    m_end.FromJSON(json["end"]);
+}
+
 JSONItem Range::ToJSON(const wxString& name) const
 {
     JSONItem json = JSONItem::createObject(name);
@@ -164,6 +176,12 @@ void TextEdit::FromJSON(const JSONItem& json)
     m_newText = json.namedObject("newText").toString();
 }
 
+void TextEdit::FromJSON(const JSONReaderItem& json)
+{
+    m_range.FromJSON(json.namedObject("range"));
+    m_newText = json.namedObject("newText").toString();
+}
+
 JSONItem TextEdit::ToJSON(const wxString& name) const
 {
     JSONItem json = JSONItem::createObject(name);
@@ -255,6 +273,12 @@ void MarkupContent::FromJSON(const JSONItem& json)
     m_value = json.namedObject("value").toString();
 }
 
+void MarkupContent::FromJSON(const JSONReaderItem& json)
+{
+    m_kind = json.namedObject("kind").toString();
+    m_value = json.namedObject("value").toString();
+}
+
 JSONItem MarkupContent::ToJSON(const wxString& name) const
 {
     JSONItem json = JSONItem::createObject(name);
@@ -4,6 +4,7 @@
 #include "IPathConverter.hpp"
 #include "JSON.h"
 #include "JSONObject.h"
+#include "JSONReader.hpp"
 #include "clModuleLogger.hpp"
 #include "codelite_exports.h"
 #include "fileutils.h"
@@ -80,6 +81,7 @@ class WXDLLIMPEXP_CL Position : public Serializable
 
 public:
     virtual void FromJSON(const JSONItem& json);
+    void FromJSON(const JSONReaderItem& json);
     virtual JSONItem ToJSON(const wxString& name) const;
 
     Position(int line, int col)
@@ -130,6 +132,7 @@ class WXDLLIMPEXP_CL Range : public Serializable
 
 public:
     virtual void FromJSON(const JSONItem& json);
+    void FromJSON(const JSONReaderItem& json);
     virtual JSONItem ToJSON(const wxString& name) const;
 
     Range(const Position& start, const Position& end)
@@ -240,6 +243,7 @@ public:
     TextEdit() = default;
     virtual ~TextEdit() = default;
     virtual void FromJSON(const JSONItem& json);
+    void FromJSON(const JSONReaderItem& json);
     virtual JSONItem ToJSON(const wxString& name) const;
     void SetNewText(const wxString& newText) { this->m_newText = newText; }
     void SetRange(const Range& range) { this->m_range = range; }
@@ -452,6 +456,7 @@ public:
     }
     const wxString& GetValue() const { return m_value; }
     virtual void FromJSON(const JSONItem& json);
+    void FromJSON(const JSONReaderItem& json);
     virtual JSONItem ToJSON(const wxString& name) const;
 };
 
@@ -0,0 +1,186 @@
+#include "clChunkedLineStore.hpp"
+
+#include "file_logger.h"
+
+#include <algorithm>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+#include <wx/mstream.h>
+#include <wx/zstream.h>
+
+clChunkedLineStore::clChunkedLineStore(size_t max_memory_chunks, bool compress)
+    : m_max_memory_chunks(max_memory_chunks)
+    , m_compress(compress)
+{
+}
+
+clChunkedLineStore::~clChunkedLineStore() { Clear(); }
+
+void clChunkedLineStore::AppendLine(const wxString& line)
+{
+    if (m_chunks.empty() || m_chunks.back().lines == LINES_PER_CHUNK) {
+        m_chunks.emplace_back();
+    }
+
+    auto& chunk = m_chunks.back();
+    const wxScopedCharBuffer utf8 = line.utf8_str();
+    chunk.data.append(utf8.data(), utf8.length());
+    chunk.data.push_back('\n');
+    ++chunk.lines;
+    ++m_lines;
+
+    if (chunk.lines == LINES_PER_CHUNK) {
+        spill_chunks();
+    }
+}
+
+void clChunkedLineStore::spill_chunks()
+{
+    // only full chunks are spilled
+    size_t full_chunks = m_chunks.back().lines == LINES_PER_CHUNK ? m_chunks.size() : m_chunks.size() - 1;
+    while (!m_spill_failed && full_chunks - m_first_memory_chunk > m_max_memory_chunks) {
+        if (!spill_chunk(m_chunks[m_first_memory_chunk])) {
+            // keep everything in memory from now on
+            clWARNING() << "Failed to write lines into:" << m_spill_path << endl;
+            m_spill_failed = true;
+            break;
+        }
+        ++m_first_memory_chunk;
+    }
+}
+
+bool clChunkedLineStore::spill_chunk(Chunk& chunk)
+{
+    if (!m_spill_file.IsOpened()) {
+        m_spill_path = wxFileName::CreateTempFileName("cl-lines");
+        if (m_spill_path.empty() || !m_spill_file.Open(m_spill_path, wxFile::read_write)) {
+            return false;
+        }
+        m_spill_size = 0;
+    }
+
+    std::string compressed;
+    if (m_compress) {
+        wxMemoryOutputStream memory;
+        {
+            wxZlibOutputStream zlib(memory, wxZ_BEST_SPEED);
+            zlib.Write(chunk.data.data(), chunk.data.length());
+            if (!zlib.Close()) {
+                return false;
+            }
+        }
+        compressed.resize(memory.GetSize());
+        memory.CopyTo(compressed.data(), compressed.length());
+    }
+
+    const std::string& stored = m_compress ? compressed : chunk.data;
+    if (m_spill_file.Seek(m_spill_size) == wxInvalidOffset ||
+        m_spill_file.Write(stored.data(), stored.length()) != stored.length()) {
+        return false;
+    }
+
+    chunk.offset = m_spill_size;
+    chunk.stored_size = stored.length();
+    chunk.raw_size = chunk.data.length();
+    chunk.spilled = true;
+    m_spill_size += stored.length();
+
+    // release the memory
+    std::string().swap(chunk.data);
+    return true;
+}
+
+const std::string* clChunkedLineStore::get_chunk_data(size_t index) const
+{
+    const auto& chunk = m_chunks[index];
+    if (!chunk.spilled) {
+        return &chunk.data;
+    }
+
+    if (m_cached_chunk == index) {
+        return &m_cached_data;
+    }
+    m_cached_chunk = std::string::npos;
+
+    std::string stored(chunk.stored_size, 0);
+    if (m_spill_file.Seek(chunk.offset) == wxInvalidOffset ||
+        m_spill_file.Read(stored.data(), stored.length()) != (ssize_t)stored.length()) {
+        clWARNING() << "Failed to read lines from:" << m_spill_path << endl;
+        return nullptr;
+    }
+
+    if (m_compress) {
+        wxMemoryInputStream memory(stored.data(), stored.length());
+        wxZlibInputStream zlib(memory);
+        m_cached_data.resize(chunk.raw_size);
+        zlib.Read(m_cached_data.data(), m_cached_data.length());
+        if (zlib.LastRead() != m_cached_data.length()) {
+            clWARNING() << "Failed to uncompress lines from:" << m_spill_path << endl;
+            return nullptr;
+        }
+    } else {
+        m_cached_data.swap(stored);
+    }
+
+    // the lines are looked up by their line feeds
+    if ((size_t)std::count(m_cached_data.begin(), m_cached_data.end(), '\n') != chunk.lines) {
+        clWARNING() << "Corrupted lines in:" << m_spill_path << endl;
+        return nullptr;
+    }
+    m_cached_chunk = index;
+    return &m_cached_data;
+}
+
+wxString clChunkedLineStore::GetLines(size_t from, size_t count) const
+{
+    if (from >= m_lines) {
+        return wxEmptyString;
+    }
+
+    size_t last = from + std::min(count, m_lines - from);
+    std::string utf8;
+    size_t line = from;
+    while (line < last) {
+        size_t index = line / LINES_PER_CHUNK;
+        size_t chunk_first_line = index * LINES_PER_CHUNK;
+        size_t chunk_last_line = std::min(last, chunk_first_line + m_chunks[index].lines);
+
+        const std::string* data = get_chunk_data(index);
+        if (data) {
+            size_t start = 0;
+            for (size_t i = chunk_first_line; i < line; ++i) {
+                start = data->find('\n', start) + 1;
+            }
+            size_t end = start;
+            for (size_t i = line; i < chunk_last_line; ++i) {
+                end = data->find('\n', end) + 1;
+            }
+            utf8.append(*data, start, end - start);
+        } else {
+            // the lines are lost, keep the line numbers of the following lines
+            clWARNING() << "Returning" << (chunk_last_line - line) << "empty lines from line" << line << endl;
+            utf8.append(chunk_last_line - line, '\n');
+        }
+        line = chunk_last_line;
+    }
+    return wxString::FromUTF8(utf8.data(), utf8.length());
+}
+
+void clChunkedLineStore::Clear()
+{
+    m_chunks.clear();
+    m_lines = 0;
+    m_first_memory_chunk = 0;
+    m_cached_chunk = std::string::npos;
+    std::string().swap(m_cached_data);
+
+    if (m_spill_file.IsOpened()) {
+        m_spill_file.Close();
+    }
+    if (!m_spill_path.empty()) {
+        ::wxRemoveFile(m_spill_path);
+        m_spill_path.clear();
+    }
+    m_spill_size = 0;
+    m_spill_failed = false;
+}
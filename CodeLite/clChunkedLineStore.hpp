@@ -0,0 +1,101 @@
+#ifndef CLCHUNKEDLINESTORE_HPP
+#define CLCHUNKEDLINESTORE_HPP
+
+#include "codelite_exports.h"
+
+#include <string>
+#include <vector>
+#include <wx/file.h>
+#include <wx/string.h>
+
+/**
+ * @class clChunkedLineStore
+ * @brief an append only store of text lines with a bounded memory footprint (e.g. a build log).
+ * The lines are kept as UTF-8, in chunks of `LINES_PER_CHUNK` lines. Only the most recent chunks are kept in memory,
+ * older chunks are written (optionally compressed) into a temporary file and read back on demand
+ */
+class WXDLLIMPEXP_CL clChunkedLineStore
+{
+public:
+    static constexpr size_t LINES_PER_CHUNK = 4096;
+
+private:
+    struct Chunk {
+        /// the lines, each one is terminated with "\n". Empty once the chunk is spilled
+        std::string data;
+        size_t lines = 0;
+        bool spilled = false;
+        /// the chunk location in the spill file
+        wxFileOffset offset = 0;
+        size_t stored_size = 0;
+        size_t raw_size = 0;
+    };
+
+    std::vector<Chunk> m_chunks;
+    size_t m_lines = 0;
+    size_t m_max_memory_chunks = 0;
+    bool m_compress = true;
+    /// index of the oldest chunk that is still in memory
+    size_t m_first_memory_chunk = 0;
+
+    wxString m_spill_path;
+    // reading the file is done from const methods
+    mutable wxFile m_spill_file;
+    wxFileOffset m_spill_size = 0;
+    bool m_spill_failed = false;
+
+    /// the last chunk that was read back from the spill file
+    mutable size_t m_cached_chunk = std::string::npos;
+    mutable std::string m_cached_data;
+
+private:
+    void spill_chunks();
+    bool spill_chunk(Chunk& chunk);
+    const std::string* get_chunk_data(size_t index) const;
+
+public:
+    /**
+     * @param max_memory_chunks number of full chunks to keep in memory, older chunks are spilled to the disk
+     * @param compress compress the spilled chunks
+     */
+    explicit clChunkedLineStore(size_t max_memory_chunks = 16, bool compress = true);
+    ~clChunkedLineStore();
+
+    clChunkedLineStore(const clChunkedLineStore&) = delete;
+    clChunkedLineStore& operator=(const clChunkedLineStore&) = delete;
+
+    /**
+     * @brief append a line, `line` should not contain line feeds
+     */
+    void AppendLine(const wxString& line);
+
+    size_t GetLineCount() const { return m_lines; }
+
+    /**
+     * @brief return `count` lines starting from line `from`, each one terminated with "\n". The lines of a chunk that
+     * can't be read back from the disk are returned empty
+     */
+    wxString GetLines(size_t from, size_t count) const;
+
+    /**
+     * @brief return all the lines
+     */
+    wxString GetText() const { return GetLines(0, m_lines); }
+
+    /**
+     * @brief the number of chunks that were moved to the disk
+     */
+    size_t GetSpilledChunksCount() const { return m_first_memory_chunk; }
+
+    /**
+     * @brief the temporary file that holds the spilled chunks, empty if no chunk was spilled
+     */
+    const wxString& GetSpillPath() const { return m_spill_path; }
+
+    /**
+     * @brief remove all the lines and delete the spill file
+     */
+    void Clear();
+};
+
+#endif // CLCHUNKEDLINESTORE_HPP
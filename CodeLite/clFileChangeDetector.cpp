@@ -0,0 +1,264 @@
+#include "clFileChangeDetector.hpp"
+
+#include "fileutils.h"
+#include "wxStringHash.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <thread>
+#include <unordered_map>
+#include <wx/filename.h>
+#include <wx/thread.h>
+
+namespace
+{
+// don't bother spawning threads for less than this number of files
+constexpr size_t MIN_FILES_PER_THREAD = 256;
+
+constexpr uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t rotl64(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+inline uint64_t read64(const unsigned char* p)
+{
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint32_t read32(const unsigned char* p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint64_t xxh64_round(uint64_t acc, uint64_t input)
+{
+    acc += input * PRIME64_2;
+    acc = rotl64(acc, 31);
+    return acc * PRIME64_1;
+}
+
+inline uint64_t xxh64_merge_round(uint64_t acc, uint64_t val)
+{
+    acc ^= xxh64_round(0, val);
+    return acc * PRIME64_1 + PRIME64_4;
+}
+
+bool get_stat(const wxString& filepath, long long* modified, long long* size)
+{
+#ifdef __WXMSW__
+    struct _stat64 buff;
+    if (_wstat64(filepath.wc_str(), &buff) != 0) {
+        return false;
+    }
+    // no sub-second resolution here
+    *modified = (long long)buff.st_mtime * 1000000000LL;
+#else
+    struct stat buff;
+    if (::stat(filepath.mb_str(wxConvUTF8).data(), &buff) != 0) {
+        return false;
+    }
+#ifdef __APPLE__
+    *modified = (long long)buff.st_mtimespec.tv_sec * 1000000000LL + buff.st_mtimespec.tv_nsec;
+#else
+    *modified = (long long)buff.st_mtim.tv_sec * 1000000000LL + buff.st_mtim.tv_nsec;
+#endif
+#endif
+    *size = buff.st_size;
+    return true;
+}
+
+enum class eResult {
+    kStatSkipped,
+    kHashSkipped,
+    kModified,
+};
+} // namespace
+
+uint64_t clFileChangeDetector::Hash(const void* data, size_t length, uint64_t seed)
+{
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    const unsigned char* end = p + length;
+    uint64_t h;
+
+    if (length >= 32) {
+        uint64_t v1 = seed + PRIME64_1 + PRIME64_2;
+        uint64_t v2 = seed + PRIME64_2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - PRIME64_1;
+        const unsigned char* limit = end - 32;
+        do {
+            v1 = xxh64_round(v1, read64(p));
+            v2 = xxh64_round(v2, read64(p + 8));
+            v3 = xxh64_round(v3, read64(p + 16));
+            v4 = xxh64_round(v4, read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+
+        h = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+        h = xxh64_merge_round(h, v1);
+        h = xxh64_merge_round(h, v2);
+        h = xxh64_merge_round(h, v3);
+        h = xxh64_merge_round(h, v4);
+    } else {
+        h = seed + PRIME64_5;
+    }
+
+    h += static_cast<uint64_t>(length);
+    while (p + 8 <= end) {
+        h ^= xxh64_round(0, read64(p));
+        h = rotl64(h, 27) * PRIME64_1 + PRIME64_4;
+        p += 8;
+    }
+    if (p + 4 <= end) {
+        h ^= static_cast<uint64_t>(read32(p)) * PRIME64_1;
+        h = rotl64(h, 23) * PRIME64_2 + PRIME64_3;
+        p += 4;
+    }
+    while (p < end) {
+        h ^= (*p) * PRIME64_5;
+        h = rotl64(h, 11) * PRIME64_1;
+        ++p;
+    }
+
+    h ^= h >> 33;
+    h *= PRIME64_2;
+    h ^= h >> 29;
+    h *= PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+bool clFileChangeDetector::GetFingerprint(const wxString& filepath, FileEntry* entry, bool hash)
+{
+    long long modified = 0;
+    long long size = 0;
+    if (!get_stat(filepath, &modified, &size)) {
+        return false;
+    }
+
+    if (hash) {
+        std::string content;
+        if (!FileUtils::ReadFileContentRaw(wxFileName(filepath), content)) {
+            return false;
+        }
+        entry->SetHash(Hash(content.data(), content.length()));
+    }
+    entry->SetModified(modified);
+    entry->SetSize(size);
+    return true;
+}
+
+void clFileChangeDetector::Check(const wxArrayString& files, const std::vector<FileEntryPtr>& entries, size_t threads)
+{
+    m_modified.clear();
+    m_touched.clear();
+    m_stats = {};
+
+    std::unordered_map<wxString, const FileEntry*> stored;
+    stored.reserve(entries.size());
+    for (const auto& entry : entries) {
+        stored.insert({ entry->GetFile(), entry.get() });
+    }
+
+    std::vector<FileEntryPtr> fingerprints(files.size());
+    std::vector<eResult> results(files.size(), eResult::kModified);
+
+    auto check_file = [&](size_t i) {
+        const wxString& filepath = files[i];
+        auto iter = stored.find(filepath);
+        const FileEntry* entry = iter == stored.end() ? nullptr : iter->second;
+
+        FileEntryPtr fingerprint(new FileEntry());
+        fingerprint->SetFile(filepath);
+        if (!GetFingerprint(filepath, fingerprint.get(), false)) {
+            // can't stat it, a file that we know about is left as is (as we did before fingerprints were stored)
+            results[i] = entry ? eResult::kStatSkipped : eResult::kModified;
+            fingerprints[i] = std::move(fingerprint);
+            return;
+        }
+
+        if (entry && entry->HasFingerprint() && entry->GetModified() == fingerprint->GetModified() &&
+            entry->GetSize() == fingerprint->GetSize()) {
+            results[i] = eResult::kStatSkipped;
+            return;
+        }
+
+        if (!GetFingerprint(filepath, fingerprint.get(), true)) {
+            // unreadable file, let the parser decide what to do with it
+            fingerprint->SetSize(-1);
+            results[i] = eResult::kModified;
+
+        } else if (entry && entry->HasFingerprint() && entry->GetSize() == fingerprint->GetSize() &&
+                   entry->GetHash() == fingerprint->GetHash()) {
+            results[i] = eResult::kHashSkipped;
+            fingerprint->SetLastRetaggedTimestamp(entry->GetLastRetaggedTimestamp());
+
+        } else if (entry && !entry->HasFingerprint() &&
+                   entry->GetLastRetaggedTimestamp() >= fingerprint->GetModified() / 1000000000LL) {
+            // an entry without a fingerprint: fallback to comparing the parse time with the modification time
+            results[i] = eResult::kHashSkipped;
+            fingerprint->SetLastRetaggedTimestamp(entry->GetLastRetaggedTimestamp());
+
+        } else {
+            results[i] = eResult::kModified;
+        }
+        fingerprints[i] = std::move(fingerprint);
+    };
+
+    if (threads == 0) {
+        threads = wxThread::GetCPUCount() > 0 ? wxThread::GetCPUCount() : 1;
+    }
+    threads = std::min(threads, files.size() / MIN_FILES_PER_THREAD + 1);
+
+    if (threads <= 1) {
+        for (size_t i = 0; i < files.size(); ++i) {
+            check_file(i);
+        }
+    } else {
+        std::atomic_size_t next_file{ 0 };
+        auto worker = [&]() {
+            while (true) {
+                size_t i = next_file.fetch_add(1);
+                if (i >= files.size()) {
+                    break;
+                }
+                check_file(i);
+            }
+        };
+
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        for (size_t i = 0; i < threads; ++i) {
+            workers.emplace_back(worker);
+        }
+        for (auto& worker_thread : workers) {
+            worker_thread.join();
+        }
+    }
+
+    for (size_t i = 0; i < files.size(); ++i) {
+        switch (results[i]) {
+        case eResult::kStatSkipped:
+            ++m_stats.stat_skipped;
+            break;
+        case eResult::kHashSkipped:
+            ++m_stats.hash_skipped;
+            m_touched.push_back(std::move(fingerprints[i]));
+            break;
+        case eResult::kModified:
+            ++m_stats.modified;
+            m_modified.push_back(std::move(fingerprints[i]));
+            break;
+        }
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef CLFILECHANGEDETECTOR_HPP
+#define CLFILECHANGEDETECTOR_HPP
+
+#include "codelite_exports.h"
+#include "database/fileentry.h"
+
+#include <cstdint>
+#include <vector>
+#include <wx/arrstr.h>
+#include <wx/string.h>
+
+/**
+ * @class clFileChangeDetector
+ * @brief decide which files need to be re-parsed by comparing them with their stored FileEntry fingerprint
+ * (modification time in nanoseconds, size and a 64 bit hash of the content). The files are checked in parallel. A file
+ * is hashed only when its modification time or size changed, so files that were touched without being modified (e.g.
+ * by switching branches) are not re-parsed
+ */
+class WXDLLIMPEXP_CL clFileChangeDetector
+{
+public:
+    struct Stats {
+        /// modification time and size did not change
+        size_t stat_skipped = 0;
+        /// modification time or size changed, but the content did not
+        size_t hash_skipped = 0;
+        /// new or modified files
+        size_t modified = 0;
+    };
+
+private:
+    std::vector<FileEntryPtr> m_modified;
+    std::vector<FileEntryPtr> m_touched;
+    Stats m_stats;
+
+public:
+    clFileChangeDetector() = default;
+    ~clFileChangeDetector() = default;
+
+    /**
+     * @brief check `files` against the `entries` loaded from the database. Files without an entry are considered as
+     * modified
+     * @param threads number of threads to use, 0 means one per CPU
+     */
+    void Check(const wxArrayString& files, const std::vector<FileEntryPtr>& entries, size_t threads = 0);
+
+    /**
+     * @brief the files that need to be parsed, with their current fingerprint. Store them once they are parsed
+     */
+    std::vector<FileEntryPtr>& GetModified() { return m_modified; }
+
+    /**
+     * @brief files whose content did not change, but their fingerprint did (e.g. a new modification time). Storing
+     * them saves re-hashing these files the next time
+     */
+    std::vector<FileEntryPtr>& GetTouched() { return m_touched; }
+
+    const Stats& GetStats() const { return m_stats; }
+
+    /**
+     * @brief read the modification time and size of `filepath` into `entry`, and if `hash` is true, its content hash
+     */
+    static bool GetFingerprint(const wxString& filepath, FileEntry* entry, bool hash);
+
+    /**
+     * @brief a fast, non cryptographic, 64 bit hash (XXH64)
+     */
+    static uint64_t Hash(const void* data, size_t length, uint64_t seed = 0);
+};
+
+#endif // CLFILECHANGEDETECTOR_HPP
@@ -1,14 +1,35 @@
 #include "clFileSystemWatcher.h"
 #include <algorithm>
 #include <set>
+#include "file_logger.h"
 #include "fileutils.h"
 
+#if CL_FSW_USE_INOTIFY
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
 wxDEFINE_EVENT(wxEVT_FILE_MODIFIED, clFileSystemEvent);
 wxDEFINE_EVENT(wxEVT_FILE_NOT_FOUND, clFileSystemEvent);
 
 // In milliseconds
 #define FILE_CHECK_INTERVAL 500
 
+#if CL_FSW_USE_INOTIFY
+// In milliseconds: inotify events are delivered once no new event arrived for INOTIFY_QUIET_PERIOD, or
+// INOTIFY_MAX_DELAY after the first event of a burst (e.g. `git checkout`)
+#define INOTIFY_QUIET_PERIOD 100
+#define INOTIFY_MAX_DELAY 1000
+
+#define INOTIFY_WATCH_MASK                                                                                   \
+    (IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |          \
+     IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR | IN_EXCL_UNLINK)
+#endif
+
 clFileSystemWatcher::clFileSystemWatcher()
     : m_owner(NULL)
 #if CL_FSW_USE_TIMER
@@ -38,12 +59,13 @@ void clFileSystemWatcher::SetFile(const wxFileName& filename)
 {
 #if CL_FSW_USE_TIMER
     if(filename.Exists()) {
+#if CL_FSW_USE_INOTIFY
+        for(const auto& [_, f] : m_files) {
+            UnwatchDirectory(f);
+        }
+#endif
         m_files.clear();
-        File f;
-        f.filename = filename;
-        f.lastModified = FileUtils::GetFileModificationTime(filename);
-        f.file_size = FileUtils::GetFileSize(filename);
-        m_files.insert(std::make_pair(filename.GetFullPath(), f));
+        AddFile(filename);
     }
 #else
     m_watcher.RemoveAll();
@@ -54,13 +76,54 @@ void clFileSystemWatcher::SetFile(const wxFileName& filename)
 #endif
 }
 
+void clFileSystemWatcher::AddFile(const wxFileName& filename)
+{
+#if CL_FSW_USE_TIMER
+    if(filename.Exists()) {
+        File f;
+        f.filename = filename;
+        f.lastModified = FileUtils::GetFileModificationTime(filename);
+        f.file_size = FileUtils::GetFileSize(filename);
+
+        auto where = m_files.find(filename.GetFullPath());
+        if(where != m_files.end()) {
+            // already watched
+            f.polled = where->second.polled;
+            where->second = f;
+            return;
+        }
+
+#if CL_FSW_USE_INOTIFY
+        if(m_inotifyFd != wxNOT_FOUND && !WatchDirectory(f)) {
+            StartPolling();
+        }
+#endif
+        m_files.insert({ filename.GetFullPath(), f });
+    }
+#else
+    SetFile(filename);
+#endif
+}
+
 void clFileSystemWatcher::Start()
 {
 #if CL_FSW_USE_TIMER
     Stop();
 
-    m_timer = new wxTimer(this);
-    m_timer->Start(FILE_CHECK_INTERVAL, true);
+    bool needs_polling = true;
+#if CL_FSW_USE_INOTIFY
+    StartInotify();
+    if(m_inotifyFd != wxNOT_FOUND) {
+        needs_polling = false;
+        for(auto& [_, f] : m_files) {
+            needs_polling |= !WatchDirectory(f);
+        }
+    }
+#endif
+
+    if(needs_polling) {
+        StartPolling();
+    }
 #else
 #endif
 }
@@ -72,6 +135,9 @@ void clFileSystemWatcher::Stop()
         m_timer->Stop();
     }
     wxDELETE(m_timer);
+#if CL_FSW_USE_INOTIFY
+    StopInotify();
+#endif
 #else
     m_watcher.RemoveAll();
 #endif
@@ -88,56 +154,89 @@ void clFileSystemWatcher::Clear()
 }
 
 #if CL_FSW_USE_TIMER
-void clFileSystemWatcher::OnTimer(wxTimerEvent& event)
+void clFileSystemWatcher::StartPolling()
 {
-    std::set<wxString> nonExistingFiles;
-    for (const auto& [_, f] : m_files) {
-        const wxFileName& fn = f.filename;
-        if(!fn.Exists()) {
+    if(!m_timer) {
+        m_timer = new wxTimer(this);
+        m_timer->Start(FILE_CHECK_INTERVAL, true);
+    }
+}
 
-            // fire file not found event
-            if(GetOwner()) {
-                clFileSystemEvent evt(wxEVT_FILE_NOT_FOUND);
-                evt.SetPath(fn.GetFullPath());
-                GetOwner()->AddPendingEvent(evt);
-            }
+bool clFileSystemWatcher::UpdateFile(File& file, bool* modified)
+{
+    const wxFileName& fn = file.filename;
+    if(!fn.Exists()) {
+        return false;
+    }
 
-            // add the missing file to a set
-            nonExistingFiles.insert(fn.GetFullPath());
-        } else {
-            
 #ifdef __WXMSW__
-            size_t prev_value = f.file_size;
-            size_t curr_value = FileUtils::GetFileSize(fn);
+    size_t prev_value = file.file_size;
+    size_t curr_value = FileUtils::GetFileSize(fn);
+    file.file_size = curr_value;
 #else
-            time_t prev_value = f.lastModified;
-            time_t curr_value = FileUtils::GetFileModificationTime(fn);
+    // Always update the last modified timestamp
+    time_t prev_value = file.lastModified;
+    time_t curr_value = FileUtils::GetFileModificationTime(fn);
+    file.lastModified = curr_value;
 #endif
+    *modified = prev_value != curr_value;
+    return true;
+}
 
-            if(prev_value != curr_value) {
-                // Fire a modified event
-                if(GetOwner()) {
-                    clFileSystemEvent evt(wxEVT_FILE_MODIFIED);
-                    evt.SetPath(fn.GetFullPath());
-                    GetOwner()->AddPendingEvent(evt);
-                }
-            }
-#ifdef __WXMSW__
-            File updatdFile = f;
-            updatdFile.file_size = curr_value;
-#else
-            // Always update the last modified timestamp
-            File updatdFile = f;
-            updatdFile.lastModified = curr_value;
+void clFileSystemWatcher::NotifyOwner(wxEventType type, const wxArrayString& paths)
+{
+    if(!GetOwner() || paths.empty()) {
+        return;
+    }
+
+    clFileSystemEvent evt(type);
+    evt.SetPath(paths[0]);
+    evt.SetPaths(paths);
+    GetOwner()->AddPendingEvent(evt);
+}
 #endif
-            m_files[fn.GetFullPath()] = updatdFile;
+
+#if CL_FSW_USE_TIMER
+void clFileSystemWatcher::OnTimer(wxTimerEvent& event)
+{
+    wxArrayString modifiedFiles;
+    wxArrayString nonExistingFiles;
+    bool has_polled_files = false;
+    for(auto iter = m_files.begin(); iter != m_files.end();) {
+        File& f = iter->second;
+        if(!f.polled) {
+            // watched by inotify
+            ++iter;
+            continue;
+        }
+        has_polled_files = true;
+
+        bool modified = false;
+        if(!UpdateFile(f, &modified)) {
+            // Remove the non existing file
+            nonExistingFiles.Add(iter->first);
+            iter = m_files.erase(iter);
+            continue;
+        }
+
+        if(modified) {
+            modifiedFiles.Add(iter->first);
         }
+        ++iter;
     }
 
-    // Remove the non existing files
-    for (const wxString& fn : nonExistingFiles) {
-        m_files.erase(fn);
+    NotifyOwner(wxEVT_FILE_NOT_FOUND, nonExistingFiles);
+    NotifyOwner(wxEVT_FILE_MODIFIED, modifiedFiles);
+
+#if CL_FSW_USE_INOTIFY
+    if(m_inotifyFd != wxNOT_FOUND && !has_polled_files) {
+        // all the files are watched by inotify
+        wxDELETE(m_timer);
+        return;
     }
+#else
+    wxUnusedVar(has_polled_files);
+#endif
 
     if(m_timer) {
         m_timer->Start(FILE_CHECK_INTERVAL, true);
@@ -145,6 +244,296 @@ void clFileSystemWatcher::OnTimer(wxTimerEvent& event)
 }
 #endif
 
+#if CL_FSW_USE_INOTIFY
+void clFileSystemWatcher::StartInotify()
+{
+    m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if(m_inotifyFd == wxNOT_FOUND) {
+        clWARNING() << "inotify_init1 failed:" << strerror(errno) << ". Falling back to polling" << endl;
+        return;
+    }
+
+    if(pipe2(m_wakeupPipe, O_NONBLOCK | O_CLOEXEC) != 0) {
+        clWARNING() << "pipe2 failed:" << strerror(errno) << ". Falling back to polling" << endl;
+        close(m_inotifyFd);
+        m_inotifyFd = wxNOT_FOUND;
+        return;
+    }
+
+    m_inotifyThread = new std::thread(
+        [this](int inotify_fd, int wakeup_fd) { InotifyThreadMain(inotify_fd, wakeup_fd); },
+        m_inotifyFd,
+        m_wakeupPipe[0]);
+}
+
+void clFileSystemWatcher::StopInotify()
+{
+    if(m_inotifyThread) {
+        // wake the thread up and wait for it to exit
+        char ch = 0;
+        if(write(m_wakeupPipe[1], &ch, 1) != 1) {
+            clWARNING() << "Failed to wake up the inotify thread:" << strerror(errno) << endl;
+        }
+        m_inotifyThread->join();
+        wxDELETE(m_inotifyThread);
+    }
+
+    for(int& fd : m_wakeupPipe) {
+        if(fd != wxNOT_FOUND) {
+            close(fd);
+            fd = wxNOT_FOUND;
+        }
+    }
+
+    if(m_inotifyFd != wxNOT_FOUND) {
+        // closing the descriptor removes all the watches
+        close(m_inotifyFd);
+        m_inotifyFd = wxNOT_FOUND;
+    }
+
+    m_watchedDirs.clear();
+    m_watchDescriptors.clear();
+    for(auto& [_, f] : m_files) {
+        f.polled = true;
+    }
+
+    std::lock_guard<std::mutex> lk{ m_pendingEventsMutex };
+    m_pendingEvents.clear();
+}
+
+int clFileSystemWatcher::AddInotifyWatch(const wxString& dir)
+{
+    return inotify_add_watch(m_inotifyFd, dir.mb_str(wxConvUTF8).data(), INOTIFY_WATCH_MASK);
+}
+
+bool clFileSystemWatcher::WatchDirectory(File& file)
+{
+    wxString dir = file.filename.GetPath();
+    auto where = m_watchedDirs.find(dir);
+    if(where == m_watchedDirs.end()) {
+        int wd = AddInotifyWatch(dir);
+        if(wd == wxNOT_FOUND) {
+            // most likely ENOSPC: max_user_watches was reached
+            LOG_IF_DEBUG { clDEBUG() << "inotify_add_watch(" << dir << ") failed:" << strerror(errno) << endl; }
+            file.polled = true;
+            return false;
+        }
+
+        DirWatch watch;
+        watch.wd = wd;
+        where = m_watchedDirs.insert({ dir, watch }).first;
+        m_watchDescriptors[wd] = dir;
+    }
+    where->second.files_count++;
+    file.polled = false;
+    return true;
+}
+
+void clFileSystemWatcher::UnwatchDirectory(const File& file)
+{
+    if(file.polled) {
+        return;
+    }
+
+    auto where = m_watchedDirs.find(file.filename.GetPath());
+    if(where == m_watchedDirs.end()) {
+        return;
+    }
+
+    where->second.files_count--;
+    if(where->second.files_count == 0) {
+        inotify_rm_watch(m_inotifyFd, where->second.wd);
+        m_watchDescriptors.erase(where->second.wd);
+        m_watchedDirs.erase(where);
+    }
+}
+
+void clFileSystemWatcher::InotifyThreadMain(int inotify_fd, int wakeup_fd)
+{
+    // events read during the current burst
+    std::vector<InotifyEvent> events;
+    auto burst_start = std::chrono::steady_clock::now();
+    alignas(struct inotify_event) char buffer[64 * 1024];
+
+    while(true) {
+        int timeout = -1;
+        if(!events.empty()) {
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                                                 burst_start)
+                               .count();
+            timeout = std::max(0, std::min<int>(INOTIFY_QUIET_PERIOD, INOTIFY_MAX_DELAY - elapsed));
+        }
+
+        struct pollfd fds[2];
+        fds[0].fd = inotify_fd;
+        fds[0].events = POLLIN;
+        fds[0].revents = 0;
+        fds[1].fd = wakeup_fd;
+        fds[1].events = POLLIN;
+        fds[1].revents = 0;
+
+        int rc = poll(fds, 2, timeout);
+        if(rc < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            clWARNING() << "inotify thread: poll error:" << strerror(errno) << endl;
+            break;
+        }
+
+        if(fds[1].revents) {
+            // Stop() was called
+            break;
+        }
+
+        if(fds[0].revents & POLLIN) {
+            if(events.empty()) {
+                burst_start = std::chrono::steady_clock::now();
+            }
+
+            ssize_t bytes_read = 0;
+            while((bytes_read = read(inotify_fd, buffer, sizeof(buffer))) > 0) {
+                for(char* ptr = buffer; ptr < buffer + bytes_read;) {
+                    const struct inotify_event* ev = reinterpret_cast<const struct inotify_event*>(ptr);
+                    InotifyEvent event;
+                    event.wd = ev->wd;
+                    event.mask = ev->mask;
+                    if(ev->len > 0) {
+                        event.name = ev->name;
+                    }
+                    events.push_back(std::move(event));
+                    ptr += sizeof(struct inotify_event) + ev->len;
+                }
+            }
+        }
+
+        if(events.empty()) {
+            continue;
+        }
+
+        auto elapsed =
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - burst_start)
+                .count();
+        if(rc == 0 || elapsed >= INOTIFY_MAX_DELAY) {
+            // the burst is over (or lasts for too long): hand the events to the main thread
+            bool schedule = false;
+            {
+                std::lock_guard<std::mutex> lk{ m_pendingEventsMutex };
+                if(m_pendingEvents.empty()) {
+                    m_pendingEvents.swap(events);
+                } else {
+                    m_pendingEvents.insert(m_pendingEvents.end(), events.begin(), events.end());
+                }
+                schedule = !m_pendingEventsScheduled;
+                m_pendingEventsScheduled = true;
+            }
+            events.clear();
+            if(schedule) {
+                CallAfter(&clFileSystemWatcher::ProcessInotifyEvents);
+            }
+        }
+    }
+}
+
+void clFileSystemWatcher::ProcessInotifyEvents()
+{
+    std::vector<InotifyEvent> events;
+    {
+        std::lock_guard<std::mutex> lk{ m_pendingEventsMutex };
+        events.swap(m_pendingEvents);
+        m_pendingEventsScheduled = false;
+    }
+
+    if(m_inotifyFd == wxNOT_FOUND) {
+        // stopped
+        return;
+    }
+
+    // the files to check. true: the content was modified, false: check the file timestamp
+    std::map<wxString, bool> files;
+    bool check_all = false;
+    for(const auto& event : events) {
+        if(event.mask & IN_Q_OVERFLOW) {
+            // events were lost
+            clDEBUG() << "inotify queue overflow, checking all files" << endl;
+            check_all = true;
+            break;
+        }
+
+        auto where = m_watchDescriptors.find(event.wd);
+        if(where == m_watchDescriptors.end()) {
+            continue;
+        }
+
+        wxString dir = where->second;
+        if(event.mask & IN_IGNORED) {
+            // the watch was removed by the kernel (the directory was deleted), poll the files that are left
+            m_watchedDirs.erase(dir);
+            m_watchDescriptors.erase(where);
+            for(auto& [path, f] : m_files) {
+                if(!f.polled && f.filename.GetPath() == dir) {
+                    f.polled = true;
+                    files.insert({ path, false });
+                }
+            }
+            StartPolling();
+            continue;
+        }
+
+        if(event.name.empty()) {
+            // the directory itself was deleted or moved, check all the files under it
+            wxString prefix = dir + "/";
+            for(auto iter = m_files.lower_bound(prefix); iter != m_files.end() && iter->first.StartsWith(prefix);
+                ++iter) {
+                files.insert({ iter->first, false });
+            }
+            continue;
+        }
+
+        wxString path = dir + "/" + wxString::FromUTF8(event.name.c_str());
+        bool content_modified = event.mask & (IN_MODIFY | IN_CREATE | IN_MOVED_TO);
+        auto iter = files.find(path);
+        if(iter == files.end()) {
+            files.insert({ path, content_modified });
+        } else {
+            iter->second |= content_modified;
+        }
+    }
+
+    if(check_all) {
+        files.clear();
+        for(const auto& [path, _] : m_files) {
+            files.insert({ path, false });
+        }
+    }
+
+    wxArrayString modifiedFiles;
+    wxArrayString nonExistingFiles;
+    for(const auto& [path, content_modified] : files) {
+        auto iter = m_files.find(path);
+        if(iter == m_files.end()) {
+            // not a watched file
+            continue;
+        }
+
+        bool modified = false;
+        if(!UpdateFile(iter->second, &modified)) {
+            nonExistingFiles.Add(path);
+            UnwatchDirectory(iter->second);
+            m_files.erase(iter);
+            continue;
+        }
+
+        if(modified || content_modified) {
+            modifiedFiles.Add(path);
+        }
+    }
+
+    NotifyOwner(wxEVT_FILE_NOT_FOUND, nonExistingFiles);
+    NotifyOwner(wxEVT_FILE_MODIFIED, modifiedFiles);
+}
+#endif
+
 #if !CL_FSW_USE_TIMER
 void clFileSystemWatcher::OnFileModified(wxFileSystemWatcherEvent& event)
 {
@@ -164,15 +553,21 @@ void clFileSystemWatcher::OnFileModified(wxFileSystemWatcherEvent& event)
 void clFileSystemWatcher::RemoveFile(const wxFileName& filename)
 {
 #if CL_FSW_USE_TIMER
-    if(m_files.count(filename.GetFullPath())) {
-        m_files.erase(filename.GetFullPath());
+    auto where = m_files.find(filename.GetFullPath());
+    if(where != m_files.end()) {
+#if CL_FSW_USE_INOTIFY
+        UnwatchDirectory(where->second);
+#endif
+        m_files.erase(where);
     }
 #endif
 }
 
 bool clFileSystemWatcher::IsRunning() const
 {
-#if CL_FSW_USE_TIMER
+#if CL_FSW_USE_INOTIFY
+    return m_timer || m_inotifyThread;
+#elif CL_FSW_USE_TIMER
     return m_timer;
 #else
     return m_watcher.GetWatchedPathsCount();
@@ -13,10 +13,28 @@
 #define CL_FSW_USE_TIMER 1
 #endif
 
+// On Linux, the directories of the watched files are watched with inotify. The timer is only used for the files
+// that could not be watched (e.g. the inotify watches limit was reached)
+#if CL_FSW_USE_TIMER && defined(__linux__)
+#define CL_FSW_USE_INOTIFY 1
+#else
+#define CL_FSW_USE_INOTIFY 0
+#endif
+
 #if !CL_FSW_USE_TIMER
 #include <wx/fswatcher.h>
 #endif
 
+#if CL_FSW_USE_INOTIFY
+#include "wxStringHash.h"
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#endif
+
 class WXDLLIMPEXP_CL clFileSystemWatcher : public wxEvtHandler
 {
 public:
@@ -24,6 +42,8 @@ public:
         wxFileName filename;
         time_t lastModified;
         size_t file_size;
+        // the file is checked by the timer
+        bool polled = true;
         typedef std::map<wxString, File> Map_t;
     };
 
@@ -36,16 +56,55 @@ public:
     wxFileName m_watchedFile;
 #endif
 
+#if CL_FSW_USE_INOTIFY
+    struct InotifyEvent {
+        int wd = -1;
+        uint32_t mask = 0;
+        std::string name;
+    };
+
+    struct DirWatch {
+        int wd = -1;
+        size_t files_count = 0;
+    };
+
+    int m_inotifyFd = -1;
+    int m_wakeupPipe[2] = { -1, -1 };
+    std::thread* m_inotifyThread = nullptr;
+    std::unordered_map<wxString, DirWatch> m_watchedDirs;
+    std::unordered_map<int, wxString> m_watchDescriptors;
+    // events read by the inotify thread, waiting to be processed on the main thread
+    std::vector<InotifyEvent> m_pendingEvents;
+    bool m_pendingEventsScheduled = false;
+    std::mutex m_pendingEventsMutex;
+#endif
+
 public:
     typedef wxSharedPtr<clFileSystemWatcher> Ptr_t;
 
 protected:
 #if CL_FSW_USE_TIMER
     void OnTimer(wxTimerEvent& event);
+    void StartPolling();
+    /// stat the file. Return false if it no longer exists
+    bool UpdateFile(File& file, bool* modified);
+    void NotifyOwner(wxEventType type, const wxArrayString& paths);
 #else
     void OnFileModified(wxFileSystemWatcherEvent& event);
 #endif
 
+#if CL_FSW_USE_INOTIFY
+    void StartInotify();
+    void StopInotify();
+    /// add an inotify watch for `dir`, return its descriptor or wxNOT_FOUND
+    virtual int AddInotifyWatch(const wxString& dir);
+    /// watch the directory of `file`, return false if inotify can not watch it (the file is polled)
+    bool WatchDirectory(File& file);
+    void UnwatchDirectory(const File& file);
+    void InotifyThreadMain(int inotify_fd, int wakeup_fd);
+    void ProcessInotifyEvents();
+#endif
+
 public:
     clFileSystemWatcher();
     virtual ~clFileSystemWatcher();
@@ -58,6 +117,11 @@ public:
      */
     void SetFile(const wxFileName& filename);
 
+    /**
+     * @brief add a file to the watch list, keeping the files that are already watched
+     */
+    void AddFile(const wxFileName& filename);
+
     /**
      * @brief remove file from the watch list
      */
@@ -66,7 +130,9 @@ public:
     /**
      * @brief start to watching list of files.
      * This object fires the following events (clFileSystemEvent):
-     * wxEVT_FILE_MODIFIED, wxEVT_FILE_DELETED
+     * wxEVT_FILE_MODIFIED, wxEVT_FILE_NOT_FOUND
+     * Changes that happen together are reported in a single event: `GetPaths()` returns all the files and `GetPath()`
+     * the first one
      */
     void Start();
 
@@ -0,0 +1,324 @@
+#include "clFuzzyIndex.hpp"
+
+#include <algorithm>
+#include <thread>
+#include <wx/thread.h>
+
+namespace
+{
+// don't bother spawning threads for less than this number of entries
+constexpr size_t MIN_ENTRIES_PER_THREAD = 8192;
+
+// scoring, similar to fzf: every matched character is worth SCORE_MATCH, matches at the start of a word or of the file
+// name get a bonus and gaps between the matched characters are penalised
+constexpr int SCORE_MATCH = 16;
+constexpr int BONUS_BOUNDARY = 8;
+constexpr int BONUS_CONSECUTIVE = 4;
+constexpr int BONUS_FILE_NAME = 8;
+constexpr int PENALTY_GAP_START = 3;
+constexpr int PENALTY_GAP_EXTENSION = 1;
+
+inline bool is_delimiter(wchar_t ch)
+{
+    return ch == '/' || ch == '\\' || ch == '_' || ch == '-' || ch == '.' || ch == ' ' || ch == ':';
+}
+
+inline bool is_boundary(const std::wstring& str, size_t pos) { return pos == 0 || is_delimiter(str[pos - 1]); }
+
+/// letters and digits get their own bit, the other characters share the remaining bits
+inline uint64_t char_bit(wchar_t ch)
+{
+    if (ch >= 'a' && ch <= 'z') {
+        return 1ULL << (ch - 'a');
+    } else if (ch >= '0' && ch <= '9') {
+        return 1ULL << (26 + ch - '0');
+    }
+    return 1ULL << (36 + static_cast<uint64_t>(ch) % 28);
+}
+
+uint64_t chars_mask(const std::wstring& str)
+{
+    uint64_t mask = 0;
+    for (wchar_t ch : str) {
+        mask |= char_bit(ch);
+    }
+    return mask;
+}
+
+size_t get_threads(size_t threads, size_t count)
+{
+    if (threads == 0) {
+        threads = wxThread::GetCPUCount() > 0 ? wxThread::GetCPUCount() : 1;
+    }
+    return std::min(threads, count / MIN_ENTRIES_PER_THREAD + 1);
+}
+
+/// split [0, count) into `threads` ranges and call `func(begin, end, slot)` for each range, from its own thread
+template <typename Func> void parallel_for(size_t count, size_t threads, Func func)
+{
+    if (threads <= 1) {
+        func(0, count, 0);
+        return;
+    }
+
+    size_t per_thread = (count + threads - 1) / threads;
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (size_t slot = 0; slot < threads; ++slot) {
+        size_t begin = slot * per_thread;
+        size_t end = std::min(count, begin + per_thread);
+        if (begin >= end) {
+            break;
+        }
+        workers.emplace_back(func, begin, end, slot);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+bool is_subsequence(const std::wstring& needle, const std::wstring& haystack)
+{
+    size_t n = 0;
+    for (size_t i = 0; i < haystack.length() && n < needle.length(); ++i) {
+        if (haystack[i] == needle[n]) {
+            ++n;
+        }
+    }
+    return n == needle.length();
+}
+} // namespace
+
+clFuzzyIndex::clFuzzyIndex(eFuzzyIndexMode mode)
+    : m_mode(mode)
+{
+}
+
+void clFuzzyIndex::Clear()
+{
+    m_entries.clear();
+    m_hasLast = false;
+    m_lastWords.clear();
+    m_lastMatches.clear();
+}
+
+void clFuzzyIndex::Build(const std::vector<wxString>& entries, size_t threads)
+{
+    Clear();
+    m_entries.resize(entries.size());
+    parallel_for(entries.size(), get_threads(threads, entries.size()), [&](size_t begin, size_t end, size_t slot) {
+        wxUnusedVar(slot);
+        for (size_t i = begin; i < end; ++i) {
+            auto& entry = m_entries[i];
+            entry.lower = entries[i].Lower().ToStdWstring();
+            size_t sep = entry.lower.find_last_of(L"/\\");
+            entry.name_offset = (sep == std::wstring::npos) ? 0 : sep + 1;
+            entry.mask = chars_mask(entry.lower);
+        }
+    });
+}
+
+bool clFuzzyIndex::Narrows(const std::vector<std::wstring>& words) const
+{
+    if (m_mode == eFuzzyIndexMode::kInOrder) {
+        return m_lastWords.empty() || (!words.empty() && is_subsequence(m_lastWords[0], words[0]));
+    }
+
+    // every previous word must be contained in one of the new words
+    for (const auto& last_word : m_lastWords) {
+        bool found = std::any_of(words.begin(), words.end(), [&](const std::wstring& word) {
+            return word.find(last_word) != std::wstring::npos;
+        });
+        if (!found) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool clFuzzyIndex::Score(const Entry& entry, const std::vector<std::wstring>& words, uint64_t mask, int* score) const
+{
+    *score = 0;
+    if (words.empty()) {
+        return true;
+    }
+
+    // quick reject: the entry does not contain all the query characters
+    if ((entry.mask & mask) != mask) {
+        return false;
+    }
+    return m_mode == eFuzzyIndexMode::kInOrder ? ScoreInOrder(entry, words[0], score)
+                                               : ScoreWords(entry, words, score);
+}
+
+bool clFuzzyIndex::ScoreWords(const Entry& entry, const std::vector<std::wstring>& words, int* score) const
+{
+    int total = 0;
+    for (const auto& word : words) {
+        // prefer a match in the file name
+        size_t pos = entry.lower.find(word, entry.name_offset);
+        bool in_name = (pos != std::wstring::npos);
+        if (!in_name) {
+            pos = entry.lower.find(word);
+            if (pos == std::wstring::npos) {
+                return false;
+            }
+        }
+
+        total += SCORE_MATCH * static_cast<int>(word.length());
+        if (is_boundary(entry.lower, pos)) {
+            total += BONUS_BOUNDARY;
+        }
+        if (in_name) {
+            total += BONUS_FILE_NAME;
+        }
+    }
+    *score = total;
+    return true;
+}
+
+bool clFuzzyIndex::ScoreInOrder(const Entry& entry, const std::wstring& needle, int* score) const
+{
+    const auto& str = entry.lower;
+
+    // forward: find where the first occurrence of the needle ends
+    size_t n = 0;
+    size_t end = std::wstring::npos;
+    for (size_t i = 0; i < str.length(); ++i) {
+        if (str[i] == needle[n] && ++n == needle.length()) {
+            end = i;
+            break;
+        }
+    }
+    if (end == std::wstring::npos) {
+        return false;
+    }
+
+    // backward: the shortest window that ends there
+    size_t start = end;
+    n = needle.length();
+    for (size_t i = end + 1; i-- > 0;) {
+        if (str[i] == needle[n - 1] && --n == 0) {
+            start = i;
+            break;
+        }
+    }
+
+    int total = 0;
+    size_t prev = std::wstring::npos;
+    n = 0;
+    for (size_t i = start; i <= end && n < needle.length(); ++i) {
+        if (str[i] != needle[n]) {
+            continue;
+        }
+        total += SCORE_MATCH;
+        if (is_boundary(str, i)) {
+            total += BONUS_BOUNDARY;
+        }
+        if (prev != std::wstring::npos) {
+            if (i == prev + 1) {
+                total += BONUS_CONSECUTIVE;
+            } else {
+                total -= PENALTY_GAP_START + static_cast<int>(i - prev - 2) * PENALTY_GAP_EXTENSION;
+            }
+        }
+        prev = i;
+        ++n;
+    }
+    if (start >= entry.name_offset) {
+        total += BONUS_FILE_NAME;
+    }
+    *score = total;
+    return true;
+}
+
+std::vector<clFuzzyIndex::Match> clFuzzyIndex::Search(const wxString& query, size_t max_results, size_t threads)
+{
+    std::vector<std::wstring> words;
+    if (m_mode == eFuzzyIndexMode::kInOrder) {
+        if (!query.empty()) {
+            words.push_back(query.Lower().ToStdWstring());
+        }
+    } else {
+        std::wstring word;
+        for (wxChar ch : query) {
+            if (ch == ' ' || ch == '\t') {
+                if (!word.empty()) {
+                    words.push_back(std::move(word));
+                    word.clear();
+                }
+            } else {
+                word.push_back(wxTolower(ch));
+            }
+        }
+        if (!word.empty()) {
+            words.push_back(std::move(word));
+        }
+    }
+
+    uint64_t mask = 0;
+    for (const auto& word : words) {
+        mask |= chars_mask(word);
+    }
+
+    // when the query extends the previous one, its matches are a subset of the previous matches
+    bool narrow = m_hasLast && Narrows(words);
+    size_t count = narrow ? m_lastMatches.size() : m_entries.size();
+    threads = get_threads(threads, count);
+
+    std::vector<std::vector<Match>> results(threads);
+    parallel_for(count, threads, [&](size_t begin, size_t end, size_t slot) {
+        auto& slot_matches = results[slot];
+        for (size_t i = begin; i < end; ++i) {
+            size_t index = narrow ? m_lastMatches[i] : i;
+            int score = 0;
+            if (Score(m_entries[index], words, mask, &score)) {
+                slot_matches.push_back({ index, score });
+            }
+        }
+    });
+
+    std::vector<Match> matches;
+    if (results.size() == 1) {
+        matches.swap(results[0]);
+    } else {
+        size_t total = 0;
+        for (const auto& slot_matches : results) {
+            total += slot_matches.size();
+        }
+        matches.reserve(total);
+        for (const auto& slot_matches : results) {
+            matches.insert(matches.end(), slot_matches.begin(), slot_matches.end());
+        }
+    }
+
+    // keep all the matches (in index order) for the next query
+    m_lastMatches.clear();
+    m_lastMatches.reserve(matches.size());
+    for (const auto& match : matches) {
+        m_lastMatches.push_back(match.index);
+    }
+    m_lastWords.swap(words);
+    m_hasLast = true;
+
+    // best score first, then the shortest entry
+    auto is_better = [this](const Match& a, const Match& b) {
+        if (a.score != b.score) {
+            return a.score > b.score;
+        }
+        size_t a_len = m_entries[a.index].lower.length();
+        size_t b_len = m_entries[b.index].lower.length();
+        if (a_len != b_len) {
+            return a_len < b_len;
+        }
+        return a.index < b.index;
+    };
+
+    if (max_results > 0 && max_results < matches.size()) {
+        std::partial_sort(matches.begin(), matches.begin() + max_results, matches.end(), is_better);
+        matches.resize(max_results);
+    } else {
+        std::sort(matches.begin(), matches.end(), is_better);
+    }
+    return matches;
+}
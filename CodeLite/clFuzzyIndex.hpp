@@ -0,0 +1,84 @@
+#ifndef CLFUZZYINDEX_HPP
+#define CLFUZZYINDEX_HPP
+
+#include "codelite_exports.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <wx/string.h>
+
+enum class eFuzzyIndexMode {
+    /// the query is split into words, each word must be found in the entry (see FileUtils::FuzzyMatch)
+    kWords,
+    /// the query characters must be found in the entry, in order (see clAnagram::MatchesInOrder)
+    kInOrder,
+};
+
+/**
+ * @class clFuzzyIndex
+ * @brief rank a (large) list of strings, e.g. the workspace files, against a fuzzy query.
+ * The entries are lower cased once, when the index is built, and each one keeps a bitmask of the characters it
+ * contains so most of the entries are rejected without scanning them. Large indexes are searched in parallel. When the
+ * query extends the previous one (e.g. the user typed another character), only the previous matches are searched.
+ *
+ * The index is not thread safe: Search() updates the previous query state
+ */
+class WXDLLIMPEXP_CL clFuzzyIndex
+{
+public:
+    struct Match {
+        /// the entry index, as passed to Build()
+        size_t index = 0;
+        int score = 0;
+    };
+
+private:
+    struct Entry {
+        std::wstring lower;
+        /// the offset of the last path component (the file name)
+        size_t name_offset = 0;
+        uint64_t mask = 0;
+    };
+
+    eFuzzyIndexMode m_mode = eFuzzyIndexMode::kWords;
+    std::vector<Entry> m_entries;
+
+    /// the last query and all of its matches, in index order
+    bool m_hasLast = false;
+    std::vector<std::wstring> m_lastWords;
+    std::vector<size_t> m_lastMatches;
+
+private:
+    bool Score(const Entry& entry, const std::vector<std::wstring>& words, uint64_t mask, int* score) const;
+    bool ScoreWords(const Entry& entry, const std::vector<std::wstring>& words, int* score) const;
+    bool ScoreInOrder(const Entry& entry, const std::wstring& needle, int* score) const;
+    /// return true if every entry matching `words` also matches the previous query
+    bool Narrows(const std::vector<std::wstring>& words) const;
+
+public:
+    explicit clFuzzyIndex(eFuzzyIndexMode mode = eFuzzyIndexMode::kWords);
+    ~clFuzzyIndex() = default;
+
+    /**
+     * @brief (re)build the index
+     * @param threads number of threads to use, 0 means one per CPU
+     */
+    void Build(const std::vector<wxString>& entries, size_t threads = 0);
+
+    /**
+     * @brief remove all the entries
+     */
+    void Clear();
+
+    size_t GetCount() const { return m_entries.size(); }
+
+    /**
+     * @brief return the entries matching `query`, best match first. An empty query matches all the entries
+     * @param max_results return at most this number of matches, 0 means all of them
+     * @param threads number of threads to use, 0 means one per CPU
+     */
+    std::vector<Match> Search(const wxString& query, size_t max_results = 0, size_t threads = 0);
+};
+
+#endif // CLFUZZYINDEX_HPP
@@ -0,0 +1,60 @@
+#include "clStringPool.hpp"
+
+clStringPool::Shard& clStringPool::GetShard(const wxString& str)
+{
+    return m_shards[std::hash<wxString>{}(str) % SHARDS_COUNT];
+}
+
+clStringPool::Ptr_t clStringPool::Intern(const wxString& str)
+{
+    static const Ptr_t empty_string = std::make_shared<const wxString>();
+    if(str.empty()) {
+        return empty_string;
+    }
+
+    Shard& shard = GetShard(str);
+    std::lock_guard lock{ shard.lock };
+    auto iter = shard.strings.find(&str);
+    if(iter != shard.strings.end()) {
+        Ptr_t pooled = iter->second.lock();
+        if(pooled) {
+            return pooled;
+        }
+        // the last reference was released, but Release() did not run yet
+        shard.strings.erase(iter);
+    }
+
+    Ptr_t pooled(new wxString(str), [this](const wxString* s) { Release(s); });
+    shard.strings.insert({ pooled.get(), pooled });
+    return pooled;
+}
+
+void clStringPool::Release(const wxString* str)
+{
+    {
+        Shard& shard = GetShard(*str);
+        std::lock_guard lock{ shard.lock };
+        // the same value may have been interned again, into another instance
+        auto iter = shard.strings.find(str);
+        if(iter != shard.strings.end() && iter->first == str) {
+            shard.strings.erase(iter);
+        }
+    }
+    delete str;
+}
+
+size_t clStringPool::GetCount()
+{
+    size_t count = 0;
+    for(auto& shard : m_shards) {
+        std::lock_guard lock{ shard.lock };
+        count += shard.strings.size();
+    }
+    return count;
+}
+
+clStringPool& clStringPool::Get()
+{
+    static clStringPool* pool = new clStringPool();
+    return *pool;
+}
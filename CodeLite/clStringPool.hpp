@@ -0,0 +1,71 @@
+#ifndef CLSTRINGPOOL_HPP
+#define CLSTRINGPOOL_HPP
+
+#include "codelite_exports.h"
+#include "wxStringHash.h"
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <wx/string.h>
+
+/**
+ * @class clStringPool
+ * @brief a thread safe pool of immutable, reference counted strings. Interning the same value twice returns the same
+ * instance, so values that repeat a lot (file names, scopes, kinds) are stored once and can be compared by address.
+ * A string is removed from the pool once the last reference to it is released, the pool must outlive the references
+ */
+class WXDLLIMPEXP_CL clStringPool
+{
+public:
+    typedef std::shared_ptr<const wxString> Ptr_t;
+
+private:
+    // the pool is split into shards to reduce the contention between the parsing threads
+    static constexpr size_t SHARDS_COUNT = 16;
+
+    /// hash and compare the pooled strings by value
+    struct Hash {
+        size_t operator()(const wxString* str) const { return std::hash<wxString>{}(*str); }
+    };
+    struct Equal {
+        bool operator()(const wxString* lhs, const wxString* rhs) const { return *lhs == *rhs; }
+    };
+
+    struct Shard {
+        std::mutex lock;
+        /// the key is the pooled string, the value tracks the references to it
+        std::unordered_map<const wxString*, std::weak_ptr<const wxString>, Hash, Equal> strings;
+    };
+    std::array<Shard, SHARDS_COUNT> m_shards;
+
+private:
+    /// called when the last reference to `str` is released, deletes it
+    void Release(const wxString* str);
+    Shard& GetShard(const wxString& str);
+
+public:
+    clStringPool() = default;
+    ~clStringPool() = default;
+
+    clStringPool(const clStringPool&) = delete;
+    clStringPool& operator=(const clStringPool&) = delete;
+
+    /**
+     * @brief return the pooled instance of `str`, adding it if needed
+     */
+    Ptr_t Intern(const wxString& str);
+
+    /**
+     * @brief number of strings in the pool
+     */
+    size_t GetCount();
+
+    /**
+     * @brief the pool used by TagEntry. It is never destroyed, so static tags can safely refer to it
+     */
+    static clStringPool& Get();
+};
+
+#endif // CLSTRINGPOOL_HPP
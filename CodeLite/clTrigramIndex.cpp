@@ -0,0 +1,491 @@
+#include "clTrigramIndex.hpp"
+
+#include "file_logger.h"
+#include "fileutils.h"
+#include "macros.h"
+
+#include <algorithm>
+#include <iterator>
+#include <unordered_map>
+
+namespace
+{
+// number of files (re)indexed per transaction
+constexpr size_t BATCH_SIZE = 500;
+
+// maximum number of trigrams used for a single query. Any subset of the query trigrams is a valid filter, so we cap
+// it to keep the query cheap
+constexpr size_t MAX_QUERY_TRIGRAMS = 32;
+
+bool is_ascii_trigram(uint32_t trigram)
+{
+    return ((trigram >> 16) & 0xFF) < 0x80 && ((trigram >> 8) & 0xFF) < 0x80 && (trigram & 0xFF) < 0x80;
+}
+
+inline unsigned char to_lower(unsigned char ch) { return (ch >= 'A' && ch <= 'Z') ? ch + ('a' - 'A') : ch; }
+
+// the position after the escape starting at `pos`, whose first char is a letter or a digit. The digits of an
+// escape (\x41, \u0041, \101) are not literals
+size_t skip_escape(const wxString& regex, size_t pos)
+{
+    size_t i = pos + 1;
+    if (i >= regex.length()) {
+        return i;
+    }
+
+    wxChar ch = regex[i++];
+    size_t max_digits = 0;
+    bool hex = true;
+    switch (ch) {
+    case 'c':
+        // control character: \cX
+        return std::min(i + 1, regex.length());
+    case 'u':
+        max_digits = 4;
+        break;
+    case 'U':
+        max_digits = 8;
+        break;
+    case 'x':
+        max_digits = wxString::npos;
+        break;
+    default:
+        if (!wxIsdigit(ch)) {
+            return i;
+        }
+        // octal character or back reference
+        max_digits = wxString::npos;
+        hex = false;
+        break;
+    }
+
+    for (size_t count = 0; i < regex.length() && count < max_digits; ++i, ++count) {
+        wxChar digit = regex[i];
+        if (hex ? !wxIsxdigit(digit) : !wxIsdigit(digit)) {
+            break;
+        }
+    }
+    return i;
+}
+} // namespace
+
+clTrigramIndex::~clTrigramIndex() { Close(); }
+
+bool clTrigramIndex::Open(const wxFileName& dbfile)
+{
+    std::lock_guard<std::mutex> lk{ m_mutex };
+    try {
+        if (m_db.IsOpen()) {
+            m_db.Close();
+        }
+        m_db.Open(dbfile.GetFullPath());
+        m_db.SetBusyTimeout(10);
+        CreateSchema();
+        LoadIndexedFiles();
+        m_filename = dbfile;
+        m_shutdown.store(false);
+
+    } catch (const wxSQLite3Exception& e) {
+        clWARNING() << "Failed to open search index:" << dbfile.GetFullPath() << "." << e.GetMessage() << endl;
+        return false;
+    }
+    clDEBUG() << "Search index" << dbfile.GetFullPath() << "opened." << m_indexedFiles.size() << "files indexed"
+              << endl;
+    return true;
+}
+
+void clTrigramIndex::Close()
+{
+    // stop any indexing in progress before we take the lock
+    m_shutdown.store(true);
+
+    std::lock_guard<std::mutex> lk{ m_mutex };
+    if (m_db.IsOpen()) {
+        m_db.Close();
+    }
+    m_indexedFiles.clear();
+    m_filename.Clear();
+}
+
+bool clTrigramIndex::IsOpened() const
+{
+    std::lock_guard<std::mutex> lk{ m_mutex };
+    return m_db.IsOpen();
+}
+
+void clTrigramIndex::CreateSchema()
+{
+    m_db.ExecuteUpdate("PRAGMA journal_mode = OFF;");
+    m_db.ExecuteUpdate("PRAGMA synchronous = OFF;");
+    m_db.ExecuteUpdate("PRAGMA temp_store = MEMORY;");
+    m_db.ExecuteUpdate("create table if not exists FILES (ID INTEGER PRIMARY KEY AUTOINCREMENT, PATH TEXT UNIQUE, "
+                       "MTIME INTEGER, SIZE INTEGER);");
+    m_db.ExecuteUpdate("create table if not exists TRIGRAMS (TRIGRAM INTEGER, FILE_ID INTEGER, PRIMARY KEY "
+                       "(TRIGRAM, FILE_ID)) WITHOUT ROWID;");
+    m_db.ExecuteUpdate("create index if not exists TRIGRAMS_FILE_ID on TRIGRAMS(FILE_ID);");
+}
+
+void clTrigramIndex::LoadIndexedFiles()
+{
+    m_indexedFiles.clear();
+    wxSQLite3ResultSet res = m_db.ExecuteQuery("select PATH, MTIME, SIZE from FILES");
+    while (res.NextRow()) {
+        m_indexedFiles.insert(
+            { res.GetString(0), { (time_t)res.GetInt64(1).GetValue(), (size_t)res.GetInt64(2).GetValue() } });
+    }
+}
+
+void clTrigramIndex::GetTrigrams(const std::string& text, std::vector<uint32_t>& trigrams)
+{
+    trigrams.clear();
+    if (text.length() < 3) {
+        return;
+    }
+
+    trigrams.reserve(text.length() - 2);
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(text.data());
+    uint32_t trigram = (to_lower(p[0]) << 8) | to_lower(p[1]);
+    for (size_t i = 2; i < text.length(); ++i) {
+        trigram = ((trigram << 8) | to_lower(p[i])) & 0xFFFFFF;
+        // a match never spans multiple lines
+        if (p[i] == '\n' || p[i - 1] == '\n' || p[i - 2] == '\n') {
+            continue;
+        }
+        trigrams.push_back(trigram);
+    }
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+}
+
+void clTrigramIndex::DoDeleteFile(const wxString& filepath)
+{
+    wxSQLite3Statement st = m_db.PrepareStatement(
+        "delete from TRIGRAMS where FILE_ID in (select ID from FILES where PATH = ?)");
+    st.Bind(1, filepath);
+    st.ExecuteUpdate();
+
+    st = m_db.PrepareStatement("delete from FILES where PATH = ?");
+    st.Bind(1, filepath);
+    st.ExecuteUpdate();
+    m_indexedFiles.erase(filepath);
+}
+
+void clTrigramIndex::DoIndexFile(const wxString& filepath)
+{
+    DoDeleteFile(filepath);
+
+    wxFileName fn(filepath);
+    std::string content;
+    if (!fn.FileExists() || !FileUtils::ReadFileContentRaw(fn, content)) {
+        return;
+    }
+
+    // binary or UTF-16 content: leave it out of the index so it is always searched
+    if (content.find('\0') != std::string::npos) {
+        return;
+    }
+
+    std::vector<uint32_t> trigrams;
+    GetTrigrams(content, trigrams);
+
+    Fingerprint_t fingerprint{ FileUtils::GetFileModificationTime(fn), content.length() };
+    wxSQLite3Statement st = m_db.PrepareStatement("insert into FILES values(NULL, ?, ?, ?)");
+    st.Bind(1, filepath);
+    st.Bind(2, wxLongLong((long long)fingerprint.first));
+    st.Bind(3, wxLongLong((long long)fingerprint.second));
+    st.ExecuteUpdate();
+    wxLongLong file_id = m_db.GetLastRowId();
+
+    st = m_db.PrepareStatement("insert into TRIGRAMS values(?, ?)");
+    for (uint32_t trigram : trigrams) {
+        st.Bind(1, (int)trigram);
+        st.Bind(2, file_id);
+        st.ExecuteUpdate();
+        st.Reset();
+    }
+    m_indexedFiles.insert({ filepath, fingerprint });
+}
+
+void clTrigramIndex::DoBatch(const wxArrayString& files, std::function<void(const wxString&)> func)
+{
+    size_t i = 0;
+    while (i < files.size() && !m_shutdown.load()) {
+        // release the lock between batches, so searches are not blocked for the whole duration of the update
+        std::lock_guard<std::mutex> lk{ m_mutex };
+        if (!m_db.IsOpen()) {
+            return;
+        }
+
+        try {
+            m_db.Begin();
+            for (size_t count = 0; count < BATCH_SIZE && i < files.size(); ++count, ++i) {
+                func(files.Item(i));
+            }
+            m_db.Commit();
+
+        } catch (const wxSQLite3Exception& e) {
+            clWARNING() << "Search index update error:" << e.GetMessage() << endl;
+            try {
+                m_db.Rollback();
+                LoadIndexedFiles();
+            } catch (const wxSQLite3Exception&) {
+            }
+            return;
+        }
+    }
+}
+
+void clTrigramIndex::Update(const wxArrayString& files)
+{
+    DoBatch(files, [this](const wxString& filepath) { DoIndexFile(filepath); });
+}
+
+void clTrigramIndex::Delete(const wxArrayString& files)
+{
+    DoBatch(files, [this](const wxString& filepath) { DoDeleteFile(filepath); });
+}
+
+void clTrigramIndex::Sync(const wxArrayString& files)
+{
+    // take a copy of the current state of the index
+    std::unordered_map<wxString, Fingerprint_t> indexed;
+    {
+        std::lock_guard<std::mutex> lk{ m_mutex };
+        if (!m_db.IsOpen()) {
+            return;
+        }
+        indexed = m_indexedFiles;
+    }
+
+    wxArrayString modified;
+    wxArrayString deleted;
+    wxStringSet_t wanted;
+    wanted.reserve(files.size());
+    for (const wxString& filepath : files) {
+        if (m_shutdown.load()) {
+            return;
+        }
+        wanted.insert(filepath);
+        auto iter = indexed.find(filepath);
+        if (iter == indexed.end() || iter->second.first != FileUtils::GetFileModificationTime(filepath) ||
+            iter->second.second != FileUtils::GetFileSize(filepath)) {
+            modified.Add(filepath);
+        }
+    }
+
+    for (const auto& [filepath, _] : indexed) {
+        if (wanted.count(filepath) == 0) {
+            deleted.Add(filepath);
+        }
+    }
+
+    clDEBUG() << "Search index sync:" << modified.size() << "files to index," << deleted.size() << "files to remove"
+              << endl;
+    Delete(deleted);
+    Update(modified);
+    clDEBUG() << "Search index sync: done" << endl;
+}
+
+bool clTrigramIndex::FilterFiles(const std::vector<wxString>& literals, wxArrayString& files) const
+{
+    std::vector<uint32_t> query;
+    std::vector<uint32_t> trigrams;
+    for (const wxString& literal : literals) {
+        GetTrigrams(literal.ToStdString(wxConvUTF8), trigrams);
+        // the file encoding is not known, so only ASCII trigrams can be trusted
+        std::copy_if(trigrams.begin(), trigrams.end(), std::back_inserter(query), is_ascii_trigram);
+    }
+
+    std::sort(query.begin(), query.end());
+    query.erase(std::unique(query.begin(), query.end()), query.end());
+    if (query.empty()) {
+        return false;
+    }
+    if (query.size() > MAX_QUERY_TRIGRAMS) {
+        query.resize(MAX_QUERY_TRIGRAMS);
+    }
+
+    wxString sql;
+    sql << "select F.PATH from FILES F join (select FILE_ID from TRIGRAMS where TRIGRAM in (";
+    for (size_t i = 0; i < query.size(); ++i) {
+        sql << (i == 0 ? "" : ",") << query[i];
+    }
+    sql << ") group by FILE_ID having count(*) = " << query.size() << ") C on F.ID = C.FILE_ID";
+
+    wxStringSet_t candidates;
+    // the files that the index rules out, with their fingerprint when they were indexed
+    std::vector<std::pair<size_t, Fingerprint_t>> excluded;
+    {
+        std::lock_guard<std::mutex> lk{ m_mutex };
+        if (!m_db.IsOpen()) {
+            return false;
+        }
+
+        try {
+            wxSQLite3ResultSet res = m_db.ExecuteQuery(sql);
+            while (res.NextRow()) {
+                candidates.insert(res.GetString(0));
+            }
+        } catch (const wxSQLite3Exception& e) {
+            clWARNING() << "Search index query error:" << e.GetMessage() << endl;
+            return false;
+        }
+
+        for (size_t i = 0; i < files.size(); ++i) {
+            if (candidates.count(files.Item(i))) {
+                continue;
+            }
+            auto iter = m_indexedFiles.find(files.Item(i));
+            if (iter != m_indexedFiles.end()) {
+                excluded.push_back({ i, iter->second });
+            }
+        }
+    }
+
+    // the index is updated in the background: a file modified since it was indexed may now match, so it is only
+    // dropped if it is still the file that was indexed
+    std::vector<bool> keep(files.size(), true);
+    for (const auto& [i, fingerprint] : excluded) {
+        const wxString& filepath = files.Item(i);
+        keep[i] = FileUtils::GetFileModificationTime(filepath) != fingerprint.first ||
+                  FileUtils::GetFileSize(filepath) != fingerprint.second;
+    }
+
+    wxArrayString filtered;
+    filtered.reserve(files.size() - excluded.size());
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (keep[i]) {
+            filtered.Add(files.Item(i));
+        }
+    }
+    files.swap(filtered);
+    return true;
+}
+
+std::vector<wxString> clTrigramIndex::GetRequiredLiterals(const wxString& regex)
+{
+    // "***" prefixed expressions are directors (e.g. "***=" - the rest is a literal), don't try to analyse them
+    if (regex.StartsWith("***")) {
+        return {};
+    }
+
+    std::vector<wxString> literals;
+    wxString current;
+    // for every open group: the number of literals collected before it, and whether its content is optional
+    std::vector<std::pair<size_t, bool>> groups;
+
+    auto flush = [&]() {
+        if (!current.empty()) {
+            literals.push_back(current);
+            current.clear();
+        }
+    };
+
+    size_t i = 0;
+    while (i < regex.length()) {
+        wxChar ch = regex[i];
+        switch (ch) {
+        case '|':
+            // alternation: no literal is required
+            return {};
+        case '\\':
+            if (i + 1 < regex.length() && !wxIsalnum((wxChar)regex[i + 1])) {
+                // escaped punctuation is a literal
+                current << regex[i + 1];
+                i += 2;
+            } else {
+                // class shorthand (\w, \d...), anchor, character entry (\x41, \u00e9, \101...) or back reference
+                flush();
+                i = skip_escape(regex, i);
+            }
+            continue;
+        case '?':
+        case '*':
+        case '{':
+            // the previous char is optional
+            if (!current.empty()) {
+                current.RemoveLast();
+            }
+            flush();
+            if (ch == '{') {
+                while (i < regex.length() && regex[i] != '}') {
+                    ++i;
+                }
+            }
+            break;
+        case '+':
+            flush();
+            break;
+        case '.':
+        case '^':
+        case '$':
+            flush();
+            break;
+        case '[': {
+            flush();
+            size_t j = i + 1;
+            if (j < regex.length() && regex[j] == '^') {
+                ++j;
+            }
+            if (j < regex.length() && regex[j] == ']') {
+                ++j;
+            }
+            while (j < regex.length() && regex[j] != ']') {
+                wxChar next = j + 1 < regex.length() ? (wxChar)regex[j + 1] : 0;
+                if (regex[j] == '[' && (next == ':' || next == '=' || next == '.')) {
+                    // a character class ([:alpha:]), an equivalence class ([=a=]) or a collating element ([.-.]):
+                    // skip to its terminator, it may contain a ']'
+                    size_t end = regex.find(wxString() << next << ']', j + 2);
+                    if (end == wxString::npos) {
+                        return {};
+                    }
+                    j = end + 2;
+                    continue;
+                }
+                if (regex[j] == '\\') {
+                    ++j;
+                }
+                ++j;
+            }
+            i = j;
+        } break;
+        case '(': {
+            flush();
+            // lookarounds, options etc. their content is never required
+            bool optional = (i + 1 < regex.length() && regex[i + 1] == '?');
+            if (optional && i + 2 < regex.length() && regex[i + 2] == ':') {
+                // a non capturing group
+                optional = false;
+                i += 2;
+            } else if (optional) {
+                ++i;
+            }
+            groups.push_back({ literals.size(), optional });
+        } break;
+        case ')': {
+            flush();
+            if (groups.empty()) {
+                return {};
+            }
+            auto group = groups.back();
+            groups.pop_back();
+            bool quantified = i + 1 < regex.length() &&
+                              (regex[i + 1] == '?' || regex[i + 1] == '*' || regex[i + 1] == '{');
+            if (group.second || quantified) {
+                literals.resize(group.first);
+            }
+        } break;
+        default:
+            current << ch;
+            break;
+        }
+        ++i;
+    }
+    flush();
+
+    if (!groups.empty()) {
+        // unbalanced expression
+        return {};
+    }
+    return literals;
+}
@@ -0,0 +1,109 @@
+#ifndef CLTRIGRAMINDEX_HPP
+#define CLTRIGRAMINDEX_HPP
+
+#include "codelite_exports.h"
+#include "wxStringHash.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <wx/filename.h>
+#include <wx/string.h>
+#include <wx/wxsqlite3.h>
+
+/**
+ * @class clTrigramIndex
+ * @brief an on-disk index that maps every 3 bytes sequence (trigram) found in a file to the files containing it.
+ * Given a list of literals that a match must contain, the index returns the files that can not possibly match, so
+ * the search only needs to open the remaining files. Trigrams are stored lower cased (ASCII only) and never span
+ * multiple lines. Files containing NUL bytes (binary, UTF-16) are not indexed.
+ *
+ * All the methods are thread safe: the index is typically updated from a background thread while the search
+ * thread queries it
+ */
+class WXDLLIMPEXP_CL clTrigramIndex
+{
+public:
+    typedef std::shared_ptr<clTrigramIndex> ptr_t;
+
+    /// the modification time and size of a file when it was indexed
+    typedef std::pair<time_t, size_t> Fingerprint_t;
+
+private:
+    mutable wxSQLite3Database m_db;
+    wxFileName m_filename;
+    /// the files in the index, with their fingerprint (the FILES table content)
+    std::unordered_map<wxString, Fingerprint_t> m_indexedFiles;
+    mutable std::mutex m_mutex;
+    std::atomic_bool m_shutdown{ false };
+
+private:
+    void CreateSchema();
+    void LoadIndexedFiles();
+    /// (re)index a single file. Must be called with m_mutex locked and within a transaction
+    void DoIndexFile(const wxString& filepath);
+    /// remove a single file. Must be called with m_mutex locked and within a transaction
+    void DoDeleteFile(const wxString& filepath);
+    /// apply `func` on `files` in batches, each batch is committed in its own transaction
+    void DoBatch(const wxArrayString& files, std::function<void(const wxString&)> func);
+
+public:
+    clTrigramIndex() = default;
+    ~clTrigramIndex();
+
+    /**
+     * @brief open (or create) the index stored in `dbfile`
+     */
+    bool Open(const wxFileName& dbfile);
+
+    /**
+     * @brief close the index. Any indexing in progress is stopped
+     */
+    void Close();
+
+    bool IsOpened() const;
+
+    /**
+     * @brief bring the index up-to-date with `files`: new files and files modified since they were indexed are
+     * (re)indexed, files that are in the index but not in `files` are removed
+     */
+    void Sync(const wxArrayString& files);
+
+    /**
+     * @brief (re)index the given files. Files that no longer exist are removed from the index
+     */
+    void Update(const wxArrayString& files);
+
+    /**
+     * @brief remove files from the index
+     */
+    void Delete(const wxArrayString& files);
+
+    /**
+     * @brief remove from `files` every file that is in the index and does not contain all the `literals`.
+     * Files that are unknown to the index, or that were modified since they were indexed, are always kept. Only ASCII trigrams are used, so the result is valid for
+     * both case sensitive and case insensitive searches
+     * @param literals strings that a matching file must contain
+     * @return false if the index can not be used for this query (e.g. all the literals are too short), in which
+     * case `files` is left untouched
+     */
+    bool FilterFiles(const std::vector<wxString>& literals, wxArrayString& files) const;
+
+    /**
+     * @brief return the literal strings that every match of the regular expression `regex` must contain.
+     * An empty list is returned if no such literals exist (or the expression is too complex to analyse)
+     */
+    static std::vector<wxString> GetRequiredLiterals(const wxString& regex);
+
+    /**
+     * @brief collect the trigrams of `text` into `trigrams` (sorted, unique)
+     */
+    static void GetTrigrams(const std::string& text, std::vector<uint32_t>& trigrams);
+};
+
+#endif // CLTRIGRAMINDEX_HPP
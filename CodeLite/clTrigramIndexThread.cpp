@@ -0,0 +1,40 @@
+#include "clTrigramIndexThread.hpp"
+
+clTrigramIndexThread::clTrigramIndexThread(clTrigramIndex::ptr_t index)
+    : m_index(index)
+{
+}
+
+clTrigramIndexThread::~clTrigramIndexThread()
+{
+    Stop();
+    // the requests that were not executed
+    while (!m_Q.empty()) {
+        delete m_Q.front();
+        m_Q.pop();
+    }
+}
+
+void clTrigramIndexThread::Add(eRequestType type, const wxArrayString& files)
+{
+    Request* req = new Request;
+    req->type = type;
+    req->files = files;
+    WorkerThread::Add(req);
+}
+
+void clTrigramIndexThread::ProcessRequest(ThreadRequest* request)
+{
+    Request* req = static_cast<Request*>(request);
+    switch (req->type) {
+    case kSync:
+        m_index->Sync(req->files);
+        break;
+    case kUpdate:
+        m_index->Update(req->files);
+        break;
+    case kDelete:
+        m_index->Delete(req->files);
+        break;
+    }
+}
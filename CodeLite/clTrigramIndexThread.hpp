@@ -0,0 +1,44 @@
+#ifndef CLTRIGRAMINDEXTHREAD_HPP
+#define CLTRIGRAMINDEXTHREAD_HPP
+
+#include "clTrigramIndex.hpp"
+#include "codelite_exports.h"
+#include "worker_thread.h"
+
+#include <wx/arrstr.h>
+
+/**
+ * @class clTrigramIndexThread
+ * @brief updates a search index in the background. The requests are executed one after the other, in the order they
+ * were added. To stop the thread quickly, close the index before calling Stop()
+ */
+class WXDLLIMPEXP_CL clTrigramIndexThread : public WorkerThread
+{
+public:
+    enum eRequestType {
+        kSync,
+        kUpdate,
+        kDelete,
+    };
+
+    struct Request : public ThreadRequest {
+        eRequestType type = kUpdate;
+        wxArrayString files;
+    };
+
+private:
+    clTrigramIndex::ptr_t m_index;
+
+public:
+    clTrigramIndexThread(clTrigramIndex::ptr_t index);
+    virtual ~clTrigramIndexThread();
+
+    /**
+     * @brief queue a clTrigramIndex::Sync, Update or Delete call
+     */
+    void Add(eRequestType type, const wxArrayString& files);
+
+    void ProcessRequest(ThreadRequest* request) override;
+};
+
+#endif // CLTRIGRAMINDEXTHREAD_HPP
@@ -170,6 +170,26 @@ clProcessEvent::clProcessEvent(wxEventType commandType, int winid)
 {
 }
 
+const wxString& clProcessEvent::GetOutput() const
+{
+    if(m_outputPending) {
+        m_outputPending = false;
+        const std::string& raw = GetStringRaw();
+        m_output = wxString(raw.c_str(), wxConvUTF8, raw.length());
+        if(m_output.empty()) {
+            m_output = wxString::From8BitData(raw.c_str(), raw.length());
+        }
+    }
+    return m_output;
+}
+
+void clProcessEvent::SetOutputFromRaw(std::string&& output)
+{
+    SetStringRaw(std::move(output));
+    m_output.clear();
+    m_outputPending = true;
+}
+
 // --------------------------------------------------------------
 // Compiler event
 // --------------------------------------------------------------
@@ -214,6 +214,7 @@ public:
     wxArrayString& GetStrings() { return m_strings; }
     const std::string& GetStringRaw() const { return m_stringRaw; }
     void SetStringRaw(const std::string& str) { m_stringRaw = str; }
+    void SetStringRaw(std::string&& str) { m_stringRaw = std::move(str); }
     void SetSshAccount(const wxString& sshAccount) { this->m_sshAccount = sshAccount; }
     const wxString& GetSshAccount() const { return m_sshAccount; }
 };
@@ -615,7 +616,9 @@ using clGotoEventFunction = void (wxEvtHandler::*)(clGotoEvent&);
 class IProcess;
 class WXDLLIMPEXP_CL clProcessEvent : public clCommandEvent
 {
-    wxString m_output;
+    mutable wxString m_output;
+    // the output was set with SetOutputFromRaw() and is not converted yet
+    mutable bool m_outputPending = false;
     IProcess* m_process = nullptr;
 
 public:
@@ -625,9 +628,20 @@ public:
     ~clProcessEvent() override = default;
     wxEvent* Clone() const override { return new clProcessEvent(*this); }
 
-    void SetOutput(const wxString& output) { this->m_output = output; }
+    void SetOutput(const wxString& output)
+    {
+        this->m_output = output;
+        m_outputPending = false;
+    }
     void SetProcess(IProcess* process) { this->m_process = process; }
-    const wxString& GetOutput() const { return m_output; }
+    /**
+     * @brief the output as string. When set with SetOutputFromRaw(), it is converted on the first call
+     */
+    const wxString& GetOutput() const;
+    /**
+     * @brief set only the raw output, GetOutput() converts it when called
+     */
+    void SetOutputFromRaw(std::string&& output);
     void SetOutputRaw(const std::string& output) { SetStringRaw(output); }
     const std::string& GetOutputRaw() const { return GetStringRaw(); }
     IProcess* GetProcess() { return m_process; }
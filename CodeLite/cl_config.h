@@ -69,6 +69,7 @@ public:
 #define kConfigLLDBTooltipW "LLDBTooltipW"
 #define kConfigLLDBTooltipH "LLDBTooltipH"
 #define kConfigBuildAutoScroll "build-auto-scroll"
+#define kConfigFindInFilesUseIndex "FindInFilesUseIndex"
 #define kConfigCreateVirtualFoldersOnDisk "CreateVirtualFoldersOnDisk"
 #define kConfigLogVerbosity "LogVerbosity"
 #define kConfigRedirectLogOutput "RedirectLogOutput"
@@ -29,10 +29,12 @@
 #include "Cxx/CxxVariableScanner.h"
 #include "Cxx/cpp_comment_creator.h"
 #include "StdToWX.h"
+#include "clFileChangeDetector.hpp"
 #include "cl_command_event.h"
 #include "codelite_events.h"
 #include "database/tags_storage_sqlite3.h"
 #include "event_notifier.h"
+#include "file_logger.h"
 #include "fileextmanager.h"
 #include "precompiled_header.h"
 
@@ -511,43 +513,47 @@ wxString TagsManager::DoReplaceMacros(const wxString& name)
     return _name;
 }
 
-void TagsManager::FilterNonNeededFilesForRetaging(wxArrayString& strFiles, ITagsStoragePtr db)
+void TagsManager::FilterNonNeededFilesForRetaging(wxArrayString& strFiles, ITagsStoragePtr db,
+                                                  std::vector<FileEntryPtr>* fingerprints)
 {
     std::vector<FileEntryPtr> files_entries;
     db->GetFiles(files_entries);
-    std::unordered_set<wxString> files_set;
 
+    // remove duplicate entries
+    std::unordered_set<wxString> files_set;
+    wxArrayString unique_files;
+    unique_files.Alloc(strFiles.GetCount());
     for(size_t i = 0; i < strFiles.GetCount(); i++) {
-        files_set.insert(strFiles.Item(i));
+        if(files_set.insert(strFiles.Item(i)).second) {
+            unique_files.Add(strFiles.Item(i));
+        }
     }
 
-    for(size_t i = 0; i < files_entries.size(); i++) {
-        const FileEntryPtr& fe = files_entries.at(i);
-
-        // does the file exist in both lists?
-        std::unordered_set<wxString>::iterator iter = files_set.find(fe->GetFile());
-        if(iter != files_set.end()) {
-            // get the actual modification time of the file from the disk
-            struct stat buff;
-            int modified(0);
-
-            const wxCharBuffer cname = _C((*iter));
-            if(stat(cname.data(), &buff) == 0) {
-                modified = (int)buff.st_mtime;
-            }
+    clFileChangeDetector detector;
+    detector.Check(unique_files, files_entries);
 
-            // if the timestamp from the database < then the actual timestamp, re-tag the file
-            if(fe->GetLastRetaggedTimestamp() >= modified) {
-                files_set.erase(iter);
-            }
+    // the content of these files did not change, store their new fingerprint so they won't be hashed again
+    if(!detector.GetTouched().empty()) {
+        db->Begin();
+        for(const auto& fe : detector.GetTouched()) {
+            db->StoreFileEntry(*fe);
         }
+        db->Commit();
     }
 
+    const auto& stats = detector.GetStats();
+    clDEBUG() << "Checked" << unique_files.size() << "files." << stats.stat_skipped << "unchanged,"
+              << stats.hash_skipped << "touched but unchanged," << stats.modified << "to parse" << endl;
+
     // copy back the files to the array
     strFiles.Clear();
-    strFiles.Alloc(files_set.size());
-    for (const auto& s : files_set) {
-        strFiles.Add(s);
+    strFiles.Alloc(detector.GetModified().size());
+    for(const auto& fe : detector.GetModified()) {
+        strFiles.Add(fe->GetFile());
+    }
+
+    if(fingerprints) {
+        *fingerprints = std::move(detector.GetModified());
     }
 }
 
@@ -309,8 +309,11 @@ public:
      * @brief filter a recently tagged files from the strFiles array
      * @param strFiles
      * @param db
+     * @param fingerprints [output] if not null, the current fingerprint of the remaining files. Store them (see
+     * ITagsStorage::StoreFileEntry) once the files are parsed
      */
-    void FilterNonNeededFilesForRetaging(wxArrayString& strFiles, ITagsStoragePtr db);
+    void FilterNonNeededFilesForRetaging(wxArrayString& strFiles, ITagsStoragePtr db,
+                                         std::vector<FileEntryPtr>* fingerprints = nullptr);
 
     /**
      * @brief insert functionBody into clsname. This function will search for best location
@@ -28,6 +28,7 @@
 #include "CompletionHelper.hpp"
 #include "Cxx/CxxScannerTokens.h"
 #include "Cxx/CxxTokenizer.h"
+#include "JSONReader.hpp"
 #include "ctags_manager.h"
 #include "language.h"
 #include "macros.h"
@@ -36,21 +37,90 @@
 #include "tokenizer.h"
 #include "wxStringHash.h"
 
+#include <charconv>
+#include <wx/filename.h>
 #include <wx/regex.h>
 #include <wx/tokenzr.h>
 
+namespace
+{
+// same characters as wxString::Trim()
+inline bool is_space(char ch)
+{
+    return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n' || ch == '\v' || ch == '\f';
+}
+
+std::string_view trim_right(std::string_view str)
+{
+    while(!str.empty() && is_space(str.back())) {
+        str.remove_suffix(1);
+    }
+    return str;
+}
+
+std::string_view trim(std::string_view str)
+{
+    while(!str.empty() && is_space(str.front())) {
+        str.remove_prefix(1);
+    }
+    return trim_right(str);
+}
+
+/// return the part of `str` before the first `delim` and keep the part after it in `str` (like BeforeFirst/AfterFirst)
+std::string_view next_field(std::string_view& str, char delim)
+{
+    size_t where = str.find(delim);
+    std::string_view field = str.substr(0, where);
+    str.remove_prefix(where == std::string_view::npos ? str.length() : where + 1);
+    return field;
+}
+
+inline wxString to_wx(std::string_view str) { return wxString::FromUTF8(str.data(), str.length()); }
+
+/// like wxString::ToLong(), the leading digits are used even if followed by garbage
+void to_long(std::string_view str, long* value)
+{
+    if(!str.empty() && str.front() == '+') {
+        str.remove_prefix(1);
+    }
+    long v = 0;
+    auto res = std::from_chars(str.data(), str.data() + str.length(), v);
+    if(res.ptr != str.data()) {
+        *value = v;
+    }
+}
+
+/// remove the anonymous parts of a struct / union scope
+wxString remove_anonymous_scopes(std::string_view scope)
+{
+    std::string fixed;
+    while(!scope.empty()) {
+        std::string_view part = next_field(scope, ':');
+        if(part.empty() || part.starts_with("__anon")) {
+            continue;
+        }
+        if(!fixed.empty()) {
+            fixed += "::";
+        }
+        fixed += part;
+    }
+    return to_wx(fixed);
+}
+} // namespace
+
 TagEntry::TagEntry()
     : m_path(wxEmptyString)
-    , m_file(wxEmptyString)
+    , m_file(clStringPool::Get().Intern(wxEmptyString))
     , m_lineNumber(-1)
     , m_pattern(wxEmptyString)
-    , m_kind("<unknown>")
-    , m_parent(wxEmptyString)
+    , m_parent(m_file)
     , m_name(wxEmptyString)
     , m_id(wxNOT_FOUND)
-    , m_scope(wxEmptyString)
+    , m_scope(m_file)
     , m_flags(0)
 {
+    static const clStringPool::Ptr_t unknown_kind = clStringPool::Get().Intern("<unknown>");
+    m_kind = unknown_kind;
 }
 
 TagEntry::TagEntry(const TagEntry& rhs) { *this = rhs; }
@@ -58,9 +128,9 @@ TagEntry::TagEntry(const TagEntry& rhs) { *this = rhs; }
 TagEntry& TagEntry::operator=(const TagEntry& rhs)
 {
     m_id = rhs.m_id;
-    m_file = rhs.m_file.c_str();
-    m_kind = rhs.m_kind.c_str();
-    m_parent = rhs.m_parent.c_str();
+    m_file = rhs.m_file;
+    m_kind = rhs.m_kind;
+    m_parent = rhs.m_parent;
     m_pattern = rhs.m_pattern.c_str();
     m_lineNumber = rhs.m_lineNumber;
     m_name = rhs.m_name.c_str();
@@ -68,7 +138,7 @@ TagEntry& TagEntry::operator=(const TagEntry& rhs)
 #if wxUSE_GUI
     m_hti = rhs.m_hti;
 #endif
-    m_scope = rhs.m_scope.c_str();
+    m_scope = rhs.m_scope;
     m_flags = rhs.m_flags;
 
     // loop over the map and copy item by item
@@ -85,6 +155,7 @@ TagEntry& TagEntry::operator=(const TagEntry& rhs)
 bool TagEntry::operator==(const TagEntry& rhs) const
 {
     // Note: tree item id is not used in this function!
+    // the scope, file, kind and parent are interned: comparing their addresses is enough
     bool res = m_scope == rhs.m_scope && m_file == rhs.m_file && m_kind == rhs.m_kind && m_parent == rhs.m_parent &&
                m_pattern == rhs.m_pattern && m_name == rhs.m_name && m_path == rhs.m_path &&
                m_lineNumber == rhs.m_lineNumber && GetInheritsAsString() == rhs.GetInheritsAsString() &&
@@ -94,14 +165,20 @@ bool TagEntry::operator==(const TagEntry& rhs) const
 
 void TagEntry::Create(const wxString& fileName, const wxString& name, int lineNumber, const wxString& pattern,
                       const wxString& kind, wxStringMap_t& extFields)
+{
+    DoCreate(wxFileName(fileName).GetFullPath(), name, lineNumber, pattern, kind, wxStringMap_t(extFields));
+}
+
+void TagEntry::DoCreate(const wxString& fullpath, const wxString& name, int lineNumber, const wxString& pattern,
+                        const wxString& kind, wxStringMap_t&& extFields)
 {
     m_flags = 0;
-    m_extFields = extFields;
+    m_extFields = std::move(extFields);
     SetName(name);
     SetLine(lineNumber);
     SetKind(kind.IsEmpty() ? "<unknown>" : kind);
     SetPattern(pattern);
-    SetFile(wxFileName(fileName).GetFullPath());
+    SetFile(fullpath);
     SetId(-1);
 
     wxString path;
@@ -222,13 +299,6 @@ bool TagEntry::IsClassTemplate() const
 
 wxString TagEntry::GetScopeName() const { return GetScope(); }
 
-wxString TagEntry::GetKind() const
-{
-    wxString kind(m_kind);
-    kind.Trim();
-    return kind;
-}
-
 const bool TagEntry::IsContainer() const
 {
     return IsClass() || IsStruct() || IsUnion() || IsNamespace() || IsEnumClass();
@@ -263,99 +333,137 @@ wxString TagEntry::GetPattern() const
 }
 
 void TagEntry::FromLine(const wxString& line)
+{
+    const wxScopedCharBuffer utf8 = line.utf8_str();
+    FromLine(std::string_view{ utf8.data(), utf8.length() });
+}
+
+bool TagEntry::FromLine(std::string_view line, LineCache* cache)
 {
     // label	C:\src\wxCustomControls\clTreeCtrl\clChoice.cpp	/^        const wxString& label = m_choices[i];$/;"
     // local line:116	type:const wxString
-    wxString pattern, kind;
-    wxString strLine = line;
     long lineNumber = wxNOT_FOUND;
     wxStringMap_t extFields;
 
     // get the token name
-    wxString name = strLine.BeforeFirst('\t');
-    strLine = strLine.AfterFirst('\t');
+    std::string_view name = next_field(line, '\t');
 
     // get the file name
-    wxString fileName = strLine.BeforeFirst('\t');
-    strLine = strLine.AfterFirst('\t');
+    std::string_view fileName = next_field(line, '\t');
 
     // here we can get two options:
     // pattern followed by ;"
     // or
     // line number followed by ;"
-    int end = strLine.Find(";\"");
-    if(end == wxNOT_FOUND) {
+    size_t end = line.find(";\"");
+    if(end == std::string_view::npos) {
         // invalid pattern found
-        return;
+        return false;
     }
 
-    if(strLine.StartsWith("/^")) {
-        // regular expression pattern found
-        pattern = strLine.Mid(0, end);
-        strLine = strLine.Right(strLine.Length() - (end + 2));
-    } else {
+    std::string_view pattern = line.substr(0, end);
+    line.remove_prefix(end + 2);
+    if(!pattern.starts_with("/^")) {
         // line number pattern found, this is usually the case when
         // dealing with macros in C++
-        pattern = strLine.Mid(0, end);
-        strLine = strLine.Right(strLine.Length() - (end + 2));
-
-        pattern = pattern.Trim();
-        pattern = pattern.Trim(false);
-        pattern.ToLong(&lineNumber);
+        pattern = trim(pattern);
+        to_long(pattern, &lineNumber);
     }
 
     // next is the kind of the token
-    if(strLine.StartsWith("\t")) {
-        strLine = strLine.AfterFirst('\t');
-    }
-
-    kind = strLine.BeforeFirst('\t');
-    strLine = strLine.AfterFirst('\t');
-
-    if(strLine.IsEmpty() == false) {
-        wxStringTokenizer tkz(strLine, '\t');
-        while(tkz.HasMoreTokens()) {
-            wxString token = tkz.NextToken();
-            wxString key = token.BeforeFirst(':');
-            wxString val = token.AfterFirst(':');
-            key = key.Trim();
-            key = key.Trim(false);
-
-            val = val.Trim();
-            val = val.Trim(false);
-            if(key == "line" && !val.IsEmpty()) {
-                val.ToLong(&lineNumber);
-            } else {
-                if(key == "union" || key == "struct") {
-
-                    // remove the anonymous part of the struct / union
-                    if(!val.StartsWith("__anon")) {
-                        // an internal anonymous union / struct
-                        // remove all parts of the
-                        wxArrayString scopeArr;
-                        wxString tmp, new_val;
-
-                        scopeArr = wxStringTokenize(val, ":", wxTOKEN_STRTOK);
-                        for(size_t i = 0; i < scopeArr.GetCount(); i++) {
-                            if(scopeArr.Item(i).StartsWith("__anon") == false) {
-                                tmp << scopeArr.Item(i) << "::";
-                            }
-                        }
-
-                        tmp.EndsWith("::", &new_val);
-                        val.swap(new_val);
-                    }
-                }
-                extFields.insert({ key, val });
-            }
+    if(line.starts_with('\t')) {
+        line.remove_prefix(1);
+    }
+    std::string_view kind = next_field(line, '\t');
+
+    while(!line.empty()) {
+        std::string_view token = next_field(line, '\t');
+        if(token.empty()) {
+            continue;
+        }
+
+        size_t colon = token.find(':');
+        std::string_view key = trim(token.substr(0, colon));
+        std::string_view val = colon == std::string_view::npos ? std::string_view{} : trim(token.substr(colon + 1));
+        if(key == "line" && !val.empty()) {
+            to_long(val, &lineNumber);
+        } else if((key == "union" || key == "struct") && !val.starts_with("__anon")) {
+            // an internal anonymous union / struct, remove the anonymous parts of the scope
+            extFields.insert({ to_wx(key), remove_anonymous_scopes(val) });
+        } else {
+            extFields.insert({ to_wx(key), to_wx(val) });
+        }
+    }
+
+    fileName = trim_right(fileName);
+    wxString fullpath;
+    if(cache && (cache->fixed || (!cache->file.empty() && cache->file == fileName))) {
+        fullpath = cache->fullpath;
+    } else {
+        fullpath = wxFileName(to_wx(fileName)).GetFullPath();
+        if(cache) {
+            cache->file = fileName;
+            cache->fullpath = fullpath;
         }
     }
 
-    kind = kind.Trim();
-    name = name.Trim();
-    fileName = fileName.Trim();
-    pattern = pattern.Trim();
-    Create(fileName, name, lineNumber, pattern, kind, extFields);
+    DoCreate(fullpath, to_wx(trim_right(name)), lineNumber, to_wx(trim_right(pattern)), to_wx(trim_right(kind)),
+             std::move(extFields));
+    return true;
+}
+
+bool TagEntry::FromCTagsJSON(const JSONReaderItem& json)
+{
+    // {"_type": "tag", "name": "x", "path": "a.cpp", "pattern": "/^  int x;$/", "line": 7, "kind": "member",
+    // "scope": "Foo", "scopeKind": "class", "access": "public"}
+    if(json["_type"].toStringView() != "tag") {
+        return false;
+    }
+
+    std::string_view name, path, pattern, kind, scope, scope_kind;
+    long lineNumber = wxNOT_FOUND;
+    wxStringMap_t extFields;
+    for(auto field = json.firstChild(); field.isOk(); field = field.nextSibling()) {
+        std::string_view key = field.GetPropertyNameView();
+        if(key == "_type") {
+            continue;
+        } else if(key == "name") {
+            name = field.toStringView();
+        } else if(key == "path") {
+            path = field.toStringView();
+        } else if(key == "pattern") {
+            pattern = field.toStringView();
+        } else if(key == "kind") {
+            kind = field.toStringView();
+        } else if(key == "line") {
+            lineNumber = field.toInt(wxNOT_FOUND);
+        } else if(key == "scope") {
+            scope = field.toStringView();
+        } else if(key == "scopeKind") {
+            scope_kind = field.toStringView();
+        } else if(field.isString()) {
+            extFields.insert({ to_wx(key), to_wx(field.toStringView()) });
+        } else if(field.isBool() && field.toBool()) {
+            // e.g. "file": true, which is written as "file:" in the tags file
+            extFields.insert({ to_wx(key), wxEmptyString });
+        }
+    }
+
+    if(name.empty()) {
+        return false;
+    }
+
+    if(!scope_kind.empty()) {
+        if((scope_kind == "union" || scope_kind == "struct") && !scope.starts_with("__anon")) {
+            extFields.insert({ to_wx(scope_kind), remove_anonymous_scopes(scope) });
+        } else {
+            extFields.insert({ to_wx(scope_kind), to_wx(scope) });
+        }
+    }
+
+    DoCreate(wxFileName(to_wx(path)).GetFullPath(), to_wx(name), lineNumber, to_wx(pattern), to_wx(kind),
+             std::move(extFields));
+    return true;
 }
 
 bool TagEntry::IsConstructor() const
@@ -657,12 +765,16 @@ std::unordered_map<wxString, eTagKind> g_kind_table = {
 void TagEntry::SetKind(const wxString& kind)
 {
     // set the string kind
-    m_kind = kind;
-    // turn on bits
-    m_tag_kind = eTagKind::TAG_KIND_UNKNOWN;
-    if(g_kind_table.count(m_kind)) {
-        m_tag_kind = g_kind_table[m_kind];
+    if(!kind.empty() && wxIsspace(kind.Last())) {
+        wxString trimmed = kind;
+        m_kind = clStringPool::Get().Intern(trimmed.Trim());
+    } else {
+        m_kind = clStringPool::Get().Intern(kind);
     }
+
+    // turn on bits
+    auto iter = g_kind_table.find(*m_kind);
+    m_tag_kind = iter == g_kind_table.end() ? eTagKind::TAG_KIND_UNKNOWN : iter->second;
 }
 
 namespace
@@ -30,15 +30,19 @@
 #include <wx/treectrl.h>
 #endif
 
+#include "clStringPool.hpp"
 #include "codelite_exports.h"
 #include "macros.h"
 
 #include <map>
 #include <memory>
+#include <string>
+#include <string_view>
 #include <vector>
 #include <wx/string.h>
 
 class TagEntry;
+class JSONReaderItem;
 using TagEntryPtr = std::shared_ptr<TagEntry>;
 using TagEntryPtrVector_t = std::vector<TagEntryPtr>;
 
@@ -110,19 +114,21 @@ private:
     };
 
 private:
-    wxString m_path;    ///< Tag full path
-    wxString m_file;    ///< File this tag is found
-    int m_lineNumber;   ///< Line number
-    wxString m_pattern; ///< A pattern that can be used to locate the tag in the file
-    wxString m_kind;    ///< Member, function, class, typedef etc.
-    wxString m_parent;  ///< Direct parent
+    // the file, kind, parent and scope are shared by many tags, they point to strings interned in
+    // clStringPool::Get(). Two interned strings are equal only if they have the same address
+    wxString m_path;              ///< Tag full path
+    clStringPool::Ptr_t m_file;   ///< File this tag is found
+    int m_lineNumber;             ///< Line number
+    wxString m_pattern;           ///< A pattern that can be used to locate the tag in the file
+    clStringPool::Ptr_t m_kind;   ///< Member, function, class, typedef etc.
+    clStringPool::Ptr_t m_parent; ///< Direct parent
 #if wxUSE_GUI
     wxTreeItemId m_hti; ///< Handle to tree item, not persistent item
 #endif
     wxString m_name;           ///< Tag name (short name, excluding any scope names)
     wxStringMap_t m_extFields; ///< Additional extension fields
     long m_id;
-    wxString m_scope;
+    clStringPool::Ptr_t m_scope;
     size_t m_flags;     // This member is not saved into the database
     wxString m_comment; // This member is not saved into the database
     wxString m_template_definition;
@@ -167,8 +173,36 @@ public:
      */
     TagEntry();
 
+    /**
+     * @brief remembers the last file name converted by FromLine(std::string_view). ctags writes the tags of a file
+     * one after the other, so the same file name is converted once per file instead of once per tag. Use one instance
+     * for all the lines of a given output
+     */
+    struct LineCache {
+        std::string file;
+        wxString fullpath;
+        /// when true, the file name of the lines is ignored: all the tags are in `fullpath`
+        bool fixed = false;
+    };
+
     void FromLine(const wxString& line);
 
+    /**
+     * @brief construct the tag from a ctags output line encoded in UTF-8. The line is split in place, only the final
+     * values are converted into wxString
+     * @param cache optional, see LineCache
+     * @return false if the line is not a valid ctags line
+     */
+    bool FromLine(std::string_view line, LineCache* cache = nullptr);
+
+    /**
+     * @brief construct the tag from a `{"_type": "tag", ...}` object written by ctags in JSON output (or
+     * interactive) mode. The scope fields (`scope` and `scopeKind`) are converted into the extension field that
+     * FromLine() would have created
+     * @return false if `json` is not a tag object
+     */
+    bool FromCTagsJSON(const JSONReaderItem& json);
+
     bool IsClassTemplate() const;
     wxString GetTemplateDefinition() const;
 
@@ -311,8 +345,8 @@ public:
     const wxString& GetPath() const { return m_path; }
     void SetPath(const wxString& path) { m_path = path; }
 
-    const wxString& GetFile() const { return m_file; }
-    void SetFile(const wxString& file) { m_file = file; }
+    const wxString& GetFile() const { return *m_file; }
+    void SetFile(const wxString& file) { m_file = clStringPool::Get().Intern(file); }
 
     int GetLine() const { return m_lineNumber; }
     void SetLine(int line) { m_lineNumber = line; }
@@ -325,11 +359,11 @@ public:
 
     void SetPattern(const wxString& pattern) { m_pattern = pattern; }
 
-    wxString GetKind() const;
+    const wxString& GetKind() const { return *m_kind; }
     void SetKind(const wxString& kind);
 
-    const wxString& GetParent() const { return m_parent; }
-    void SetParent(const wxString& parent) { m_parent = parent; }
+    const wxString& GetParent() const { return *m_parent; }
+    void SetParent(const wxString& parent) { m_parent = clStringPool::Get().Intern(parent); }
 #if wxUSE_GUI
     wxTreeItemId& GetTreeItemId() { return m_hti; }
     void SetTreeItemId(wxTreeItemId& hti) { m_hti = hti; }
@@ -352,8 +386,8 @@ public:
     void SetMacrodef(const wxString& value);
     void SetTemplateDefinition(const wxString& def) { set_extra_field("template", def); }
 
-    const wxString& GetScope() const { return m_scope; }
-    void SetScope(const wxString& scope) { m_scope = scope; }
+    const wxString& GetScope() const { return *m_scope; }
+    void SetScope(const wxString& scope) { m_scope = clStringPool::Get().Intern(scope); }
 
     /**
      * \return Scope name of the tag.
@@ -403,6 +437,12 @@ private:
      * \param path path to add
      */
     void UpdatePath(wxString& path);
+
+    /**
+     * Same as Create(), but `fullpath` is already normalised
+     */
+    void DoCreate(const wxString& fullpath, const wxString& name, int lineNumber, const wxString& pattern,
+                  const wxString& kind, wxStringMap_t&& extFields);
 };
 
 #endif // CODELITE_ENTRY_H
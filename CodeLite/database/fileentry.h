@@ -26,6 +26,7 @@
 #ifndef __fileentry__
 #define __fileentry__
 
+#include <cstdint>
 #include <memory>
 #include <wx/string.h>
 
@@ -34,6 +35,10 @@ class FileEntry
 	long      m_id;
 	wxString  m_file;
 	int       m_lastRetaggedTimestamp;
+	// the file fingerprint at the time it was parsed: modification time (nanoseconds), size and content hash
+	long long m_modified = 0;
+	long long m_size = -1;
+	uint64_t  m_hash = 0;
 
 public:
 	FileEntry();
@@ -50,6 +55,16 @@ public:
 	int GetLastRetaggedTimestamp() const { return m_lastRetaggedTimestamp; }
 	void SetId(long id) { this->m_id = id; }
 	long GetId() const { return m_id; }
+	void SetModified(long long modified) { this->m_modified = modified; }
+	long long GetModified() const { return m_modified; }
+	void SetSize(long long size) { this->m_size = size; }
+	long long GetSize() const { return m_size; }
+	void SetHash(uint64_t hash) { this->m_hash = hash; }
+	uint64_t GetHash() const { return m_hash; }
+	/**
+	 * @brief does this entry contain a fingerprint? (entries created by older versions or from unsaved buffers don't)
+	 */
+	bool HasFingerprint() const { return m_size >= 0; }
 };
 using FileEntryPtr = std::unique_ptr<FileEntry>;
 
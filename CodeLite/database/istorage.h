@@ -217,6 +217,11 @@ public:
      */
     virtual int UpdateFileEntry(const wxString& filename, int timestamp) = 0;
 
+    /**
+     * @brief insert or replace an entry, including the file fingerprint (modification time, size and hash)
+     */
+    virtual int StoreFileEntry(const FileEntry& entry) = 0;
+
     // -------------------------- TagEntry -------------------------------------------
     /**
      * Return a result set of tags according to file name.
@@ -269,6 +274,22 @@ public:
      */
     virtual void Store(const std::vector<TagEntryPtr>& tags, bool auto_commit = true) = 0;
 
+    /**
+     * @brief return true if the database contains at least one tag
+     */
+    virtual bool HasTags() = 0;
+
+    /**
+     * @brief prepare the storage for storing a large number of tags, e.g. the first indexing of a workspace. Until
+     * EndBulkLoad() is called the search indexes are not maintained, so the searches are slower
+     */
+    virtual void BeginBulkLoad() = 0;
+
+    /**
+     * @brief rebuild the indexes dropped by BeginBulkLoad()
+     */
+    virtual void EndBulkLoad() = 0;
+
     /**
      * return list of files from the database. The returned list is ordered
      * by name (ascending)
@@ -34,6 +34,53 @@
 #include <wx/longlong.h>
 #include <wx/tokenzr.h>
 
+namespace
+{
+// the trigram tokenizer can not match strings shorter than this
+constexpr size_t TRIGRAM_MIN_LENGTH = 3;
+
+// the page cache size used while bulk loading
+constexpr int BULK_LOAD_CACHE_SIZE_KB = 64 * 1024;
+
+const wxString INSERT_TAG_SQL = "INSERT OR REPLACE INTO TAGS VALUES (NULL, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)";
+
+struct IndexDefinition {
+    const char* name;
+    const char* columns;
+};
+
+// indexes used only by the searches. The indexes used while storing tags (TAGS_UNIQ, FILE_IDX and
+// global_tags_idx_2, used by the tags_delete trigger) are not listed here
+const IndexDefinition SEARCH_INDEXES[] = {
+    { "KIND_IDX", "tags(kind)" },           { "global_tags_idx_1", "global_tags(name)" },
+    { "TAGS_NAME", "tags(name)" },          { "TAGS_SCOPE", "tags(scope)" },
+    { "TAGS_PATH", "tags(path)" },          { "TAGS_PARENT", "tags(parent)" },
+    { "TAGS_TYPEREF", "tags(typeref)" },
+};
+
+// ranking all the matches of a short string (bm25 or any ORDER BY) costs more than the LIKE scan it replaces, so only
+// the first matches found by the index are ranked: this many per requested result
+constexpr int TRIGRAM_CANDIDATES_PER_RESULT = 4;
+
+wxString escape_sql_literal(const wxString& str)
+{
+    wxString escaped = str;
+    escaped.Replace("'", "''");
+    return escaped;
+}
+
+/// return an FTS5 query matching `text` anywhere in `column`, escaped for an SQL string literal
+wxString fts_substring_query(const wxString& column, const wxString& text)
+{
+    wxString phrase = text;
+    phrase.Replace("\"", "\"\"");
+
+    wxString query;
+    query << "{" << column << "} : \"" << phrase << "\"";
+    return escape_sql_literal(query);
+}
+} // namespace
+
 //-------------------------------------------------
 // Tags database class implementation
 //-------------------------------------------------
@@ -46,6 +93,10 @@ TagsStorageSQLite::TagsStorageSQLite()
 
 TagsStorageSQLite::~TagsStorageSQLite()
 {
+    if(m_bulkLoading) {
+        EndBulkLoad();
+    }
+
     if(m_db) {
         m_db->Close();
         delete m_db;
@@ -110,6 +161,10 @@ void TagsStorageSQLite::CreateSchema()
         sql = wxT("PRAGMA case_sensitive_like = 0;");
         m_db->ExecuteUpdate(sql);
 
+        // let "INSERT OR REPLACE" fire the delete triggers for the rows it replaces
+        sql = wxT("PRAGMA recursive_triggers = ON;");
+        m_db->ExecuteUpdate(sql);
+
         sql = wxT("create  table if not exists tags (ID INTEGER PRIMARY KEY AUTOINCREMENT, name string, file string, "
                   "line integer, kind string, access string, signature string, pattern string, parent string, inherits "
                   "string, path string, typeref string, scope string, template_definition string, tag_properties "
@@ -121,9 +176,19 @@ void TagsStorageSQLite::CreateSchema()
         m_db->ExecuteUpdate(sql);
 
         sql = wxT("create  table if not exists FILES (ID INTEGER PRIMARY KEY AUTOINCREMENT, file string, last_retagged "
-                  "integer);");
+                  "integer, modified integer, size integer, hash integer);");
         m_db->ExecuteUpdate(sql);
 
+        // databases created by older versions don't have the fingerprint columns
+        for(const wxString& column : { "modified", "size", "hash" }) {
+            try {
+                m_db->ExecuteUpdate(wxString() << "ALTER TABLE FILES ADD COLUMN " << column << " integer");
+            } catch (const wxSQLite3Exception& e) {
+                // the column already exists
+                wxUnusedVar(e);
+            }
+        }
+
         sql = wxT("create  table if not exists MACROS (ID INTEGER PRIMARY KEY AUTOINCREMENT, file string, line "
                   "integer, name string, is_function_like int, replacement string, signature string);");
         m_db->ExecuteUpdate(sql);
@@ -154,36 +219,17 @@ void TagsStorageSQLite::CreateSchema()
                   "template_definition);");
         m_db->ExecuteUpdate(sql);
 
-        sql = wxT("CREATE INDEX IF NOT EXISTS KIND_IDX on tags(kind);");
-        m_db->ExecuteUpdate(sql);
-
         sql = wxT("CREATE INDEX IF NOT EXISTS FILE_IDX on tags(file);");
         m_db->ExecuteUpdate(sql);
 
         sql = wxT("CREATE UNIQUE INDEX IF NOT EXISTS MACROS_UNIQ on MACROS(name);");
         m_db->ExecuteUpdate(sql);
 
-        sql = wxT("CREATE INDEX IF NOT EXISTS global_tags_idx_1 on global_tags(name);");
-        m_db->ExecuteUpdate(sql);
-
         sql = wxT("CREATE INDEX IF NOT EXISTS global_tags_idx_2 on global_tags(tag_id);");
         m_db->ExecuteUpdate(sql);
 
         // Create search indexes
-        sql = wxT("CREATE INDEX IF NOT EXISTS TAGS_NAME on tags(name);");
-        m_db->ExecuteUpdate(sql);
-
-        sql = wxT("CREATE INDEX IF NOT EXISTS TAGS_SCOPE on tags(scope);");
-        m_db->ExecuteUpdate(sql);
-
-        sql = wxT("CREATE INDEX IF NOT EXISTS TAGS_PATH on tags(path);");
-        m_db->ExecuteUpdate(sql);
-
-        sql = wxT("CREATE INDEX IF NOT EXISTS TAGS_PARENT on tags(parent);");
-        m_db->ExecuteUpdate(sql);
-
-        sql = wxT("CREATE INDEX IF NOT EXISTS TAGS_TYPEREF on tags(typeref);");
-        m_db->ExecuteUpdate(sql);
+        DoCreateSearchIndexes();
 
         sql = wxT("CREATE INDEX IF NOT EXISTS MACROS_NAME on MACROS(name);");
         m_db->ExecuteUpdate(sql);
@@ -203,6 +249,134 @@ void TagsStorageSQLite::CreateSchema()
     } catch (const wxSQLite3Exception& e) {
         wxUnusedVar(e);
     }
+    DoCreateTrigramIndex(false);
+}
+
+void TagsStorageSQLite::DoCreateSearchIndexes()
+{
+    for(const auto& index : SEARCH_INDEXES) {
+        m_db->ExecuteUpdate(wxString() << "CREATE INDEX IF NOT EXISTS " << index.name << " on " << index.columns << ";");
+    }
+}
+
+void TagsStorageSQLite::DoCreateTrigramIndex(bool rebuild)
+{
+    // "name LIKE '%foo%'" can not use the TAGS_NAME index and scans the whole table. When SQLite supports it, keep a
+    // trigram index of the names and paths for the substring searches
+    m_hasTrigramIndex = false;
+    try {
+        bool exists = m_db->TableExists("tags_fts");
+        if(!exists) {
+            m_db->ExecuteUpdate("CREATE VIRTUAL TABLE tags_fts USING fts5(name, path, content='tags', "
+                                "content_rowid='ID', tokenize='trigram');");
+        }
+
+        m_db->ExecuteUpdate("CREATE TRIGGER IF NOT EXISTS tags_fts_insert AFTER INSERT ON tags FOR EACH ROW "
+                            "BEGIN "
+                            "    INSERT INTO tags_fts (rowid, name, path) VALUES (NEW.ID, NEW.name, NEW.path);"
+                            "END;");
+        m_db->ExecuteUpdate(
+            "CREATE TRIGGER IF NOT EXISTS tags_fts_delete AFTER DELETE ON tags FOR EACH ROW "
+            "BEGIN "
+            "    INSERT INTO tags_fts (tags_fts, rowid, name, path) VALUES ('delete', OLD.ID, OLD.name, OLD.path);"
+            "END;");
+
+        if(!exists || rebuild) {
+            // index the tags that were stored before the index existed
+            m_db->ExecuteUpdate("INSERT INTO tags_fts (tags_fts) VALUES ('rebuild');");
+        }
+        m_hasTrigramIndex = true;
+
+    } catch (const wxSQLite3Exception& e) {
+        clDEBUG() << "Substring tag searches will not be indexed:" << e.GetMessage() << endl;
+    }
+}
+
+bool TagsStorageSQLite::HasTags()
+{
+    try {
+        wxSQLite3ResultSet rs = m_db->ExecuteQuery("select 1 from tags limit 1");
+        return rs.NextRow();
+    } catch (const wxSQLite3Exception& e) {
+        clWARNING() << "TagsStorageSQLite::HasTags() error:" << e.GetMessage() << endl;
+    }
+    return false;
+}
+
+void TagsStorageSQLite::BeginBulkLoad()
+{
+    if(m_bulkLoading) {
+        return;
+    }
+
+    // set the flag first: if we fail half way, EndBulkLoad() restores whatever was dropped
+    m_bulkLoading = true;
+    m_bulkLoadCount = 0;
+    m_bulkLoadStopWatch.Start();
+    try {
+        m_bulkLoadCacheSize = m_db->ExecuteScalar("PRAGMA cache_size;");
+        for(const auto& index : SEARCH_INDEXES) {
+            m_db->ExecuteUpdate(wxString() << "DROP INDEX IF EXISTS " << index.name << ";");
+        }
+
+        // the trigram index is rebuilt from the tags table in a single pass by EndBulkLoad(). If we never get there,
+        // the next OpenDatabase() creates it again
+        m_hasTrigramIndex = false;
+        m_db->ExecuteUpdate("DROP TRIGGER IF EXISTS tags_fts_insert;");
+        m_db->ExecuteUpdate("DROP TRIGGER IF EXISTS tags_fts_delete;");
+        m_db->ExecuteUpdate("DROP TABLE IF EXISTS tags_fts;");
+
+        // a larger page cache (in KiB) for the inserts and for sorting the indexes at the end
+        m_db->ExecuteUpdate(wxString() << "PRAGMA cache_size = -" << BULK_LOAD_CACHE_SIZE_KB << ";");
+        m_bulkInsertStatement = m_db->GetPrepareStatement(INSERT_TAG_SQL);
+
+    } catch (const wxSQLite3Exception& e) {
+        clWARNING() << "TagsStorageSQLite::BeginBulkLoad() error:" << e.GetMessage() << endl;
+        EndBulkLoad();
+    }
+}
+
+void TagsStorageSQLite::EndBulkLoad()
+{
+    if(!m_bulkLoading) {
+        return;
+    }
+
+    m_bulkLoading = false;
+    try {
+        m_bulkInsertStatement.Finalize();
+    } catch (const wxSQLite3Exception& e) {
+        clDEBUG() << "Failed to finalize the bulk insert statement:" << e.GetMessage() << endl;
+    }
+    long store_ms = m_bulkLoadStopWatch.Time();
+
+    wxStopWatch sw;
+    long indexes_ms = 0;
+    long fts_ms = 0;
+    long analyze_ms = 0;
+    try {
+        DoCreateSearchIndexes();
+        indexes_ms = sw.Time();
+
+        sw.Start();
+        DoCreateTrigramIndex(true);
+        fts_ms = sw.Time();
+
+        // collect statistics for the query planner, sampling at most analysis_limit rows per index
+        sw.Start();
+        m_db->ExecuteUpdate("PRAGMA analysis_limit = 1000;");
+        m_db->ExecuteUpdate("ANALYZE;");
+        analyze_ms = sw.Time();
+
+        m_db->ExecuteUpdate(wxString() << "PRAGMA cache_size = " << m_bulkLoadCacheSize << ";");
+
+    } catch (const wxSQLite3Exception& e) {
+        clWARNING() << "TagsStorageSQLite::EndBulkLoad() error:" << e.GetMessage() << endl;
+    }
+
+    clSYSTEM() << "Bulk load of" << m_bulkLoadCount << "tags completed in" << m_bulkLoadStopWatch.Time()
+               << "ms. Storing tags:" << store_ms << "ms, search indexes:" << indexes_ms
+               << "ms, trigram index:" << fts_ms << "ms, analyze:" << analyze_ms << "ms" << endl;
 }
 
 wxString TagsStorageSQLite::GetSchemaVersion() const
@@ -266,6 +440,9 @@ void TagsStorageSQLite::Store(const std::vector<TagEntryPtr>& tags, bool auto_co
                 continue;
             DoInsertTagEntry(*tag);
         }
+        if(m_bulkLoading) {
+            m_bulkLoadCount += tags.size();
+        }
     } catch (const wxSQLite3Exception& e) {
         clWARNING() << "TagsStorageSQLite::Store(): failed to insert entries into the db. " << e.GetMessage() << endl;
         SAFE_ROLLBACK_IF_NEEDED(auto_commit);
@@ -396,8 +573,8 @@ void TagsStorageSQLite::GetFiles(const wxString& partialName, std::vector<FileEn
         wxString query;
         wxString tmpName(partialName);
         tmpName.Replace(wxT("_"), wxT("^_"));
-        query << wxT("select * from files where file like '%%") << tmpName << wxT("%%' ESCAPE '^' ")
-              << wxT("order by file");
+        query << wxT("select ID, file, last_retagged, modified, size, hash from files where file like '%%") << tmpName
+              << wxT("%%' ESCAPE '^' ") << wxT("order by file");
 
         wxSQLite3ResultSet res = m_db->ExecuteQuery(query);
         while(res.NextRow()) {
@@ -406,6 +583,9 @@ void TagsStorageSQLite::GetFiles(const wxString& partialName, std::vector<FileEn
             fe->SetId(res.GetInt(0));
             fe->SetFile(res.GetString(1));
             fe->SetLastRetaggedTimestamp(res.GetInt(2));
+            fe->SetModified(res.GetInt64(3).GetValue());
+            fe->SetSize(res.GetInt64(4, -1).GetValue());
+            fe->SetHash(res.GetInt64(5).GetValue());
 
             wxFileName fileName(fe->GetFile());
             wxString match = match_path ? fileName.GetFullPath() : fileName.GetFullName();
@@ -431,7 +611,7 @@ void TagsStorageSQLite::GetFiles(const wxString& partialName, std::vector<FileEn
 void TagsStorageSQLite::GetFiles(std::vector<FileEntryPtr>& files)
 {
     try {
-        wxString query(wxT("select * from files order by file"));
+        wxString query(wxT("select ID, file, last_retagged, modified, size, hash from files order by file"));
         wxSQLite3ResultSet res = m_db->ExecuteQuery(query);
 
         // Pre allocate a reasonable amount of entries
@@ -442,6 +622,9 @@ void TagsStorageSQLite::GetFiles(std::vector<FileEntryPtr>& files)
             fe->SetId(res.GetInt(0));
             fe->SetFile(res.GetString(1));
             fe->SetLastRetaggedTimestamp(res.GetInt(2));
+            fe->SetModified(res.GetInt64(3).GetValue());
+            fe->SetSize(res.GetInt64(4, -1).GetValue());
+            fe->SetHash(res.GetInt64(5).GetValue());
 
             files.push_back(std::move(fe));
         }
@@ -742,7 +925,7 @@ int TagsStorageSQLite::InsertFileEntry(const wxString& filename, int timestamp)
 {
     try {
         wxSQLite3Statement statement =
-            m_db->GetPrepareStatement(wxT("INSERT OR REPLACE INTO FILES VALUES(NULL, ?, ?)"));
+            m_db->GetPrepareStatement(wxT("INSERT OR REPLACE INTO FILES (file, last_retagged) VALUES(?, ?)"));
         statement.Bind(1, filename);
         statement.Bind(2, timestamp);
         statement.ExecuteUpdate();
@@ -757,7 +940,8 @@ int TagsStorageSQLite::UpdateFileEntry(const wxString& filename, int timestamp)
 {
     try {
         wxSQLite3Statement statement =
-            m_db->GetPrepareStatement(wxT("UPDATE OR REPLACE FILES SET last_retagged=? WHERE file=?"));
+            m_db->GetPrepareStatement(wxT("UPDATE OR REPLACE FILES SET last_retagged=?, modified=NULL, size=NULL, "
+                                          "hash=NULL WHERE file=?"));
         statement.Bind(1, timestamp);
         statement.Bind(2, filename);
         statement.ExecuteUpdate();
@@ -768,6 +952,25 @@ int TagsStorageSQLite::UpdateFileEntry(const wxString& filename, int timestamp)
     return TagOk;
 }
 
+int TagsStorageSQLite::StoreFileEntry(const FileEntry& entry)
+{
+    try {
+        wxSQLite3Statement statement = m_db->GetPrepareStatement(
+            wxT("INSERT OR REPLACE INTO FILES (file, last_retagged, modified, size, hash) VALUES(?, ?, ?, ?, ?)"));
+        statement.Bind(1, entry.GetFile());
+        statement.Bind(2, entry.GetLastRetaggedTimestamp());
+        statement.Bind(3, wxLongLong(entry.GetModified()));
+        statement.Bind(4, wxLongLong(entry.GetSize()));
+        // sqlite integers are signed
+        statement.Bind(5, wxLongLong(static_cast<wxLongLong_t>(entry.GetHash())));
+        statement.ExecuteUpdate();
+
+    } catch (const wxSQLite3Exception& exc) {
+        return TagError;
+    }
+    return TagOk;
+}
+
 int TagsStorageSQLite::DoInsertTagEntry(const TagEntry& tag)
 {
     // If this node is a dummy, (IsOk() == false) we don't insert it to database
@@ -780,8 +983,12 @@ int TagsStorageSQLite::DoInsertTagEntry(const TagEntry& tag)
     }
 
     try {
-        wxSQLite3Statement statement = m_db->GetPrepareStatement(
-            wxT("INSERT OR REPLACE INTO TAGS VALUES (NULL, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)"));
+        // while bulk loading, the statement is prepared once and reused for all the tags
+        wxSQLite3Statement local_statement;
+        if(!m_bulkLoading) {
+            local_statement = m_db->GetPrepareStatement(INSERT_TAG_SQL);
+        }
+        wxSQLite3Statement& statement = m_bulkLoading ? m_bulkInsertStatement : local_statement;
         statement.Bind(1, tag.GetName());
         statement.Bind(2, wxFileName(tag.GetFile()).GetFullPath());
         statement.Bind(3, tag.GetLine());
@@ -1192,11 +1399,32 @@ void TagsStorageSQLite::GetTagsByPartName(const wxString& partname, std::vector<
         if(partname.IsEmpty())
             return;
 
-        wxString tmpName(partname);
-        tmpName.Replace(wxT("_"), wxT("^_"));
-
         wxString sql;
-        sql << wxT("select * from tags where name like '%%") << tmpName << wxT("%%' ESCAPE '^' ");
+        if(m_hasTrigramIndex && partname.length() >= TRIGRAM_MIN_LENGTH) {
+            // the names starting with `partname` come first and are found with the TAGS_NAME index, so they are never
+            // left out of the ranked candidates below
+            wxString prefixSql = "select * from tags where ";
+            DoAddNamePartToQuery(prefixSql, partname, true, false);
+            prefixSql << " order by length(name) ";
+            DoAddLimitPartToQuery(prefixSql, tags);
+            DoFetchTags(prefixSql, tags);
+            if(tags.size() >= (size_t)GetSingleSearchLimit()) {
+                return;
+            }
+
+            // then the other matches, best first: the earlier the match and the shorter the name, the better
+            sql << "select tags.* from (select rowid from tags_fts where tags_fts match '"
+                << fts_substring_query("name", partname) << "' limit "
+                << GetSingleSearchLimit() * TRIGRAM_CANDIDATES_PER_RESULT
+                << ") as matches join tags on tags.ID = matches.rowid where not (";
+            DoAddNamePartToQuery(sql, partname, true, false);
+            sql << ") order by instr(lower(tags.name), '" << escape_sql_literal(partname.Lower())
+                << "'), length(tags.name) ";
+        } else {
+            wxString tmpName(partname);
+            tmpName.Replace(wxT("_"), wxT("^_"));
+            sql << wxT("select * from tags where name like '%%") << tmpName << wxT("%%' ESCAPE '^' ");
+        }
         DoAddLimitPartToQuery(sql, tags);
         DoFetchTags(sql, tags);
 
@@ -1219,14 +1447,34 @@ void TagsStorageSQLite::GetTagsByPartName(const wxArrayString& parts, std::vecto
             return;
         }
 
-        wxString filterQuery = "where ";
+        // parts long enough for the trigram index are matched with it, the others with LIKE
+        wxString matchQuery;
+        wxString likeQuery;
         for(size_t i = 0; i < parts.size(); ++i) {
-            wxString tmpName = parts.Item(i);
-            tmpName.Replace(wxT("_"), wxT("^_"));
-            filterQuery << "path like '%%" << tmpName << "%%' " << ((i == (parts.size() - 1)) ? "" : "AND ");
+            const wxString& part = parts.Item(i);
+            if(m_hasTrigramIndex && part.length() >= TRIGRAM_MIN_LENGTH) {
+                matchQuery << (matchQuery.empty() ? "" : " AND ") << fts_substring_query("path", part);
+            } else {
+                wxString tmpName = part;
+                tmpName.Replace(wxT("_"), wxT("^_"));
+                likeQuery << (likeQuery.empty() ? "" : "AND ") << "path like '%%" << tmpName << "%%' ESCAPE '^' ";
+            }
         }
 
-        sql << "select * from tags " << filterQuery << " ESCAPE '^' ";
+        if(matchQuery.empty()) {
+            sql << "select * from tags where " << likeQuery;
+        } else {
+            // the LIKE conditions may reject the first candidates, so rank all of them in that case
+            sql << "select tags.* from (select rowid from tags_fts where tags_fts match '" << matchQuery << "' ";
+            if(likeQuery.empty()) {
+                sql << "limit " << GetSingleSearchLimit() * TRIGRAM_CANDIDATES_PER_RESULT;
+            }
+            sql << ") as matches join tags on tags.ID = matches.rowid ";
+            if(!likeQuery.empty()) {
+                sql << "where " << likeQuery;
+            }
+            sql << "order by length(tags.path) ";
+        }
         DoAddLimitPartToQuery(sql, tags);
         DoFetchTags(sql, tags);
 
@@ -34,6 +34,7 @@
 
 #include <unordered_map>
 #include <wx/filename.h>
+#include <wx/stopwatch.h>
 #include <wx/wxsqlite3.h>
 
 /**
@@ -63,6 +64,11 @@
  * |Path          | String | full name including path, (e.g. Project::ClassName::FunctionName
  * |Typeref       | String | Special type of tag, that points to other Tag (i.e. typedef)
  *
+ * Table Name: TAGS_FTS
+ *
+ * An FTS5 trigram index of the TAGS name and path columns, kept in sync by triggers. Used for substring searches.
+ * Only created when the SQLite library supports it (FTS5 and SQLite 3.34 or later)
+ *
  * Table Name: TAGS_VERSION
  *
  * || Column Name || Type || Description
@@ -135,6 +141,14 @@ class WXDLLIMPEXP_CL TagsStorageSQLite : public ITagsStorage
 {
     clSqliteDB* m_db;
     TagsStorageSQLiteCache m_cache;
+    bool m_hasTrigramIndex = false;
+
+    // bulk load state, see BeginBulkLoad()
+    bool m_bulkLoading = false;
+    wxSQLite3Statement m_bulkInsertStatement;
+    wxStopWatch m_bulkLoadStopWatch;
+    size_t m_bulkLoadCount = 0;
+    int m_bulkLoadCacheSize = -2000; // the cache size to restore, SQLite's default until read
 
 private:
     /**
@@ -154,6 +168,12 @@ private:
     void DoAddNamePartToQuery(wxString& sql, const wxString& name, bool partial, bool prependAnd);
     void DoAddLimitPartToQuery(wxString& sql, const std::vector<TagEntryPtr>& tags);
     int DoInsertTagEntry(const TagEntry& tag);
+    void DoCreateSearchIndexes();
+    /**
+     * @brief create the tags_fts table (if needed) and its triggers
+     * @param rebuild re-index all the tags, even if the table already exists
+     */
+    void DoCreateTrigramIndex(bool rebuild);
 
 public:
     static TagEntry* FromSQLite3ResultSet(wxSQLite3ResultSet& rs);
@@ -209,6 +229,20 @@ public:
      */
     void Store(const std::vector<TagEntryPtr>& tags, bool auto_commit = true);
 
+    bool HasTags();
+
+    /**
+     * @brief drop the search indexes and the trigram index, and insert the tags with a single prepared statement.
+     * The caller should still group the Store() calls in large transactions
+     */
+    void BeginBulkLoad();
+
+    /**
+     * @brief create the search indexes and the trigram index again, then ANALYZE the database. The timings are
+     * written to the log
+     */
+    void EndBulkLoad();
+
     /**
      * Return a result set of tags according to file name.
      * @param file Source file name
@@ -456,6 +490,11 @@ public:
      */
     virtual int UpdateFileEntry(const wxString& filename, int timestamp);
 
+    /**
+     * @brief insert or replace an entry, including the file fingerprint (modification time, size and hash)
+     */
+    virtual int StoreFileEntry(const FileEntry& entry);
+
     /**
      * @brief
      * @param typeName
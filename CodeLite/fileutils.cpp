@@ -194,6 +194,36 @@ bool FileUtils::ReadFileContent(const wxFileName& fn, wxString& data, const wxMB
     return true;
 }
 
+bool FileUtils::ReadFileContentRaw(const wxFileName& fn, std::string& data)
+{
+    wxFFile fp(fn.GetFullPath(), "rb");
+    if (!fp.IsOpened()) {
+        clERROR() << "failed to open file:" << fn << "for read-binary" << endl;
+        return false;
+    }
+
+    data.clear();
+    size_t size = fp.Length();
+    if (size == 0) {
+        // an empty file
+        return true;
+    }
+
+    if (size > (100 << 20)) {
+        // File is too big
+        clERROR() << "input file:" << fn << "exceeds the maximum file size of:" << (100 << 20) << "bytes" << endl;
+        return false;
+    }
+
+    data.resize(size);
+    if (fp.Read(data.data(), size) != size) {
+        clERROR() << "Failed to Read() file:" << fn << endl;
+        data.clear();
+        return false;
+    }
+    return true;
+}
+
 void FileUtils::OpenFileExplorerAndSelect(const wxFileName& filename)
 {
 #ifdef __WXMSW__
@@ -58,6 +58,11 @@ public:
 public:
     static bool ReadFileContent(const wxFileName& fn, wxString& data, const wxMBConv& conv = wxConvUTF8);
 
+    /**
+     * @brief read file content into a raw buffer, without any encoding conversion
+     */
+    static bool ReadFileContentRaw(const wxFileName& fn, std::string& data);
+
     /**
      * @brief attempt to read up to bufferSize from the beginning of file
      */
@@ -42,6 +42,7 @@
 
 #include <memory>
 #include <stdio.h>
+#include <string>
 #include <wx/tokenzr.h>
 #ifdef __WXMSW__
 #include <wx/msw/private.h>
@@ -517,6 +518,54 @@ wxString ProcUtils::SafeExecuteCommand(const wxString& command)
     return strOut;
 }
 
+void ProcUtils::SafeExecuteCommand(const wxString& command, const std::function<void(std::string_view)>& on_line)
+{
+#ifdef __WXMSW__
+    wxArrayString output;
+    SafeExecuteCommand(command, output);
+    for (const wxString& line : output) {
+        const wxScopedCharBuffer utf8 = line.utf8_str();
+        on_line(std::string_view{ utf8.data(), utf8.length() });
+    }
+#else
+    FILE* fp = popen(command.mb_str(wxConvUTF8), "r");
+    if (!fp) {
+        return;
+    }
+
+    constexpr size_t CHUNK_SIZE = 64 * 1024;
+    std::string buffer;
+    while (true) {
+        // the buffer only holds the incomplete last line of the previous chunk
+        size_t prev_size = buffer.size();
+        buffer.resize(prev_size + CHUNK_SIZE);
+        size_t count = fread(buffer.data() + prev_size, 1, CHUNK_SIZE, fp);
+        buffer.resize(prev_size + count);
+        if (count == 0) {
+            break;
+        }
+
+        size_t offset = 0;
+        size_t eol = buffer.find('\n', prev_size);
+        while (eol != std::string::npos) {
+            std::string_view line{ buffer.data() + offset, eol - offset };
+            if (!line.empty() && line.back() == '\r') {
+                line.remove_suffix(1);
+            }
+            on_line(line);
+            offset = eol + 1;
+            eol = buffer.find('\n', offset);
+        }
+        buffer.erase(0, offset);
+    }
+
+    if (!buffer.empty()) {
+        on_line(buffer);
+    }
+    pclose(fp);
+#endif
+}
+
 wxString ProcUtils::GrepCommandOutput(const std::vector<wxString>& cmd, const wxString& find_what)
 {
     IProcess::Ptr_t proc(::CreateAsyncProcess(nullptr, cmd, IProcessCreateDefault | IProcessCreateSync));
@@ -26,8 +26,10 @@
 
 #include "codelite_exports.h"
 
+#include <functional>
 #include <map>
 #include <set>
+#include <string_view>
 #include <vector>
 #include <wx/arrstr.h>
 #include <wx/defs.h>
@@ -118,6 +120,13 @@ public:
      */
     static wxString SafeExecuteCommand(const wxString& command);
 
+    /**
+     * @brief execute a command and pass each line of its output to `on_line` as soon as it is read, without
+     * collecting the whole output first. The line is UTF-8 encoded, without its terminator, and is only valid during
+     * the call
+     */
+    static void SafeExecuteCommand(const wxString& command, const std::function<void(std::string_view)>& on_line);
+
     /**
      * @brief execute command and execute the callback on each line until the callback returns true
      */
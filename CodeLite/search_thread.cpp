@@ -31,9 +31,15 @@
 #include "fileutils.h"
 #include "macros.h"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <set>
+#include <thread>
 #include <wx/event.h>
 #include <wx/fontmap.h>
+#include <wx/intl.h>
 #include <wx/stopwatch.h>
 #include <wx/tokenzr.h>
 
@@ -60,6 +66,94 @@ namespace
 {
 bool is_word_char(wxChar ch) { return ch == '_' || wxIsalnum(ch); }
 
+bool is_ascii(const std::string& str)
+{
+    return std::all_of(str.begin(), str.end(), [](char ch) { return (unsigned char)ch < 0x80; });
+}
+
+/// check that `buffer` is a well formed UTF-8 string, set `is_ascii` to true if it only contains ASCII chars
+bool validate_utf8(const std::string& buffer, bool* is_ascii)
+{
+    *is_ascii = true;
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(buffer.data());
+    const unsigned char* end = p + buffer.length();
+    while (p < end) {
+        if (*p < 0x80) {
+            ++p;
+            continue;
+        }
+
+        *is_ascii = false;
+        size_t trailing = 0;
+        if (*p >= 0xC2 && *p <= 0xDF) {
+            trailing = 1;
+        } else if (*p >= 0xE0 && *p <= 0xEF) {
+            trailing = 2;
+        } else if (*p >= 0xF0 && *p <= 0xF4) {
+            trailing = 3;
+        } else {
+            return false;
+        }
+
+        if ((size_t)(end - p) <= trailing) {
+            return false;
+        }
+
+        for (size_t i = 1; i <= trailing; ++i) {
+            if ((p[i] & 0xC0) != 0x80) {
+                return false;
+            }
+        }
+        p += trailing + 1;
+    }
+    return true;
+}
+
+/// return the number of wxChars required to hold the UTF-8 range [begin, end)
+size_t count_chars(const char* begin, const char* end)
+{
+    size_t count = 0;
+    for (const char* p = begin; p < end; ++p) {
+        unsigned char ch = *p;
+        if ((ch & 0xC0) != 0x80) {
+            ++count;
+            // on platforms where wxChar is UTF-16, code points outside of the BMP take 2 chars
+            if (sizeof(wxChar) == 2 && ch >= 0xF0) {
+                ++count;
+            }
+        }
+    }
+    return count;
+}
+
+/// decode the UTF-8 code point starting at `pos`
+wxChar char_at(std::string_view text, size_t pos)
+{
+    wxString ch = wxString::FromUTF8(text.data() + pos, std::min<size_t>(4, text.length() - pos));
+    return ch.empty() ? 0 : ch[0];
+}
+
+/// decode the UTF-8 code point that ends just before `pos`
+wxChar char_before(std::string_view text, size_t pos)
+{
+    size_t start = pos - 1;
+    while (start > 0 && ((unsigned char)text[start] & 0xC0) == 0x80) {
+        --start;
+    }
+    wxString ch = wxString::FromUTF8(text.data() + start, pos - start);
+    return ch.empty() ? 0 : ch[0];
+}
+
+/// return true if files read with `enc` are decoded as UTF-8
+bool is_utf8_encoding(wxFontEncoding enc)
+{
+    if (enc == wxFONTENCODING_UTF8) {
+        return true;
+    }
+    return (enc == wxFONTENCODING_DEFAULT || enc == wxFONTENCODING_SYSTEM) &&
+           wxLocale::GetSystemEncoding() == wxFONTENCODING_UTF8;
+}
+
 // Minumum of 10ms between events that this thread is sending to the main thread
 constexpr long MIN_SEND_INTERVAL_MS = 1;
 size_t send_count = 0;
@@ -86,6 +180,7 @@ SearchData& SearchData::Copy(const SearchData& other)
     m_files.clear();
     m_files.reserve(other.m_files.size());
     m_file_scanner_flags = other.m_file_scanner_flags;
+    m_threadCount = other.m_threadCount;
     for (size_t i = 0; i < other.m_files.size(); ++i) {
         m_files.Add(other.m_files.Item(i).c_str());
     }
@@ -98,18 +193,18 @@ SearchData& SearchData::Copy(const SearchData& other)
 
 SearchThread::SearchThread()
     : WorkerThread()
-    , m_reExpr(wxT(""))
+    , m_stopSearch(false)
 {
     m_stopWatch.Start();
 }
 
-wxRegEx& SearchThread::GetRegex(const wxString& expr, bool matchCase)
+wxRegEx& SearchThread::GetRegex(const wxString& expr, bool matchCase, SearchContext& ctx)
 {
-    if (m_reExpr == expr && matchCase == m_matchCase) {
-        return m_regex;
+    if (ctx.reExpr == expr && matchCase == ctx.reMatchCase) {
+        return ctx.regex;
     } else {
-        m_reExpr = expr;
-        m_matchCase = matchCase;
+        ctx.reExpr = expr;
+        ctx.reMatchCase = matchCase;
 #ifndef __WXMAC__
         int flags = wxRE_ADVANCED;
 #else
@@ -118,9 +213,9 @@ wxRegEx& SearchThread::GetRegex(const wxString& expr, bool matchCase)
 
         if (!matchCase)
             flags |= wxRE_ICASE;
-        m_regex.Compile(m_reExpr, flags);
+        ctx.regex.Compile(ctx.reExpr, flags);
     }
-    return m_regex;
+    return ctx.regex;
 }
 
 void SearchThread::PerformSearch(const SearchData& data) { Add(new SearchData(data)); }
@@ -219,6 +314,7 @@ void SearchThread::DoSearchFiles(ThreadRequest* req)
     StopSearch(false);
     wxArrayString fileList;
     GetFiles(data, fileList);
+    FilterFilesUsingIndex(data, fileList);
 
     wxStopWatch sw;
 
@@ -234,18 +330,134 @@ void SearchThread::DoSearchFiles(ThreadRequest* req)
         }
     }
 
-    for (size_t i = 0; i < fileList.Count(); i++) {
+    size_t threadCount = data->GetThreadCount();
+    if (threadCount == 0) {
+        threadCount = wxThread::GetCPUCount() > 0 ? wxThread::GetCPUCount() : 1;
+    }
+    // no point in spawning more searchers than we have files
+    threadCount = wxMin(threadCount, fileList.size());
+
+    bool completed = true;
+    if (threadCount > 1) {
+        clDEBUG() << "Searching" << fileList.size() << "files using" << threadCount << "threads" << endl;
+        completed = DoSearchFilesParallel(fileList, data, threadCount);
+    } else {
+        completed = DoSearchFilesSerial(fileList, data);
+    }
+    clDEBUG() << "Searching files... done (" << sw.Time() << "ms)" << endl;
+
+    if (!completed) {
+        // Send cancel event
+        SendEvent(wxEVT_SEARCH_THREAD_SEARCHCANCELED, data->GetOwner());
+        StopSearch(false);
+    }
+}
+
+bool SearchThread::DoSearchFilesSerial(const wxArrayString& files, const SearchData* data)
+{
+    SearchContext ctx;
+    for (size_t i = 0; i < files.size(); i++) {
         m_summary.SetNumFileScanned((int)i + 1);
 
         // give user chance to cancel the search ...
         if (TestStopSearch()) {
-            // Send cancel event
-            SendEvent(wxEVT_SEARCH_THREAD_SEARCHCANCELED, data->GetOwner());
-            StopSearch(false);
+            return false;
+        }
+
+        if (!DoSearchFile(files.Item(i), data, ctx)) {
+            m_summary.GetFailedFiles().Add(files.Item(i));
+        }
+
+        if (!ctx.results.empty()) {
+            m_summary.SetNumMatchesFound(m_summary.GetNumMatchesFound() + (int)ctx.results.size());
+            m_results.swap(ctx.results);
+            ctx.results.clear();
+            SendEvent(wxEVT_SEARCH_THREAD_MATCHFOUND, data->GetOwner());
+        }
+    }
+    return true;
+}
+
+bool SearchThread::DoSearchFilesParallel(const wxArrayString& files, const SearchData* data, size_t threadCount)
+{
+    // the outcome of searching a single file
+    struct FileSlot {
+        SearchResultList results;
+        bool failed = false;
+        bool done = false;
+    };
+
+    std::vector<FileSlot> slots(files.size());
+    std::atomic_size_t nextFile{ 0 };
+    std::mutex slots_mutex;
+    std::condition_variable slots_cv;
+
+    // each searcher grabs the next unclaimed file, so a searcher that gets stuck on a large
+    // file does not hold back the others
+    auto searcher = [&]() {
+        SearchContext ctx;
+        while (true) {
+            size_t index = nextFile.fetch_add(1);
+            if (index >= files.size() || TestStopSearch()) {
+                break;
+            }
+
+            bool ok = DoSearchFile(files.Item(index), data, ctx);
+
+            std::lock_guard<std::mutex> lk{ slots_mutex };
+            FileSlot& slot = slots[index];
+            slot.results.swap(ctx.results);
+            slot.failed = !ok;
+            slot.done = true;
+            ctx.results.clear();
+            slots_cv.notify_one();
+        }
+    };
+
+    std::vector<std::thread> searchers;
+    searchers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        searchers.emplace_back(searcher);
+    }
+
+    // merge the results in the order of the files list. Matches from all the files that are
+    // ready are sent to the owner as a single event
+    bool completed = true;
+    size_t nextToReport = 0;
+    while (nextToReport < files.size()) {
+        if (TestStopSearch()) {
+            completed = false;
             break;
         }
-        DoSearchFile(fileList.Item(i), data);
+
+        {
+            std::unique_lock<std::mutex> lk{ slots_mutex };
+            slots_cv.wait_for(lk, std::chrono::milliseconds(50), [&]() { return slots[nextToReport].done; });
+            while (nextToReport < files.size() && slots[nextToReport].done) {
+                FileSlot& slot = slots[nextToReport];
+                if (slot.failed) {
+                    m_summary.GetFailedFiles().Add(files.Item(nextToReport));
+                }
+                m_results.reserve(m_results.size() + slot.results.size());
+                for (auto& result : slot.results) {
+                    m_results.emplace_back(std::move(result));
+                }
+                SearchResultList().swap(slot.results);
+                ++nextToReport;
+            }
+        }
+
+        m_summary.SetNumFileScanned((int)nextToReport);
+        if (!m_results.empty()) {
+            m_summary.SetNumMatchesFound(m_summary.GetNumMatchesFound() + (int)m_results.size());
+            SendEvent(wxEVT_SEARCH_THREAD_MATCHFOUND, data->GetOwner());
+        }
+    }
+
+    for (auto& t : searchers) {
+        t.join();
     }
+    return completed;
 }
 
 bool SearchThread::TestStopSearch()
@@ -264,40 +476,104 @@ void SearchThread::StopSearch(bool stop)
     m_stopSearch = stop;
 }
 
-void SearchThread::DoSearchFile(const wxString& fileName, const SearchData* data)
+void SearchThread::SetIndex(clTrigramIndex::ptr_t index)
+{
+    wxCriticalSectionLocker locker(m_cs);
+    m_index = index;
+}
+
+void SearchThread::FilterFilesUsingIndex(const SearchData* data, wxArrayString& files)
+{
+    clTrigramIndex::ptr_t index;
+    {
+        wxCriticalSectionLocker locker(m_cs);
+        index = m_index;
+    }
+
+    if (!index || !index->IsOpened()) {
+        return;
+    }
+
+    // collect the strings that every matching line must contain
+    std::vector<wxString> literals;
+    if (data->IsRegularExpression()) {
+        literals = clTrigramIndex::GetRequiredLiterals(data->GetFindString());
+    } else {
+        wxString findWhat;
+        wxArrayString filters;
+        GetFindWhatAndFilters(data, findWhat, filters);
+        literals.push_back(findWhat);
+        literals.insert(literals.end(), filters.begin(), filters.end());
+    }
+
+    wxStopWatch sw;
+    size_t count = files.size();
+    if (index->FilterFiles(literals, files)) {
+        clDEBUG() << "Search index: narrowed" << count << "files down to" << files.size() << "(" << sw.Time()
+                  << "ms)" << endl;
+    }
+}
+
+bool SearchThread::DoSearchFile(const wxString& fileName, const SearchData* data, SearchContext& ctx)
 {
     // Process single lines
     int lineNumber = 1;
     if (!wxFileName::FileExists(fileName)) {
-        return;
+        return true;
     }
 
     // ignore binary executables
     if (FileUtils::IsBinaryExecutable(fileName)) {
-        return;
+        return true;
     }
 
     size_t size = FileUtils::GetFileSize(fileName);
     if (size == 0) {
-        return;
+        return true;
+    }
+
+    std::string buffer;
+    if (!FileUtils::ReadFileContentRaw(fileName, buffer)) {
+        return false;
+    }
+
+    if (buffer.empty()) {
+        return true;
     }
-    wxString fileData;
-    fileData.Alloc(size);
 
 #if wxUSE_GUI
     // support for other encoding
     wxFontEncoding enc = wxFontMapper::GetEncodingFromName(data->GetEncoding().c_str());
     wxCSConv fontEncConv(enc);
-    if (!FileUtils::ReadFileContent(fileName, fileData, fontEncConv)) {
-        m_summary.GetFailedFiles().Add(fileName);
-        return;
-    }
+    const wxMBConv& conv = fontEncConv;
 #else
-    if (!FileUtils::ReadFileContent(fileName, fileData, wxConvLibc)) {
-        m_summary.GetFailedFiles().Add(fileName);
-        return;
-    }
+    wxFontEncoding enc = wxFONTENCODING_SYSTEM;
+    const wxMBConv& conv = wxConvLibc;
 #endif
+
+    wxString findString;
+    wxArrayString filters;
+    if (!data->IsRegularExpression()) {
+        GetFindWhatAndFilters(data, findString, filters);
+        // Don't search for empty strings
+        if (findString.empty()) {
+            return true;
+        }
+
+        // plain ASCII and UTF-8 files are scanned as is, without converting them first
+        if (DoSearchBuffer(buffer, is_utf8_encoding(enc), fileName, data, findString, filters, ctx)) {
+            return true;
+        }
+    }
+
+    wxString fileData(buffer.c_str(), conv, buffer.length());
+    if (fileData.empty()) {
+        // conversion failed
+        return false;
+    }
+
+    // release the raw buffer before we split the file into lines
+    std::string().swap(buffer);
     wxArrayString lines = ::wxStringTokenize(fileData, wxT("\n"), wxTOKEN_RET_EMPTY_ALL);
 
     int lineOffset = 0;
@@ -305,53 +581,165 @@ void SearchThread::DoSearchFile(const wxString& fileName, const SearchData* data
         // regular expression search
         for (const wxString& line : lines) {
             // Read the next line
-            DoSearchLineRE(line, lineNumber, lineOffset, fileName, data);
+            DoSearchLineRE(line, lineNumber, lineOffset, fileName, data, ctx);
             lineOffset += line.Length() + 1;
             lineNumber++;
         }
     } else {
         // simple search
-        wxString findString;
-        wxArrayString filters;
-        findString = data->GetFindString();
-        if (data->IsEnablePipeSupport()) {
-            if (data->GetFindString().Find('|') != wxNOT_FOUND) {
-                findString = data->GetFindString().BeforeFirst('|');
-
-                wxString filtersString = data->GetFindString().AfterFirst('|');
-                filters = ::wxStringTokenize(filtersString, "|", wxTOKEN_STRTOK);
-                if (!data->IsMatchCase()) {
-                    for (size_t i = 0; i < filters.size(); ++i) {
-                        filters.Item(i).MakeLower();
-                    }
+        for (const wxString& line : lines) {
+            DoSearchLine(line, lineNumber, lineOffset, fileName, data, findString, filters, ctx);
+            lineOffset += line.Length() + 1;
+            lineNumber++;
+        }
+    }
+    return true;
+}
+
+void SearchThread::GetFindWhatAndFilters(const SearchData* data, wxString& findWhat, wxArrayString& filters) const
+{
+    findWhat = data->GetFindString();
+    filters.clear();
+    if (data->IsEnablePipeSupport()) {
+        if (data->GetFindString().Find('|') != wxNOT_FOUND) {
+            findWhat = data->GetFindString().BeforeFirst('|');
+
+            wxString filtersString = data->GetFindString().AfterFirst('|');
+            filters = ::wxStringTokenize(filtersString, "|", wxTOKEN_STRTOK);
+            if (!data->IsMatchCase()) {
+                for (size_t i = 0; i < filters.size(); ++i) {
+                    filters.Item(i).MakeLower();
                 }
             }
         }
+    }
 
-        // Don't search for empty strings
-        if (findString.empty()) {
-            return;
-        }
+    if (!data->IsMatchCase()) {
+        findWhat.MakeLower();
+    }
+}
 
-        if (!data->IsMatchCase()) {
-            findString.MakeLower();
+bool SearchThread::DoSearchBuffer(const std::string& buffer,
+                                  bool utf8Encoding,
+                                  const wxString& fileName,
+                                  const SearchData* data,
+                                  const wxString& findWhat,
+                                  const wxArrayString& filters,
+                                  SearchContext& ctx)
+{
+    bool matchCase = data->IsMatchCase();
+
+    // When ignoring case, we only know how to fold ASCII letters
+    std::string needle = findWhat.ToStdString(wxConvUTF8);
+    if (needle.find('\n') != std::string::npos || (!matchCase && !is_ascii(needle))) {
+        return false;
+    }
+
+    std::vector<std::string> filtersUTF8;
+    filtersUTF8.reserve(filters.size());
+    for (const wxString& filter : filters) {
+        filtersUTF8.push_back(filter.ToStdString(wxConvUTF8));
+        if (!matchCase && !is_ascii(filtersUTF8.back())) {
+            return false;
         }
-        for (const wxString& line : lines) {
-            DoSearchLine(line, lineNumber, lineOffset, fileName, data, findString, filters);
-            lineOffset += line.Length() + 1;
-            lineNumber++;
+    }
+
+    // A file that is not plain ASCII can only be scanned as is when it is read as UTF-8
+    bool ascii = false;
+    if (!validate_utf8(buffer, &ascii) || (!ascii && !utf8Encoding)) {
+        return false;
+    }
+
+    std::string lowered;
+    if (!matchCase) {
+        lowered = buffer;
+        for (char& ch : lowered) {
+            if (ch >= 'A' && ch <= 'Z') {
+                ch += ('a' - 'A');
+            }
         }
     }
 
-    if (m_results.empty() == false) {
-        SendEvent(wxEVT_SEARCH_THREAD_MATCHFOUND, data->GetOwner());
+    std::string_view text{ buffer };
+    std::string_view haystack = matchCase ? text : std::string_view{ lowered };
+
+    // we advance these as we move from one match to the next one, so the file is
+    // traversed only once
+    size_t lineStart = 0;
+    size_t lineNumber = 1;
+    size_t lineOffsetInChars = 0;
+
+    // the line for which we last checked the pipe filters
+    size_t filteredLine = 0;
+    bool filtersOK = true;
+
+    int lenInChars = (int)findWhat.length();
+    int len = (int)needle.length();
+    size_t pos = haystack.find(needle);
+    while (pos != std::string_view::npos) {
+        // move to the line containing the match
+        size_t nl = haystack.find('\n', lineStart);
+        while (nl != std::string_view::npos && nl < pos) {
+            lineOffsetInChars += count_chars(text.data() + lineStart, text.data() + nl + 1);
+            lineStart = nl + 1;
+            ++lineNumber;
+            nl = haystack.find('\n', lineStart);
+        }
+        size_t lineEnd = nl == std::string_view::npos ? text.length() : nl;
+
+        // Pipe support: if the line does not contain all the filters, skip it
+        if (!filtersUTF8.empty() && filteredLine != lineNumber) {
+            filteredLine = lineNumber;
+            std::string_view line = haystack.substr(lineStart, lineEnd - lineStart);
+            filtersOK = std::all_of(filtersUTF8.begin(), filtersUTF8.end(), [&line](const std::string& filter) {
+                return line.find(filter) != std::string_view::npos;
+            });
+        }
+
+        if (!filtersOK) {
+            pos = lineEnd == text.length() ? std::string_view::npos : haystack.find(needle, lineEnd + 1);
+            continue;
+        }
+
+        if (data->IsMatchWholeWord()) {
+            if ((pos > lineStart && is_word_char(char_before(text, pos))) ||
+                (pos + needle.length() < lineEnd && is_word_char(char_at(text, pos + needle.length())))) {
+                pos = haystack.find(needle, pos + needle.length());
+                continue;
+            }
+        }
+
+        int col = (int)(pos - lineStart);
+        int colInChars = (int)count_chars(text.data() + lineStart, text.data() + pos);
+        wxString line = wxString::FromUTF8(text.data() + lineStart, lineEnd - lineStart);
+
+        SearchResult result;
+        result.SetPosition((int)lineOffsetInChars + colInChars);
+        result.SetColumnInChars(colInChars);
+        result.SetColumn(col);
+        result.SetLineNumber((int)lineNumber);
+        // Don't use match pattern larger than 500 chars
+        result.SetPattern(line.length() > 500 ? line.Mid(0, 500) : line);
+        result.SetFileName(fileName);
+        result.SetLenInChars(lenInChars);
+        result.SetLen(len);
+        result.SetFindWhat(data->GetFindString());
+        result.SetFlags(data->m_flags);
+        ctx.results.push_back(result);
+
+        pos = haystack.find(needle, pos + needle.length());
     }
+    return true;
 }
 
-void SearchThread::DoSearchLineRE(
-    const wxString& line, const int lineNum, const int lineOffset, const wxString& fileName, const SearchData* data)
+void SearchThread::DoSearchLineRE(const wxString& line,
+                                  const int lineNum,
+                                  const int lineOffset,
+                                  const wxString& fileName,
+                                  const SearchData* data,
+                                  SearchContext& ctx)
 {
-    wxRegEx& re = GetRegex(data->GetFindString(), data->IsMatchCase());
+    wxRegEx& re = GetRegex(data->GetFindString(), data->IsMatchCase(), ctx);
     size_t col = 0;
     int iCorrectedCol = 0;
     int iCorrectedLen = 0;
@@ -384,8 +772,7 @@ void SearchThread::DoSearchLineRE(
             result.SetRegexCaptures(regexCaptures);
 
             // Make sure our match is not on a comment
-            m_results.push_back(result);
-            m_summary.SetNumMatchesFound(m_summary.GetNumMatchesFound() + 1);
+            ctx.results.push_back(result);
 
             col += len;
 
@@ -403,7 +790,8 @@ void SearchThread::DoSearchLine(const wxString& line,
                                 const wxString& fileName,
                                 const SearchData* data,
                                 const wxString& findWhat,
-                                const wxArrayString& filters)
+                                const wxArrayString& filters,
+                                SearchContext& ctx)
 {
     wxString modLine = line;
 
@@ -477,8 +865,7 @@ void SearchThread::DoSearchLine(const wxString& line,
             result.SetFindWhat(data->GetFindString());
             result.SetFlags(data->m_flags);
 
-            m_results.push_back(result);
-            m_summary.SetNumMatchesFound(m_summary.GetNumMatchesFound() + 1);
+            ctx.results.push_back(result);
 
             if (!AdjustLine(modLine, pos, findWhat)) {
                 break;
@@ -27,6 +27,7 @@
 
 #include "JSON.h"
 #include "clFilesCollector.h"
+#include "clTrigramIndex.hpp"
 #include "codelite_exports.h"
 #include "singleton.h"
 #include "worker_thread.h"
@@ -35,6 +36,7 @@
 #include <deque>
 #include <list>
 #include <map>
+#include <string>
 #include <vector>
 #include <wx/event.h>
 #include <wx/filename.h>
@@ -77,6 +79,7 @@ class WXDLLIMPEXP_CL SearchData : public ThreadRequest
     wxString m_encoding;
     wxArrayString m_excludePatterns;
     size_t m_file_scanner_flags = clFilesScanner::SF_DONT_FOLLOW_SYMLINKS | clFilesScanner::SF_EXCLUDE_HIDDEN_DIRS;
+    size_t m_threadCount = 0;
     friend class SearchThread;
 
 private:
@@ -113,6 +116,12 @@ public:
     //------------------------------------------
     size_t GetFileScannerFlags() const { return m_file_scanner_flags; }
     void SetFileScannerFlags(size_t flags) { m_file_scanner_flags = flags; }
+    /**
+     * @brief number of searcher threads to use. 0 means: one per CPU, 1 means: search on the
+     * search thread itself (no pool)
+     */
+    size_t GetThreadCount() const { return m_threadCount; }
+    void SetThreadCount(size_t count) { m_threadCount = count; }
     bool IsMatchCase() const { return m_flags & wxSD_MATCHCASE ? true : false; }
     bool IsEnablePipeSupport() const { return m_flags & wxSD_ENABLE_PIPE_SUPPORT; }
     void SetEnablePipeSupport(bool b) { SetOption(wxSD_ENABLE_PIPE_SUPPORT, b); }
@@ -261,6 +270,17 @@ public:
 
 typedef std::vector<SearchResult> SearchResultList;
 
+/**
+ * @brief per searcher state. Each searcher owns one of these so several files can be
+ * scanned concurrently without sharing the results buffer or the compiled regex
+ */
+struct WXDLLIMPEXP_CL SearchContext {
+    SearchResultList results;
+    wxString reExpr;
+    bool reMatchCase = false;
+    wxRegEx regex;
+};
+
 class WXDLLIMPEXP_CL SearchSummary : public wxObject
 {
     int m_fileScanned;
@@ -347,11 +367,9 @@ class WXDLLIMPEXP_CL SearchThread : public WorkerThread
     SearchResultList m_results;
     bool m_stopSearch;
     SearchSummary m_summary;
-    wxString m_reExpr;
-    wxRegEx m_regex;
-    bool m_matchCase;
     wxCriticalSection m_cs;
     wxStopWatch m_stopWatch;
+    clTrigramIndex::ptr_t m_index;
 
 public:
     /**
@@ -381,6 +399,12 @@ public:
      */
     void StopSearch(bool stop = true);
 
+    /**
+     * Set an index used to skip files that can not contain a match. Pass nullptr to search all the files
+     * \note This call must be called from the context of other thread (e.g. main thread)
+     */
+    void SetIndex(clTrigramIndex::ptr_t index);
+
 private:
     /**
      * Return files to search
@@ -392,28 +416,60 @@ private:
     // Test to see if user asked to cancel the search
     bool TestStopSearch();
 
+    /**
+     * Use the index (if any) to remove the files that can not contain a match
+     */
+    void FilterFilesUsingIndex(const SearchData* data, wxArrayString& files);
+
     /**
      * Do the actual search operation
      * \param data input contains information about the search
      */
     void DoSearchFiles(ThreadRequest* data);
 
-    // Perform search on a single file
-    void DoSearchFile(const wxString& fileName, const SearchData* data);
+    /**
+     * Search the files one by one on this thread
+     * \return false if the search was cancelled
+     */
+    bool DoSearchFilesSerial(const wxArrayString& files, const SearchData* data);
+
+    /**
+     * Search the files using a pool of `threadCount` searchers. The matches are
+     * merged and reported to the owner in the same order as `files`
+     * \return false if the search was cancelled
+     */
+    bool DoSearchFilesParallel(const wxArrayString& files, const SearchData* data, size_t threadCount);
+
+    // Perform search on a single file. Return false if the file could not be read
+    bool DoSearchFile(const wxString& fileName, const SearchData* data, SearchContext& ctx);
+
+    /**
+     * Perform a simple (non regex) search directly on the raw content of a file. Lines are not split, the line
+     * number, column and the line text are only computed for the matches.
+     * \return false if the buffer can not be searched as is (e.g. not UTF-8), in which case nothing is reported and
+     * the caller should search the converted content instead
+     */
+    bool DoSearchBuffer(const std::string& buffer, bool utf8Encoding, const wxString& fileName,
+                        const SearchData* data, const wxString& findWhat, const wxArrayString& filters,
+                        SearchContext& ctx);
+
+    // Split the find string into the string to search and the pipe filters. Both are lower cased when ignoring case
+    void GetFindWhatAndFilters(const SearchData* data, wxString& findWhat, wxArrayString& filters) const;
 
     // Perform search on a line
     void DoSearchLine(const wxString& line, const int lineNum, const int lineOffset, const wxString& fileName,
-                      const SearchData* data, const wxString& findWhat, const wxArrayString& filters);
+                      const SearchData* data, const wxString& findWhat, const wxArrayString& filters,
+                      SearchContext& ctx);
 
     // Perform search on a line using regular expression
     void DoSearchLineRE(const wxString& line, const int lineNum, const int lineOffset, const wxString& fileName,
-                        const SearchData* data);
+                        const SearchData* data, SearchContext& ctx);
 
     // Send an event to the notified window
     void SendEvent(wxEventType type, wxEvtHandler* owner);
 
     // return a compiled regex object for the expression
-    wxRegEx& GetRegex(const wxString& expr, bool matchCase);
+    wxRegEx& GetRegex(const wxString& expr, bool matchCase, SearchContext& ctx);
 
     // Internal function
     bool AdjustLine(wxString& line, int& pos, const wxString& findString);
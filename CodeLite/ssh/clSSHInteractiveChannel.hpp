@@ -101,11 +101,11 @@ public:
     /**
      * @brief stop reading process output in the background thread
      */
-    void SuspendAsyncReads();
+    virtual void SuspendAsyncReads();
     /**
      * @brief resume reading process output in the background
      */
-    void ResumeAsyncReads();
+    virtual void ResumeAsyncReads();
 };
 #endif // USE_SFTP
 #endif // CLSSHINTERACTIVECHANNEL_HPP
@@ -0,0 +1,1540 @@
+#include "AsyncProcess/asyncprocess.h"
+#include "AsyncProcess/clPosixSpawn.hpp"
+#include "AsyncProcess/clProcessReactor.hpp"
+#include "CTags.hpp"
+#include "JSONReader.hpp"
+#include "LSP/CompletionItem.h"
+#include "LSP/MessageFramer.hpp"
+#include "clChunkedLineStore.hpp"
+#include "clFileChangeDetector.hpp"
+#include "clFileSystemWatcher.h"
+#include "clFuzzyIndex.hpp"
+#include "clStringPool.hpp"
+#include "clTrigramIndex.hpp"
+#include "cl_standard_paths.h"
+#include "ctags_manager.h"
+#include "database/tags_storage_sqlite3.h"
+#include "fileutils.h"
+#include "procutils.h"
+#include "search_thread.h"
+#include "tester.hpp"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <wx/init.h>
+#include <wx/log.h>
+#include <wx/stopwatch.h>
+#include <wx/tokenzr.h>
+#include <wx/wxcrtvararg.h>
+
+#if CL_USE_PROCESS_REACTOR
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+/// generate a synthetic source tree under `root`
+void create_search_tree(const TestTempDir& root, size_t files_count, size_t lines_per_file)
+{
+    for(size_t i = 0; i < files_count; ++i) {
+        wxString content;
+        for(size_t line = 0; line < lines_per_file; ++line) {
+            content << "int value_" << line << " = compute(" << i << ", " << line << ");";
+            if(line % 97 == 0) {
+                content << " // FindMeMarker";
+            }
+            content << "\n";
+        }
+        FileUtils::WriteFileContent(root.GetFile(wxString() << "file_" << i << ".cpp"), content);
+    }
+}
+
+/// run `SearchThread` over `root` using `threads` searchers, collect the matches as "file:line"
+std::vector<wxString> run_search(const wxString& root, size_t threads, long* elapsed_ms)
+{
+    std::vector<wxString> matches;
+    bool search_ended = false;
+    wxEvtHandler owner;
+    owner.Bind(wxEVT_SEARCH_THREAD_MATCHFOUND, [&](wxCommandEvent& event) {
+        SearchResultList* results = reinterpret_cast<SearchResultList*>(event.GetClientData());
+        for(const auto& result : *results) {
+            matches.push_back(wxString() << result.GetFileName() << ":" << result.GetLineNumber());
+        }
+        wxDELETE(results);
+    });
+    owner.Bind(wxEVT_SEARCH_THREAD_SEARCHSTARTED, [](wxCommandEvent& event) {
+        SearchData* data = reinterpret_cast<SearchData*>(event.GetClientData());
+        wxDELETE(data);
+    });
+    owner.Bind(wxEVT_SEARCH_THREAD_SEARCHEND, [&](wxCommandEvent& event) {
+        SearchSummary* summary = reinterpret_cast<SearchSummary*>(event.GetClientData());
+        wxDELETE(summary);
+        search_ended = true;
+    });
+
+    wxArrayString root_dirs;
+    root_dirs.Add(root);
+
+    SearchData data;
+    data.SetRootDirs(root_dirs);
+    data.SetExtensions("*.cpp");
+    data.SetFindString("findmemarker");
+    data.SetMatchCase(false);
+    data.SetOwner(&owner);
+    data.SetThreadCount(threads);
+
+    SearchThread searcher;
+    searcher.Start();
+
+    wxStopWatch sw;
+    searcher.PerformSearch(data);
+    while(!search_ended) {
+        wxMilliSleep(1);
+        owner.ProcessPendingEvents();
+    }
+    *elapsed_ms = sw.Time();
+    return matches;
+}
+} // namespace
+
+TEST_FUNC(test_search_thread_parallel_search)
+{
+    TestTempDir root("codelite-tests-search-tree");
+    create_search_tree(root, 40, 2000);
+
+    long serial_ms = 0;
+    long parallel_ms = 0;
+    auto serial = run_search(root.GetPath(), 1, &serial_ms);
+    auto parallel = run_search(root.GetPath(), 0, &parallel_ms);
+
+    // both modes must report the same matches, in the same order
+    CHECK_SIZE(serial.size(), 40 * 21);
+    CHECK_SIZE(parallel.size(), serial.size());
+    CHECK_BOOL(serial == parallel);
+    return true;
+}
+
+BENCHMARK_FUNC(benchmark_search_thread_parallel_search)
+{
+    TestTempDir root("codelite-tests-search-tree");
+    create_search_tree(root, 400, 2000);
+
+    long serial_ms = 0;
+    long parallel_ms = 0;
+    auto serial = run_search(root.GetPath(), 1, &serial_ms);
+    auto parallel = run_search(root.GetPath(), 0, &parallel_ms);
+    wxPrintf("Find in files: serial %ldms, parallel (%d threads) %ldms\n", serial_ms, wxThread::GetCPUCount(),
+             parallel_ms);
+    CHECK_SIZE(parallel.size(), serial.size());
+    return true;
+}
+
+TEST_FUNC(test_trigram_index)
+{
+    {
+        auto literals = clTrigramIndex::GetRequiredLiterals("foo.*bar");
+        CHECK_SIZE(literals.size(), 2);
+        CHECK_STRING(literals[0], "foo");
+        CHECK_STRING(literals[1], "bar");
+    }
+    {
+        auto literals = clTrigramIndex::GetRequiredLiterals("colou?r");
+        CHECK_SIZE(literals.size(), 2);
+        CHECK_STRING(literals[0], "colo");
+        CHECK_STRING(literals[1], "r");
+    }
+    {
+        auto literals = clTrigramIndex::GetRequiredLiterals("(abc)?def");
+        CHECK_SIZE(literals.size(), 1);
+        CHECK_STRING(literals[0], "def");
+    }
+    {
+        auto literals = clTrigramIndex::GetRequiredLiterals("\\bwx[A-Z]+Event\\(");
+        CHECK_SIZE(literals.size(), 2);
+        CHECK_STRING(literals[0], "wx");
+        CHECK_STRING(literals[1], "Event(");
+    }
+    {
+        // bracket expressions containing classes: the first ']' does not end them
+        auto literals = clTrigramIndex::GetRequiredLiterals("[[:alpha:]_]+Handler[[.].][=e=]]end");
+        CHECK_SIZE(literals.size(), 2);
+        CHECK_STRING(literals[0], "Handler");
+        CHECK_STRING(literals[1], "end");
+    }
+    {
+        // the digits of a character entry are not part of a literal. \x takes all the hex digits that follow
+        CHECK_BOOL(clTrigramIndex::GetRequiredLiterals("\\x41BC").empty());
+        auto literals = clTrigramIndex::GetRequiredLiterals("\\u0041BC");
+        CHECK_SIZE(literals.size(), 1);
+        CHECK_STRING(literals[0], "BC");
+        literals = clTrigramIndex::GetRequiredLiterals("\\101BC");
+        CHECK_SIZE(literals.size(), 1);
+        CHECK_STRING(literals[0], "BC");
+        literals = clTrigramIndex::GetRequiredLiterals("foo\\x41;bar");
+        CHECK_SIZE(literals.size(), 2);
+        CHECK_STRING(literals[0], "foo");
+        CHECK_STRING(literals[1], ";bar");
+    }
+    CHECK_BOOL(clTrigramIndex::GetRequiredLiterals("foo[[:alpha").empty());
+    CHECK_BOOL(clTrigramIndex::GetRequiredLiterals("foo|bar").empty());
+
+    TestTempDir root("codelite-tests-trigram-index");
+    wxFileName file1 = root.GetFile("file1.cpp");
+    wxFileName file2 = root.GetFile("file2.cpp");
+    wxFileName not_indexed = root.GetFile("file3.cpp");
+    FileUtils::WriteFileContent(file1, "int main() {\n    printf(\"Hello World\");\n}\n");
+    FileUtils::WriteFileContent(file2, "int main() {\n    return 0;\n}\n");
+    FileUtils::WriteFileContent(not_indexed, "// no hello here\n");
+
+    clTrigramIndex index;
+    CHECK_BOOL(index.Open(root.GetFile("index.db")));
+
+    wxArrayString files;
+    files.Add(file1.GetFullPath());
+    files.Add(file2.GetFullPath());
+    index.Sync(files);
+
+    files.Add(not_indexed.GetFullPath());
+    CHECK_BOOL(index.FilterFiles({ "hello world" }, files));
+    CHECK_SIZE(files.size(), 2);
+    CHECK_STRING(files[0], file1.GetFullPath());
+    CHECK_STRING(files[1], not_indexed.GetFullPath());
+
+    // a file modified after it was indexed is kept until the index is updated
+    FileUtils::WriteFileContent(file2, "int main() {\n    puts(\"hello world\");\n}\n");
+    files.Add(file2.GetFullPath());
+    CHECK_BOOL(index.FilterFiles({ "hello world" }, files));
+    CHECK_SIZE(files.size(), 3);
+    CHECK_STRING(files[2], file2.GetFullPath());
+
+    // too short to be narrowed down by the index
+    CHECK_BOOL(!index.FilterFiles({ "he" }, files));
+    index.Close();
+    return true;
+}
+
+TEST_FUNC(test_file_change_detector)
+{
+    CHECK_BOOL(clFileChangeDetector::Hash("", 0) == 0xEF46DB3751D8E999ULL);
+    CHECK_BOOL(clFileChangeDetector::Hash("a", 1) == 0xD24EC4F1A98C6E5BULL);
+
+    TestTempDir root("codelite-tests-file-change-detector");
+    wxFileName dbfile = root.GetFile("tags.db");
+    wxFileName file1 = root.GetFile("file1.cpp");
+    wxFileName file2 = root.GetFile("file2.cpp");
+    FileUtils::WriteFileContent(file1, "int a = 1;\n");
+    FileUtils::WriteFileContent(file2, "int b = 2;\n");
+
+    ITagsStoragePtr db(new TagsStorageSQLite());
+    db->OpenDatabase(dbfile);
+
+    // new files
+    wxArrayString files;
+    files.Add(file1.GetFullPath());
+    files.Add(file2.GetFullPath());
+    std::vector<FileEntryPtr> fingerprints;
+    TagsManagerST::Get()->FilterNonNeededFilesForRetaging(files, db, &fingerprints);
+    CHECK_SIZE(files.size(), 2);
+    CHECK_SIZE(fingerprints.size(), 2);
+    for (const auto& entry : fingerprints) {
+        CHECK_BOOL(entry->HasFingerprint());
+        db->StoreFileEntry(*entry);
+    }
+
+    // nothing changed
+    files.Clear();
+    files.Add(file1.GetFullPath());
+    files.Add(file2.GetFullPath());
+    {
+        std::vector<FileEntryPtr> entries;
+        db->GetFiles(entries);
+        CHECK_SIZE(entries.size(), 2);
+        clFileChangeDetector detector;
+        detector.Check(files, entries);
+        CHECK_SIZE(detector.GetStats().stat_skipped, 2);
+        CHECK_SIZE(detector.GetModified().size(), 0);
+    }
+
+    // file1 is touched, file2 is modified (same size)
+    wxDateTime past = wxDateTime::Now() - wxTimeSpan::Hours(1);
+    FileUtils::WriteFileContent(file2, "int b = 3;\n");
+    file1.SetTimes(nullptr, &past, nullptr);
+    file2.SetTimes(nullptr, &past, nullptr);
+    {
+        std::vector<FileEntryPtr> entries;
+        db->GetFiles(entries);
+        clFileChangeDetector detector;
+        detector.Check(files, entries);
+        CHECK_SIZE(detector.GetStats().stat_skipped, 0);
+        CHECK_SIZE(detector.GetStats().hash_skipped, 1);
+        CHECK_SIZE(detector.GetStats().modified, 1);
+        CHECK_STRING(detector.GetTouched()[0]->GetFile(), file1.GetFullPath());
+        CHECK_STRING(detector.GetModified()[0]->GetFile(), file2.GetFullPath());
+    }
+
+    // the touched file is updated in the database, so it is not hashed again
+    TagsManagerST::Get()->FilterNonNeededFilesForRetaging(files, db);
+    CHECK_SIZE(files.size(), 1);
+    CHECK_STRING(files[0], file2.GetFullPath());
+    {
+        std::vector<FileEntryPtr> entries;
+        db->GetFiles(entries);
+        clFileChangeDetector detector;
+        detector.Check(files, entries);
+        CHECK_SIZE(detector.GetStats().modified, 1);
+        files.Clear();
+        files.Add(file1.GetFullPath());
+        detector.Check(files, entries);
+        CHECK_SIZE(detector.GetStats().stat_skipped, 1);
+    }
+    return true;
+}
+
+TEST_FUNC(test_tags_storage_substring_search)
+{
+    TestTempDir root("codelite-tests-substring-search");
+    wxFileName dbfile = root.GetFile("tags.db");
+
+    auto make_tag = [](const wxString& file, const wxString& scope, const wxString& name, int line) {
+        TagEntryPtr tag(new TagEntry());
+        tag->SetName(name);
+        tag->SetFile(file);
+        tag->SetLine(line);
+        tag->SetKind("function");
+        tag->SetScope(scope);
+        tag->SetParent(scope);
+        tag->SetPath(scope + "::" + name);
+        return tag;
+    };
+
+    const wxString scopes[] = { "Editor", "Manager", "Workspace", "Project", "Cache", "Parser" };
+    const wxString words[] = { "Get", "Set", "File", "Name", "Line", "Path", "Text", "Item" };
+    std::vector<TagEntryPtr> tags;
+    for(size_t i = 0; i < 200000; ++i) {
+        wxString name;
+        name << words[i % 8] << words[(i / 8) % 8] << words[(i / 64) % 8] << i;
+        tags.push_back(make_tag(wxString() << "/src/file" << (i / 100) << ".cpp", scopes[(i / 7) % 6], name, i % 1000));
+    }
+    tags.push_back(make_tag("/src/main.cpp", "Editor", "DoGetTextLength", 1));
+    tags.push_back(make_tag("/src/main.cpp", "Editor", "GetTextFile", 2));
+    tags.push_back(make_tag("/src/main.cpp", "Editor", "TextFile", 3));
+
+    TagsStorageSQLite db;
+    db.OpenDatabase(dbfile);
+    db.SetUseCache(false);
+    db.Store(tags, true);
+
+    // best match first
+    std::vector<TagEntryPtr> matches;
+    db.GetTagsByPartName("gettextfile", matches);
+    CHECK_SIZE(matches.size(), MAX_SEARCH_LIMIT);
+    CHECK_STRING(matches[0]->GetName(), "GetTextFile");
+
+    // the exact match is found even when the index returns thousands of other matches before it
+    matches.clear();
+    db.GetTagsByPartName("TextFile", matches);
+    CHECK_SIZE(matches.size(), MAX_SEARCH_LIMIT);
+    CHECK_STRING(matches[0]->GetName(), "TextFile");
+
+    // too short for the trigram index
+    matches.clear();
+    db.GetTagsByPartName("do", matches);
+    CHECK_SIZE(matches.size(), 1);
+
+    // all the parts must be found in the path, short parts are not indexed
+    for(const wxString& scope_part : { "editor", "ed" }) {
+        wxArrayString parts;
+        parts.Add(scope_part);
+        parts.Add("TextLen");
+        matches.clear();
+        db.GetTagsByPartName(parts, matches);
+        CHECK_SIZE(matches.size(), 1);
+        CHECK_STRING(matches[0]->GetName(), "DoGetTextLength");
+    }
+
+    // the index follows the tags table
+    db.Store({ make_tag("/src/main.cpp", "Editor", "DoGetTextSize", 1) }, true);
+    matches.clear();
+    db.GetTagsByPartName("DoGetText", matches);
+    CHECK_SIZE(matches.size(), 1);
+    CHECK_STRING(matches[0]->GetName(), "DoGetTextSize");
+    return true;
+}
+
+namespace
+{
+std::vector<TagEntryPtr> make_function_tags(size_t count)
+{
+    std::vector<TagEntryPtr> tags;
+    for(size_t i = 0; i < count; ++i) {
+        TagEntryPtr tag(new TagEntry());
+        tag->SetName(wxString() << "Function" << i);
+        tag->SetFile(wxString() << "/src/file" << (i / 100) << ".cpp");
+        tag->SetLine(i % 100);
+        tag->SetKind("function");
+        tag->SetScope(wxString() << "Class" << (i / 100));
+        tag->SetPath(wxString() << "Class" << (i / 100) << "::Function" << i);
+        tags.push_back(tag);
+    }
+    return tags;
+}
+
+/// store the tags the way ctagsd does: one transaction per chunk
+ITagsStoragePtr store_function_tags(const wxFileName& dbfile, const std::vector<TagEntryPtr>& tags, bool bulk_load)
+{
+    ITagsStoragePtr db(new TagsStorageSQLite());
+    db->OpenDatabase(dbfile);
+    db->SetUseCache(false);
+
+    if(bulk_load) {
+        db->BeginBulkLoad();
+    }
+    for(size_t i = 0; i < tags.size(); i += 10000) {
+        db->Begin();
+        db->Store(std::vector<TagEntryPtr>(tags.begin() + i, tags.begin() + std::min(i + 10000, tags.size())), false);
+        db->Commit();
+    }
+    if(bulk_load) {
+        db->EndBulkLoad();
+    }
+    return db;
+}
+} // namespace
+
+TEST_FUNC(test_tags_storage_bulk_load)
+{
+    TestTempDir root("codelite-tests-bulk-load");
+    std::vector<TagEntryPtr> tags = make_function_tags(100000);
+    auto incremental = store_function_tags(root.GetFile("incremental.db"), tags, false);
+    auto bulk = store_function_tags(root.GetFile("bulk-load.db"), tags, true);
+    CHECK_BOOL(bulk->HasTags());
+
+    // both databases are searchable the same way
+    std::vector<TagEntryPtr> incremental_matches;
+    std::vector<TagEntryPtr> bulk_matches;
+    incremental->GetTagsByPartName("Function9999", incremental_matches);
+    bulk->GetTagsByPartName("Function9999", bulk_matches);
+    CHECK_SIZE(bulk_matches.size(), incremental_matches.size());
+    CHECK_SIZE(bulk_matches.size(), 11);
+    CHECK_STRING(bulk_matches[0]->GetName(), "Function9999");
+
+    bulk_matches.clear();
+    bulk->GetTagsByScope("Class999", bulk_matches);
+    CHECK_SIZE(bulk_matches.size(), 100);
+
+    // after a bulk load, the tags are stored incrementally
+    bulk->Store(std::vector<TagEntryPtr>(tags.begin(), tags.begin() + 1), true);
+    bulk_matches.clear();
+    bulk->GetTagsByPartName("Function1", bulk_matches);
+    CHECK_STRING(bulk_matches[0]->GetName(), "Function1");
+    return true;
+}
+
+BENCHMARK_FUNC(benchmark_tags_storage_bulk_load)
+{
+    TestTempDir root("codelite-tests-bulk-load");
+    std::vector<TagEntryPtr> tags = make_function_tags(100000);
+    for(bool bulk_load : { false, true }) {
+        wxStopWatch sw;
+        auto db = store_function_tags(root.GetFile(bulk_load ? "bulk-load.db" : "incremental.db"), tags, bulk_load);
+        wxPrintf("Tags storage: storing %d tags took %ldms (%s)\n", (int)tags.size(), sw.Time(),
+                 bulk_load ? "bulk load" : "incremental");
+        CHECK_BOOL(db->HasTags());
+    }
+    return true;
+}
+
+#if CL_USE_PROCESS_REACTOR && CL_USE_POSIX_SPAWN
+namespace
+{
+/// the events that clProcessReactor sends to its owner. Consecutive outputs of the same kind are merged, so the list
+/// tells in which order stdout and stderr were written
+class ReactorEvents
+{
+    wxEvtHandler m_owner;
+    std::vector<std::pair<wxEventType, std::string>> m_outputs;
+    size_t m_eventsCount = 0;
+    bool m_terminated = false;
+    wxString m_exitMessage;
+
+    void OnOutput(clProcessEvent& event)
+    {
+        ++m_eventsCount;
+        if(m_outputs.empty() || m_outputs.back().first != event.GetEventType()) {
+            m_outputs.push_back({ event.GetEventType(), std::string() });
+        }
+        m_outputs.back().second.append(event.GetOutputRaw());
+    }
+
+public:
+    ReactorEvents()
+    {
+        m_owner.Bind(wxEVT_ASYNC_PROCESS_OUTPUT, &ReactorEvents::OnOutput, this);
+        m_owner.Bind(wxEVT_ASYNC_PROCESS_STDERR, &ReactorEvents::OnOutput, this);
+        m_owner.Bind(wxEVT_ASYNC_PROCESS_TERMINATED, [this](clProcessEvent& event) {
+            ++m_eventsCount;
+            m_terminated = true;
+            m_exitMessage = event.GetString();
+        });
+    }
+
+    /// handle the events sent so far, for `ms` milliseconds or until `done` returns true
+    bool Wait(long ms, const std::function<bool()>& done = nullptr)
+    {
+        wxStopWatch sw;
+        do {
+            m_owner.ProcessPendingEvents();
+            if(done && done()) {
+                return true;
+            }
+            wxMilliSleep(1);
+        } while(sw.Time() < ms);
+        return false;
+    }
+    bool WaitForTerminated(long ms = 5000)
+    {
+        return Wait(ms, [this]() { return m_terminated; });
+    }
+    bool WaitForOutput(const std::string& output, long ms = 5000)
+    {
+        return Wait(ms, [&]() { return GetStdout().find(output) != std::string::npos; });
+    }
+
+    std::string GetStdout() const
+    {
+        std::string output;
+        for(const auto& [type, text] : m_outputs) {
+            output += (type == wxEVT_ASYNC_PROCESS_OUTPUT) ? text : std::string();
+        }
+        return output;
+    }
+
+    wxEvtHandler* GetOwner() { return &m_owner; }
+    const std::vector<std::pair<wxEventType, std::string>>& GetOutputs() const { return m_outputs; }
+    size_t GetEventsCount() const { return m_eventsCount; }
+    bool IsTerminated() const { return m_terminated; }
+    const wxString& GetExitMessage() const { return m_exitMessage; }
+};
+
+/// a shell script started with its output in pipes that are read by clProcessReactor
+struct ReactorProcess {
+    int pid = wxNOT_FOUND;
+    /// the script is a process group leader, the group outlives it when it started processes in the background
+    int pgid = wxNOT_FOUND;
+    int stdin_fd = wxNOT_FOUND;
+    int stdout_fd = wxNOT_FOUND;
+    int stderr_fd = wxNOT_FOUND;
+    uint64_t id = 0;
+
+    ~ReactorProcess()
+    {
+        if(id) {
+            clProcessReactor::Get().Remove(id);
+        }
+        if(pgid != wxNOT_FOUND) {
+            ::kill(-pgid, SIGKILL);
+        }
+        if(pid != wxNOT_FOUND) {
+            ::waitpid(pid, nullptr, 0);
+        }
+        for(int fd : { stdin_fd, stdout_fd, stderr_fd }) {
+            if(fd != wxNOT_FOUND) {
+                ::close(fd);
+            }
+        }
+    }
+
+    bool Start(const char* script, ReactorEvents& events, bool write_with_reactor = false)
+    {
+        int stdin_pipe[2], stdout_pipe[2], stderr_pipe[2];
+        if(::pipe2(stdin_pipe, O_CLOEXEC) < 0 || ::pipe2(stdout_pipe, O_CLOEXEC) < 0 ||
+           ::pipe2(stderr_pipe, O_CLOEXEC) < 0) {
+            return false;
+        }
+
+        clPosixSpawn::Options options;
+        options.stdin_fd = stdin_pipe[0];
+        options.stdout_fd = stdout_pipe[1];
+        options.stderr_fd = stderr_pipe[1];
+        const char* argv[] = { "/bin/sh", "-c", script, nullptr };
+        pid = clPosixSpawn::Spawn(const_cast<char* const*>(argv), options);
+        ::close(stdin_pipe[0]);
+        ::close(stdout_pipe[1]);
+        ::close(stderr_pipe[1]);
+        stdin_fd = stdin_pipe[1];
+        stdout_fd = stdout_pipe[0];
+        stderr_fd = stderr_pipe[0];
+        if(pid == wxNOT_FOUND) {
+            return false;
+        }
+        pgid = pid;
+
+        clProcessReactor::Registration reg;
+        reg.pid = pid;
+        reg.stdout_fd = stdout_fd;
+        reg.stderr_fd = stderr_fd;
+        reg.stdin_fd = write_with_reactor ? stdin_fd : wxNOT_FOUND;
+        reg.owner = events.GetOwner();
+        reg.wait = [this]() {
+            int status = 0;
+            ::waitpid(pid, &status, 0);
+            pid = wxNOT_FOUND;
+            return WIFEXITED(status) ? WEXITSTATUS(status) : wxNOT_FOUND;
+        };
+        id = clProcessReactor::Get().Add(reg);
+        return id != 0;
+    }
+
+    bool WriteToStdin(const std::string& data) const
+    {
+        return ::write(stdin_fd, data.c_str(), data.length()) == (ssize_t)data.length();
+    }
+};
+
+bool has_pidfd()
+{
+#ifdef SYS_pidfd_open
+    int fd = static_cast<int>(::syscall(SYS_pidfd_open, ::getpid(), 0));
+    if(fd != wxNOT_FOUND) {
+        ::close(fd);
+        return true;
+    }
+#endif
+    return false;
+}
+} // namespace
+
+TEST_FUNC(test_process_reactor_output)
+{
+    ReactorEvents events;
+    ReactorProcess process;
+    CHECK_BOOL(process.Start("i=0; while [ $i -lt 1000 ]; do echo line$i; i=$((i + 1)); done; exit 3", events));
+    CHECK_BOOL(events.WaitForTerminated());
+
+    // all the output, before the termination
+    std::string expected;
+    for(int i = 0; i < 1000; ++i) {
+        expected += "line" + std::to_string(i) + "\n";
+    }
+    CHECK_BOOL(events.GetStdout() == expected);
+    CHECK_WXSTRING(events.GetExitMessage().BeforeFirst(':'), "Process exit code (3)");
+
+    // the lines written together are sent together
+    CHECK_BOOL(events.GetEventsCount() < 100);
+    return true;
+}
+
+TEST_FUNC(test_process_reactor_stdout_stderr_order)
+{
+    ReactorEvents events;
+    ReactorProcess process;
+    CHECK_BOOL(process.Start("echo out1; sleep 0.05; echo err1 >&2; sleep 0.05; echo out2; echo out3; sleep 0.05; "
+                             "echo err2 >&2",
+                             events));
+    CHECK_BOOL(events.WaitForTerminated());
+
+    const auto& outputs = events.GetOutputs();
+    CHECK_SIZE(outputs.size(), 4);
+    CHECK_BOOL(outputs[0].first == wxEVT_ASYNC_PROCESS_OUTPUT);
+    CHECK_STRING(outputs[0].second.c_str(), "out1\n");
+    CHECK_BOOL(outputs[1].first == wxEVT_ASYNC_PROCESS_STDERR);
+    CHECK_STRING(outputs[1].second.c_str(), "err1\n");
+    CHECK_BOOL(outputs[2].first == wxEVT_ASYNC_PROCESS_OUTPUT);
+    CHECK_STRING(outputs[2].second.c_str(), "out2\nout3\n");
+    CHECK_BOOL(outputs[3].first == wxEVT_ASYNC_PROCESS_STDERR);
+    CHECK_STRING(outputs[3].second.c_str(), "err2\n");
+    return true;
+}
+
+TEST_FUNC(test_process_reactor_suspend_resume)
+{
+    ReactorEvents events;
+    ReactorProcess process;
+    CHECK_BOOL(process.Start("echo first; read a; echo second; read b; echo third", events));
+    CHECK_BOOL(events.WaitForOutput("first\n"));
+
+    // while suspended, the output is read synchronously and no event is sent
+    clProcessReactor::Get().Suspend(process.id);
+    CHECK_BOOL(process.WriteToStdin("a\n"));
+    pollfd pfd = { process.stdout_fd, POLLIN, 0 };
+    CHECK_BOOL(::poll(&pfd, 1, 5000) == 1);
+    char buffer[64];
+    ssize_t bytes_read = ::read(process.stdout_fd, buffer, sizeof(buffer));
+    CHECK_BOOL(std::string(buffer, std::max<ssize_t>(bytes_read, 0)) == "second\n");
+    events.Wait(50);
+    CHECK_BOOL(events.GetStdout() == "first\n");
+
+    clProcessReactor::Get().Resume(process.id);
+    CHECK_BOOL(process.WriteToStdin("b\n"));
+    CHECK_BOOL(events.WaitForTerminated());
+    CHECK_BOOL(events.GetStdout() == "first\nthird\n");
+    return true;
+}
+
+TEST_FUNC(test_process_reactor_write)
+{
+    ReactorEvents events;
+    ReactorProcess process;
+    CHECK_BOOL(process.Start("head -c 1048576 | wc -c", events, true));
+
+    // much more than the pipe buffer: the reactor writes it as the process reads it
+    std::string data(1024 * 1024, 'x');
+    CHECK_BOOL(clProcessReactor::Get().Write(process.id, data.substr(0, 1000)));
+    CHECK_BOOL(clProcessReactor::Get().Write(process.id, data.substr(1000)));
+    CHECK_BOOL(events.WaitForTerminated());
+    CHECK_WXSTRING(wxString(events.GetStdout()).Trim().Trim(false), "1048576");
+    return true;
+}
+
+TEST_FUNC(test_process_reactor_grandchild_keeps_output_open)
+{
+    if(!has_pidfd()) {
+        // without a pidfd, the exit is only detected when the output is closed
+        return true;
+    }
+
+    ReactorEvents events;
+    ReactorProcess process;
+    wxStopWatch sw;
+    CHECK_BOOL(process.Start("sleep 30 & echo started", events));
+    CHECK_BOOL(events.WaitForTerminated(10000));
+    CHECK_BOOL(sw.Time() < 10000);
+    CHECK_BOOL(events.GetStdout() == "started\n");
+    CHECK_WXSTRING(events.GetExitMessage().BeforeFirst(':'), "Process exit code (0)");
+    return true;
+}
+
+TEST_FUNC(test_process_reactor_remove_with_pending_output)
+{
+    ReactorEvents events;
+    ReactorProcess process;
+    CHECK_BOOL(process.Start("while true; do echo data; done", events));
+    CHECK_BOOL(events.WaitForOutput("data\n"));
+
+    // the output read so far is dropped, nothing is sent once Remove() returns
+    clProcessReactor::Get().Remove(process.id);
+    process.id = 0;
+    events.GetOwner()->DeletePendingEvents();
+    size_t count = events.GetEventsCount();
+    events.Wait(50);
+    CHECK_SIZE(events.GetEventsCount(), count);
+    CHECK_BOOL(!events.IsTerminated());
+    return true;
+}
+#endif
+
+#ifndef __WXMSW__
+TEST_FUNC(test_async_process_launch)
+{
+    for(int i = 0; i < 10; ++i) {
+        std::unique_ptr<IProcess> process(::CreateAsyncProcess(nullptr, "/bin/true", IProcessCreateSync));
+        CHECK_BOOL(process != nullptr);
+        wxString output;
+        process->WaitForTerminate(output);
+    }
+
+    // a pipe based process, in a working directory
+    std::unique_ptr<IProcess> process(
+        ::CreateAsyncProcess(nullptr, "pwd", IProcessCreateSync | IProcessNoPty, wxFileName::GetTempDir()));
+    CHECK_BOOL(process != nullptr);
+    wxString output;
+    process->WaitForTerminate(output);
+    output.Trim();
+    CHECK_BOOL(wxFileName(output).SameAs(wxFileName(wxFileName::GetTempDir())));
+
+    // unlike fork(), posix_spawn reports a missing executable to the caller
+    if(CL_USE_POSIX_SPAWN) {
+        process.reset(::CreateAsyncProcess(nullptr, "/no/such/executable", IProcessCreateSync));
+        CHECK_BOOL(process == nullptr);
+    }
+    return true;
+}
+
+BENCHMARK_FUNC(benchmark_async_process_launch)
+{
+    constexpr int count = 1000;
+    wxStopWatch sw;
+    for(int i = 0; i < count; ++i) {
+        std::unique_ptr<IProcess> process(::CreateAsyncProcess(nullptr, "/bin/true", IProcessCreateSync));
+        CHECK_BOOL(process != nullptr);
+        wxString output;
+        process->WaitForTerminate(output);
+    }
+    wxPrintf("Async process: launching %d processes took %ldms (%s)\n", count, sw.Time(),
+             CL_USE_POSIX_SPAWN ? "posix_spawn" : "fork");
+    return true;
+}
+#endif
+
+#if CL_FSW_USE_INOTIFY
+namespace
+{
+/// a watcher that can't add an inotify watch for the directories named "polled", and whose timer is run by the test
+class TestFileSystemWatcher : public clFileSystemWatcher
+{
+protected:
+    int AddInotifyWatch(const wxString& dir) override
+    {
+        return dir.AfterLast('/') == "polled" ? wxNOT_FOUND : clFileSystemWatcher::AddInotifyWatch(dir);
+    }
+
+public:
+    void Poll()
+    {
+        wxTimerEvent event;
+        OnTimer(event);
+    }
+};
+
+/// the events that clFileSystemWatcher sends to its owner
+class WatcherEvents
+{
+    wxEvtHandler m_owner;
+    clFileSystemWatcher& m_watcher;
+    std::vector<std::pair<wxEventType, wxArrayString>> m_events;
+
+public:
+    WatcherEvents(clFileSystemWatcher& watcher)
+        : m_watcher(watcher)
+    {
+        m_watcher.SetOwner(&m_owner);
+        auto on_event = [this](clFileSystemEvent& event) {
+            m_events.push_back({ event.GetEventType(), event.GetPaths() });
+        };
+        m_owner.Bind(wxEVT_FILE_MODIFIED, on_event);
+        m_owner.Bind(wxEVT_FILE_NOT_FOUND, on_event);
+    }
+    ~WatcherEvents() { m_watcher.SetOwner(nullptr); }
+
+    /// handle the events sent so far, for `ms` milliseconds or until `count` events were received
+    bool Wait(size_t count, long ms = 5000)
+    {
+        wxStopWatch sw;
+        do {
+            // the inotify events are handed to the watcher with CallAfter()
+            m_watcher.ProcessPendingEvents();
+            m_owner.ProcessPendingEvents();
+            if(m_events.size() >= count) {
+                return true;
+            }
+            wxMilliSleep(1);
+        } while(sw.Time() < ms);
+        return false;
+    }
+
+    /// remove the events received so far
+    std::vector<std::pair<wxEventType, wxArrayString>> Take()
+    {
+        std::vector<std::pair<wxEventType, wxArrayString>> events;
+        events.swap(m_events);
+        return events;
+    }
+};
+
+/// change the modification time of `file`, the way `touch` does
+void touch_file(const wxFileName& file, int seconds_ago)
+{
+    wxDateTime time = wxDateTime::Now() - wxTimeSpan::Seconds(seconds_ago);
+    file.SetTimes(nullptr, &time, nullptr);
+}
+} // namespace
+
+TEST_FUNC(test_file_system_watcher_batch)
+{
+    TestTempDir root("codelite-tests-fsw-batch");
+    clFileSystemWatcher watcher;
+    WatcherEvents events(watcher);
+
+    wxArrayString expected;
+    for(int i = 0; i < 50; ++i) {
+        wxFileName file = root.GetFile(wxString() << "file_" << i << ".cpp");
+        FileUtils::WriteFileContent(file, "int a;\n");
+        watcher.AddFile(file);
+        expected.Add(file.GetFullPath());
+    }
+    watcher.Start();
+    CHECK_BOOL(watcher.IsRunning());
+
+    // half of the files are written again, the other half are touched: a single event reports them all
+    for(int i = 0; i < 50; ++i) {
+        if(i % 2 == 0) {
+            FileUtils::WriteFileContent(expected[i], "int b;\n");
+        } else {
+            touch_file(expected[i], 60);
+        }
+    }
+    CHECK_BOOL(events.Wait(1));
+    CHECK_BOOL(!events.Wait(2, 300));
+    auto received = events.Take();
+    CHECK_BOOL(received[0].first == wxEVT_FILE_MODIFIED);
+    wxArrayString paths = received[0].second;
+    paths.Sort();
+    expected.Sort();
+    CHECK_BOOL(paths == expected);
+
+    // so are the deleted files
+    for(int i = 0; i < 10; ++i) {
+        FileUtils::RemoveFile(expected[i]);
+    }
+    CHECK_BOOL(events.Wait(1));
+    received = events.Take();
+    CHECK_BOOL(received[0].first == wxEVT_FILE_NOT_FOUND);
+    CHECK_SIZE(received[0].second.size(), 10);
+    return true;
+}
+
+TEST_FUNC(test_file_system_watcher_new_directory)
+{
+    TestTempDir root("codelite-tests-fsw-new-directory");
+    clFileSystemWatcher watcher;
+    WatcherEvents events(watcher);
+    FileUtils::WriteFileContent(root.GetFile("main.cpp"), "int main() {}\n");
+    watcher.AddFile(root.GetFile("main.cpp"));
+    watcher.Start();
+
+    // a file created in a new directory, added while the watcher runs
+    wxFileName file(root.GetPath() + "/src", "new.cpp");
+    CHECK_BOOL(file.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL));
+    FileUtils::WriteFileContent(file, "int a;\n");
+    watcher.AddFile(file);
+
+    FileUtils::WriteFileContent(file, "int b;\n");
+    CHECK_BOOL(events.Wait(1));
+    auto received = events.Take();
+    CHECK_BOOL(received[0].first == wxEVT_FILE_MODIFIED);
+    CHECK_SIZE(received[0].second.size(), 1);
+    CHECK_STRING(received[0].second[0], file.GetFullPath());
+
+    // the directory is deleted
+    CHECK_BOOL(wxFileName::Rmdir(file.GetPath(), wxPATH_RMDIR_RECURSIVE));
+    CHECK_BOOL(events.Wait(1));
+    received = events.Take();
+    CHECK_BOOL(received[0].first == wxEVT_FILE_NOT_FOUND);
+    CHECK_SIZE(received[0].second.size(), 1);
+    CHECK_STRING(received[0].second[0], file.GetFullPath());
+
+    // the other directory is still watched
+    FileUtils::WriteFileContent(root.GetFile("main.cpp"), "int main() { return 0; }\n");
+    CHECK_BOOL(events.Wait(1));
+    CHECK_STRING(events.Take()[0].second[0], root.GetFile("main.cpp").GetFullPath());
+    return true;
+}
+
+TEST_FUNC(test_file_system_watcher_polling_fallback)
+{
+    TestTempDir root("codelite-tests-fsw-polling");
+    wxFileName polled(root.GetPath() + "/polled", "polled.cpp");
+    wxFileName watched(root.GetPath() + "/watched", "watched.cpp");
+    for(const wxFileName& file : { polled, watched }) {
+        file.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+        FileUtils::WriteFileContent(file, "int a;\n");
+    }
+
+    TestFileSystemWatcher watcher;
+    WatcherEvents events(watcher);
+    watcher.AddFile(polled);
+    watcher.AddFile(watched);
+    watcher.Start();
+
+    // the directory that can't be watched by inotify: its changes are found by the timer only
+    touch_file(polled, 60);
+    CHECK_BOOL(!events.Wait(1, 300));
+    watcher.Poll();
+    CHECK_BOOL(events.Wait(1));
+    auto received = events.Take();
+    CHECK_BOOL(received[0].first == wxEVT_FILE_MODIFIED);
+    CHECK_SIZE(received[0].second.size(), 1);
+    CHECK_STRING(received[0].second[0], polled.GetFullPath());
+
+    // the other one is still watched by inotify
+    touch_file(watched, 60);
+    CHECK_BOOL(events.Wait(1));
+    received = events.Take();
+    CHECK_SIZE(received[0].second.size(), 1);
+    CHECK_STRING(received[0].second[0], watched.GetFullPath());
+
+    FileUtils::RemoveFile(polled);
+    watcher.Poll();
+    CHECK_BOOL(events.Wait(1));
+    received = events.Take();
+    CHECK_BOOL(received[0].first == wxEVT_FILE_NOT_FOUND);
+    CHECK_STRING(received[0].second[0], polled.GetFullPath());
+    return true;
+}
+#endif
+
+TEST_FUNC(test_lsp_message_framer)
+{
+    // build a stream of 10k framed messages
+    std::string stream;
+    constexpr size_t messages_count = 10000;
+    for (size_t i = 0; i < messages_count; ++i) {
+        std::string payload = "{\"jsonrpc\":\"2.0\",\"id\":" + std::to_string(i) + ",\"result\":\"" +
+                              std::string(i % 512, 'x') + "\"}";
+        stream += "Content-Length: " + std::to_string(payload.length()) + "\r\n\r\n" + payload;
+    }
+
+    // feed it in 4K chunks, like the socket does
+    LSP::MessageFramer framer;
+    size_t count = 0;
+    bool ids_ok = true;
+    for (size_t offset = 0; offset < stream.length(); offset += 4096) {
+        framer.Append(stream.data() + offset, std::min<size_t>(4096, stream.length() - offset));
+        while (auto json = framer.NextJSON()) {
+            ids_ok = ids_ok && json->toElement()["id"].toSize_t() == count;
+            ++count;
+        }
+    }
+    CHECK_SIZE(count, messages_count);
+    CHECK_BOOL(ids_ok);
+    CHECK_BOOL(framer.IsEmpty());
+
+    // the headers and the payload split across reads
+    std::string_view payload;
+    framer.Append("content-length:");
+    CHECK_BOOL(!framer.Next(&payload));
+    framer.Append(" 7\r\nContent-Type: application/vscode-jsonrpc\r\n\r\n{\"a\"");
+    CHECK_BOOL(!framer.Next(&payload));
+    framer.Append(":1}Content-Length: 2");
+    CHECK_BOOL(framer.Next(&payload));
+    CHECK_STRING(std::string(payload), "{\"a\":1}");
+    CHECK_BOOL(!framer.Next(&payload));
+    CHECK_STRING(std::string(framer.GetPendingData()), "Content-Length: 2");
+    return true;
+}
+
+namespace
+{
+/// a completion response with `count` items
+std::string make_completion_response(size_t count)
+{
+    std::string completions = R"({"jsonrpc":"2.0","id":1,"result":{"isIncomplete":false,"items":[)";
+    for (size_t i = 0; i < count; ++i) {
+        if (i > 0) {
+            completions += ",";
+        }
+        completions += R"({"label":" push_back_)" + std::to_string(i) +
+                       R"(","kind":2,"detail":"void","documentation":{"kind":"markdown",)"
+                       R"("value":"Adds an \"element\" to the end\nof the vector é"},"insertTextFormat":2,)"
+                       R"("textEdit":{"newText":"push_back_)" +
+                       std::to_string(i) + R"(","range":{"start":{"line":10,"character":4},)"
+                                           R"("end":{"line":10,"character":8}}}})";
+    }
+    completions += "]}}";
+    return completions;
+}
+
+/// a semantic tokens response with `count` integers
+std::string make_semantic_tokens_response(size_t count)
+{
+    std::string tokens = R"({"jsonrpc":"2.0","id":2,"result":{"resultId":"1","data":[)";
+    for (size_t i = 0; i < count; ++i) {
+        tokens += (i > 0 ? "," : "") + std::to_string(i % 97);
+    }
+    tokens += "]}}";
+    return tokens;
+}
+
+void parse_with_cjson(const std::string& completions, const std::string& tokens,
+                      std::vector<LSP::CompletionItem>& items, std::vector<int>& data)
+{
+    JSON json(cJSON_ParseWithLength(completions.c_str(), completions.length()));
+    for (const auto& item : json.toElement()["result"]["items"].GetAsVector()) {
+        items.emplace_back();
+        items.back().FromJSON(item);
+    }
+    JSON tokens_json(cJSON_ParseWithLength(tokens.c_str(), tokens.length()));
+    data = tokens_json.toElement()["result"]["data"].toIntArray();
+}
+
+bool parse_with_json_reader(const std::string& completions, const std::string& tokens,
+                            std::vector<LSP::CompletionItem>& items, std::vector<int>& data)
+{
+    JSONReader reader(completions);
+    JSONReader tokens_reader(tokens);
+    if (!reader.isOk() || !tokens_reader.isOk()) {
+        return false;
+    }
+    auto json_items = reader.toElement()["result"]["items"];
+    for (auto item = json_items.firstChild(); item.isOk(); item = item.nextSibling()) {
+        items.emplace_back();
+        items.back().FromJSON(item);
+    }
+    data = tokens_reader.toElement()["result"]["data"].toIntArray();
+    return true;
+}
+} // namespace
+
+TEST_FUNC(test_json_reader)
+{
+    std::string completions = make_completion_response(5000);
+    std::string tokens = make_semantic_tokens_response(100000);
+
+    std::vector<LSP::CompletionItem> cjson_items;
+    std::vector<int> cjson_tokens;
+    parse_with_cjson(completions, tokens, cjson_items, cjson_tokens);
+
+    std::vector<LSP::CompletionItem> reader_items;
+    std::vector<int> reader_tokens;
+    CHECK_BOOL(parse_with_json_reader(completions, tokens, reader_items, reader_tokens));
+
+    CHECK_SIZE(reader_items.size(), 5000);
+    CHECK_SIZE(cjson_items.size(), reader_items.size());
+    for (size_t i = 0; i < reader_items.size(); i += 999) {
+        CHECK_STRING(reader_items[i].GetLabel(), cjson_items[i].GetLabel());
+        CHECK_STRING(reader_items[i].GetDocumentation().GetValue(), cjson_items[i].GetDocumentation().GetValue());
+        CHECK_BOOL(reader_items[i].GetTextEdit()->GetRange().GetEnd() ==
+                   cjson_items[i].GetTextEdit()->GetRange().GetEnd());
+    }
+    CHECK_STRING(reader_items[1].GetLabel(), "push_back_1");
+    CHECK_BOOL(reader_tokens == cjson_tokens);
+    CHECK_SIZE(reader_tokens.size(), 100000);
+
+    // malformed input
+    JSONReader broken(R"({"a":[1,2})");
+    CHECK_BOOL(!broken.isOk());
+    CHECK_BOOL(!broken.toElement()["a"].isOk());
+    return true;
+}
+
+BENCHMARK_FUNC(benchmark_json_reader)
+{
+    std::string completions = make_completion_response(5000);
+    std::string tokens = make_semantic_tokens_response(100000);
+
+    wxStopWatch sw;
+    std::vector<LSP::CompletionItem> cjson_items;
+    std::vector<int> cjson_tokens;
+    parse_with_cjson(completions, tokens, cjson_items, cjson_tokens);
+    long cjson_ms = sw.Time();
+
+    sw.Start();
+    std::vector<LSP::CompletionItem> reader_items;
+    std::vector<int> reader_tokens;
+    CHECK_BOOL(parse_with_json_reader(completions, tokens, reader_items, reader_tokens));
+    wxPrintf("JSON: cJSON %ldms, JSONReader %ldms\n", cjson_ms, sw.Time());
+    return true;
+}
+
+namespace
+{
+/// append `count` lines of ctags output (as produced by codelite-indexer) to `output`, 5 lines per "class" and 100
+/// lines per file
+void make_ctags_output(size_t first, size_t count, std::string& output)
+{
+    for (size_t i = first; i < first + count; i += 5) {
+        std::string file = "/home/user/src/project/file" + std::to_string(i / 100) + ".cpp";
+        std::string id = std::to_string(i);
+        std::string line = std::to_string(i % 100 + 1);
+        output += "Foo" + id + "\t" + file + "\t/^class Foo" + id + " {$/;\"\tclass\tline:" + line + "\tnamespace:ns\n";
+        output += "Bar" + id + "\t" + file + "\t/^    void Bar" + id +
+                  "(int a, const wxString& b);$/;\"\tprototype\tline:" + line + "\tclass:ns::Foo" + id +
+                  "\taccess:public\tsignature:(int a, const wxString& b)\n";
+        output += "Colour" + id + "\t" + file + "\t/^enum Colour" + id + " {$/;\"\tenum\tline:" + line +
+                  "\tnamespace:ns\n";
+        output += "kRed" + id + "\t" + file + "\t/^    kRed" + id + ",$/;\"\tenumerator\tline:" + line +
+                  "\tenum:ns::Colour" + id + "\n";
+        output += "x" + id + "\t" + file + "\t/^        int x" + id + ";$/;\"\tmember\tline:" + line +
+                  "\tstruct:ns::Foo" + id + "::__anon1\taccess:public\n";
+    }
+}
+} // namespace
+
+TEST_FUNC(test_ctags_output_parser)
+{
+    {
+        std::vector<TagEntryPtr> tags;
+        CTagsOutputParser parser(tags);
+        std::string output;
+        make_ctags_output(0, 5, output);
+        output += "MAX_SIZE\t/home/user/src/project/file0.cpp\t12;\"\tmacro\tline:12\n";
+        output += "not a ctags line\n\n";
+        parser.AddOutput(output);
+        CHECK_SIZE(parser.GetLinesCount(), 8);
+        CHECK_SIZE(tags.size(), 6);
+
+        CHECK_STRING(tags[0]->GetPath(), "ns::Foo0");
+        CHECK_STRING(tags[0]->GetFile(), "/home/user/src/project/file0.cpp");
+        CHECK_SIZE(tags[0]->GetLine(), 1);
+        CHECK_STRING(tags[1]->GetScope(), "ns::Foo0");
+        CHECK_STRING(tags[1]->GetSignature(), "(int a, const wxString& b)");
+        CHECK_STRING(tags[1]->GetPattern(), "/^    void Bar0(int a, const wxString& b);$/");
+        // the enumerator belongs to the enum scope
+        CHECK_STRING(tags[3]->GetScope(), "ns");
+        // anonymous scopes are removed
+        CHECK_STRING(tags[4]->GetScope(), "ns::Foo0");
+        CHECK_STRING(tags[5]->GetName(), "MAX_SIZE");
+        CHECK_STRING(tags[5]->GetKind(), "macro");
+        CHECK_SIZE(tags[5]->GetLine(), 12);
+    }
+
+    // parsed in blocks, as they are read from the indexer
+    constexpr size_t BLOCK_SIZE = 10000;
+    std::vector<std::string> blocks;
+    for (size_t i = 0; i < 10 * BLOCK_SIZE; i += BLOCK_SIZE) {
+        blocks.emplace_back();
+        make_ctags_output(i, BLOCK_SIZE, blocks.back());
+    }
+
+    size_t tags_count = 0;
+    bool tags_ok = true;
+    {
+        std::vector<TagEntryPtr> tags;
+        CTagsOutputParser parser(tags);
+        for (const auto& block : blocks) {
+            parser.AddOutput(block);
+            tags_ok = tags_ok && tags.size() == BLOCK_SIZE && tags[3]->GetScope() == "ns";
+            tags_count += tags.size();
+            tags.clear();
+        }
+    }
+    CHECK_SIZE(tags_count, 10 * BLOCK_SIZE);
+    CHECK_BOOL(tags_ok);
+
+#ifndef __WXMSW__
+    // read the output of a process, line by line
+    wxFileName fixture(wxFileName::GetTempDir(), "codelite-tests-ctags-output.txt");
+    FileUtils::Deleter d{ fixture };
+    std::string content;
+    for (size_t i = 0; i < 10; ++i) {
+        content += blocks[i];
+    }
+    FileUtils::WriteFileContent(fixture, wxString::FromUTF8(content.data(), content.length()));
+    std::vector<TagEntryPtr> tags;
+    CTagsOutputParser parser(tags);
+    ProcUtils::SafeExecuteCommand("cat " + fixture.GetFullPath(),
+                                  [&parser](std::string_view line) { parser.AddLine(line); });
+    CHECK_SIZE(tags.size(), 10 * BLOCK_SIZE);
+    wxString last_name;
+    last_name << "x" << (10 * BLOCK_SIZE - 5);
+    CHECK_STRING(tags.back()->GetName(), last_name);
+#endif
+    return true;
+}
+
+BENCHMARK_FUNC(benchmark_ctags_output_parser)
+{
+    // 1M lines, parsed in blocks, as they are read from the indexer
+    constexpr size_t LINES_COUNT = 1000000;
+    constexpr size_t BLOCK_SIZE = 10000;
+    std::vector<std::string> blocks;
+    for (size_t i = 0; i < LINES_COUNT; i += BLOCK_SIZE) {
+        blocks.emplace_back();
+        make_ctags_output(i, BLOCK_SIZE, blocks.back());
+    }
+
+    size_t tags_count = 0;
+    wxStopWatch sw;
+    {
+        std::vector<TagEntryPtr> tags;
+        CTagsOutputParser parser(tags);
+        for (const auto& block : blocks) {
+            parser.AddOutput(block);
+            tags_count += tags.size();
+            tags.clear();
+        }
+    }
+    long elapsed = sw.Time();
+    CHECK_SIZE(tags_count, LINES_COUNT);
+
+    // the same, using wxString lines
+    sw.Start();
+    tags_count = 0;
+    for (const auto& block : blocks) {
+        wxString content = wxString::FromUTF8(block.data(), block.length());
+        wxArrayString lines = ::wxStringTokenize(content, "\n", wxTOKEN_STRTOK);
+        std::vector<TagEntryPtr> tags;
+        tags.reserve(lines.size());
+        for (wxString& line : lines) {
+            line.Trim(false).Trim();
+            tags.emplace_back(new TagEntry());
+            tags.back()->FromLine(line);
+        }
+        tags_count += tags.size();
+    }
+    CHECK_SIZE(tags_count, LINES_COUNT);
+    wxPrintf("CTags: parsing %zu lines took %ldms (%ldms using wxString lines)\n", LINES_COUNT, elapsed, sw.Time());
+    return true;
+}
+
+TEST_FUNC(test_ctags_json_tag)
+{
+    // the same tag, as written by ctags in a tags file and in interactive mode
+    TagEntry from_line;
+    CHECK_BOOL(from_line.FromLine(std::string_view{ "x\t/src/a.cpp\t/^        int x;$/;\"\tmember\tline:7\t"
+                                                    "struct:ns::Foo::__anon1\ttyperef:typename:int\taccess:public" }));
+
+    JSONReader reader;
+    CHECK_BOOL(reader.Parse(R"({"_type": "tag", "name": "x", "path": "/src/a.cpp", "pattern": "/^        int x;$/",)"
+                            R"( "line": 7, "kind": "member", "scope": "ns::Foo::__anon1", "scopeKind": "struct",)"
+                            R"( "typeref": "typename:int", "access": "public", "file": true})"));
+    TagEntry from_json;
+    CHECK_BOOL(from_json.FromCTagsJSON(reader.toElement()));
+    CHECK_BOOL(from_json == from_line);
+    CHECK_STRING(from_json.GetScope(), "ns::Foo");
+    CHECK_STRING(from_json.GetTypename(), "int");
+    CHECK_SIZE(from_json.GetLine(), 7);
+
+    CHECK_BOOL(reader.Parse(R"({"_type": "completed", "command": "generate-tags"})"));
+    CHECK_BOOL(!from_json.FromCTagsJSON(reader.toElement()));
+    return true;
+}
+
+TEST_FUNC(test_tag_entry_interning)
+{
+    std::vector<TagEntryPtr> tags;
+    CTagsOutputParser parser(tags);
+    std::string output;
+    make_ctags_output(0, 1000, output);
+    parser.AddOutput(output);
+    CHECK_SIZE(tags.size(), 1000);
+
+    // tags of the same file share the file name, kind and scope
+    CHECK_BOOL(&tags[0]->GetFile() == &tags[99]->GetFile());
+    CHECK_BOOL(&tags[0]->GetFile() != &tags[100]->GetFile());
+    CHECK_BOOL(&tags[0]->GetKind() == &tags[5]->GetKind());
+    CHECK_BOOL(&tags[0]->GetScope() == &tags[2]->GetScope());
+    CHECK_STRING(tags[0]->GetKind(), "class");
+
+    // interning the same value again does not grow the pool
+    size_t count = clStringPool::Get().GetCount();
+    TagEntry copy = *tags[1];
+    copy.SetFile(wxString(tags[1]->GetFile().c_str()));
+    copy.SetKind("prototype ");
+    CHECK_SIZE(clStringPool::Get().GetCount(), count);
+    CHECK_BOOL(&copy.GetFile() == &tags[1]->GetFile());
+    CHECK_STRING(copy.GetKind(), "prototype");
+    CHECK_BOOL(copy.IsPrototype());
+    CHECK_BOOL(copy == *tags[1]);
+
+    TagEntry empty;
+    CHECK_STRING(empty.GetKind(), "<unknown>");
+    CHECK_BOOL(empty.GetFile().empty() && empty.GetScope().empty() && empty.GetParent().empty());
+
+    // a buffer parsed from a temporary file: the temporary path is not interned
+    const wxString temp_path = "/tmp/codelite-tests-1234.cpp";
+    size_t count_before = clStringPool::Get().GetCount();
+    {
+        std::vector<TagEntryPtr> buffer_tags;
+        CTagsOutputParser buffer_parser(buffer_tags);
+        buffer_parser.SetFile("/home/user/src/project/buffer.cpp");
+        buffer_parser.AddOutput("Baz\t" + temp_path.ToStdString() + "\t/^class Baz {$/;\"\tclass\tline:1\n");
+        CHECK_SIZE(buffer_tags.size(), 1);
+        CHECK_STRING(buffer_tags[0]->GetFile(), "/home/user/src/project/buffer.cpp");
+
+        size_t count = clStringPool::Get().GetCount();
+        auto probe = clStringPool::Get().Intern(temp_path);
+        CHECK_SIZE(clStringPool::Get().GetCount(), count + 1);
+    }
+
+    // the strings are removed from the pool with the last tag that refers to them
+    CHECK_SIZE(clStringPool::Get().GetCount(), count_before);
+    return true;
+}
+
+TEST_FUNC(test_chunked_line_store)
+{
+    const size_t lines_count = 3 * clChunkedLineStore::LINES_PER_CHUNK + 10;
+    {
+        // keep a single chunk in memory
+        clChunkedLineStore store(1);
+        for (size_t i = 0; i < lines_count; ++i) {
+            store.AppendLine(wxString() << "line " << i);
+        }
+        CHECK_SIZE(store.GetLineCount(), lines_count);
+        CHECK_SIZE(store.GetSpilledChunksCount(), 2);
+
+        // read from a spilled chunk
+        CHECK_STRING(store.GetLines(1, 2), "line 1\nline 2\n");
+        // across the boundary between a spilled chunk and an in-memory chunk
+        const size_t boundary = 2 * clChunkedLineStore::LINES_PER_CHUNK;
+        wxString expected;
+        expected << "line " << (boundary - 1) << "\n"
+                 << "line " << boundary << "\n";
+        CHECK_STRING(store.GetLines(boundary - 1, 2), expected);
+        // the last (partial) chunk, the count is clipped
+        expected.clear();
+        expected << "line " << (lines_count - 1) << "\n";
+        CHECK_STRING(store.GetLines(lines_count - 1, 100), expected);
+        CHECK_STRING(store.GetLines(lines_count, 1), "");
+
+        wxString text = store.GetText();
+        CHECK_SIZE(::wxStringTokenize(text, "\n", wxTOKEN_STRTOK).size(), lines_count);
+        CHECK_BOOL(text.StartsWith("line 0\nline 1\n"));
+
+        store.Clear();
+        CHECK_SIZE(store.GetLineCount(), 0);
+        CHECK_SIZE(store.GetSpilledChunksCount(), 0);
+        store.AppendLine("after clear");
+        CHECK_STRING(store.GetText(), "after clear\n");
+    }
+    {
+        // spill every full chunk, without compression
+        clChunkedLineStore store(0, false);
+        for (size_t i = 0; i < lines_count; ++i) {
+            store.AppendLine(wxString() << "line " << i);
+        }
+        CHECK_SIZE(store.GetSpilledChunksCount(), 3);
+        wxString expected;
+        expected << "line " << clChunkedLineStore::LINES_PER_CHUNK << "\n";
+        CHECK_STRING(store.GetLines(clChunkedLineStore::LINES_PER_CHUNK, 1), expected);
+        CHECK_STRING(store.GetLines(0, 1), "line 0\n");
+    }
+    return true;
+}
+
+TEST_FUNC(test_chunked_line_store_corrupted_spill_file)
+{
+    const size_t chunk_lines = clChunkedLineStore::LINES_PER_CHUNK;
+    const size_t lines_count = 3 * chunk_lines;
+    for (bool compress : { true, false }) {
+        // the first two chunks are spilled
+        clChunkedLineStore store(1, compress);
+        for (size_t i = 0; i < lines_count; ++i) {
+            store.AppendLine(wxString() << "line " << i);
+        }
+        CHECK_SIZE(store.GetSpilledChunksCount(), 2);
+        CHECK_BOOL(!store.GetSpillPath().empty());
+
+        // overwrite the start of the first chunk
+        {
+            wxFile file(store.GetSpillPath(), wxFile::read_write);
+            CHECK_BOOL(file.IsOpened());
+            const std::string garbage(64, 'x');
+            CHECK_BOOL(file.Write(garbage.data(), garbage.length()) == garbage.length());
+        }
+
+        // its lines are empty, the line numbers of the other lines are kept
+        wxString expected;
+        expected << "\nline " << chunk_lines << "\n";
+        CHECK_STRING(store.GetLines(chunk_lines - 1, 2), expected);
+        wxString text = store.GetText();
+        CHECK_SIZE(text.Freq('\n'), lines_count);
+        expected.clear();
+        expected << wxString('\n', chunk_lines) << "line " << chunk_lines << "\n";
+        CHECK_BOOL(text.StartsWith(expected));
+
+        // truncate the file: the lines of both chunks are empty
+        {
+            wxFile file(store.GetSpillPath(), wxFile::write);
+            CHECK_BOOL(file.IsOpened());
+        }
+        text = store.GetText();
+        CHECK_SIZE(text.Freq('\n'), lines_count);
+        expected.clear();
+        expected << wxString('\n', 2 * chunk_lines) << "line " << (2 * chunk_lines) << "\n";
+        CHECK_BOOL(text.StartsWith(expected));
+        expected.clear();
+        expected << "line " << (lines_count - 1) << "\n";
+        CHECK_STRING(store.GetLines(lines_count - 1, 1), expected);
+    }
+    return true;
+}
+
+namespace
+{
+/// the files of a large workspace
+std::vector<wxString> make_workspace_files(size_t count)
+{
+    std::vector<wxString> files;
+    const wxString dirs[] = { "src", "CodeLite", "Plugin", "LiteEditor", "tests", "include" };
+    const wxString names[] = { "main", "file_utils", "editor", "Manager", "search_thread", "parser" };
+    for (size_t i = 0; i < count; ++i) {
+        wxString file;
+        file << "/home/user/" << dirs[i % 6] << "/" << dirs[(i / 6) % 6] << "/" << names[(i / 36) % 6] << i
+             << ((i % 2) ? ".cpp" : ".h");
+        files.push_back(file);
+    }
+    return files;
+}
+} // namespace
+
+TEST_FUNC(test_fuzzy_index)
+{
+    {
+        std::vector<wxString> files = { "/src/lib/main/other.cpp", "/src/Foo.cpp", "/src/barfoo.cpp", "/src/main.h" };
+        clFuzzyIndex index;
+        index.Build(files);
+        CHECK_SIZE(index.GetCount(), 4);
+
+        // a match at the start of the file name ranks first
+        auto matches = index.Search("FOO");
+        CHECK_SIZE(matches.size(), 2);
+        CHECK_SIZE(matches[0].index, 1);
+        CHECK_SIZE(matches[1].index, 2);
+
+        // all the words must match, in any order
+        matches = index.Search("cpp main");
+        CHECK_SIZE(matches.size(), 1);
+        CHECK_SIZE(matches[0].index, 0);
+
+        // narrowed from the previous query
+        matches = index.Search("cpp mainx");
+        CHECK_SIZE(matches.size(), 0);
+        matches = index.Search("src");
+        CHECK_SIZE(matches.size(), 4);
+        CHECK_SIZE(index.Search("src", 2).size(), 2);
+        CHECK_SIZE(index.Search("").size(), 4);
+    }
+    {
+        std::vector<wxString> entries = { "File > Open", "Edit > Find", "View > Output" };
+        clFuzzyIndex index(eFuzzyIndexMode::kInOrder);
+        index.Build(entries);
+        auto matches = index.Search("fo");
+        CHECK_SIZE(matches.size(), 1);
+        CHECK_SIZE(matches[0].index, 0);
+        CHECK_SIZE(index.Search("fop").size(), 1);
+        CHECK_SIZE(index.Search("e").size(), 3);
+        CHECK_SIZE(index.Search("of").size(), 0);
+    }
+
+    // a large workspace: the results must be the same with or without narrowing
+    std::vector<wxString> files = make_workspace_files(30000);
+    clFuzzyIndex index;
+    index.Build(files);
+    size_t narrowed_count = 0;
+    for (const wxString& query : { "e", "ed", "edi", "edit", "editor", "editor1", "editor12" }) {
+        narrowed_count = index.Search(query).size();
+    }
+
+    clFuzzyIndex fresh_index;
+    fresh_index.Build(files);
+    CHECK_SIZE(narrowed_count, fresh_index.Search("editor12").size());
+    CHECK_BOOL(narrowed_count > 0);
+    return true;
+}
+
+BENCHMARK_FUNC(benchmark_fuzzy_index)
+{
+    std::vector<wxString> files = make_workspace_files(300000);
+
+    wxStopWatch sw;
+    clFuzzyIndex index;
+    index.Build(files);
+    wxPrintf("Fuzzy index: indexing %d files took %ldms\n", (int)files.size(), sw.Time());
+
+    sw.Start();
+    for (const wxString& query : { "e", "ed", "edi", "edit", "editor", "editor1", "editor12" }) {
+        index.Search(query);
+    }
+    wxPrintf("Fuzzy index: 7 incremental queries took %ldms\n", sw.Time());
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    wxInitializer initializer(argc, argv);
+    wxLogNull NOLOG;
+
+    // ensure that the user data dir exists
+    wxFileName::Mkdir(clStandardPaths::Get().GetUserDataDir(), wxPosixPermissions::wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+    bool benchmarks = argc > 1 && wxString(argv[1]) == "--benchmark";
+    return Tester::Instance()->RunTests(benchmarks);
+}
@@ -63,6 +63,10 @@ protected:
     wxBitmap m_alternateBitmap;
     wxString m_signature; // when IsFunction() is true
     size_t m_flags = 0;
+    // the text used for filtering (i.e. the trimmed text) and its lower case version. Computed once, on demand
+    mutable wxString m_filterText;
+    mutable wxString m_lcFilterText;
+    mutable bool m_filterTextValid = false;
 
 protected:
     void EnableFlag(bool b, eFlags f)
@@ -176,9 +180,36 @@ public:
     void SetWeight(int weight) { this->m_weight = weight; }
     int GetWeight() const { return m_weight; }
     void SetImgIndex(int imgIndex) { this->m_imgIndex = imgIndex; }
-    void SetText(const wxString& text) { this->m_text = text; }
+    void SetText(const wxString& text)
+    {
+        this->m_text = text;
+        this->m_filterTextValid = false;
+    }
     int GetImgIndex() const { return m_imgIndex; }
     const wxString& GetText() const { return m_text; }
+
+    /**
+     * @brief return the text used for filtering the completion box (the text, without leading and trailing whitespace)
+     */
+    const wxString& GetFilterText() const
+    {
+        if(!m_filterTextValid) {
+            m_filterText = m_text;
+            m_filterText.Trim().Trim(false);
+            m_lcFilterText = m_filterText.Lower();
+            m_filterTextValid = true;
+        }
+        return m_filterText;
+    }
+
+    /**
+     * @brief the lower case version of GetFilterText()
+     */
+    const wxString& GetLcFilterText() const
+    {
+        GetFilterText();
+        return m_lcFilterText;
+    }
     /**
      * @brief set client data, deleting the old client data
      * @param clientData
@@ -110,10 +110,10 @@ template <typename T>
 wxString get_file_name(const T& node)
 {
     wxString file_name;
-    if (!node["fullname"].value.empty()) {
-        file_name = node["fullname"].value;
-    } else if (!node["pending"].value.empty()) {
-        file_name = node["pending"].value;
+    if (!node["fullname"].value().empty()) {
+        file_name = node["fullname"].value();
+    } else if (!node["pending"].value().empty()) {
+        file_name = node["pending"].value();
         if (file_name.AfterLast(':').IsNumber()) {
             file_name = file_name.BeforeLast(':');
         }
@@ -123,13 +123,24 @@ wxString get_file_name(const T& node)
     return file_name;
 }
 
-void ParseStackEntry(gdbmi::Node& frame, StackEntry& entry)
+DisassembleEntry ParseDisassembleEntry(const gdbmi::Node& insn)
 {
-    entry.level = frame["level"].value;
-    entry.address = frame["addr"].value;
-    entry.function = frame["func"].value;
+    // {address="0x000000000040113a",func-name="main",offset="4",inst="mov    $0x0,%eax"}
+    DisassembleEntry entry;
+    entry.m_address = insn["address"].value();
+    entry.m_function = insn["func-name"].value();
+    entry.m_offset = insn["offset"].value();
+    entry.m_inst = insn["inst"].value();
+    return entry;
+}
+
+void ParseStackEntry(const gdbmi::Node& frame, StackEntry& entry)
+{
+    entry.level = frame["level"].value();
+    entry.address = frame["addr"].value();
+    entry.function = frame["func"].value();
     entry.file = get_file_name(frame);
-    entry.line = frame["line"].value;
+    entry.line = frame["line"].value();
 }
 
 wxString ExtractGdbChild(const std::map<std::string, std::string>& attr, const wxString& name)
@@ -166,8 +177,8 @@ bool DbgCmdHandlerGetLine::ProcessOutput(const wxString& line)
     // read the file name, giving fullname priority
     filename = get_file_name(result);
 
-    if (!result["line"].value.empty()) {
-        lineNumber = result["line"].value;
+    if (!result["line"].value().empty()) {
+        lineNumber = result["line"].value();
         lineNumber.ToCLong(&line_number);
     }
 
@@ -210,9 +221,9 @@ bool DbgCmdHandlerAsyncCmd::ProcessOutput(const wxString& line)
         return false;
     }
 
-    wxString func = result["frame"]["func"].value;
-    wxString reason = result["reason"].value;
-    wxString signal_name = result["signal-name"].value;
+    wxString func = result["frame"]["func"].value();
+    wxString reason = result["reason"].value();
+    wxString signal_name = result["signal-name"].value();
 
     // Note:
     // This might look like a stupid if-else, since all taking
@@ -355,7 +366,7 @@ bool DbgCmdHandlerAsyncCmd::ProcessOutput(const wxString& line)
         // Return to the caller the gdb-result-var since we might want
         // to create a variable object out of it
         if (result.exists("gdb-result-var")) {
-            wxString gdbVar = result["gdb-result-var"].value;
+            wxString gdbVar = result["gdb-result-var"].value();
             DebuggerEventData evt;
             evt.m_updateReason = DBG_UR_FUNCTIONFINISHED;
             evt.m_expression = gdbVar;
@@ -482,7 +493,7 @@ bool DbgCmdHandlerLocals::ProcessOutput(const wxString& line)
         return false;
     }
 
-    auto variables = result["variables"].children;
+    auto variables = result["variables"].children();
     if (!variables.empty()) {
         // no children
         locals.reserve(variables.size());
@@ -490,8 +501,8 @@ bool DbgCmdHandlerLocals::ProcessOutput(const wxString& line)
             // each entry in the list is also represented as a list
             // with the index as its name
             LocalVariable var;
-            var.name = (*variables[i])["name"].value;
-            var.value = (*variables[i])["value"].value;
+            var.name = variables[i]["name"].value();
+            var.value = variables[i]["value"].value();
             if (var.value.empty()) {
                 var.value = "{..}";
             }
@@ -538,15 +549,16 @@ bool DbgCmdStackList::ProcessOutput(const wxString& line)
     gdbmi::ParsedResult result;
 
     parser.parse(line, &result);
-    if (result["stack"].children.empty()) {
+    if (result["stack"].children().empty()) {
         return false;
     }
 
     const auto& stack = result["stack"];
 
     StackEntryArray stackArray;
-    stackArray.reserve(stack.children.size());
-    for (size_t i = 0; i < stack.children.size(); ++i) {
+    size_t frames_count = stack.children().size();
+    stackArray.reserve(frames_count);
+    for (size_t i = 0; i < frames_count; ++i) {
         StackEntry entry;
         ParseStackEntry(stack[i], entry);
         stackArray.push_back(entry);
@@ -618,8 +630,8 @@ bool DbgCmdResolveTypeHandler::ProcessOutput(const wxString& line)
         return true;
 
     } else {
-        var_name = result["name"].value;
-        type_name = result["type"].value;
+        var_name = result["name"].value();
+        type_name = result["type"].value();
     }
 
     // delete the variable object
@@ -707,7 +719,7 @@ bool DbgCmdBreakList::ProcessOutput(const wxString& line)
         return false;
     }
 
-    const auto& body = result["BreakpointTable"]["body"].children;
+    auto body = result["BreakpointTable"]["body"].children();
     if (body.empty()) {
         return false;
     }
@@ -716,23 +728,22 @@ bool DbgCmdBreakList::ProcessOutput(const wxString& line)
     // convert gdbmi breakpoint info into clDebuggerBreakpoint construct
     for (size_t i = 0; i < body.size(); i++) {
         clDebuggerBreakpoint breakpoint;
-        auto& bkpt = *body[i];
+        const auto& bkpt = body[i];
 
-        // "consume" the values by swapping them
-        breakpoint.what.swap(bkpt["what"].value);
-        breakpoint.at.swap(bkpt["at"].value);
+        breakpoint.what = bkpt["what"].value();
+        breakpoint.at = bkpt["at"].value();
         breakpoint.file = get_file_name(bkpt);
 
-        wxString lineNumber = bkpt["line"].value;
+        wxString lineNumber = bkpt["line"].value();
         if (!lineNumber.empty()) {
             breakpoint.lineno = wxAtoi(lineNumber);
         }
-        wxString ignore = bkpt["ignore"].value;
+        wxString ignore = bkpt["ignore"].value();
         if (!ignore.empty()) {
             breakpoint.ignore_number = wxAtoi(ignore);
         }
 
-        wxString bpId = bkpt["number"].value;
+        wxString bpId = bkpt["number"].value();
         if (!bpId.empty()) {
             breakpoint.debugger_id = wxAtof(bpId);
         }
@@ -787,20 +798,22 @@ bool DbgCmdWatchMemory::ProcessOutput(const wxString& line)
 
     wxString output;
     wxString current_line;
-    size_t rows_count = result["memory"].children.size();
+    const auto& memory = result["memory"];
+    size_t rows_count = memory.children().size();
     if (rows_count) {
         for (size_t i = 0; i < rows_count; ++i) {
-            const auto& row = result["memory"][i];
-            current_line << row["addr"].value << " ";
+            const auto& row = memory[i];
+            current_line << row["addr"].value() << " ";
 
             // add the data
-            size_t data_size = row["data"].children.size();
+            const auto& data = row["data"];
+            size_t data_size = data.children().size();
             for (size_t x = 0; x < data_size; ++x) {
-                current_line << row["data"][x].value << " ";
+                current_line << data[x].value() << " ";
             }
 
             if (row.exists("ascii")) {
-                current_line << row["ascii"].value;
+                current_line << row["ascii"].value();
             }
             output << current_line << "\n";
             current_line.clear();
@@ -907,11 +920,11 @@ static VariableObjChild FromParserOutput(const gdbmi::Node& child)
 {
     VariableObjChild var_child;
 
-    var_child.varName = child["exp"].value;
-    var_child.type = child["type"].value;
-    var_child.gdbId = child["name"].value;
-    wxString numChilds = child["numchild"].value;
-    wxString dynamic = child["dynamic"].value;
+    var_child.varName = child["exp"].value();
+    var_child.type = child["type"].value();
+    var_child.gdbId = child["name"].value();
+    wxString numChilds = child["numchild"].value();
+    wxString dynamic = child["dynamic"].value();
 
     if (numChilds.IsEmpty() == false) {
         var_child.numChilds = wxAtoi(numChilds);
@@ -930,7 +943,7 @@ static VariableObjChild FromParserOutput(const gdbmi::Node& child)
     // }
 
     // For primitive types, we also get the value
-    var_child.value = child["value"].value;
+    var_child.value = child["value"].value();
     if (!var_child.value.empty()) {
         var_child.varName << " = " << var_child.value;
     }
@@ -949,7 +962,7 @@ bool DbgCmdListChildren::ProcessOutput(const wxString& line)
         return false;
     }
 
-    const auto& children = result["children"].children;
+    auto children = result["children"].children();
     if (children.empty()) {
         return true;
     }
@@ -958,7 +971,7 @@ bool DbgCmdListChildren::ProcessOutput(const wxString& line)
 
     // Convert the parser output to CodeLite data structure
     for (size_t i = 0; i < children.size(); ++i) {
-        e.m_varObjChildren.push_back(FromParserOutput(*children[i]));
+        e.m_varObjChildren.push_back(FromParserOutput(children[i]));
     }
 
     e.m_updateReason = DBG_UR_LISTCHILDREN;
@@ -978,7 +991,7 @@ bool DbgCmdEvalVarObj::ProcessOutput(const wxString& line)
     gdbmi::Parser parser;
     parser.parse(line, &result);
 
-    wxString display_line = result["value"].value;
+    wxString display_line = result["value"].value();
 
     if (!display_line.empty()) {
         if (m_userReason == DBG_USERR_WATCHTABLE || display_line != "{...}") {
@@ -1106,35 +1119,15 @@ bool DbgCmdStopHandler::ProcessOutput(const wxString& line)
 bool DbgCmdHandlerDisasseble::ProcessOutput(const wxString& line)
 {
     clCommandEvent event(wxEVT_DEBUGGER_DISASSEBLE_OUTPUT);
-    GdbChildrenInfo info;
-    ::gdbParseListChildren(line.mb_str(wxConvUTF8).data(), info);
+    gdbmi::Parser parser;
+    gdbmi::ParsedResult result;
+    parser.parse(line, &result);
 
     DebuggerEventData* evtData = new DebuggerEventData();
-    for (size_t i = 0; i < info.children.size(); ++i) {
-
-        DisassembleEntry entry;
-
-        GdbStringMap_t& attrs = info.children.at(i);
-        if (attrs.count("address")) {
-            entry.m_address = attrs["address"].c_str();
-            wxGDB_STRIP_QUOATES(entry.m_address);
-        }
-
-        if (attrs.count("inst")) {
-            entry.m_inst = attrs["inst"].c_str();
-            wxGDB_STRIP_QUOATES(entry.m_inst);
-        }
-
-        if (attrs.count("func-name")) {
-            entry.m_function = attrs["func-name"].c_str();
-            wxGDB_STRIP_QUOATES(entry.m_function);
-        }
-
-        if (attrs.count("offset")) {
-            entry.m_offset = attrs["offset"].c_str();
-            wxGDB_STRIP_QUOATES(entry.m_offset);
-        }
-        evtData->m_disassembleLines.push_back(entry);
+    auto insns = result["asm_insns"].children();
+    evtData->m_disassembleLines.reserve(insns.size());
+    for (size_t i = 0; i < insns.size(); ++i) {
+        evtData->m_disassembleLines.push_back(ParseDisassembleEntry(insns[i]));
     }
 
     event.SetClientObject(evtData);
@@ -1145,34 +1138,14 @@ bool DbgCmdHandlerDisasseble::ProcessOutput(const wxString& line)
 bool DbgCmdHandlerDisassebleCurLine::ProcessOutput(const wxString& line)
 {
     clCommandEvent event(wxEVT_DEBUGGER_DISASSEBLE_CURLINE);
-    GdbChildrenInfo info;
-    ::gdbParseListChildren(line.mb_str(wxConvUTF8).data(), info);
+    gdbmi::Parser parser;
+    gdbmi::ParsedResult result;
+    parser.parse(line, &result);
 
     DebuggerEventData* evtData = new DebuggerEventData();
-    if (info.children.empty() == false) {
-
-        DisassembleEntry entry;
-        GdbStringMap_t& attrs = info.children.at(0);
-        if (attrs.count("address")) {
-            entry.m_address = attrs["address"].c_str();
-            wxGDB_STRIP_QUOATES(entry.m_address);
-        }
-
-        if (attrs.count("inst")) {
-            entry.m_inst = attrs["inst"].c_str();
-            wxGDB_STRIP_QUOATES(entry.m_inst);
-        }
-
-        if (attrs.count("func-name")) {
-            entry.m_function = attrs["func-name"].c_str();
-            wxGDB_STRIP_QUOATES(entry.m_function);
-        }
-
-        if (attrs.count("offset")) {
-            entry.m_offset = attrs["offset"].c_str();
-            wxGDB_STRIP_QUOATES(entry.m_offset);
-        }
-        evtData->m_disassembleLines.push_back(entry);
+    auto insns = result["asm_insns"].children();
+    if (!insns.empty()) {
+        evtData->m_disassembleLines.push_back(ParseDisassembleEntry(insns[0]));
     }
 
     event.SetClientObject(evtData);
@@ -7,16 +7,38 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
-
-thread_local gdbmi::Node emptyNode;
+#include <wx/crt.h>
 
 namespace
 {
-std::unordered_map<wxString, gdbmi::eToken> words = {
-    { "done", gdbmi::T_DONE },   { "running", gdbmi::T_RUNNING }, { "connected", gdbmi::T_CONNECTED },
-    { "error", gdbmi::T_ERROR }, { "exit", gdbmi::T_EXIT },       { "stopped", gdbmi::T_STOPPED },
+// nodes with fewer children are searched by scanning them
+constexpr uint32_t MIN_CHILDREN_FOR_LOOKUP = 16;
+
+struct Keyword {
+    const wxChar* text;
+    size_t length;
+    gdbmi::eToken type;
+};
+
+const Keyword keywords[] = {
+    { wxT("done"), 4, gdbmi::T_DONE },
+    { wxT("running"), 7, gdbmi::T_RUNNING },
+    { wxT("connected"), 9, gdbmi::T_CONNECTED },
+    { wxT("error"), 5, gdbmi::T_ERROR },
+    { wxT("exit"), 4, gdbmi::T_EXIT },
+    { wxT("stopped"), 7, gdbmi::T_STOPPED },
 };
 
+gdbmi::eToken classify_word(const gdbmi::StringView& word)
+{
+    for(const auto& keyword : keywords) {
+        if(word.equals(keyword.text, keyword.length)) {
+            return keyword.type;
+        }
+    }
+    return gdbmi::T_WORD;
+}
+
 void trim_both(wxString& str)
 {
     static wxString trimString(" \r\n\t\v");
@@ -49,14 +71,116 @@ void strip_double_backslashes(wxString& str)
     trim_both(str);
 }
 
+bool needs_unescape(const gdbmi::StringView& value)
+{
+    if(value.empty()) {
+        return false;
+    }
+    if(wxIsspace(value[0]) || wxIsspace(value[value.length() - 1])) {
+        return true;
+    }
+    for(size_t i = 0; i < value.length(); ++i) {
+        if(value[i] == '\\') {
+            return true;
+        }
+    }
+    return false;
+}
 } // namespace
 
-gdbmi::Node::ptr_t gdbmi::Node::add_child(const wxString& name, const wxString& value)
+wxString gdbmi::Node::value() const
+{
+    wxString str = m_value.to_string();
+    if(needs_unescape(m_value)) {
+        strip_double_backslashes(str);
+    }
+    return str;
+}
+
+gdbmi::NodeList gdbmi::Node::children() const { return NodeList(this); }
+
+const gdbmi::Node& gdbmi::Node::empty_node()
+{
+    static const Node emptyNode;
+    return emptyNode;
+}
+
+const gdbmi::Node& gdbmi::Node::operator[](size_t index) const
+{
+    if(!m_tree) {
+        return empty_node();
+    }
+    return m_tree->child_of(*this, index);
+}
+
+const gdbmi::Node& gdbmi::Node::find_child(const wxString& name) const
+{
+    if(!m_tree) {
+        return empty_node();
+    }
+    return m_tree->find_child_of(*this, name);
+}
+
+gdbmi::Tree::Tree() { clear(); }
+
+void gdbmi::Tree::clear()
 {
-    auto c = do_add_child(name);
-    c->value = std::move(value);
-    strip_double_backslashes(c->value);
-    return c;
+    m_nodes.clear();
+    m_links.clear();
+    m_lookup.clear();
+    add_node({}, {}); // the root
+}
+
+uint32_t gdbmi::Tree::add_node(const StringView& name, const StringView& value)
+{
+    m_nodes.emplace_back();
+    Node& node = m_nodes.back();
+    node.m_tree = this;
+    node.m_name = name;
+    node.m_value = value;
+    return static_cast<uint32_t>(m_nodes.size() - 1);
+}
+
+const gdbmi::Node& gdbmi::Tree::child_of(const Node& parent, size_t index) const
+{
+    if(index >= parent.m_count) {
+        return Node::empty_node();
+    }
+    return m_nodes[m_links[parent.m_first + index]];
+}
+
+const gdbmi::Node& gdbmi::Tree::find_child_of(const Node& parent, const wxString& name) const
+{
+    StringView key(name);
+    if(parent.m_count < MIN_CHILDREN_FOR_LOOKUP) {
+        for(uint32_t i = 0; i < parent.m_count; ++i) {
+            const Node& child = m_nodes[m_links[parent.m_first + i]];
+            if(child.m_name == key) {
+                return child;
+            }
+        }
+        return Node::empty_node();
+    }
+
+    // build the lookup table on first use
+    uint32_t parent_index = static_cast<uint32_t>(&parent - m_nodes.data());
+    auto where = m_lookup.find(parent_index);
+    if(where == m_lookup.end()) {
+        where = m_lookup.insert({ parent_index, {} }).first;
+        auto& lookup = where->second;
+        lookup.reserve(parent.m_count);
+        for(uint32_t i = 0; i < parent.m_count; ++i) {
+            uint32_t link = m_links[parent.m_first + i];
+            // on duplicate names, the first child wins
+            lookup.insert({ m_nodes[link].m_name, link });
+        }
+    }
+
+    auto match = where->second.find(key);
+    if(match == where->second.end()) {
+        return Node::empty_node();
+    }
+    return m_nodes[match->second];
 }
 
 #define CHECK_EOF()                      \
@@ -129,14 +253,8 @@ gdbmi::StringView gdbmi::Tokenizer::next_token(eToken* type)
     } else {
 
         auto w = read_word(type);
-        wxString as_str = w.to_string();
-        if(words.count(as_str)) {
-            *type = words[as_str];
-            return w;
-        } else {
-            *type = T_WORD;
-            return w;
-        }
+        *type = classify_word(w);
+        return w;
     }
 }
 
@@ -190,7 +308,12 @@ gdbmi::StringView gdbmi::Tokenizer::remainder()
 gdbmi::StringView gdbmi::Tokenizer::read_word(eToken* type)
 {
     size_t start_pos = m_pos;
-    while(std::isalnum(m_buffer[m_pos]) || m_buffer[m_pos] == '-' || m_buffer[m_pos] == '_') {
+    while(m_pos < m_buffer.length() &&
+          (wxIsalnum(m_buffer[m_pos]) || m_buffer[m_pos] == '-' || m_buffer[m_pos] == '_')) {
+        ++m_pos;
+    }
+    if(m_pos == start_pos) {
+        // not a word character: consume it so the tokenizer always progresses
         ++m_pos;
     }
     *type = T_WORD;
@@ -199,6 +322,9 @@ gdbmi::StringView gdbmi::Tokenizer::read_word(eToken* type)
 
 void gdbmi::Parser::parse(const wxString& buffer, ParsedResult* result)
 {
+    result->tree.clear();
+    m_pending.clear();
+
     gdbmi::Tokenizer tokenizer(buffer);
     gdbmi::eToken token;
 
@@ -285,10 +411,23 @@ void gdbmi::Parser::parse(const wxString& buffer, ParsedResult* result)
             break;
         }
     }
-    parse_properties(&tokenizer, result->tree);
+    parse_properties(&tokenizer, &result->tree, 0);
 }
 
-void gdbmi::Parser::parse_properties(Tokenizer* tokenizer, Node::ptr_t parent)
+void gdbmi::Parser::parse_properties(Tokenizer* tokenizer, Tree* tree, uint32_t parent)
+{
+    size_t first_pending = m_pending.size();
+    read_properties(tokenizer, tree);
+
+    // the node is complete: store its children next to each other
+    Node& node = tree->m_nodes[parent];
+    node.m_first = static_cast<uint32_t>(tree->m_links.size());
+    node.m_count = static_cast<uint32_t>(m_pending.size() - first_pending);
+    tree->m_links.insert(tree->m_links.end(), m_pending.begin() + first_pending, m_pending.end());
+    m_pending.resize(first_pending);
+}
+
+void gdbmi::Parser::read_properties(Tokenizer* tokenizer, Tree* tree)
 {
     gdbmi::eToken token;
 
@@ -317,9 +456,8 @@ void gdbmi::Parser::parse_properties(Tokenizer* tokenizer, Node::ptr_t parent)
         case STATE_NAME:
             switch(token) {
             case T_CSTRING: {
-                // an array look-a-like
-                // create a fake entry id
-                parent->add_child("", s.to_string());
+                // an array look-a-like: a value without a name
+                m_pending.push_back(tree->add_node({}, s));
                 break;
             }
             case T_TUPLE_CLOSE:
@@ -327,7 +465,9 @@ void gdbmi::Parser::parse_properties(Tokenizer* tokenizer, Node::ptr_t parent)
                 return;
             case T_TUPLE_OPEN:
             case T_LIST_OPEN: {
-                parse_properties(tokenizer, parent->add_child());
+                uint32_t child = tree->add_node({}, {});
+                m_pending.push_back(child);
+                parse_properties(tokenizer, tree, child);
                 state = STATE_NAME;
                 RESET_PROP();
                 break;
@@ -360,7 +500,9 @@ void gdbmi::Parser::parse_properties(Tokenizer* tokenizer, Node::ptr_t parent)
                 return;
             case T_TUPLE_OPEN:
             case T_LIST_OPEN: {
-                parse_properties(tokenizer, parent->add_child(name.to_string()));
+                uint32_t child = tree->add_node(name, {});
+                m_pending.push_back(child);
+                parse_properties(tokenizer, tree, child);
                 state = STATE_NAME;
                 RESET_PROP();
                 break;
@@ -368,7 +510,7 @@ void gdbmi::Parser::parse_properties(Tokenizer* tokenizer, Node::ptr_t parent)
             case T_CSTRING: {
                 state = STATE_NAME;
                 value = s;
-                parent->add_child(name.to_string(), value.to_string());
+                m_pending.push_back(tree->add_node(name, value));
                 RESET_PROP();
                 break;
             }
@@ -381,27 +523,20 @@ void gdbmi::Parser::parse_properties(Tokenizer* tokenizer, Node::ptr_t parent)
 #undef RESET_PROP
 }
 
-void gdbmi::Parser::print(Node::ptr_t node, int depth)
+void gdbmi::Parser::print(const Node& node, int depth)
 {
     std::cout << wxString(depth, ' ');
-    if(!node->name.empty()) {
-        std::cout << node->name;
+    if(!node.name().empty()) {
+        std::cout << node.name();
     }
 
-    if(!node->value.empty()) {
-        std::cout << " -> " << node->value;
+    if(!node.raw_value().empty()) {
+        std::cout << " -> " << node.value();
     }
     std::cout << std::endl;
 
-    for(auto child : node->children) {
-        print(child, depth + 4);
-    }
-}
-
-gdbmi::Node& gdbmi::Node::find_child(const wxString& name) const
-{
-    if(children_map.count(name) == 0) {
-        return emptyNode;
+    auto children = node.children();
+    for(size_t i = 0; i < children.size(); ++i) {
+        print(children[i], depth + 4);
     }
-    return *(children_map.find(name)->second);
 }
@@ -2,6 +2,7 @@
 #define GDBMI_HPP
 
 #include "wxStringHash.h"
+#include <cstdint>
 #include <memory>
 #include <sstream>
 #include <string>
@@ -73,8 +74,27 @@ struct StringView {
 
     const wxChar* data() const { return m_pdata; }
     size_t length() const { return m_length; }
-    char operator[](size_t index) const { return m_pdata[index]; }
+    wxChar operator[](size_t index) const { return m_pdata[index]; }
     bool empty() const { return m_length == 0; }
+    bool equals(const wxChar* p, size_t len) const
+    {
+        return m_length == len && (len == 0 || std::char_traits<wxChar>::compare(m_pdata, p, len) == 0);
+    }
+    bool operator==(const StringView& other) const { return equals(other.m_pdata, other.m_length); }
+    bool operator==(const wxString& str) const { return equals(str.c_str(), str.length()); }
+};
+
+struct StringViewHash {
+    size_t operator()(const StringView& view) const
+    {
+        // FNV-1a
+        size_t hash = 14695981039346656037ULL;
+        for(size_t i = 0; i < view.length(); ++i) {
+            hash ^= static_cast<size_t>(view[i]);
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
 };
 
 class Tokenizer
@@ -95,67 +115,115 @@ public:
     StringView remainder();
 };
 
-struct Node {
-public:
-    typedef std::shared_ptr<Node> ptr_t;
-    typedef std::vector<ptr_t> vec_t;
+class Tree;
+class NodeList;
 
-private:
-    ptr_t do_add_child(const wxString& name)
-    {
-        children.emplace_back(std::make_shared<Node>());
-        auto child = children.back();
-        child->name = std::move(name);
-        children_map.insert({ child->name, child });
-        return child;
-    }
+/**
+ * @brief a node in the parse tree. Nodes are owned by their Tree and their name and value are views into the
+ * parsed reply, so the reply buffer must outlive the tree
+ */
+class Node
+{
+    friend class Tree;
+    friend class NodeList;
+    friend class Parser;
 
-public:
-    wxString name;
-    wxString value; // optional
-    vec_t children;
-    std::unordered_map<wxString, ptr_t> children_map;
+    const Tree* m_tree = nullptr;
+    StringView m_name;
+    StringView m_value;
+    /// the node children are stored, in order, at [m_first, m_first + m_count) in the tree child table
+    uint32_t m_first = 0;
+    uint32_t m_count = 0;
 
+public:
     Node() = default;
-    Node& find_child(const wxString& name) const;
-    Node& operator[](const wxString& name) const { return find_child(name); }
-    Node& operator[](size_t index) const
-    {
-        if(index >= children.size()) {
-            thread_local Node emptyNode;
-            return emptyNode;
-        }
-        return *(children[index].get());
-    }
 
-    ptr_t add_child()
+    /// the name, empty for list entries
+    wxString name() const { return m_name.to_string(); }
+    /// the value, unescaped
+    wxString value() const;
+    /// the value, as it appears in the reply
+    const StringView& raw_value() const { return m_value; }
+
+    NodeList children() const;
+    const Node& find_child(const wxString& name) const;
+    const Node& operator[](const wxString& name) const { return find_child(name); }
+    const Node& operator[](size_t index) const;
+    bool exists(const wxString& name) const { return &find_child(name) != &empty_node(); }
+
+    /// returned when a lookup fails
+    static const Node& empty_node();
+};
+
+class NodeList
+{
+    const Node* m_parent = nullptr;
+
+public:
+    explicit NodeList(const Node* parent)
+        : m_parent(parent)
     {
-        wxString s;
-        s << children.size();
-        return do_add_child(s);
     }
+    size_t size() const { return m_parent->m_count; }
+    bool empty() const { return size() == 0; }
+    const Node& operator[](size_t index) const { return (*m_parent)[index]; }
+};
 
-    ptr_t add_child(const wxString& name, const wxString& value = {});
-    bool exists(const wxString& name) const { return children_map.count(name) > 0; }
+/**
+ * @brief the nodes of a parsed reply. All the nodes live in a single vector (and all the child links in another
+ * one) instead of being allocated one by one. Name lookups scan the children, nodes with many children build
+ * a hash index on their first lookup
+ */
+class Tree
+{
+    friend class Node;
+    friend class Parser;
+
+    std::vector<Node> m_nodes;
+    std::vector<uint32_t> m_links;
+    mutable std::unordered_map<uint32_t, std::unordered_map<StringView, uint32_t, StringViewHash>> m_lookup;
+
+    uint32_t add_node(const StringView& name, const StringView& value);
+    const Node& child_of(const Node& parent, size_t index) const;
+    const Node& find_child_of(const Node& parent, const wxString& name) const;
+
+public:
+    Tree();
+    // nodes keep a pointer to their tree
+    Tree(const Tree&) = delete;
+    Tree& operator=(const Tree&) = delete;
+
+    void clear();
+    const Node& root() const { return m_nodes[0]; }
+    /// number of nodes, including the root
+    size_t size() const { return m_nodes.size(); }
 };
 
 struct ParsedResult {
     eLineType line_type = LT_INVALID;
     StringView line_type_context; // depends on the line type, this will hold the context string
     StringView txid;              //  optional
-    Node::ptr_t tree = std::make_shared<Node>();
-    Node& operator[](const wxString& index) const { return tree->find_child(index); }
-    bool exists(const wxString& name) const { return tree->exists(name); }
+    Tree tree;
+    const Node& operator[](const wxString& index) const { return tree.root().find_child(index); }
+    bool exists(const wxString& name) const { return tree.root().exists(name); }
 };
 
 class Parser
 {
 private:
-    void parse_properties(Tokenizer* tokenizer, Node::ptr_t parent);
+    /// the children of the nodes being parsed, moved to the tree child table once a node is complete
+    std::vector<uint32_t> m_pending;
+
+    void parse_properties(Tokenizer* tokenizer, Tree* tree, uint32_t parent);
+    void read_properties(Tokenizer* tokenizer, Tree* tree);
 
 public:
+    /**
+     * @brief parse `buffer` into `result`. The result points into `buffer`, so it must not be modified or destroyed
+     * while the result is in use
+     */
     void parse(const wxString& buffer, ParsedResult* result);
-    void print(Node::ptr_t node, int depth = 0);
+    void print(const Node& node, int depth = 0);
 };
 } // namespace gdbmi
 
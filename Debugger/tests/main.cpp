@@ -0,0 +1,143 @@
+#include "gdbmi.hpp"
+#include "tester.hpp"
+
+#include <vector>
+#include <wx/init.h>
+#include <wx/log.h>
+#include <wx/stopwatch.h>
+#include <wx/wxcrtvararg.h>
+
+namespace
+{
+/// build a reply the size of a big frame, by repeating a record captured from gdb
+wxString make_mi_reply(const wxString& prefix, const wxString& record, size_t count, const wxString& suffix)
+{
+    wxString reply;
+    reply.reserve(prefix.length() + (record.length() + 8) * count + suffix.length());
+    reply << prefix;
+    for(size_t i = 0; i < count; ++i) {
+        if(i > 0) {
+            reply << ",";
+        }
+        wxString entry = record;
+        entry.Replace("%N", wxString() << i);
+        reply << entry;
+    }
+    reply << suffix;
+    return reply;
+}
+
+struct BigReply {
+    wxString title;
+    wxString list_name;
+    wxString text;
+    wxString key;
+    wxString last_value;
+};
+
+/// replies with `count` entries, the last entry key is `last_value`
+std::vector<BigReply> make_big_replies(size_t count)
+{
+    wxString last = wxString() << (count - 1);
+    return {
+        { "-stack-list-variables", "variables",
+          make_mi_reply("00001547^done,variables=[",
+                        "{name=\"var%N\",value=\"{first = %N, second = \\\"<error reading variable>\\\"}\"}", count,
+                        "]"),
+          "name", "var" + last },
+        { "-var-list-children", "children",
+          make_mi_reply(wxString::Format("00000060^done,numchild=\"%d\",children=[", (int)count),
+                        "child={name=\"var1.public.m_items[%N]\",exp=\"[%N]\",numchild=\"0\",value=\"%N\","
+                        "type=\"int\",thread-id=\"1\"}",
+                        count, "],has_more=\"0\""),
+          "exp", "[" + last + "]" },
+        { "-data-disassemble", "asm_insns",
+          make_mi_reply("00000131^done,asm_insns=[",
+                        "{address=\"0x000000000040113a\",func-name=\"main\",offset=\"%N\","
+                        "inst=\"mov    0x10(%rbp),%rax\"}",
+                        count, "]"),
+          "offset", last },
+    };
+}
+
+} // namespace
+
+TEST_FUNC(test_gdbmi_parser)
+{
+    {
+        wxString reply = "00000372^done,stack=[frame={level=\"0\",addr=\"0x00007ff77a9853b0\",func=\"main\","
+                         "fullname=\"C:\\\\src\\\\main.cpp\",line=\"132\"},frame={level=\"1\",func=\"start\"}]";
+        gdbmi::Parser parser;
+        gdbmi::ParsedResult result;
+        parser.parse(reply, &result);
+        CHECK_BOOL(result.line_type == gdbmi::LT_RESULT);
+        CHECK_WXSTRING(result.txid.to_string(), "00000372");
+        CHECK_WXSTRING(result.line_type_context.to_string(), "done");
+
+        auto frames = result["stack"].children();
+        CHECK_SIZE(frames.size(), 2);
+        CHECK_WXSTRING(frames[0].name(), "frame");
+        CHECK_WXSTRING(frames[0]["fullname"].value(), "C:\\src\\main.cpp");
+        CHECK_WXSTRING(frames[1]["func"].value(), "start");
+        CHECK_BOOL(!frames[1].exists("line"));
+        CHECK_WXSTRING(result["stack"][2]["func"].value(), "");
+        CHECK_WXSTRING(result["nosuchnode"]["func"].value(), "");
+    }
+    {
+        // escaped quotes and a list of values
+        wxString reply = "^done,value=\"\\\"hello\\\"\",data=[\"0x00\",\"0x01\"]";
+        gdbmi::Parser parser;
+        gdbmi::ParsedResult result;
+        parser.parse(reply, &result);
+        CHECK_WXSTRING(result["value"].value(), "\"hello\"");
+        CHECK_SIZE(result["data"].children().size(), 2);
+        CHECK_WXSTRING(result["data"][1].value(), "0x01");
+    }
+    {
+        // a node with enough children for a lookup table, the first of duplicate names wins
+        wxString reply = make_mi_reply("^done,", "f%N=\"%N\"", 100, ",f7=\"duplicate\"");
+        gdbmi::Parser parser;
+        gdbmi::ParsedResult result;
+        parser.parse(reply, &result);
+        CHECK_SIZE(result.tree.root().children().size(), 101);
+        CHECK_WXSTRING(result["f57"].value(), "57");
+        CHECK_WXSTRING(result["f7"].value(), "7");
+        CHECK_BOOL(!result.exists("f100"));
+    }
+
+    // big replies
+    const size_t count = 5000;
+    for(const auto& reply : make_big_replies(count)) {
+        gdbmi::Parser parser;
+        gdbmi::ParsedResult result;
+        parser.parse(reply.text, &result);
+        auto entries = result[reply.list_name].children();
+        CHECK_SIZE(entries.size(), count);
+        CHECK_WXSTRING(entries[count - 1][reply.key].value(), reply.last_value);
+    }
+    return true;
+}
+
+BENCHMARK_FUNC(benchmark_gdbmi_parser)
+{
+    const size_t count = 50000;
+    for(const auto& reply : make_big_replies(count)) {
+        wxStopWatch sw;
+        gdbmi::Parser parser;
+        gdbmi::ParsedResult result;
+        parser.parse(reply.text, &result);
+        auto entries = result[reply.list_name].children();
+        wxPrintf("gdbmi: parsing %s reply (%d entries, %d chars) took %ldms\n", reply.title, (int)entries.size(),
+                 (int)reply.text.length(), sw.Time());
+        CHECK_SIZE(entries.size(), count);
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    wxInitializer initializer(argc, argv);
+    wxLogNull NOLOG;
+    bool benchmarks = argc > 1 && wxString(argv[1]) == "--benchmark";
+    return Tester::Instance()->RunTests(benchmarks);
+}
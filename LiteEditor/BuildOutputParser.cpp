@@ -0,0 +1,337 @@
+#include "BuildOutputParser.hpp"
+
+#include "StringUtils.h"
+#include "clAnsiEscapeCodeColourBuilder.hpp"
+#include "clWorkspaceManager.h"
+#include "file_logger.h"
+#include "macros.h"
+#include "workspace.h"
+
+#include <wx/filename.h>
+#include <wx/tokenzr.h>
+
+namespace
+{
+wxString WrapLineInColour(const wxString& line, int colour, bool fold_font, bool is_dark_theme)
+{
+    wxString text;
+    clAnsiEscapeCodeColourBuilder text_builder(&text);
+
+    text_builder.SetTheme(is_dark_theme ? eColourTheme::DARK : eColourTheme::LIGHT).Add(line, colour, fold_font);
+    return text;
+}
+
+wxString ProcessBuildingProjectLine(const wxString& line)
+{
+    // extract the project name from the line
+    // an example line:
+    // ----------Building project:[ CodeLiteIDE - Win_x64_Release ] (Single File Build)----------
+    wxString s = line.AfterFirst('[');
+    s = s.BeforeLast(']');
+    s = s.BeforeLast('-');
+    s.Trim().Trim(false);
+    return s;
+}
+} // namespace
+
+void BuildOutputParser::Initialise(CompilerPtr compiler, const wxString& project, bool is_dark_theme)
+{
+    m_activeCompiler = compiler; // maybe null
+    m_outputMatcher.reset();
+    if (m_activeCompiler) {
+        // compile the error and warning patterns once per build
+        m_outputMatcher = m_activeCompiler->CreateOutputMatcher();
+    }
+    m_isDarkTheme = is_dark_theme;
+    m_remainder.clear();
+    m_errorCount = 0;
+    m_warnCount = 0;
+    m_currentProject.clear();
+    m_workingDirectories.clear();
+    m_isRemoteBuild = false;
+
+    auto workspace = clWorkspaceManager::Get().GetWorkspace();
+    if (workspace) {
+        m_isRemoteBuild = workspace->IsRemote();
+        wxString workspace_file = workspace->GetFileName();
+        workspace_file.Replace("\\", "/");
+        wxString workspace_dir = workspace_file.BeforeLast('/');
+
+        if (clCxxWorkspaceST::Get() && clCxxWorkspaceST::Get()->IsOpen()) {
+            auto cxx_project = clCxxWorkspaceST::Get()->GetProject(project);
+            if (cxx_project) {
+                auto build_conf = cxx_project->GetBuildConfiguration(wxEmptyString);
+                if (build_conf && build_conf->IsCustomBuild() && !build_conf->GetCustomBuildWorkingDir().empty()) {
+                    // use the custom build's working directory
+                    wxFileName custom_wd(build_conf->GetCustomBuildWorkingDir(), wxEmptyString);
+                    if (custom_wd.IsRelative()) {
+                        custom_wd.MakeAbsolute(cxx_project->GetProjectPath());
+                    }
+                    m_workingDirectories.push_front(custom_wd.GetPath());
+                } else {
+                    // use the project path
+                    m_workingDirectories.push_front(cxx_project->GetProjectPath());
+                }
+            } else {
+                clWARNING() << "Could not locate project:" << project << endl;
+            }
+        } else {
+            m_workingDirectories.push_front(workspace_dir);
+        }
+    }
+}
+
+void BuildOutputParser::Add(const wxString& output, bool process_last_line, std::vector<BuildOutputLine>* lines)
+{
+    m_remainder << output;
+    auto output_lines = ::wxStringTokenize(m_remainder, "\n", wxTOKEN_RET_DELIMS);
+    m_remainder.clear();
+
+    const size_t line_count = output_lines.Count();
+    for (size_t i = 0; i < line_count; i++) {
+        auto& line = output_lines[i];
+        if (!process_last_line && !line.EndsWith("\n")) {
+            // not a complete line
+            m_remainder.swap(line);
+            break;
+        }
+        line.Trim();
+
+        // Remove unwanted ANSI OSC escape sequences
+        line = StringUtils::StripTerminalOSC(line);
+
+        BuildOutputLine output_line;
+
+        // easy path: check for common makefile messages
+        wxString lcLine = line.Lower();
+        if (lcLine.Contains("entering directory") || lcLine.Contains("leaving directory")) {
+            StringUtils::StripTerminalColouring(line, line);
+
+            wxString directory_name = line.AfterFirst('\'');
+            directory_name = directory_name.BeforeLast('\'');
+
+            // this functions as a stack, so we "push_front"
+            if (lcLine.Contains("entering directory")) {
+                m_workingDirectories.push_front(directory_name);
+
+            } else { // "Leaving directory"
+                if (!m_workingDirectories.empty()) {
+                    m_workingDirectories.pop_front();
+                } else {
+                    clWARNING() << "Leaving directory found, but no matching 'Entering directory'?" << endl;
+                }
+            }
+            output_line.text = WrapLineInColour(line, AnsiColours::Gray(), false, m_isDarkTheme);
+
+        } else if (lcLine.Contains(CLEAN_PROJECT_PREFIX)) {
+            StringUtils::StripTerminalColouring(line, line);
+            output_line.text = WrapLineInColour(line, AnsiColours::Gray(), false, m_isDarkTheme);
+
+        } else if (lcLine.Contains(BUILD_END_MSG) || lcLine.Contains("=== build completed") ||
+                   lcLine.Contains("=== build ended")) {
+            StringUtils::StripTerminalColouring(line, line);
+            if (m_errorCount > 0) {
+                // build ended with error
+                output_line.text = WrapLineInColour(line, AnsiColours::Red(), false, m_isDarkTheme);
+            } else if (m_warnCount > 0) {
+                // build ended with warnings only
+                output_line.text = WrapLineInColour(line, AnsiColours::Yellow(), false, m_isDarkTheme);
+            } else {
+                // clean build
+                output_line.text = WrapLineInColour(line, AnsiColours::Green(), false, m_isDarkTheme);
+            }
+
+        } else if (lcLine.Contains(BUILD_PROJECT_PREFIX)) {
+            m_currentProject = ProcessBuildingProjectLine(line);
+            output_line.text = WrapLineInColour(line, AnsiColours::Gray(), false, m_isDarkTheme);
+
+        } else {
+            std::shared_ptr<LineClientData> line_data(new LineClientData);
+            line_data->message = line;
+            line_data->root_dir = wxEmptyString; // maybe empty string
+
+            // remove the terminal ANSI colouring escape code
+            wxString modified_line;
+            StringUtils::StripTerminalColouring(line, modified_line);
+            bool lineHasColours = (line.length() != modified_line.length());
+
+            // Pass the "clean" line to the regex processor
+            if (!m_outputMatcher || !m_outputMatcher->Matches(modified_line, &line_data->match_pattern)) {
+                line_data.reset();
+            } else {
+                switch (line_data->match_pattern.sev) {
+                case Compiler::kSevError:
+                    m_errorCount++;
+                    break;
+                case Compiler::kSevWarning:
+                    m_warnCount++;
+                    break;
+                default:
+                    break;
+                }
+            }
+
+            // if this line matches a pattern (error or warning) AND
+            // this colour has no colour associated with it (using ANSI escape)
+            // add some
+            if (!lineHasColours && line_data != nullptr) {
+                line = WrapLineInColour(
+                    line,
+                    line_data->match_pattern.sev == Compiler::kSevError ? AnsiColours::Red() : AnsiColours::Yellow(),
+                    false,
+                    m_isDarkTheme);
+            }
+
+            // Associate the match info with the line in the view
+            // this will be used later when selecting lines
+            if (line_data) {
+                // set the line project name
+                line_data->toolchain = m_activeCompiler ? m_activeCompiler->GetName() : wxString();
+                line_data->project_name = m_currentProject;
+                line_data->match_pattern.file_path = MakeAbsolute(line_data->match_pattern.file_path);
+            }
+            output_line.text.swap(line);
+            output_line.info = std::move(line_data);
+        }
+        lines->push_back(std::move(output_line));
+    }
+}
+
+wxString BuildOutputParser::MakeAbsolute(const wxString& filepath)
+{
+    if (!filepath.StartsWith("..")) {
+        clDEBUG() << "(Build Tab View) file:" << filepath << "is already in absolute path" << endl;
+        return filepath; // already absolute path
+    }
+
+    if (m_isRemoteBuild) {
+        if (!m_workingDirectories.empty()) {
+            wxFileName fn(filepath, wxPATH_UNIX);
+            if (fn.MakeAbsolute(m_workingDirectories.front(), wxPATH_UNIX)) {
+                clDEBUG() << "(Build Tab View) File path modified from:" << filepath << "->"
+                          << fn.GetFullPath(wxPATH_UNIX) << endl;
+                return fn.GetFullPath(wxPATH_UNIX);
+            }
+        }
+    } else {
+        for (const auto& path : m_workingDirectories) {
+            wxFileName fn(filepath);
+            clDEBUG() << "(Build Tab View) Trying to convert file:" << filepath << "into abs path using wd:" << path
+                      << endl;
+            if (fn.MakeAbsolute(path) && fn.FileExists()) {
+                clDEBUG() << "(Build Tab View) File path modified from:" << filepath << "->" << fn.GetFullPath()
+                          << endl;
+                return fn.GetFullPath();
+            }
+        }
+    }
+
+    // default: do not modify the path
+    return filepath;
+}
+
+BuildOutputPipeline::BuildOutputPipeline()
+    : m_parser(new BuildOutputParser())
+{
+    m_worker = std::thread([this]() { WorkerMain(); });
+}
+
+BuildOutputPipeline::~BuildOutputPipeline()
+{
+    {
+        std::unique_lock<std::mutex> lk{ m_mutex };
+        m_shutdown = true;
+    }
+    m_cv.notify_all();
+    m_worker.join();
+}
+
+void BuildOutputPipeline::SetParser(std::unique_ptr<BuildOutputParser> parser)
+{
+    Flush();
+    std::unique_lock<std::mutex> lk{ m_mutex };
+    m_parser = std::move(parser);
+}
+
+void BuildOutputPipeline::Add(const wxString& output, bool process_last_line)
+{
+    {
+        std::unique_lock<std::mutex> lk{ m_mutex };
+        m_input.push_back({ output, process_last_line });
+    }
+    m_cv.notify_one();
+}
+
+void BuildOutputPipeline::Flush()
+{
+    std::unique_lock<std::mutex> lk{ m_mutex };
+    m_idle_cv.wait(lk, [this]() { return m_input.empty() && !m_busy; });
+}
+
+bool BuildOutputPipeline::TakeLines(std::vector<BuildOutputLine>* lines)
+{
+    std::unique_lock<std::mutex> lk{ m_mutex };
+    if (m_lines.empty()) {
+        return false;
+    }
+    lines->swap(m_lines);
+    m_lines.clear();
+    return true;
+}
+
+void BuildOutputPipeline::Clear()
+{
+    std::unique_lock<std::mutex> lk{ m_mutex };
+    m_input.clear();
+    // wait for the worker, so no lines are added after we return
+    m_idle_cv.wait(lk, [this]() { return !m_busy; });
+    m_lines.clear();
+}
+
+bool BuildOutputPipeline::IsIdle()
+{
+    std::unique_lock<std::mutex> lk{ m_mutex };
+    return m_input.empty() && !m_busy && m_lines.empty();
+}
+
+void BuildOutputPipeline::WorkerMain()
+{
+    while (true) {
+        std::deque<Input> input;
+        {
+            std::unique_lock<std::mutex> lk{ m_mutex };
+            m_cv.wait(lk, [this]() { return m_shutdown || !m_input.empty(); });
+            if (m_shutdown) {
+                break;
+            }
+            input.swap(m_input);
+            m_busy = true;
+        }
+
+        // parse everything that was queued since the last time in one go
+        std::vector<BuildOutputLine> lines;
+        wxString output;
+        for (auto& item : input) {
+            output << item.output;
+            if (item.process_last_line) {
+                m_parser->Add(output, true, &lines);
+                output.clear();
+            }
+        }
+        if (!output.empty()) {
+            m_parser->Add(output, false, &lines);
+        }
+
+        {
+            std::unique_lock<std::mutex> lk{ m_mutex };
+            if (m_lines.empty()) {
+                m_lines.swap(lines);
+            } else {
+                m_lines.insert(m_lines.end(), std::make_move_iterator(lines.begin()),
+                               std::make_move_iterator(lines.end()));
+            }
+            m_busy = false;
+        }
+        m_idle_cv.notify_all();
+    }
+}
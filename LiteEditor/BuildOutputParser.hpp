@@ -0,0 +1,104 @@
+#pragma once
+
+#include "CompilerOutputMatcher.hpp"
+#include "compiler.h"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <wx/string.h>
+
+struct LineClientData {
+    wxString project_name;
+    // use this as the root folder for changing relative paths to abs. If empty, use the workspace path
+    wxString root_dir;
+    Compiler::PatternMatch match_pattern;
+    wxString message;
+    wxString toolchain;
+};
+
+/// A line of the build output, ready to be displayed
+struct BuildOutputLine {
+    /// the line, without the line terminator, with its ANSI colours
+    wxString text;
+    /// set for errors and warnings
+    std::shared_ptr<LineClientData> info;
+};
+
+/// Split the build output into lines, match them against the compiler error and warning patterns and colour them.
+/// The parser does not access the UI, so it can run from a worker thread once it is initialised
+class BuildOutputParser
+{
+public:
+    BuildOutputParser() = default;
+    ~BuildOutputParser() = default;
+
+    /// Prepare the parser for a new build. This method accesses the workspace, call it from the main thread
+    void Initialise(CompilerPtr compiler, const wxString& project, bool is_dark_theme);
+
+    /// Parse `output`: the complete lines are added to `lines`. If the last line in the output is not completed (i.e.
+    /// it does not end with a line terminator) it is kept for the next call, unless `process_last_line` is `true`
+    void Add(const wxString& output, bool process_last_line, std::vector<BuildOutputLine>* lines);
+
+private:
+    /// Attempt to convert 'filepath' into absolute path
+    wxString MakeAbsolute(const wxString& filepath);
+
+    CompilerPtr m_activeCompiler;
+    CompilerOutputMatcher::Ptr_t m_outputMatcher;
+    wxString m_remainder;
+    size_t m_errorCount = 0;
+    size_t m_warnCount = 0;
+    wxString m_currentProject;
+    std::deque<wxString> m_workingDirectories;
+    bool m_isRemoteBuild = false;
+    bool m_isDarkTheme = false;
+};
+
+/// Run a BuildOutputParser on a worker thread. The output is queued with `Add` and the parsed lines are collected with
+/// `TakeLines`, typically from a timer, so the view is updated at a fixed rate regardless of the amount of output
+class BuildOutputPipeline
+{
+public:
+    BuildOutputPipeline();
+    ~BuildOutputPipeline();
+
+    /// Replace the parser, the output that was already queued is parsed by the previous parser
+    void SetParser(std::unique_ptr<BuildOutputParser> parser);
+
+    /// Queue build output for parsing
+    void Add(const wxString& output, bool process_last_line = false);
+
+    /// Wait until all the queued output is parsed
+    void Flush();
+
+    /// Move the parsed lines into `lines`. Return false if there are none
+    bool TakeLines(std::vector<BuildOutputLine>* lines);
+
+    /// Drop the queued output and the parsed lines
+    void Clear();
+
+    /// Return true if there is no output waiting to be parsed or collected
+    bool IsIdle();
+
+private:
+    void WorkerMain();
+
+    struct Input {
+        wxString output;
+        bool process_last_line = false;
+    };
+
+    std::unique_ptr<BuildOutputParser> m_parser;
+    std::deque<Input> m_input;
+    std::vector<BuildOutputLine> m_lines;
+    bool m_busy = false;
+    bool m_shutdown = false;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::condition_variable m_idle_cv;
+    std::thread m_worker;
+};
@@ -17,6 +17,12 @@
 #include <wx/sizer.h>
 #include <wx/tokenzr.h>
 
+namespace
+{
+/// The rate at which the parsed build output is added to the view (~30 frames per second)
+constexpr int FLUSH_INTERVAL_MS = 33;
+} // namespace
+
 BuildTab::BuildTab(wxWindow* parent)
     : wxPanel(parent, wxID_ANY)
 {
@@ -34,7 +40,16 @@ BuildTab::BuildTab(wxWindow* parent)
         e.Skip();
         Cleanup();
     });
-    m_buffer_sw.Start();
+
+    m_flushTimer = new wxTimer(this);
+    Bind(wxEVT_TIMER, &BuildTab::OnFlushTimer, this, m_flushTimer->GetId());
+}
+
+BuildTab::~BuildTab()
+{
+    m_flushTimer->Stop();
+    Unbind(wxEVT_TIMER, &BuildTab::OnFlushTimer, this, m_flushTimer->GetId());
+    wxDELETE(m_flushTimer);
 }
 
 void BuildTab::OnBuildStarted(clBuildEvent& e)
@@ -54,7 +69,8 @@ void BuildTab::OnBuildStarted(clBuildEvent& e)
     // ensure that the BUILD_IN is visible
     ManagerST::Get()->ShowOutputPane(BUILD_WIN, true, false);
 
-    m_buffer.clear();
+    // drop any output that was not parsed yet
+    m_pipeline.Clear();
     if (e.IsCleanLog()) {
         ClearView();
     }
@@ -72,21 +88,27 @@ void BuildTab::OnBuildStarted(clBuildEvent& e)
         clDEBUG() << "Active compiler is set to:" << m_activeCompiler->GetName() << endl;
     }
 
-    m_viewStc->Initialise(m_activeCompiler, m_buildTabSettings.IsSkipWarnings(), e.GetProjectName());
+    m_viewStc->Initialise(m_buildTabSettings.IsSkipWarnings());
+
+    // the parser accesses the workspace, so it is initialised here. From now on, it runs on the pipeline thread
+    std::unique_ptr<BuildOutputParser> parser(new BuildOutputParser());
+    parser->Initialise(m_activeCompiler, e.GetProjectName(), DrawingUtils::IsDark(m_viewStc->StyleGetBackground(0)));
+    m_pipeline.SetParser(std::move(parser));
+
     if (!m_activeCompiler) {
         clDEBUG() << "Compiler not selected in the workspace build settings or not available" << endl;
 
         // toolchain not selected in build configuration or unavailable
-        m_viewStc->Add(wxT("\n"));
-        m_viewStc->Add(
+        m_pipeline.Add(wxT("\n"));
+        m_pipeline.Add(
             WrapLineInColour(_("> WARNING: No toolchain selected. Build log highlighting will not be available!\n"),
                              AnsiColours::Yellow()));
-        m_viewStc->Add(
+        m_pipeline.Add(
             WrapLineInColour(_("           Check toolchain properly selected in the workspace build settings.\n"),
                              AnsiColours::Yellow()));
-        m_viewStc->Add(wxT("\n"));
-        m_viewStc->ScrollToEnd();
+        m_pipeline.Add(wxT("\n"));
     }
+    StartFlushTimer();
 
     // notify the plugins that the build had started
     clBuildEvent build_started_event(wxEVT_BUILD_STARTED);
@@ -101,19 +123,21 @@ void BuildTab::OnBuildStarted(clBuildEvent& e)
 void BuildTab::OnBuildAddLine(clBuildEvent& e)
 {
     e.Skip();
-    m_buffer << e.GetString();
-    ProcessBuffer();
+    m_pipeline.Add(e.GetString());
+    StartFlushTimer();
 }
 
 void BuildTab::OnBuildEnded(clBuildEvent& e)
 {
     e.Skip();
     m_buildInProgress = false;
-    ProcessBuffer(true);
+    m_pipeline.Add(wxEmptyString, true);
+    FlushOutput(true);
 
-    wxString text = CreateSummaryLine();
-    m_buffer.swap(text);
-    ProcessBuffer(true);
+    // the summary line uses the errors and warnings counted by the view, so it is created once all the output is
+    // displayed
+    m_pipeline.Add(CreateSummaryLine(), true);
+    FlushOutput(true);
 
     if (m_buildTabSettings.GetScrollTo() == BuildTabSettingsData::SCROLL_TO_FIRST_ERROR) {
         m_viewStc->SelectFirstErrorOrWarning(0, m_buildTabSettings.IsSkipWarnings(), true);
@@ -129,25 +153,37 @@ void BuildTab::OnBuildEnded(clBuildEvent& e)
     m_currentRootDir.clear();
 }
 
-#define PROCESSBUFFER_FMT_LINES_MAX 8192
-#define PROCESSBUFFER_FLUSH_TIME 200 // ms
+void BuildTab::FlushOutput(bool wait)
+{
+    if (wait) {
+        m_pipeline.Flush();
+    }
+
+    std::vector<BuildOutputLine> lines;
+    if (m_pipeline.TakeLines(&lines)) {
+        m_viewStc->AddLines(lines);
+    }
+}
 
-void BuildTab::ProcessBuffer(bool last_line)
+void BuildTab::OnFlushTimer(wxTimerEvent& e)
 {
-    auto remainder = m_viewStc->Add(m_buffer, last_line);
-    m_viewStc->ScrollToEnd();
+    wxUnusedVar(e);
+    FlushOutput(false);
+    if (!m_buildInProgress && m_pipeline.IsIdle()) {
+        m_flushTimer->Stop();
+    }
+}
 
-    if (last_line) {
-        m_buffer.clear();
-    } else {
-        m_buffer.swap(remainder);
+void BuildTab::StartFlushTimer()
+{
+    if (!m_flushTimer->IsRunning()) {
+        m_flushTimer->Start(FLUSH_INTERVAL_MS);
     }
 }
 
 void BuildTab::Cleanup()
 {
     m_buildInProgress = false;
-    m_buffer.clear();
     ClearView();
     m_activeCompiler = nullptr;
     m_buildInterrupted = false;
@@ -156,14 +192,14 @@ void BuildTab::Cleanup()
 
 void BuildTab::AppendLine(const wxString& text)
 {
-    m_buffer << text;
-    ProcessBuffer();
+    m_pipeline.Add(text);
+    StartFlushTimer();
 }
 
 void BuildTab::ClearView()
 {
+    m_pipeline.Clear();
     m_viewStc->Clear();
-    m_buffer.clear();
 }
 
 wxString BuildTab::WrapLineInColour(const wxString& line, int colour, bool fold_font) const
@@ -193,7 +229,7 @@ void BuildTab::SaveBuildLog()
             return;
         }
     }
-    FileUtils::WriteFileContent(path, m_viewStc->GetText());
+    FileUtils::WriteFileContent(path, m_viewStc->GetBuildLog());
 }
 
 wxString BuildTab::CreateSummaryLine()
@@ -216,7 +252,7 @@ wxString BuildTab::CreateSummaryLine()
         m_buildInterrupted = false;
     } else {
 
-        // at this point, m_buffer is empty
+        // at this point, all the build output was parsed
         text << "\n";
         if (m_viewStc->GetErrorCount()) {
             text = _("==== build ended with ");
@@ -268,4 +304,4 @@ void BuildTab::ProcessBuildingProjectLine(const wxString& line)
     m_currentProjectName.swap(s);
 }
 
-wxString BuildTab::GetBuildOutput() const { return m_viewStc->GetText(); }
+wxString BuildTab::GetBuildOutput() const { return m_viewStc->GetBuildLog(); }
@@ -11,12 +11,13 @@
 
 #include <wx/panel.h>
 #include <wx/stopwatch.h>
+#include <wx/timer.h>
 
 class BuildTab : public wxPanel
 {
 public:
     BuildTab(wxWindow* parent);
-    ~BuildTab() = default;
+    ~BuildTab();
 
     void AppendLine(const wxString& text);
     void ClearView();
@@ -33,7 +34,10 @@ protected:
     void OnBuildAddLine(clBuildEvent& e);
     void OnBuildEnded(clBuildEvent& e);
 
-    void ProcessBuffer(bool last_line = false);
+    void OnFlushTimer(wxTimerEvent& e);
+    /// Move the lines parsed by the pipeline into the view. If `wait` is true, wait for all the queued output first
+    void FlushOutput(bool wait);
+    void StartFlushTimer();
     void Cleanup();
     void ProcessBuildingProjectLine(const wxString& line);
     bool ProcessCargoBuildLine(const wxString& line);
@@ -48,8 +52,8 @@ private:
 
     // cleanable properties (between builds)
     bool m_buildInProgress = false;
-    wxString m_buffer;
-    wxStopWatch m_buffer_sw;
+    BuildOutputPipeline m_pipeline;
+    wxTimer* m_flushTimer = nullptr;
     CompilerPtr m_activeCompiler;
     bool m_buildInterrupted = false;
     wxString m_currentProjectName;
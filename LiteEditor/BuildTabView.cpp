@@ -2,7 +2,6 @@
 
 #include "ColoursAndFontsManager.h"
 #include "StringUtils.h"
-#include "clAnsiEscapeCodeColourBuilder.hpp"
 #include "clColours.h"
 #include "clSTCHelper.hpp"
 #include "clWorkspaceManager.h"
@@ -21,27 +20,6 @@
 
 namespace
 {
-wxString WrapLineInColour(const wxString& line, int colour, bool fold_font, bool is_dark_theme)
-{
-    wxString text;
-    clAnsiEscapeCodeColourBuilder text_builder(&text);
-
-    text_builder.SetTheme(is_dark_theme ? eColourTheme::DARK : eColourTheme::LIGHT).Add(line, colour, fold_font);
-    return text;
-}
-
-wxString ProcessBuildingProjectLine(const wxString& line)
-{
-    // extract the project name from the line
-    // an example line:
-    // ----------Building project:[ CodeLiteIDE - Win_x64_Release ] (Single File Build)----------
-    wxString s = line.AfterFirst('[');
-    s = s.BeforeLast(']');
-    s = s.BeforeLast('-');
-    s.Trim().Trim(false);
-    return s;
-}
-
 /// given range, [start, end), return the string in this range without any ANSI escape codes
 wxString GetSelectedRange(wxStyledTextCtrl* ctrl, int start_pos, int end_pos)
 {
@@ -64,6 +42,11 @@ constexpr int LINE_MARKER = 7;
 constexpr int NUMBER_MARGIN_ID = 1;
 constexpr int SYMBOLS_MARGIN_SEP_ID = 4;
 
+/// The maximum number of lines displayed by the control, the complete log is kept in a clChunkedLineStore
+constexpr size_t MAX_VIEW_LINES = 50000;
+/// Trim the control once it exceeds MAX_VIEW_LINES by this number of lines
+constexpr size_t TRIM_VIEW_LINES = 5000;
+
 /// Provide a helper that strips ANSI codes from the text
 class MyEventsHandler : public clEditEventsHandler
 {
@@ -149,145 +132,76 @@ void BuildTabView::InitialiseView()
     UsePopUp(0);
 }
 
-#define PROCESSBUFFER_FMT_LINES_MAX 8192
-#define PROCESSBUFFER_FLUSH_TIME 200 // ms
-
-wxString BuildTabView::Add(const wxString& output, bool process_last_line)
+void BuildTabView::AddLines(const std::vector<BuildOutputLine>& lines)
 {
-    SetEditable(true);
-    auto lines = ::wxStringTokenize(output, "\n", wxTOKEN_RET_DELIMS);
-    wxString remainder;
-    const size_t line_count = lines.Count();
-    bool is_dark_theme = DrawingUtils::IsDark(StyleGetBackground(0));
-    size_t cur_line_number = GetLineCount() - 1;
+    if (lines.empty()) {
+        return;
+    }
 
     wxString textToAppend;
-    for (size_t i = 0; i < line_count; i++, cur_line_number++) {
-        auto& line = lines[i];
-        if (!process_last_line && !line.EndsWith("\n")) {
-            // not a complete line
-            remainder.swap(line);
-            break;
-        }
-        line.Trim();
-
-        // Remove unwanted ANSI OSC escape sequences
-        line = StringUtils::StripTerminalOSC(line);
-
-        // easy path: check for common makefile messages
-        wxString lcLine = line.Lower();
-        if (lcLine.Contains("entering directory") || lcLine.Contains("leaving directory")) {
-            StringUtils::StripTerminalColouring(line, line);
-
-            wxString directory_name = line.AfterFirst('\'');
-            directory_name = directory_name.BeforeLast('\'');
-
-            // this functions as a stack, so we "push_front"
-            if (lcLine.Contains("entering directory")) {
-                m_workingDirectories.push_front(directory_name);
-
-            } else { // "Leaving directory"
-                if (!m_workingDirectories.empty()) {
-                    m_workingDirectories.pop_front();
-                } else {
-                    clWARNING() << "Leaving directory found, but no matching 'Entering directory'?" << endl;
-                }
-            }
-
-            line = WrapLineInColour(line, AnsiColours::Gray(), false, is_dark_theme);
-            textToAppend << line << "\n";
-
-        } else if (lcLine.Contains(CLEAN_PROJECT_PREFIX)) {
-            StringUtils::StripTerminalColouring(line, line);
-            line = WrapLineInColour(line, AnsiColours::Gray(), false, is_dark_theme);
-            textToAppend << line << "\n";
-
-        } else if (lcLine.Contains(BUILD_END_MSG) || lcLine.Contains("=== build completed") ||
-                   lcLine.Contains("=== build ended")) {
-            StringUtils::StripTerminalColouring(line, line);
-            if (m_errorCount > 0) {
-                // build ended with error
-                line = WrapLineInColour(line, AnsiColours::Red(), false, is_dark_theme);
-            } else if (m_warnCount > 0) {
-                // build ended with warnings only
-                line = WrapLineInColour(line, AnsiColours::Yellow(), false, is_dark_theme);
-            } else {
-                // clean build
-                line = WrapLineInColour(line, AnsiColours::Green(), false, is_dark_theme);
-            }
-            textToAppend << line << "\n";
-
-        } else if (lcLine.Contains(BUILD_PROJECT_PREFIX)) {
-            m_currentProject = ProcessBuildingProjectLine(line);
-            line = WrapLineInColour(line, AnsiColours::Gray(), false, is_dark_theme);
-            textToAppend << line << "\n";
-
-        } else if (line_count > PROCESSBUFFER_FMT_LINES_MAX) {
-            // Do not heavy process big lines count, no one will read results.
-            textToAppend << line;
-
-        } else {
-            std::shared_ptr<LineClientData> line_data(new LineClientData);
-            line_data->message = line;
-            line_data->root_dir = wxEmptyString; // maybe empty string
-
-            // remove the terminal ANSI colouring escape code
-            wxString modified_line;
-            StringUtils::StripTerminalColouring(line, modified_line);
-            bool lineHasColours = (line.length() != modified_line.length());
-
-            if (!m_activeCompiler) {
-                clWARNING() << "(Build Tab View) No active compiler" << endl;
-            }
-
-            // Pass the "clean" line to the regex processor
-            if (!m_activeCompiler || !m_activeCompiler->Matches(modified_line, &line_data->match_pattern)) {
-                line_data.reset();
-            } else {
-                switch (line_data->match_pattern.sev) {
-                case Compiler::kSevError:
-                    m_errorCount++;
-                    break;
-                case Compiler::kSevWarning:
-                    m_warnCount++;
-                    break;
-                default:
-                    break;
-                }
-            }
-
-            // if this line matches a pattern (error or warning) AND
-            // this colour has no colour associated with it (using ANSI escape)
-            // add some
-            if (!lineHasColours && line_data != nullptr) {
-                line = WrapLineInColour(
-                    line,
-                    line_data->match_pattern.sev == Compiler::kSevError ? AnsiColours::Red() : AnsiColours::Yellow(),
-                    false,
-                    is_dark_theme);
-            }
-            // Associate the match info with the line in the view
-            // this will be used later when selecting lines
-            // Note: its OK to pass null here
-            if (line_data) {
-                // set the line project name
-                line_data->toolchain = m_activeCompiler ? m_activeCompiler->GetName() : wxString();
-                line_data->project_name = m_currentProject;
-                line_data->match_pattern.file_path = MakeAbsolute(line_data->match_pattern.file_path);
-
-                clDEBUG() << "(Build Tab View) Storing line info for line:" << cur_line_number << endl;
-                m_lineInfo.insert({cur_line_number, line_data});
+    for (const auto& line : lines) {
+        size_t log_line = m_log.GetLineCount();
+        if (line.info) {
+            switch (line.info->match_pattern.sev) {
+            case Compiler::kSevError:
+                m_errorCount++;
+                break;
+            case Compiler::kSevWarning:
+                m_warnCount++;
+                break;
+            default:
+                break;
             }
-            textToAppend << line << "\n";
+            m_lineInfo.insert({ log_line, line.info });
+        }
+        m_log.AppendLine(line.text);
+        if (m_followTail) {
+            textToAppend << line.text << "\n";
         }
     }
 
-    if (!textToAppend.empty()) {
-        AppendText(textToAppend);
+    if (textToAppend.empty()) {
+        // the user is viewing older lines
+        return;
     }
 
+    SetEditable(true);
+    AppendText(textToAppend);
+
+    // the control keeps a single trailing empty line
+    size_t view_lines = GetLineCount() - 1;
+    if (view_lines > MAX_VIEW_LINES + TRIM_VIEW_LINES) {
+        // drop the oldest lines from the control, they are still available from the log
+        size_t excess = view_lines - MAX_VIEW_LINES;
+        DeleteRange(0, PositionFromLine(excess));
+        m_firstLogLine += excess;
+        m_indicatorStartPos = m_indicatorEndPos = wxNOT_FOUND;
+    }
     SetEditable(false);
-    return remainder;
+    ScrollToEnd();
+}
+
+void BuildTabView::ShowLogWindow(size_t first_line)
+{
+    SetEditable(true);
+    ClearAll();
+    AppendText(m_log.GetLines(first_line, MAX_VIEW_LINES));
+    SetEditable(false);
+
+    m_firstLogLine = first_line;
+    m_followTail = (first_line + MAX_VIEW_LINES >= m_log.GetLineCount());
+    m_indicatorStartPos = m_indicatorEndPos = wxNOT_FOUND;
+    ClearLineMarker();
+}
+
+size_t BuildTabView::EnsureLogLineShown(size_t line)
+{
+    size_t view_lines = GetLineCount() - 1;
+    if (line < m_firstLogLine || line >= m_firstLogLine + view_lines) {
+        // place the line in the middle of the window
+        ShowLogWindow(line > MAX_VIEW_LINES / 2 ? line - MAX_VIEW_LINES / 2 : 0);
+    }
+    return line - m_firstLogLine;
 }
 
 void BuildTabView::Clear()
@@ -298,11 +212,9 @@ void BuildTabView::Clear()
     m_lineInfo.clear();
     m_errorCount = 0;
     m_warnCount = 0;
-    m_currentProject = wxEmptyString;
-    m_activeCompiler = nullptr;
-    m_workingDirectories.clear();
-    m_isRemoteBuild = false;
-    m_buildingProject.clear();
+    m_log.Clear();
+    m_firstLogLine = 0;
+    m_followTail = true;
     ClearLineMarker();
 }
 
@@ -348,9 +260,10 @@ void BuildTabView::OnLeftUp(wxMouseEvent& e)
 void BuildTabView::DoPatternClicked(const wxString& pattern, int pattern_line)
 {
     clDEBUG() << "(Build Tab View) Searching for line info for view line:" << pattern_line << endl;
-    if (m_lineInfo.count(pattern_line)) {
-        clDEBUG() << "Using parsed data for view line:" << pattern_line << endl;
-        const auto& line_info = m_lineInfo[pattern_line];
+    size_t log_line = m_firstLogLine + pattern_line;
+    if (m_lineInfo.count(log_line)) {
+        clDEBUG() << "Using parsed data for log line:" << log_line << endl;
+        const auto& line_info = m_lineInfo[log_line];
         OpenEditor(line_info);
     } else {
         clDEBUG() << "(Build Tab View) No line info for view line:" << pattern_line << endl;
@@ -430,7 +343,8 @@ void BuildTabView::OnNextBuildError(wxCommandEvent& event)
     if (from == wxString::npos) {
         from = 0;
     } else {
-        ++from;
+        // convert to log line
+        from += m_firstLogLine + 1;
     }
     clDEBUG() << "(Build Tab View) searching error from line:" << from << endl;
     SelectFirstErrorOrWarning(from, m_onlyErrors, true);
@@ -442,8 +356,12 @@ void BuildTabView::SelectFirstErrorOrWarning(size_t from, bool errors_only, bool
 {
     auto line_info = GetNextLineWithErrorOrWarning(from, errors_only);
     if (line_info.has_value()) {
-        SetLineMarker(line_info.value().first, center_line);
+        SetLineMarker(EnsureLogLineShown(line_info.value().first), center_line);
         OpenEditor(line_info.value().second);
+    } else if (!m_followTail) {
+        // no more errors: go back to the end of the log
+        size_t line_count = m_log.GetLineCount();
+        ShowLogWindow(line_count > MAX_VIEW_LINES ? line_count - MAX_VIEW_LINES : 0);
     }
 }
 
@@ -454,8 +372,7 @@ BuildTabView::GetNextLineWithErrorOrWarning(size_t from, bool errors_only) const
         return {};
     }
 
-    size_t line_count = GetLineCount();
-    if (from >= static_cast<size_t>(GetLineCount())) {
+    if (from >= m_log.GetLineCount()) {
         return {};
     }
 
@@ -584,6 +501,10 @@ void BuildTabView::OnContextMenu(wxContextMenuEvent& e)
             SetEditable(true);
             ClearAll();
             SetEditable(false);
+            m_lineInfo.clear();
+            m_log.Clear();
+            m_firstLogLine = 0;
+            m_followTail = true;
         },
         XRCID("buildtabview_clear_all"));
     menu.Bind(
@@ -591,74 +512,8 @@ void BuildTabView::OnContextMenu(wxContextMenuEvent& e)
     PopupMenu(&menu);
 }
 
-void BuildTabView::Initialise(CompilerPtr compiler, bool only_erros, const wxString& project)
+void BuildTabView::Initialise(bool only_erros)
 {
     Clear();
-    m_activeCompiler = compiler; // maybe null
     m_onlyErrors = only_erros;
-    m_isRemoteBuild = false;
-    m_buildingProject = project;
-
-    auto workspace = clWorkspaceManager::Get().GetWorkspace();
-    if (workspace) {
-        m_isRemoteBuild = workspace->IsRemote();
-        wxString workspace_file = workspace->GetFileName();
-        workspace_file.Replace("\\", "/");
-        wxString workspace_dir = workspace_file.BeforeLast('/');
-
-        if (clCxxWorkspaceST::Get() && clCxxWorkspaceST::Get()->IsOpen()) {
-            auto project = clCxxWorkspaceST::Get()->GetProject(m_buildingProject);
-            if (project) {
-                auto build_conf = project->GetBuildConfiguration(wxEmptyString);
-                if (build_conf && build_conf->IsCustomBuild() && !build_conf->GetCustomBuildWorkingDir().empty()) {
-                    // use the custom build's working directory
-                    wxFileName custom_wd(build_conf->GetCustomBuildWorkingDir(), wxEmptyString);
-                    if (custom_wd.IsRelative()) {
-                        custom_wd.MakeAbsolute(project->GetProjectPath());
-                    }
-                    m_workingDirectories.push_front(custom_wd.GetPath());
-                } else {
-                    // use the project path
-                    m_workingDirectories.push_front(project->GetProjectPath());
-                }
-            } else {
-                clWARNING() << "Could not locate project:" << m_buildingProject << endl;
-            }
-        } else {
-            m_workingDirectories.push_front(workspace_dir);
-        }
-    }
-}
-
-wxString BuildTabView::MakeAbsolute(const wxString& filepath)
-{
-    if (!filepath.StartsWith("..")) {
-        clDEBUG() << "(Build Tab View) file:" << filepath << "is already in absolute path" << endl;
-        return filepath; // already absolute path
-    }
-
-    if (m_isRemoteBuild) {
-        if (!m_workingDirectories.empty()) {
-            wxFileName fn(filepath, wxPATH_UNIX);
-            if (fn.MakeAbsolute(m_workingDirectories.front(), wxPATH_UNIX)) {
-                clDEBUG() << "(Build Tab View) File path modified from:" << filepath << "->"
-                          << fn.GetFullPath(wxPATH_UNIX) << endl;
-                return fn.GetFullPath(wxPATH_UNIX);
-            }
-        }
-    } else {
-        for (const auto& path : m_workingDirectories) {
-            wxFileName fn(filepath);
-            clDEBUG() << "(Build Tab View) Trying to convert file:" << filepath << "into abs path using wd:" << path
-                      << endl;
-            if (fn.MakeAbsolute(path) && fn.FileExists()) {
-                clDEBUG() << "(Build Tab View) File path modified from:" << filepath << "->" << fn.GetFullPath()
-                          << endl;
-                return fn.GetFullPath();
-            }
-        }
-    }
-
-    // default: do not modify the path
-    return filepath;
 }
@@ -1,50 +1,41 @@
 #pragma once
 
+#include "BuildOutputParser.hpp"
+#include "clChunkedLineStore.hpp"
 #include "clEditorEditEventsHandler.h"
 #include "compiler.h"
 
-#include <deque>
 #include <map>
 #include <memory>
 #include <optional>
 #include <wx/stc/stc.h>
 
-struct LineClientData {
-    wxString project_name;
-    // use this as the root folder for changing relative paths to abs. If empty, use the workspace path
-    wxString root_dir;
-    Compiler::PatternMatch match_pattern;
-    wxString message;
-    wxString toolchain;
-};
-
 class BuildTabView : public wxStyledTextCtrl
 {
 public:
     BuildTabView(wxWindow* parent);
     virtual ~BuildTabView();
 
-    /// Append text to the control.
+    /// Append parsed lines (see BuildOutputParser) to the log.
     ///
-    /// This function adds complete lines (i.e. line that ends with a line terminator)
-    /// to the view and parses them for errors / warnings.
-    ///
-    /// Returns:
-    /// If the last line in the output is not completed (i.e. it does not end with a line terminator)
-    /// it is returned for later processing (unless `process_last_line` is `true`)
-    wxString Add(const wxString& output, bool process_last_line = false);
+    /// All the lines are kept in a chunked store, that spills the old lines to the disk. The control itself shows a
+    /// window of at most `MAX_VIEW_LINES` lines: the last ones, unless the user navigated to an older error
+    void AddLines(const std::vector<BuildOutputLine>& lines);
 
     /// Clear the view and all parsed information
     void Clear();
 
     /// Initialise the view, preparing it for the next build process. This method should be called when a new build
     /// is starting
-    void Initialise(CompilerPtr compiler, bool only_erros, const wxString& project);
+    void Initialise(bool only_erros);
 
     size_t GetErrorCount() const { return m_errorCount; }
     size_t GetWarnCount() const { return m_warnCount; }
 
-    /// Select the first error / warning message starting from line `from`
+    /// Return the complete build log (including the lines that are not displayed)
+    wxString GetBuildLog() const { return m_log.GetText(); }
+
+    /// Select the first error / warning message starting from the log line `from`
     void SelectFirstErrorOrWarning(size_t from, bool errors_only, bool center_line);
 
 protected:
@@ -63,20 +54,23 @@ protected:
     void InitialiseView();
     void OnThemeChanged(wxCommandEvent& e);
 
-    /// Attempt to convert 'filepath' into absolute path
-    wxString MakeAbsolute(const wxString& filepath);
+    /// Display the log lines starting at `first_line`
+    void ShowLogWindow(size_t first_line);
+    /// Make sure that the log line `line` is displayed, and return its line in the control
+    size_t EnsureLogLineShown(size_t line);
 
 private:
+    // log line -> error / warning info
     std::map<size_t, std::shared_ptr<LineClientData>> m_lineInfo;
-    CompilerPtr m_activeCompiler;
     bool m_onlyErrors = false;
     size_t m_errorCount = 0;
     size_t m_warnCount = 0;
-    wxString m_currentProject;
     int m_indicatorStartPos = wxNOT_FOUND;
     int m_indicatorEndPos = wxNOT_FOUND;
     clEditEventsHandler::Ptr_t m_editEvents;
-    std::deque<wxString> m_workingDirectories;
-    bool m_isRemoteBuild = false;
-    wxString m_buildingProject; // only relevant for C++ workspace
+    clChunkedLineStore m_log;
+    // the log line displayed in the first line of the control
+    size_t m_firstLogLine = 0;
+    // the control displays the last log lines, new lines are appended to it
+    bool m_followTail = true;
 };
@@ -229,6 +229,14 @@ FindInFilesDialogBase::FindInFilesDialogBase(wxWindow* parent, wxWindowID id, co
 
     staticBoxSizer175->Add(m_checkBoxIncludeHiddenFolders, 0, wxALL, WXC_FROM_DIP(5));
 
+    m_checkBoxUseIndex = new wxCheckBox(m_panelMainPanel, wxID_ANY, _("Use index"), wxDefaultPosition,
+                                        wxDLG_UNIT(m_panelMainPanel, wxSize(-1, -1)), 0);
+    m_checkBoxUseIndex->SetValue(false);
+    m_checkBoxUseIndex->SetToolTip(_("File system workspaces: narrow down the files to search with an index of their "
+                                     "content, kept up-to-date in the background"));
+
+    staticBoxSizer175->Add(m_checkBoxUseIndex, 0, wxALL, WXC_FROM_DIP(5));
+
     wxStaticBoxSizer* staticBoxSizer171 =
         new wxStaticBoxSizer(new wxStaticBox(m_panelMainPanel, wxID_ANY, _("Presets:")), wxHORIZONTAL);
 
@@ -68,6 +68,7 @@ protected:
     wxCheckBox* m_checkBoxSaveFilesBeforeSearching;
     wxCheckBox* m_checkBoxFollowSymlinks;
     wxCheckBox* m_checkBoxIncludeHiddenFolders;
+    wxCheckBox* m_checkBoxUseIndex;
     wxCheckBox* m_checkBoxTODO;
     wxCheckBox* m_checkBoxATTN;
     wxCheckBox* m_checkBoxBUG;
@@ -110,6 +111,7 @@ public:
     wxCheckBox* GetCheckBoxSaveFilesBeforeSearching() { return m_checkBoxSaveFilesBeforeSearching; }
     wxCheckBox* GetCheckBoxFollowSymlinks() { return m_checkBoxFollowSymlinks; }
     wxCheckBox* GetCheckBoxIncludeHiddenFolders() { return m_checkBoxIncludeHiddenFolders; }
+    wxCheckBox* GetCheckBoxUseIndex() { return m_checkBoxUseIndex; }
     wxCheckBox* GetCheckBoxTODO() { return m_checkBoxTODO; }
     wxCheckBox* GetCheckBoxATTN() { return m_checkBoxATTN; }
     wxCheckBox* GetCheckBoxBUG() { return m_checkBoxBUG; }
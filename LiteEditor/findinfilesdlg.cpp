@@ -25,6 +25,7 @@
 #include "findinfilesdlg.h"
 
 #include "ColoursAndFontsManager.h"
+#include "FileSystemWorkspace/clFileSystemWorkspace.hpp"
 #include "FindInFilesLocationsDlg.h"
 #include "StringUtils.h"
 #include "clFilesCollector.h"
@@ -163,6 +164,7 @@ FindInFilesDialog::FindInFilesDialog(wxWindow* parent, wxWindow* handler)
 
     m_checkBoxFollowSymlinks->SetValue(!(m_data.files_scanner_flags & clFilesScanner::SF_DONT_FOLLOW_SYMLINKS));
     m_checkBoxIncludeHiddenFolders->SetValue(!(m_data.files_scanner_flags & clFilesScanner::SF_EXCLUDE_HIDDEN_DIRS));
+    m_checkBoxUseIndex->SetValue(clConfig::Get().Read(kConfigFindInFilesUseIndex, false));
 
     SetName("FindInFilesDialog");
     CallAfter(&FindInFilesDialog::DoSelectAll);
@@ -604,6 +606,7 @@ void FindInFilesDialog::SaveFindReplaceData()
         search_flags &= ~clFilesScanner::SF_EXCLUDE_HIDDEN_DIRS;
     }
     m_data.files_scanner_flags = search_flags;
+    clFileSystemWorkspace::Get().EnableSearchIndex(m_checkBoxUseIndex->IsChecked());
 
     // save the session
     SessionManager::Get().SaveFindInFilesSession(m_data);
@@ -0,0 +1,424 @@
+#include "CompilerOutputMatcher.hpp"
+
+#include "file_logger.h"
+
+#include <algorithm>
+
+namespace
+{
+/// A sequence of regex atoms
+struct Sequence {
+    /// each entry is a list of strings, one of them at least must be found in a matching text
+    std::vector<std::vector<wxString>> required;
+    /// the sequence text, if it is made of plain characters only
+    wxString literal;
+    bool is_literal = true;
+};
+
+/// Collect the strings required by a regular expression (ARE syntax). This is conservative: any construct that is not
+/// understood makes the whole pattern unsupported, and optional atoms are ignored
+class RequiredLiteralsParser
+{
+    const wxString& m_re;
+    size_t m_pos = 0;
+    bool m_ok = true;
+
+private:
+    bool at_end() const { return m_pos >= m_re.length(); }
+    wxUniChar peek(size_t offset = 0) const
+    {
+        return m_pos + offset < m_re.length() ? m_re[m_pos + offset] : wxUniChar(0);
+    }
+    static bool is_digit(wxUniChar ch) { return ch >= '0' && ch <= '9'; }
+    static bool is_hex_digit(wxUniChar ch)
+    {
+        return is_digit(ch) || (ch >= 'a' && ch <= 'f') || (ch >= 'A' && ch <= 'F');
+    }
+
+    void skip_escape()
+    {
+        // we are placed on the letter or the digit that follows the "\". The digits of a character entry (\x1b,
+        // \u00e9, \033) or of a back reference are part of the escape
+        wxUniChar ch = peek();
+        ++m_pos;
+        size_t max_digits = 0;
+        bool hex = true;
+        if (ch == 'c') {
+            // \cX
+            m_pos = std::min(m_pos + 1, m_re.length());
+            return;
+        } else if (ch == 'u') {
+            max_digits = 4;
+        } else if (ch == 'U') {
+            max_digits = 8;
+        } else if (ch == 'x') {
+            max_digits = wxString::npos;
+        } else if (is_digit(ch)) {
+            max_digits = wxString::npos;
+            hex = false;
+        }
+
+        for (size_t count = 0; count < max_digits && (hex ? is_hex_digit(peek()) : is_digit(peek())); ++count) {
+            ++m_pos;
+        }
+    }
+
+    void skip_bracket()
+    {
+        // we are placed on the opening "["
+        ++m_pos;
+        if (peek() == '^') {
+            ++m_pos;
+        }
+        if (peek() == ']') {
+            // a leading "]" is part of the set
+            ++m_pos;
+        }
+        while (!at_end() && peek() != ']') {
+            if (peek() == '[' && (peek(1) == ':' || peek(1) == '.' || peek(1) == '=')) {
+                // [:alpha:], [.x.] or [=x=]
+                wxString terminator;
+                terminator << peek(1) << "]";
+                size_t where = m_re.find(terminator, m_pos + 2);
+                if (where == wxString::npos) {
+                    m_ok = false;
+                    return;
+                }
+                m_pos = where + terminator.length();
+            } else if (peek() == '\\') {
+                m_pos += 2;
+            } else {
+                ++m_pos;
+            }
+        }
+
+        if (at_end()) {
+            m_ok = false;
+            return;
+        }
+        ++m_pos;
+    }
+
+    std::vector<Sequence> parse_alternatives()
+    {
+        std::vector<Sequence> alternatives;
+        alternatives.push_back(parse_sequence());
+        while (m_ok && peek() == '|') {
+            ++m_pos;
+            alternatives.push_back(parse_sequence());
+        }
+        return alternatives;
+    }
+
+    Sequence parse_sequence()
+    {
+        Sequence seq;
+        wxString run;
+        auto flush = [&]() {
+            if (!run.empty()) {
+                seq.required.push_back({ run });
+                run.clear();
+            }
+        };
+
+        while (m_ok && !at_end() && peek() != '|' && peek() != ')') {
+            wxUniChar ch = peek();
+
+            // the atom
+            bool is_char = false;
+            bool is_literal_group = false;
+            wxString text;
+            std::vector<std::vector<wxString>> atom_required;
+
+            if (ch == '(') {
+                ++m_pos;
+                bool lookahead = false;
+                if (peek() == '?') {
+                    if (peek(1) == ':') {
+                        m_pos += 2;
+                    } else if (peek(1) == '=' || peek(1) == '!') {
+                        m_pos += 2;
+                        lookahead = true;
+                    } else {
+                        // embedded options and such
+                        m_ok = false;
+                        break;
+                    }
+                }
+
+                auto alternatives = parse_alternatives();
+                if (!m_ok || peek() != ')') {
+                    m_ok = false;
+                    break;
+                }
+                ++m_pos;
+
+                if (lookahead) {
+                    // matches no text
+                } else if (alternatives.size() == 1) {
+                    atom_required.swap(alternatives[0].required);
+                    is_literal_group = alternatives[0].is_literal;
+                    text = alternatives[0].literal;
+                } else {
+                    // (note|warning): one of the alternatives must be found
+                    std::vector<wxString> any_of;
+                    for (const auto& alternative : alternatives) {
+                        if (!alternative.is_literal || alternative.literal.empty()) {
+                            any_of.clear();
+                            break;
+                        }
+                        any_of.push_back(alternative.literal.Lower());
+                    }
+                    if (!any_of.empty()) {
+                        atom_required.push_back(std::move(any_of));
+                    }
+                }
+
+            } else if (ch == '[') {
+                skip_bracket();
+
+            } else if (ch == '\\') {
+                wxUniChar escaped = peek(1);
+                if (escaped == 0) {
+                    m_ok = false;
+                    break;
+                }
+                ++m_pos;
+                if (!wxIsalnum(escaped)) {
+                    // an escaped special character, e.g. "\("
+                    is_char = true;
+                    text << escaped;
+                    ++m_pos;
+                } else {
+                    // a class, a back reference, an anchor, a character entry... we don't know what it matches
+                    skip_escape();
+                }
+
+            } else if (ch == '.' || ch == '^' || ch == '$') {
+                ++m_pos;
+
+            } else if (ch == '*' || ch == '+' || ch == '?' || (ch == '{' && is_digit(peek(1)))) {
+                // a quantifier without an atom (e.g. the "***=" director)
+                m_ok = false;
+                break;
+
+            } else {
+                is_char = true;
+                text << ch;
+                ++m_pos;
+            }
+
+            if (!m_ok) {
+                break;
+            }
+
+            // the quantifier
+            bool optional = false;
+            bool repeated = false;
+            wxUniChar q = peek();
+            if (q == '*' || q == '?') {
+                optional = true;
+                ++m_pos;
+            } else if (q == '+') {
+                repeated = true;
+                ++m_pos;
+            } else if (q == '{' && is_digit(peek(1))) {
+                size_t close = m_re.find('}', m_pos);
+                if (close == wxString::npos) {
+                    m_ok = false;
+                    break;
+                }
+                long min_count = 0;
+                m_re.Mid(m_pos + 1, close - m_pos - 1).BeforeFirst(',').ToCLong(&min_count);
+                optional = (min_count == 0);
+                repeated = true;
+                m_pos = close + 1;
+            }
+            if ((optional || repeated) && peek() == '?') {
+                // non greedy
+                ++m_pos;
+            }
+
+            if (optional) {
+                flush();
+                seq.is_literal = false;
+
+            } else if (is_char || is_literal_group) {
+                // the text is part of the current run
+                run << text.Lower();
+                seq.literal << text;
+                if (repeated) {
+                    flush();
+                    seq.is_literal = false;
+                }
+
+            } else {
+                flush();
+                seq.is_literal = false;
+                for (auto& any_of : atom_required) {
+                    seq.required.push_back(std::move(any_of));
+                }
+            }
+        }
+        flush();
+        return seq;
+    }
+
+public:
+    explicit RequiredLiteralsParser(const wxString& re)
+        : m_re(re)
+    {
+    }
+
+    std::vector<wxString> Parse()
+    {
+        auto alternatives = parse_alternatives();
+        if (!m_ok || !at_end()) {
+            return {};
+        }
+
+        std::vector<std::vector<wxString>> required;
+        if (alternatives.size() == 1) {
+            required.swap(alternatives[0].required);
+        } else {
+            std::vector<wxString> any_of;
+            for (const auto& alternative : alternatives) {
+                if (!alternative.is_literal || alternative.literal.empty()) {
+                    return {};
+                }
+                any_of.push_back(alternative.literal.Lower());
+            }
+            required.push_back(std::move(any_of));
+        }
+
+        // pick the most selective requirement: the one whose shortest string is the longest
+        auto score = [](const std::vector<wxString>& any_of) {
+            size_t shortest = wxString::npos;
+            for (const auto& str : any_of) {
+                shortest = std::min(shortest, str.length());
+            }
+            return shortest;
+        };
+
+        std::vector<wxString> best;
+        for (auto& any_of : required) {
+            if (best.empty() || score(any_of) > score(best)) {
+                best.swap(any_of);
+            }
+        }
+        return best;
+    }
+};
+} // namespace
+
+CompilerOutputMatcher::CompilerOutputMatcher(const Compiler::CmpListInfoPattern& warning_patterns,
+                                             const Compiler::CmpListInfoPattern& error_patterns)
+{
+    // warnings must be first!
+    AddPatterns(warning_patterns, Compiler::kSevWarning);
+    AddPatterns(error_patterns, Compiler::kSevError);
+    m_literals_found.resize(m_literals.size());
+}
+
+void CompilerOutputMatcher::AddPatterns(const Compiler::CmpListInfoPattern& patterns, Compiler::eSeverity severity)
+{
+    for (const auto& info : patterns) {
+        Pattern pattern;
+        pattern.severity = severity;
+
+        // if any of the below conversion fails, we got a problem with this pattern
+        if (!info.columnIndex.ToCLong(&pattern.column_index) || !info.lineNumberIndex.ToCLong(&pattern.line_index) ||
+            !info.fileNameIndex.ToCLong(&pattern.file_index)) {
+            continue;
+        }
+
+        pattern.re.reset(new wxRegEx(info.pattern, wxRE_ADVANCED | wxRE_ICASE));
+        if (!pattern.re->IsValid()) {
+            clWARNING() << "Regex pattern:" << info.pattern << "is not valid!" << endl;
+            continue;
+        }
+
+        for (const auto& literal : GetRequiredLiterals(info.pattern)) {
+            auto iter = std::find(m_literals.begin(), m_literals.end(), literal);
+            pattern.literals.push_back(iter - m_literals.begin());
+            if (iter == m_literals.end()) {
+                m_literals.push_back(literal);
+            }
+        }
+        m_patterns.push_back(std::move(pattern));
+    }
+}
+
+std::vector<wxString> CompilerOutputMatcher::GetRequiredLiterals(const wxString& pattern)
+{
+    RequiredLiteralsParser parser(pattern);
+    return parser.Parse();
+}
+
+bool CompilerOutputMatcher::Matches(const wxString& line, Compiler::PatternMatch* match_result)
+{
+    if (!match_result) {
+        return false;
+    }
+
+    wxString lc_line;
+    if (!m_literals.empty()) {
+        lc_line = line.Lower();
+        std::fill(m_literals_found.begin(), m_literals_found.end(), 0);
+    }
+
+    for (auto& pattern : m_patterns) {
+        bool found = pattern.literals.empty();
+        for (size_t index : pattern.literals) {
+            auto& state = m_literals_found[index];
+            if (state == 0) {
+                state = lc_line.find(m_literals[index]) == wxString::npos ? 2 : 1;
+            }
+            if (state == 1) {
+                found = true;
+                break;
+            }
+        }
+
+        if (found && IsMatchesPattern(pattern, line, match_result)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CompilerOutputMatcher::IsMatchesPattern(Pattern& pattern,
+                                             const wxString& line,
+                                             Compiler::PatternMatch* match_result) const
+{
+    if (!pattern.re->Matches(line)) {
+        return false;
+    }
+
+    match_result->sev = pattern.severity;
+    // extract the file name
+    if (pattern.re->GetMatchCount() > (size_t)pattern.file_index) {
+        match_result->file_path = pattern.re->GetMatch(line, pattern.file_index);
+    }
+
+    // extract the line number
+    if (pattern.re->GetMatchCount() > (size_t)pattern.line_index) {
+        long lineNumber;
+        wxString strLine = pattern.re->GetMatch(line, pattern.line_index);
+        strLine.ToCLong(&lineNumber);
+        match_result->line_number = lineNumber;
+    }
+
+    if (pattern.re->GetMatchCount() > (size_t)pattern.column_index) {
+        long column;
+        wxString strCol = pattern.re->GetMatch(line, pattern.column_index);
+        if (strCol.StartsWith(":")) {
+            strCol.Remove(0, 1);
+        }
+
+        if (!strCol.IsEmpty() && strCol.ToLong(&column)) {
+            match_result->column = column;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "codelite_exports.h"
+#include "compiler.h"
+
+#include <memory>
+#include <vector>
+#include <wx/regex.h>
+#include <wx/string.h>
+
+/// Match build output lines against all the error and warning patterns of a compiler.
+///
+/// The patterns are compiled once, when the matcher is created. Each pattern is guarded by a literal prefilter: the
+/// strings that any line matching the pattern must contain (e.g. "error" for `^(.+?):(\d+):.* (error): (.*)$`). The
+/// line is lower-cased once and a pattern's regex runs only when one of its strings is found in it, so the bulk of the
+/// build output (compiler command lines, progress messages) never reaches the regex engine.
+///
+/// Warnings are tested before errors, like `Compiler::Matches` always did. A matcher is not thread safe (`wxRegEx`
+/// keeps the last match), create one per thread.
+class WXDLLIMPEXP_SDK CompilerOutputMatcher
+{
+public:
+    typedef std::shared_ptr<CompilerOutputMatcher> Ptr_t;
+
+private:
+    struct Pattern {
+        std::unique_ptr<wxRegEx> re;
+        Compiler::eSeverity severity = Compiler::kSevError;
+        long file_index = wxNOT_FOUND;
+        long line_index = wxNOT_FOUND;
+        long column_index = wxNOT_FOUND;
+        /// indices in m_literals, a matching line contains at least one of them. Empty: no prefilter
+        std::vector<size_t> literals;
+    };
+
+    std::vector<Pattern> m_patterns;
+    /// the distinct, lower case, literals used by the patterns
+    std::vector<wxString> m_literals;
+    /// per line cache: 0 - not checked yet, 1 - found, 2 - not found
+    std::vector<char> m_literals_found;
+
+private:
+    void AddPatterns(const Compiler::CmpListInfoPattern& patterns, Compiler::eSeverity severity);
+    bool IsMatchesPattern(Pattern& pattern, const wxString& line, Compiler::PatternMatch* match_result) const;
+
+public:
+    CompilerOutputMatcher(const Compiler::CmpListInfoPattern& warning_patterns,
+                          const Compiler::CmpListInfoPattern& error_patterns);
+    ~CompilerOutputMatcher() = default;
+
+    CompilerOutputMatcher(const CompilerOutputMatcher&) = delete;
+    CompilerOutputMatcher& operator=(const CompilerOutputMatcher&) = delete;
+
+    /// Attempt to parse `line` and provide details about the parsed data
+    bool Matches(const wxString& line, Compiler::PatternMatch* match_result);
+
+    /// Return the number of valid patterns
+    size_t GetPatternsCount() const { return m_patterns.size(); }
+
+    /// Return the strings (in lower case) that a line must contain, one of them at least, to match `pattern`.
+    /// An empty list means that no such string could be determined
+    static std::vector<wxString> GetRequiredLiterals(const wxString& pattern);
+};
@@ -9,6 +9,7 @@
 #include "NewFileSystemWorkspaceDialog.h"
 #include "StringUtils.h"
 #include "build_settings_config.h"
+#include "cl_config.h"
 #include "clFileSystemEvent.h"
 #include "clFileSystemWorkspaceView.hpp"
 #include "clFilesCollector.h"
@@ -28,6 +29,7 @@
 #include "imanager.h"
 #include "macromanager.h"
 #include "macros.h"
+#include "search_thread.h"
 #include "shell_command.h"
 #include "wxStringHash.h"
 
@@ -77,6 +79,9 @@ clFileSystemWorkspace::clFileSystemWorkspace(bool dummy)
         Bind(wxEVT_ASYNC_PROCESS_TERMINATED, &clFileSystemWorkspace::OnBuildProcessTerminated, this);
         Bind(wxEVT_ASYNC_PROCESS_OUTPUT, &clFileSystemWorkspace::OnBuildProcessOutput, this);
         Bind(wxEVT_TERMINAL_EXIT, &clFileSystemWorkspace::OnExecProcessTerminated, this);
+        m_searchIndexWatcher.SetOwner(this);
+        Bind(wxEVT_FILE_MODIFIED, &clFileSystemWorkspace::OnSearchIndexFileModified, this);
+        Bind(wxEVT_FILE_NOT_FOUND, &clFileSystemWorkspace::OnSearchIndexFileDeleted, this);
 
         // Exec events
         EventNotifier::Get()->Bind(wxEVT_CMD_EXECUTE_ACTIVE_PROJECT, &clFileSystemWorkspace::OnExecute, this);
@@ -120,6 +125,9 @@ clFileSystemWorkspace::~clFileSystemWorkspace()
         Unbind(wxEVT_ASYNC_PROCESS_TERMINATED, &clFileSystemWorkspace::OnBuildProcessTerminated, this);
         Unbind(wxEVT_ASYNC_PROCESS_OUTPUT, &clFileSystemWorkspace::OnBuildProcessOutput, this);
         Unbind(wxEVT_TERMINAL_EXIT, &clFileSystemWorkspace::OnExecProcessTerminated, this);
+        Unbind(wxEVT_FILE_MODIFIED, &clFileSystemWorkspace::OnSearchIndexFileModified, this);
+        Unbind(wxEVT_FILE_NOT_FOUND, &clFileSystemWorkspace::OnSearchIndexFileDeleted, this);
+        CloseSearchIndex();
 
         // Exec events
         EventNotifier::Get()->Unbind(wxEVT_CMD_EXECUTE_ACTIVE_PROJECT, &clFileSystemWorkspace::OnExecute, this);
@@ -316,6 +324,9 @@ void clFileSystemWorkspace::DoOpen()
     fnFolder.AppendDir(".codelite");
     fnFolder.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
 
+    // Open the find in files index (if enabled), it is populated once the files are cached
+    OpenSearchIndex();
+
     // Load the backticks cache file, this needs to be done early as we can
     // since it is used
     if (m_backtickCache) {
@@ -390,6 +401,7 @@ void clFileSystemWorkspace::DoClose()
 
     // Free the database
     TagsManagerST::Get()->CloseDatabase();
+    CloseSearchIndex();
 
     m_isLoaded = false;
     m_showWelcomePage = true;
@@ -441,6 +453,9 @@ void clFileSystemWorkspace::OnScanCompleted(clFileSystemEvent& event)
     }
     clGetManager()->SetStatusMessage(_("File system scan completed"));
 
+    // Bring the find in files index up-to-date with the new list of files
+    UpdateSearchIndex(event.GetPaths(), true);
+
     // Trigger a non full reparse
     Parse(false);
 
@@ -1082,6 +1097,7 @@ void clFileSystemWorkspace::OnFileSystemUpdated(clFileSystemEvent& event)
         for (const wxString& path : paths) {
             m_files.Add(path);
         }
+        UpdateSearchIndex(paths, false);
 
         // Parse the newly added files
         Parse(false);
@@ -1292,3 +1308,105 @@ int clFileSystemWorkspace::GetIndentWidth()
     m_indentWidth = ::GetClangFormatIntProperty(content, "IndentWidth");
     return *m_indentWidth;
 }
+
+void clFileSystemWorkspace::OpenSearchIndex()
+{
+    CloseSearchIndex();
+    if (!clConfig::Get().Read(kConfigFindInFilesUseIndex, false)) {
+        return;
+    }
+
+    // the index is kept next to the workspace symbols database
+    wxFileName fnIndex(GetDir(), "search_index.db");
+    fnIndex.AppendDir(".codelite");
+
+    m_searchIndex.reset(new clTrigramIndex());
+    if (!m_searchIndex->Open(fnIndex)) {
+        m_searchIndex.reset();
+        return;
+    }
+    m_searchIndexThread.reset(new clTrigramIndexThread(m_searchIndex));
+    m_searchIndexThread->Start();
+    SearchThreadST::Get()->SetIndex(m_searchIndex);
+}
+
+void clFileSystemWorkspace::CloseSearchIndex()
+{
+    m_searchIndexWatcher.Clear();
+    if (!m_searchIndex) {
+        return;
+    }
+
+    SearchThreadST::Get()->SetIndex(nullptr);
+    // stops any update that is still running in the background, so the thread exits quickly
+    m_searchIndex->Close();
+    // joins the thread
+    m_searchIndexThread.reset();
+    m_searchIndex.reset();
+}
+
+void clFileSystemWorkspace::EnableSearchIndex(bool enable)
+{
+    if (clConfig::Get().Read(kConfigFindInFilesUseIndex, false) == enable) {
+        return;
+    }
+
+    clConfig::Get().Write(kConfigFindInFilesUseIndex, enable);
+    if (!IsOpen()) {
+        return;
+    }
+
+    if (!enable) {
+        CloseSearchIndex();
+        return;
+    }
+
+    OpenSearchIndex();
+    wxArrayString files;
+    files.reserve(GetFiles().size());
+    for (const wxFileName& file : GetFiles()) {
+        files.Add(file.GetFullPath());
+    }
+    UpdateSearchIndex(files, true);
+}
+
+void clFileSystemWorkspace::UpdateSearchIndex(const wxArrayString& files, bool sync)
+{
+    if (!m_searchIndex || files.empty()) {
+        return;
+    }
+
+    // keep the index up-to-date with files modified outside of CodeLite
+    if (sync) {
+        // `files` is the complete list of files
+        m_searchIndexWatcher.Clear();
+    }
+    m_searchIndexWatcher.Stop();
+    for (const wxString& file : files) {
+        m_searchIndexWatcher.AddFile(file);
+    }
+    m_searchIndexWatcher.Start();
+
+    m_searchIndexThread->Add(sync ? clTrigramIndexThread::kSync : clTrigramIndexThread::kUpdate, files);
+}
+
+void clFileSystemWorkspace::OnSearchIndexFileModified(clFileSystemEvent& event)
+{
+    event.Skip();
+    if (!m_searchIndex) {
+        return;
+    }
+
+    // the watcher reports all the files that were modified together
+    m_searchIndexThread->Add(clTrigramIndexThread::kUpdate, event.GetPaths());
+}
+
+void clFileSystemWorkspace::OnSearchIndexFileDeleted(clFileSystemEvent& event)
+{
+    event.Skip();
+    if (!m_searchIndex) {
+        return;
+    }
+
+    m_searchIndexThread->Add(clTrigramIndexThread::kDelete, event.GetPaths());
+}
@@ -7,13 +7,17 @@
 #include "clDebuggerTerminal.h"
 #include "clFileCache.hpp"
 #include "clFileSystemEvent.h"
+#include "clFileSystemWatcher.h"
 #include "clFileSystemWorkspaceConfig.hpp"
 #include "clShellHelper.hpp"
+#include "clTrigramIndex.hpp"
+#include "clTrigramIndexThread.hpp"
 #include "clWorkspaceManager.h"
 #include "cl_command_event.h"
 #include "codelite_exports.h"
 #include "compiler.h"
 
+#include <memory>
 #include <optional>
 #include <unordered_map>
 #include <vector>
@@ -39,6 +43,10 @@ class WXDLLIMPEXP_SDK clFileSystemWorkspace : public LocalWorkspaceCommon
     clBacktickCache::ptr_t m_backtickCache;
     clShellHelper m_shell_helper;
     std::optional<int> m_indentWidth{ std::nullopt };
+    clTrigramIndex::ptr_t m_searchIndex;
+    /// updates m_searchIndex, one request at a time
+    std::unique_ptr<clTrigramIndexThread> m_searchIndexThread;
+    clFileSystemWatcher m_searchIndexWatcher;
 
 protected:
     void CacheFiles(bool force = false);
@@ -76,6 +84,8 @@ protected:
     void OnSourceControlPulled(clSourceControlEvent& event);
     void OnDebug(clDebugEvent& event);
     void OnFileSystemUpdated(clFileSystemEvent& event);
+    void OnSearchIndexFileModified(clFileSystemEvent& event);
+    void OnSearchIndexFileDeleted(clFileSystemEvent& event);
     void OnReloadWorkspace(clCommandEvent& event);
 
 protected:
@@ -86,6 +96,9 @@ protected:
     void DoCreate(const wxString& name, const wxString& path, bool loadIfExists);
     void RestoreSession();
     void DoBuild(const wxString& target);
+    void OpenSearchIndex();
+    void CloseSearchIndex();
+    void UpdateSearchIndex(const wxArrayString& files, bool sync);
     clFileSystemWorkspaceConfig::Ptr_t GetConfig() const;
 
 public:
@@ -168,6 +181,12 @@ public:
      */
     bool IsOpen() const { return m_isLoaded; }
 
+    /**
+     * @brief enable or disable the find in files index (a global setting). An open workspace starts or stops using
+     * it immediately
+     */
+    void EnableSearchIndex(bool enable);
+
     const std::vector<wxFileName>& GetFiles() const { return m_files.GetFiles(); }
 
     wxString GetName() const override { return m_filename.GetName(); }
@@ -1,6 +1,5 @@
 #include "GotoAnythingDlg.h"
 
-#include "clAnagram.h"
 #include "codelite_events.h"
 #include "event_notifier.h"
 #include "file_logger.h"
@@ -13,6 +12,12 @@ GotoAnythingDlg::GotoAnythingDlg(wxWindow* parent, const std::vector<clGotoEntry
     : GotoAnythingBaseDlg(parent)
     , m_allEntries(entries)
 {
+    std::vector<wxString> descriptions;
+    descriptions.reserve(m_allEntries.size());
+    for (const clGotoEntry& entry : m_allEntries) {
+        descriptions.push_back(entry.GetDesc());
+    }
+    m_index.Build(descriptions);
     DoPopulate(m_allEntries);
 
     ::clSetDialogBestSizeAndPosition(this);
@@ -102,16 +107,12 @@ void GotoAnythingDlg::ApplyFilter()
         DoPopulate(m_allEntries);
     } else {
 
-        // Filter the list
-        clAnagram anagram(filter);
+        // Filter the list, the best matches first
         std::vector<clGotoEntry> matchedEntries;
         std::vector<int> matchedEntriesIndex;
-        for (size_t i = 0; i < m_allEntries.size(); ++i) {
-            const clGotoEntry& entry = m_allEntries[i];
-            if (anagram.MatchesInOrder(entry.GetDesc())) {
-                matchedEntries.push_back(entry);
-                matchedEntriesIndex.push_back(i);
-            }
+        for (const auto& match : m_index.Search(filter)) {
+            matchedEntries.push_back(m_allEntries[match.index]);
+            matchedEntriesIndex.push_back(match.index);
         }
 
         // And populate the list
@@ -3,6 +3,7 @@
 
 #include "GotoAnythingBaseUI.h"
 #include "bitmap_loader.h"
+#include "clFuzzyIndex.hpp"
 #include "clGotoAnythingManager.h"
 #include "clThemedListCtrl.h"
 #include "codelite_exports.h"
@@ -12,6 +13,7 @@
 class WXDLLIMPEXP_SDK GotoAnythingDlg : public GotoAnythingBaseDlg
 {
     const std::vector<clGotoEntry>& m_allEntries;
+    clFuzzyIndex m_index{ eFuzzyIndexMode::kInOrder };
     wxString m_currentFilter;
     clThemedListCtrl::BitmapVec_t m_bitmaps;
 
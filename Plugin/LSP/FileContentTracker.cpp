@@ -6,8 +6,42 @@
 namespace
 {
 const wxString EMPTY_STRING;
+
+// when the modifications log grows beyond these limits, a full sync is cheaper
+constexpr size_t MAX_CHANGES = 1000;
+constexpr size_t MAX_CHANGES_TEXT_SIZE = 1024 * 1024;
+
+/// the length of `text` in UTF-16 code units, the LSP default position encoding
+int utf16_length(const wxString& text)
+{
+    if(sizeof(wxChar) == 2) {
+        // wxString is UTF-16 already
+        return text.length();
+    }
+
+    int length = 0;
+    for(wxChar ch : text) {
+        length += ((wxUint32)ch > 0xFFFF) ? 2 : 1;
+    }
+    return length;
 }
 
+LSP::Position to_lsp_position(const FileContentTracker::IText& text, int pos)
+{
+    int line = text.LineFromPosition(pos);
+    return LSP::Position{ line, utf16_length(text.GetTextRange(text.PositionFromLine(line), pos)) };
+}
+
+LSP::TextDocumentContentChangeEvent make_change(const LSP::Position& start, const LSP::Position& end,
+                                                const wxString& text)
+{
+    LSP::TextDocumentContentChangeEvent change;
+    change.SetRange(LSP::Range{ start, end });
+    change.SetText(text);
+    return change;
+}
+} // namespace
+
 bool FileContentTracker::exists(const wxString& filepath)
 {
     FileState* dummy = nullptr;
@@ -79,6 +113,43 @@ std::vector<LSP::TextDocumentContentChangeEvent> FileContentTracker::changes_fro
     return result;
 }
 
+LSP::TextDocumentContentChangeEvent FileContentTracker::insert_change(const IText& text, int pos, int length)
+{
+    // the range is in the document before the insertion: its text before `pos` is the same, and the text that was at
+    // `pos` now follows the inserted text
+    wxString inserted = text.GetTextRange(pos, pos + length);
+    if(pos == 0 || text.GetCharAt(pos - 1) != '\r') {
+        LSP::Position start_pos = to_lsp_position(text, pos);
+        return make_change(start_pos, start_pos, inserted);
+    }
+
+    // `pos` follows a CR, so it starts a line unless it was between the CR and the LF of a line end. A position can't
+    // be placed there: the line end is replaced instead
+    LSP::Position line_start{ text.LineFromPosition(pos - 1) + 1, 0 };
+    if(text.GetCharAt(pos + length) == '\n') {
+        return make_change(to_lsp_position(text, pos - 1), line_start, "\r" + inserted + "\n");
+    }
+    return make_change(line_start, line_start, inserted);
+}
+
+LSP::TextDocumentContentChangeEvent FileContentTracker::delete_change(const IText& text, int pos, int length)
+{
+    // a position can't be placed between the CR and the LF of a line end: a line end split by the deletion is
+    // replaced with what is left of it
+    int start = pos;
+    int end = pos + length;
+    wxString replacement;
+    if(start > 0 && text.GetCharAt(start - 1) == '\r' && text.GetCharAt(start) == '\n') {
+        --start;
+        replacement << "\r";
+    }
+    if(end > 0 && text.GetCharAt(end - 1) == '\r' && text.GetCharAt(end) == '\n') {
+        ++end;
+        replacement << "\n";
+    }
+    return make_change(to_lsp_position(text, start), to_lsp_position(text, end), replacement);
+}
+
 bool FileContentTracker::find(const wxString& filepath, FileState** state)
 {
     for(size_t i = 0; i < m_files.size(); ++i) {
@@ -112,3 +183,58 @@ bool FileContentTracker::get_last_content(const wxString& filepath, wxString* co
     }
     return false;
 }
+
+void FileContentTracker::start_tracking_changes(const wxString& filepath)
+{
+    FileState* state = nullptr;
+    if(find(filepath, &state)) {
+        state->changes_tracked = true;
+        reset_changes(filepath);
+    }
+}
+
+bool FileContentTracker::is_tracking_changes(const wxString& filepath)
+{
+    FileState* state = nullptr;
+    return find(filepath, &state) && state->changes_tracked;
+}
+
+void FileContentTracker::add_change(const wxString& filepath, const LSP::TextDocumentContentChangeEvent& change)
+{
+    FileState* state = nullptr;
+    if(!find(filepath, &state) || !state->changes_tracked || state->changes_overflow) {
+        return;
+    }
+
+    state->changes.push_back(change);
+    state->changes_text_size += change.GetText().length();
+    if(state->changes.size() > MAX_CHANGES || state->changes_text_size > MAX_CHANGES_TEXT_SIZE) {
+        LSP_DEBUG() << "Too many changes for file:" << filepath << ". A full sync is required" << endl;
+        state->changes.clear();
+        state->changes_text_size = 0;
+        state->changes_overflow = true;
+    }
+}
+
+bool FileContentTracker::take_changes(const wxString& filepath,
+                                      std::vector<LSP::TextDocumentContentChangeEvent>* changes)
+{
+    FileState* state = nullptr;
+    if(!find(filepath, &state) || !state->changes_tracked || state->changes_overflow) {
+        return false;
+    }
+    changes->swap(state->changes);
+    state->changes.clear();
+    state->changes_text_size = 0;
+    return true;
+}
+
+void FileContentTracker::reset_changes(const wxString& filepath)
+{
+    FileState* state = nullptr;
+    if(find(filepath, &state)) {
+        state->changes.clear();
+        state->changes_text_size = 0;
+        state->changes_overflow = false;
+    }
+}
@@ -17,10 +17,34 @@ struct WXDLLIMPEXP_SDK FileState {
     size_t flags = FILE_STATE_NONE;
     wxString content;
     wxString file_path;
+    // the editor modifications made since the last sync, in order
+    std::vector<LSP::TextDocumentContentChangeEvent> changes;
+    size_t changes_text_size = 0;
+    // true: `changes` holds every modification made since the last sync
+    bool changes_tracked = false;
+    // true: too many modifications were made, a full sync is required
+    bool changes_overflow = false;
 };
 
 class WXDLLIMPEXP_SDK FileContentTracker
 {
+public:
+    /**
+     * @brief the editor text, with the wxStyledTextCtrl positions (UTF-8 bytes) and line semantics (a line ends with
+     * CR, LF or CRLF)
+     */
+    class IText
+    {
+    public:
+        virtual ~IText() = default;
+        virtual int LineFromPosition(int pos) const = 0;
+        virtual int PositionFromLine(int line) const = 0;
+        /// the byte at `pos`, 0 past the end of the text
+        virtual int GetCharAt(int pos) const = 0;
+        virtual wxString GetTextRange(int start, int end) const = 0;
+    };
+
+private:
     std::vector<FileState> m_files;
 
 private:
@@ -45,6 +69,16 @@ public:
      */
     std::vector<LSP::TextDocumentContentChangeEvent> changes_from(const wxString& before, const wxString& after);
 
+    /**
+     * @brief the change for the `length` bytes inserted at `pos`. `text` contains them already
+     */
+    static LSP::TextDocumentContentChangeEvent insert_change(const IText& text, int pos, int length);
+
+    /**
+     * @brief the change for `length` bytes about to be deleted at `pos`. `text` still contains them
+     */
+    static LSP::TextDocumentContentChangeEvent delete_change(const IText& text, int pos, int length);
+
     /**
      * @brief update the content for `filepath`
      */
@@ -54,6 +88,35 @@ public:
      * @brief return the last seen content for filepath
      */
     bool get_last_content(const wxString& filepath, wxString* content);
+
+    /**
+     * @brief start recording the modifications made to `filepath`. From this point on, every modification must be
+     * reported using `add_change()`
+     */
+    void start_tracking_changes(const wxString& filepath);
+
+    /**
+     * @brief are the modifications made to `filepath` recorded?
+     */
+    bool is_tracking_changes(const wxString& filepath);
+
+    /**
+     * @brief record a modification. If the log grows too large, it is discarded and marked as overflowed
+     */
+    void add_change(const wxString& filepath, const LSP::TextDocumentContentChangeEvent& change);
+
+    /**
+     * @brief move the recorded modifications into `changes`
+     * @return false if the file is not tracked or if the log overflowed. In the latter case the caller should send
+     * the full content and call `reset_changes()`
+     */
+    bool take_changes(const wxString& filepath, std::vector<LSP::TextDocumentContentChangeEvent>* changes);
+
+    /**
+     * @brief clear the modifications log of `filepath` (e.g. after the full content was sent)
+     */
+    void reset_changes(const wxString& filepath);
+
     void clear() { m_files.clear(); }
 };
 
@@ -44,6 +44,26 @@
 #include <wx/textdlg.h>
 
 thread_local wxString emptyString;
+
+namespace
+{
+/// the text of an editor, for FileContentTracker
+class EditorText : public FileContentTracker::IText
+{
+    wxStyledTextCtrl* m_ctrl;
+
+public:
+    EditorText(wxStyledTextCtrl* ctrl)
+        : m_ctrl(ctrl)
+    {
+    }
+    int LineFromPosition(int pos) const override { return m_ctrl->LineFromPosition(pos); }
+    int PositionFromLine(int line) const override { return m_ctrl->PositionFromLine(line); }
+    int GetCharAt(int pos) const override { return m_ctrl->GetCharAt(pos); }
+    wxString GetTextRange(int start, int end) const override { return m_ctrl->GetTextRange(start, end); }
+};
+} // namespace
+
 FileExtManager::FileType LanguageServerProtocol::workspace_file_type = FileExtManager::TypeOther;
 
 LanguageServerProtocol::LanguageServerProtocol(const wxString& name, eNetworkType netType, wxEvtHandler* owner)
@@ -236,7 +256,10 @@ bool LanguageServerProtocol::Start()
 void LanguageServerProtocol::DoClear()
 {
     m_filesTracker.clear();
-    m_outputBuffer.clear();
+    m_trackedEditors.clear();
+    m_filesWithPendingChanges.clear();
+    m_incrementalChangeSupported = false;
+    m_framer.Clear();
     m_state = kUnInitialized;
     m_initializeRequestID = wxNOT_FOUND;
     m_Queue.Clear();
@@ -301,6 +324,30 @@ void LanguageServerProtocol::SendOpenOrChangeRequest(IEditor* editor,
     CHECK_PTR_RET(editor);
     wxString filename = GetEditorFilePath(editor);
 
+    if (IsIncrementalChangeSupported() && m_filesTracker.is_tracking_changes(filename)) {
+        // the editor modifications are recorded as they happen, send them
+        m_filesWithPendingChanges.erase(filename);
+        std::vector<LSP::TextDocumentContentChangeEvent> changes;
+        if (!m_filesTracker.take_changes(filename, &changes)) {
+            LSP_DEBUG() << "textDocument/didChange: too many changes, using full change request" << endl;
+            m_filesTracker.reset_changes(filename);
+            LSP::DidChangeTextDocumentRequest::Ptr_t req =
+                LSP::MessageWithParams::MakeRequest(new LSP::DidChangeTextDocumentRequest(filename, fileContent));
+            QueueMessage(req);
+
+        } else if (!changes.empty()) {
+            LSP_DEBUG() << "textDocument/didChange: using incremental changes:" << changes.size() << "changes" << endl;
+            LSP::DidChangeTextDocumentRequest::Ptr_t req =
+                LSP::MessageWithParams::MakeRequest(new LSP::DidChangeTextDocumentRequest(filename, changes));
+            QueueMessage(req);
+
+        } else {
+            LOG_IF_TRACE { LSP_TRACE() << GetLogPrefix() << "No changes detected in file:" << filename << endl; }
+        }
+        return;
+    }
+
+    bool opened = false;
     wxString preContent;
     if (m_filesTracker.exists(filename) && m_filesTracker.get_last_content(filename, &preContent)) {
         // we already did "open" for this, see if there are changes to report back to the language server
@@ -332,6 +379,7 @@ void LanguageServerProtocol::SendOpenOrChangeRequest(IEditor* editor,
         LSP::DidOpenTextDocumentRequest::Ptr_t req =
             LSP::MessageWithParams::MakeRequest(new LSP::DidOpenTextDocumentRequest(filename, fileContent, languageId));
         QueueMessage(req);
+        opened = true;
 
         // send a semantic request
         SendSemanticTokensRequest(editor);
@@ -339,6 +387,82 @@ void LanguageServerProtocol::SendOpenOrChangeRequest(IEditor* editor,
 
     // update the content for the file
     m_filesTracker.update_content(filename, fileContent);
+    if (opened) {
+        TrackEditorChanges(editor);
+    }
+}
+
+void LanguageServerProtocol::TrackEditorChanges(IEditor* editor)
+{
+    wxStyledTextCtrl* ctrl = editor->GetCtrl();
+    if (!IsIncrementalChangeSupported() || !ctrl) {
+        return;
+    }
+
+    // make sure we are bound exactly once
+    ctrl->Unbind(wxEVT_STC_MODIFIED, &LanguageServerProtocol::OnEditorModified, this);
+    ctrl->Bind(wxEVT_STC_MODIFIED, &LanguageServerProtocol::OnEditorModified, this);
+
+    wxString filename = GetEditorFilePath(editor);
+    m_trackedEditors.erase(ctrl);
+    m_trackedEditors.insert({ ctrl, filename });
+    m_filesTracker.start_tracking_changes(filename);
+}
+
+void LanguageServerProtocol::OnEditorModified(wxStyledTextEvent& event)
+{
+    event.Skip();
+    int type = event.GetModificationType();
+    bool inserted = (type & wxSTC_MOD_INSERTTEXT);
+    bool deleted = (type & wxSTC_MOD_BEFOREDELETE);
+    if (!inserted && !deleted) {
+        return;
+    }
+
+    wxStyledTextCtrl* ctrl = dynamic_cast<wxStyledTextCtrl*>(event.GetEventObject());
+    CHECK_PTR_RET(ctrl);
+    auto iter = m_trackedEditors.find(ctrl);
+    if (iter == m_trackedEditors.end()) {
+        return;
+    }
+
+    // an insertion is reported after the text was added and a deletion before the text is removed, so in both cases
+    // the positions are valid for the document as the server knows it
+    EditorText text(ctrl);
+    if (inserted) {
+        m_filesTracker.add_change(iter->second,
+                                  FileContentTracker::insert_change(text, event.GetPosition(), event.GetLength()));
+    } else {
+        m_filesTracker.add_change(iter->second,
+                                  FileContentTracker::delete_change(text, event.GetPosition(), event.GetLength()));
+    }
+    m_filesWithPendingChanges.insert(iter->second);
+
+    // batch the modifications, they are sent once the event loop is idle
+    if (!m_flushChangesScheduled) {
+        m_flushChangesScheduled = true;
+        CallAfter(&LanguageServerProtocol::FlushPendingChanges);
+    }
+}
+
+void LanguageServerProtocol::FlushPendingChanges()
+{
+    m_flushChangesScheduled = false;
+
+    wxStringSet_t files;
+    files.swap(m_filesWithPendingChanges);
+    for (const wxString& filename : files) {
+        std::vector<LSP::TextDocumentContentChangeEvent> changes;
+        if (!m_filesTracker.take_changes(filename, &changes) || changes.empty()) {
+            // the log overflowed: the next request for this file will send its full content
+            continue;
+        }
+
+        LSP_DEBUG() << "textDocument/didChange: sending" << changes.size() << "changes for file:" << filename << endl;
+        LSP::DidChangeTextDocumentRequest::Ptr_t req =
+            LSP::MessageWithParams::MakeRequest(new LSP::DidChangeTextDocumentRequest(filename, changes));
+        QueueMessage(req);
+    }
 }
 
 void LanguageServerProtocol::SendCloseRequest(const wxString& filename)
@@ -351,6 +475,14 @@ void LanguageServerProtocol::SendCloseRequest(const wxString& filename)
         LSP::MessageWithParams::MakeRequest(new LSP::DidCloseTextDocumentRequest(filename));
     QueueMessage(req);
     m_filesTracker.erase(filename);
+    m_filesWithPendingChanges.erase(filename);
+    for (auto iter = m_trackedEditors.begin(); iter != m_trackedEditors.end();) {
+        if (iter->second == filename) {
+            iter = m_trackedEditors.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
 }
 
 void LanguageServerProtocol::SendSaveRequest(IEditor* editor, const wxString& fileContent)
@@ -611,14 +743,14 @@ void LanguageServerProtocol::OnNetError(clCommandEvent& event)
 
 void LanguageServerProtocol::EventMainLoop(clCommandEvent& event)
 {
-    m_outputBuffer.append(event.GetStringRaw());
-    LSP_DEBUG() << "Received data from LSP server of size:" << m_outputBuffer.size() << "bytes" << endl;
+    m_framer.Append(event.GetStringRaw());
+    LSP_DEBUG() << "Received data from LSP server of size:" << m_framer.GetPendingData().size() << "bytes" << endl;
 
     m_Queue.SetWaitingReponse(false);
-    while (!m_outputBuffer.empty()) {
+    while (!m_framer.IsEmpty()) {
         // attempt to consume a complete JSON payload from the aggregated network buffer
-        auto json = LSP::Message::GetJSONPayload(m_outputBuffer);
-        if (!json) {
+        std::string_view payload;
+        if (!m_framer.Next(&payload)) {
             LOG_IF_TRACE { LSP_TRACE() << "Unable to read JSON payload" << endl; }
             LOG_IF_DEBUG
             {
@@ -627,19 +759,27 @@ void LanguageServerProtocol::EventMainLoop(clCommandEvent& event)
                 // dump the output buffer into a file and continue
                 // we only dump 3 files per CodeLite session
                 static size_t dumps_count = 0;
-                if (dumps_count < 3 && (m_outputBuffer.size() > (1024 * 1024 * 1024))) {
+                auto pending_data = m_framer.GetPendingData();
+                if (dumps_count < 3 && (pending_data.size() > (1024 * 1024 * 1024))) {
                     dumps_count++;
                     auto tmp_filename =
                         FileUtils::CreateTempFileName(clStandardPaths::Get().GetTempDir(), "cl_lsp", "txt");
-                    FileUtils::WriteFileContent(tmp_filename, m_outputBuffer);
-                    LSP_SYSTEM() << "Output buffer exceeds 1MB (" << m_outputBuffer.size() << "Bytes)" << endl;
-                    LSP_SYSTEM() << "Dumped m_outputBuffer into:" << tmp_filename.GetFullPath() << endl;
+                    FileUtils::WriteFileContentRaw(tmp_filename, std::string{ pending_data });
+                    LSP_SYSTEM() << "Output buffer exceeds 1MB (" << pending_data.size() << "Bytes)" << endl;
+                    LSP_SYSTEM() << "Dumped the output buffer into:" << tmp_filename.GetFullPath() << endl;
                 }
             }
             break;
         }
 
-        auto json_item = json->toElement();
+        std::unique_ptr<JSONReader> reader(new JSONReader(payload));
+        if (!reader->isOk()) {
+            LSP_ERROR() << "Unable to parse JSON object from response!" << endl;
+            LOG_IF_TRACE { LSP_TRACE() << "Payload:" << wxString::FromUTF8(payload.data(), payload.length()) << endl; }
+            continue;
+        }
+
+        auto json_item = reader->toElement();
         // check the message type
         wxString message_method = json_item["method"].toString();
         // LSP_TRACE() << "-- LSP:" << json_item.format(false) << endl;
@@ -663,11 +803,12 @@ void LanguageServerProtocol::EventMainLoop(clCommandEvent& event)
         } else if (message_method == "workspace/applyEdit") {
 
             // the server is requesting us to apply an edit
-            HandleWorkspaceEdit(json_item["params"]["edit"]);
+            LSP::ResponseMessage res(std::move(reader));
+            HandleWorkspaceEdit(res["params"]["edit"]);
 
         } else {
             // other response
-            LSP::ResponseMessage res(std::move(json));
+            LSP::ResponseMessage res(std::move(reader));
             if (IsInitialized()) {
                 LSP::MessageWithParams::Ptr_t msg_ptr = m_Queue.TakePendingReplyMessage(res.GetId());
                 // Is this an error message?
@@ -864,7 +1005,7 @@ void LanguageServerProtocol::HandleResponse(LSP::ResponseMessage& response, LSP:
         }
         preq->SetServerName(GetName());
         LSP_DEBUG() << "Processing response for request:" << preq->GetMethod() << endl;
-        LSP_TRACE() << response.ToString() << endl;
+        LOG_IF_TRACE { LSP_TRACE() << response.ToString() << endl; }
         preq->OnResponse(response, m_cluster);
 
     } else if (response.IsPushDiagnostics()) {
@@ -7,6 +7,7 @@
 #include "LSP/IPathConverter.hpp"
 #include "LSP/LSPEvent.h"
 #include "LSP/LSPNetwork.h"
+#include "LSP/MessageFramer.hpp"
 #include "LSP/MessageWithParams.h"
 #include "SocketAPI/clSocketClientAsync.h"
 #include "cl_command_event.h"
@@ -28,6 +29,8 @@
 typedef std::function<void()> LSPOnConnectedCallback_t;
 
 class IEditor;
+class wxStyledTextCtrl;
+class wxStyledTextEvent;
 class WXDLLIMPEXP_SDK LSPRequestMessageQueue
 {
     std::queue<LSP::MessageWithParams::Ptr_t> m_Queue;
@@ -64,7 +67,7 @@ class WXDLLIMPEXP_SDK LanguageServerProtocol : public wxEvtHandler
     wxString m_initOptions;
     FileContentTracker m_filesTracker;
     wxStringSet_t m_languages;
-    std::string m_outputBuffer;
+    LSP::MessageFramer m_framer;
     wxString m_rootFolder;
     clEnvList_t m_env;
     LSPStartupInfo m_startupInfo;
@@ -85,6 +88,11 @@ class WXDLLIMPEXP_SDK LanguageServerProtocol : public wxEvtHandler
     wxArrayString m_semanticTokensTypes;
     LSPOnConnectedCallback_t m_onServerStartedCallback = nullptr;
     bool m_incrementalChangeSupported = false;
+    // editors whose modifications are recorded (incremental sync) and their file path
+    std::unordered_map<wxStyledTextCtrl*, wxString> m_trackedEditors;
+    // files with recorded modifications that were not sent yet
+    wxStringSet_t m_filesWithPendingChanges;
+    bool m_flushChangesScheduled = false;
 
 public:
     using Ptr_t = std::shared_ptr<LanguageServerProtocol>;
@@ -102,6 +110,17 @@ protected:
     void OnWorkspaceLoaded(clWorkspaceEvent& e);
     void OnWorkspaceClosed(clWorkspaceEvent& e);
     void OnEditorChanged(wxCommandEvent& event);
+    void OnEditorModified(wxStyledTextEvent& event);
+
+    /**
+     * @brief send the modifications recorded since the last sync as incremental textDocument/didChange
+     * notifications. Called once per batch of editor modifications, when the event loop is idle
+     */
+    void FlushPendingChanges();
+    /**
+     * @brief start recording the modifications made to the editor, so they can be sent as ranges
+     */
+    void TrackEditorChanges(IEditor* editor);
 
     wxString GetEditorFilePath(IEditor* editor) const;
     bool
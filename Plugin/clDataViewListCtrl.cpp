@@ -484,6 +484,7 @@ void clDataViewListCtrl::SetSortFunction(const clSortFunc_t& CompareFunc)
 
     // Step 3: sort the children
     std::sort(children.begin(), children.end(), CompareFunc);
+    root->ChildrenReordered();
 
     // Now, reconnect the children, starting with the root
     clRowEntry* prev = root;
@@ -512,13 +513,10 @@ int clDataViewListCtrl::ItemToRow(const wxDataViewItem& item) const
         return wxNOT_FOUND;
     }
 
-    const clRowEntry::Vec_t& children = root->GetChildren();
-    for(size_t i = 0; i < children.size(); ++i) {
-        if(children[i] == pItem) {
-            return i;
-        }
+    if(pItem->GetParent() != root) {
+        return wxNOT_FOUND;
     }
-    return wxNOT_FOUND;
+    return pItem->GetIndexInParent();
 }
 
 void clDataViewListCtrl::Select(const wxDataViewItem& item)
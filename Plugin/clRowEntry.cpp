@@ -276,6 +276,15 @@ void clRowEntry::InsertChild(clRowEntry* child, clRowEntry* prev)
         nodeBefore = prevSibling;
     }
     child->ConnectNodes(nodeBefore, nodeBefore->m_next);
+
+    // Update the rows count. Appending is the common case, it does not change the offsets of the other children
+    if (m_childrenOffsetsValid && child == m_children.back()) {
+        child->m_indexInParent = m_childrenOffsets.size();
+        m_childrenOffsets.push_back(m_childrenRows);
+    } else {
+        m_childrenOffsetsValid = false;
+    }
+    ChildRowsChanged(child, child->m_subtreeRows);
 }
 
 void clRowEntry::AddChild(clRowEntry* child) { InsertChild(child, m_children.empty() ? nullptr : m_children.back()); }
@@ -305,10 +314,17 @@ void clRowEntry::DeleteChild(clRowEntry* child)
     if (next) {
         next->m_prev = prev;
     }
+
+    ChildRowsChanged(child, -child->m_subtreeRows);
+
     // Now disconnect this child from this node
     if (child == m_children.back()) { // Fast track for DeleteAllChildren().
         m_children.pop_back();
+        if (m_childrenOffsetsValid) {
+            m_childrenOffsets.pop_back();
+        }
     } else {
+        m_childrenOffsetsValid = false;
         clRowEntry::Vec_t::iterator iter =
             std::find_if(m_children.begin(), m_children.end(), [&](clRowEntry* c) { return c == child; });
         if (iter != m_children.end()) {
@@ -394,17 +410,15 @@ void clRowEntry::UnselectAll()
 
 bool clRowEntry::SetExpanded(bool b)
 {
-    if (!m_model) {
-        return false;
-    }
     if (IsHidden() && !b) {
         // Hidden root can not be hidden
         return false;
     }
 
-    if (IsHidden()) {
-        // Hidden node do not fire events
+    if (IsHidden() || !m_model) {
+        // Hidden node (or a node that is not attached to a tree) do not fire events
         SetFlag(kNF_Expanded, b);
+        UpdateSubtreeRows();
         return true;
     }
 
@@ -422,10 +436,119 @@ bool clRowEntry::SetExpanded(bool b)
     }
 
     SetFlag(kNF_Expanded, b);
+    UpdateSubtreeRows();
     m_model->NodeExpanded(this, b);
     return true;
 }
 
+void clRowEntry::UpdateSubtreeRows()
+{
+    int rows = (IsHidden() ? 0 : 1) + (IsExpanded() ? m_childrenRows : 0);
+    int delta = rows - m_subtreeRows;
+    if (delta == 0) {
+        return;
+    }
+    m_subtreeRows = rows;
+    if (m_parent) {
+        m_parent->ChildRowsChanged(this, delta);
+    }
+}
+
+void clRowEntry::ChildRowsChanged(clRowEntry* child, int delta)
+{
+    // propagate the change up to the first collapsed node. A change in the last child does not affect the offsets
+    // of its siblings
+    clRowEntry* node = this;
+    while (node) {
+        node->m_childrenRows += delta;
+        if (node->m_children.empty() || node->m_children.back() != child) {
+            node->m_childrenOffsetsValid = false;
+        }
+        if (!node->IsExpanded()) {
+            break;
+        }
+        node->m_subtreeRows += delta;
+        child = node;
+        node = node->m_parent;
+    }
+}
+
+void clRowEntry::BuildChildrenOffsets() const
+{
+    if (m_childrenOffsetsValid) {
+        return;
+    }
+    m_childrenOffsets.resize(m_children.size());
+    int offset = 0;
+    for (size_t i = 0; i < m_children.size(); ++i) {
+        m_childrenOffsets[i] = offset;
+        m_children[i]->m_indexInParent = i;
+        offset += m_children[i]->m_subtreeRows;
+    }
+    m_childrenOffsetsValid = true;
+}
+
+int clRowEntry::GetIndexInParent() const
+{
+    if (!m_parent) {
+        return wxNOT_FOUND;
+    }
+    m_parent->BuildChildrenOffsets();
+    return m_indexInParent;
+}
+
+int clRowEntry::GetRowIndex() const
+{
+    // collect the path from the top-most parent to this item
+    std::vector<const clRowEntry*> path;
+    for (const clRowEntry* node = this; node; node = node->m_parent) {
+        path.push_back(node);
+    }
+
+    int index = 0;
+    for (size_t i = path.size() - 1; i > 0; --i) {
+        const clRowEntry* parent = path[i];
+        if (!parent->IsHidden()) {
+            ++index;
+        }
+        if (!parent->IsExpanded()) {
+            // the rest of the path is not visible
+            break;
+        }
+        parent->BuildChildrenOffsets();
+        index += parent->m_childrenOffsets[path[i - 1]->m_indexInParent];
+    }
+    return index;
+}
+
+clRowEntry* clRowEntry::GetRowAt(int row) const
+{
+    if (row < 0 || row >= m_subtreeRows) {
+        return nullptr;
+    }
+
+    const clRowEntry* node = this;
+    while (node) {
+        if (!node->IsHidden()) {
+            if (row == 0) {
+                return const_cast<clRowEntry*>(node);
+            }
+            --row;
+        }
+        if (!node->IsExpanded() || row >= node->m_childrenRows) {
+            return nullptr;
+        }
+
+        // find the child whose subtree contains `row`
+        node->BuildChildrenOffsets();
+        auto iter = std::upper_bound(node->m_childrenOffsets.begin(), node->m_childrenOffsets.end(), row);
+        --iter;
+        row -= *iter;
+        node = node->m_children[iter - node->m_childrenOffsets.begin()];
+    }
+    return nullptr;
+}
+
 void clRowEntry::ClearRects()
 {
     m_buttonRect = wxRect();
@@ -879,6 +1002,7 @@ void clRowEntry::SetHidden(bool b)
     } else {
         m_indentsCount = 0;
     }
+    UpdateSubtreeRows();
 }
 
 int clRowEntry::CalcItemWidth(wxDC& dc, int rowHeight, size_t col)
@@ -73,6 +73,15 @@ protected:
     wxRect m_rowRect;
     wxRect m_buttonRect;
     clMatchResult m_higlightInfo;
+    // the number of visible rows in this subtree (this row included), assuming that this row is visible
+    int m_subtreeRows = 1;
+    // the sum of the children `m_subtreeRows`, whether this node is expanded or not
+    int m_childrenRows = 0;
+    // built on demand: the number of rows in this subtree that are placed before the nth child
+    mutable std::vector<int> m_childrenOffsets;
+    mutable bool m_childrenOffsetsValid = true;
+    // this node's index in its parent's children list, valid when the parent `m_childrenOffsetsValid` is true
+    mutable size_t m_indexInParent = 0;
 
 protected:
     void SetFlag(clTreeCtrlNodeFlags flag, bool b)
@@ -86,6 +95,10 @@ protected:
 
     bool HasFlag(clTreeCtrlNodeFlags flag) const { return m_flags & flag; }
 
+    void UpdateSubtreeRows();
+    void ChildRowsChanged(clRowEntry* child, int delta);
+    void BuildChildrenOffsets() const;
+
     /**
      * @brief return the nth visible item
      */
@@ -239,6 +252,34 @@ public:
     }
     size_t GetChildrenCount(bool recurse) const;
     int GetExpandedLines() const;
+
+    /**
+     * @brief return the number of visible rows in this subtree, this row included (unless it is hidden)
+     * NOTE: this assumes that this row itself is visible (i.e. all of its parents are expanded)
+     */
+    int GetSubtreeRows() const { return m_subtreeRows; }
+
+    /**
+     * @brief return the row index of this item, counting the visible rows from the top-most parent. If this item is
+     * not visible, return the index of the row that would follow it. This is O(depth * log(siblings))
+     */
+    int GetRowIndex() const;
+
+    /**
+     * @brief return the item at a given row index, counting the visible rows from this item
+     * @return nullptr if `row` is out of range
+     */
+    clRowEntry* GetRowAt(int row) const;
+
+    /**
+     * @brief return the index of this item in its parent children list
+     */
+    int GetIndexInParent() const;
+
+    /**
+     * @brief must be called after re-ordering the children list directly (via `GetChildren()`)
+     */
+    void ChildrenReordered() { m_childrenOffsetsValid = false; }
     void GetNextItems(int count, clRowEntry::Vec_t& items, bool selfIncluded = true);
     void GetPrevItems(int count, clRowEntry::Vec_t& items, bool selfIncluded = true);
     void SetIndentsCount(int count) { this->m_indentsCount = count; }
@@ -24,6 +24,7 @@
 //////////////////////////////////////////////////////////////////////////////
 #include "compiler.h"
 
+#include "CompilerOutputMatcher.hpp"
 #include "GCCMetadata.hpp"
 #include "ICompilerLocator.h"
 #include "StringUtils.h"
@@ -544,6 +545,7 @@ void Compiler::AddPattern(int type, const wxString& pattern, int fileNameIndex,
     } else {
         m_warningPatterns.push_back(pt);
     }
+    m_outputMatcher.reset();
 }
 
 void Compiler::SetTool(const wxString& toolname, const wxString& cmd)
@@ -730,91 +732,19 @@ GCCMetadata Compiler::GetMetadata() const
 
 bool Compiler::HasMetadata() const { return IsGnuCompatibleCompiler(); }
 
-bool Compiler::IsMatchesPattern(CmpInfoPattern& pattern,
-                                eSeverity severity,
-                                const wxString& line,
-                                PatternMatch* match_result) const
+bool Compiler::Matches(const wxString& line, PatternMatch* match_result)
 {
     if (!match_result) {
         return false;
     }
 
-    if (!pattern.re) {
-        // compile the regex
-        pattern.re.reset(new wxRegEx);
-        pattern.re->Compile(pattern.pattern, wxRE_ADVANCED | wxRE_ICASE);
-    }
-
-    if (!pattern.re->IsValid()) {
-        clWARNING() << "Regex pattern:" << pattern.pattern << "is not valid!" << endl;
-        return false;
-    }
-
-    // convert the strings holding the index of the various part of the matches
-    // into numbers
-    long colIndex = wxNOT_FOUND;
-    long lineIndex = wxNOT_FOUND;
-    long fileIndex = wxNOT_FOUND;
-
-    // if any of the below conversion fails, we got a problem with this pattern
-    if (!pattern.columnIndex.ToCLong(&colIndex))
-        return false;
-
-    if (!pattern.lineNumberIndex.ToCLong(&lineIndex))
-        return false;
-
-    if (!pattern.fileNameIndex.ToCLong(&fileIndex))
-        return false;
-
-    if (!pattern.re->Matches(line)) {
-        return false;
-    }
-
-    match_result->sev = severity;
-    // extract the file name
-    if (pattern.re->GetMatchCount() > (size_t)fileIndex) {
-        match_result->file_path = pattern.re->GetMatch(line, fileIndex);
-    }
-
-    // extract the line number
-    if (pattern.re->GetMatchCount() > (size_t)lineIndex) {
-        long lineNumber;
-        wxString strLine = pattern.re->GetMatch(line, lineIndex);
-        strLine.ToCLong(&lineNumber);
-        match_result->line_number = lineNumber;
+    if (!m_outputMatcher) {
+        m_outputMatcher = CreateOutputMatcher();
     }
-
-    if (pattern.re->GetMatchCount() > (size_t)colIndex) {
-        long column;
-        wxString strCol = pattern.re->GetMatch(line, colIndex);
-        if (strCol.StartsWith(":")) {
-            strCol.Remove(0, 1);
-        }
-
-        if (!strCol.IsEmpty() && strCol.ToLong(&column)) {
-            match_result->column = column;
-        }
-    }
-    return true;
+    return m_outputMatcher->Matches(line, match_result);
 }
 
-bool Compiler::Matches(const wxString& line, PatternMatch* match_result)
+std::shared_ptr<CompilerOutputMatcher> Compiler::CreateOutputMatcher() const
 {
-    if (!match_result) {
-        return false;
-    }
-
-    // warnings must be first!
-    for (auto& warn_pattern : m_warningPatterns) {
-        if (IsMatchesPattern(warn_pattern, kSevWarning, line, match_result)) {
-            return true;
-        }
-    }
-
-    for (auto& err_pattern : m_errorPatterns) {
-        if (IsMatchesPattern(err_pattern, kSevError, line, match_result)) {
-            return true;
-        }
-    }
-    return false;
+    return std::make_shared<CompilerOutputMatcher>(m_warningPatterns, m_errorPatterns);
 }
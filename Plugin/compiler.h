@@ -39,6 +39,8 @@
 #include <wx/regex.h>
 #include <wx/string.h>
 
+class CompilerOutputMatcher;
+
 /**
  * \ingroup LiteEditor
  * This class represents a compiler entry in the configuration file
@@ -74,7 +76,6 @@ public:
         wxString lineNumberIndex;
         wxString fileNameIndex;
         wxString columnIndex;
-        std::shared_ptr<wxRegEx> re;
     };
 
     /// If a file matches a regular expression, this structure
@@ -123,10 +124,7 @@ protected:
     bool m_isDefault;
     wxString m_installationPath;
     std::map<wxString, LinkLine> m_linkerLines;
-
-private:
-    bool IsMatchesPattern(CmpInfoPattern& pattern, eSeverity severity, const wxString& line,
-                          PatternMatch* match_result) const;
+    std::shared_ptr<CompilerOutputMatcher> m_outputMatcher;
 
 public:
     typedef std::map<wxString, wxString>::const_iterator ConstIterator;
@@ -139,6 +137,12 @@ public:
      */
     bool Matches(const wxString& line, PatternMatch* match_result);
 
+    /**
+     * @brief create a matcher for the error and warning patterns of this compiler. Use it for matching many lines, or
+     * for matching lines from a worker thread
+     */
+    std::shared_ptr<CompilerOutputMatcher> CreateOutputMatcher() const;
+
     /**
      * @brief return { "PATH", "/compiler/bin:$PATH"} pair
      */
@@ -193,8 +197,16 @@ public:
     const CmpListInfoPattern& GetErrPatterns() const { return m_errorPatterns; }
     const CmpListInfoPattern& GetWarnPatterns() const { return m_warningPatterns; }
 
-    void SetErrPatterns(const CmpListInfoPattern& p) { m_errorPatterns = p; }
-    void SetWarnPatterns(const CmpListInfoPattern& p) { m_warningPatterns = p; }
+    void SetErrPatterns(const CmpListInfoPattern& p)
+    {
+        m_errorPatterns = p;
+        m_outputMatcher.reset();
+    }
+    void SetWarnPatterns(const CmpListInfoPattern& p)
+    {
+        m_warningPatterns = p;
+        m_outputMatcher.reset();
+    }
 
     void SetGlobalIncludePath(const wxString& globalIncludePath) { this->m_globalIncludePath = globalIncludePath; }
     void SetGlobalLibPath(const wxString& globalLibPath) { this->m_globalLibPath = globalLibPath; }
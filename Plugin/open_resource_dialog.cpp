@@ -28,6 +28,7 @@
 #include "FileSystemWorkspace/clFileSystemWorkspace.hpp"
 #include "LSP/LSPManager.hpp"
 #include "bitmap_loader.h"
+#include "clFuzzyIndex.hpp"
 #include "clWorkspaceManager.h"
 #include "codelite_events.h"
 #include "ctags_manager.h"
@@ -58,6 +59,33 @@ END_EVENT_TABLE()
 
 wxDEFINE_EVENT(wxEVT_OPEN_RESOURCE_FILE_SELECTED, clCommandEvent);
 
+namespace
+{
+/// The workspace files and their fuzzy index. The index is kept between the dialog instances and it is only rebuilt
+/// when the workspace files change
+struct WorkspaceFiles {
+    std::vector<wxString> files;
+    clFuzzyIndex index;
+};
+
+WorkspaceFiles& GetWorkspaceFiles()
+{
+    static WorkspaceFiles workspace_files;
+    return workspace_files;
+}
+
+void UpdateWorkspaceFiles(std::vector<wxString>& files)
+{
+    auto& workspace_files = GetWorkspaceFiles();
+    if (workspace_files.files == files) {
+        return;
+    }
+    workspace_files.files.swap(files);
+    workspace_files.index.Build(workspace_files.files);
+    clDEBUG() << "Open resource: indexed" << workspace_files.files.size() << "files" << endl;
+}
+} // namespace
+
 OpenResourceDialog::OpenResourceDialog(wxWindow* parent, IManager* manager, const wxString& initialSelection)
     : OpenResourceDialogBase(parent)
     , m_manager(manager)
@@ -93,6 +121,7 @@ OpenResourceDialog::OpenResourceDialog(wxWindow* parent, IManager* manager, cons
     SetName("OpenResourceDialog");
 
     // load all files from the workspace
+    std::vector<wxString> workspace_files;
     if (::clIsCxxWorkspaceOpened()) {
         if (m_manager->IsWorkspaceOpen()) {
             wxArrayString projects;
@@ -104,15 +133,15 @@ OpenResourceDialog::OpenResourceDialog(wxWindow* parent, IManager* manager, cons
                     const Project::FilesMap_t& files = p->GetFiles();
                     // convert std::vector to wxArrayString
                     for (const auto& p : files) {
-                        wxFileName fn(p.second->GetFilename());
-                        m_files.insert(std::make_pair(fn.GetFullName(), fn.GetFullPath()));
+                        workspace_files.push_back(p.second->GetFilename());
                     }
                 }
             }
         } else if (clFileSystemWorkspace::Get().IsOpen()) {
             const std::vector<wxFileName>& files = clFileSystemWorkspace::Get().GetFiles();
+            workspace_files.reserve(files.size());
             for (const wxFileName& fn : files) {
-                m_files.insert({fn.GetFullName(), fn.GetFullPath()});
+                workspace_files.push_back(fn.GetFullPath());
             }
         }
     } else if (clWorkspaceManager::Get().IsWorkspaceOpened()) {
@@ -120,18 +149,18 @@ OpenResourceDialog::OpenResourceDialog(wxWindow* parent, IManager* manager, cons
         wxArrayString files;
         clWorkspaceManager::Get().GetWorkspace()->GetWorkspaceFiles(files);
         wxStringSet_t unique_files;
-        m_files.reserve(files.size());
+        workspace_files.reserve(files.size());
         for (const auto& file : files) {
             if (unique_files.count(file) == 0) {
                 unique_files.insert(file);
-                wxFileName fn(file);
                 // keep the file as-is do not "format" it by calling
                 // fn.GetFullPath() since we might be on Windows and we display
                 // Linux path style files
-                m_files.insert({fn.GetFullName(), file});
+                workspace_files.push_back(file);
             }
         }
     }
+    UpdateWorkspaceFiles(workspace_files);
 
     wxString lastStringTyped = clConfig::Get().Read("OpenResourceDialog/SearchString", wxString());
     // Set the initial selection
@@ -222,6 +251,7 @@ void OpenResourceDialog::DoPopulateList()
     clDEBUG() << "Open resource:" << name << ":" << nLineNumber << ":" << nColumn << endl;
     m_lineNumber = nLineNumber;
     m_column = nColumn;
+    m_nameFilter = name;
 
     // Prepare the user filter
     m_userFilters.Clear();
@@ -287,24 +317,19 @@ void OpenResourceDialog::DoPopulateWorkspaceFile()
     }
 
     if (!m_userFilters.empty()) {
-
-        std::unordered_multimap<wxString, wxString>::iterator iter = m_files.begin();
-        const int maxFileSize = 100;
-        int counter = 0;
-        for (; (iter != m_files.end()) && (counter < maxFileSize); iter++) {
-            const wxString& fullpath = iter->second;
-            if (!MatchesFilter(fullpath)) {
-                continue;
-            }
-
-            wxFileName fn(iter->second);
+        // the best matches first
+        const size_t maxFileSize = 100;
+        auto& workspace_files = GetWorkspaceFiles();
+        auto matches = workspace_files.index.Search(m_nameFilter, maxFileSize);
+        for (const auto& match : matches) {
+            const wxString& fullpath = workspace_files.files[match.index];
+            wxFileName fn(fullpath);
             int imgId = clGetManager()->GetStdIcons()->GetMimeImageId(fn.GetFullName());
             DoAppendLine(fn.GetFullName(),
-                         iter->second,
+                         fullpath,
                          false,
-                         new OpenResourceDialogItemData(iter->second, -1, "", fn.GetFullName(), ""),
+                         new OpenResourceDialogItemData(fullpath, -1, "", fn.GetFullName(), ""),
                          imgId);
-            ++counter;
         }
     }
 }
@@ -429,12 +454,16 @@ int OpenResourceDialog::DoGetTagImg(const LSP::SymbolInformation& symbol)
     return clGetManager()->GetStdIcons()->GetImageIndex(imgId);
 }
 
-bool OpenResourceDialog::MatchesFilter(const wxString& name)
+bool OpenResourceDialog::MatchesFilter(const wxString& name) const
 {
-    wxString mod_filter;
-    long line_number, column_number;
-    GetLineAndColumnFromFilter(m_textCtrlResourceName->GetValue(), mod_filter, line_number, column_number);
-    return FileUtils::FuzzyMatch(mod_filter, name);
+    // m_userFilters is already split and lower cased
+    wxString lcName = name.Lower();
+    for (const wxString& word : m_userFilters) {
+        if (!lcName.Contains(word)) {
+            return false;
+        }
+    }
+    return true;
 }
 
 void OpenResourceDialog::OnCheckboxfilesCheckboxClicked(wxCommandEvent& event) { DoPopulateList(); }
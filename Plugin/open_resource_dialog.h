@@ -91,11 +91,13 @@ template <> struct hash<LSP::eSymbolKind> {
 class WXDLLIMPEXP_SDK OpenResourceDialog : public OpenResourceDialogBase
 {
     IManager* m_manager;
-    std::unordered_multimap<wxString, wxString> m_files;
     std::unordered_map<LSP::eSymbolKind, int> m_fileTypeHash;
     wxTimer* m_timer;
     bool m_needRefresh;
     wxArrayString m_filters;
+    // the filter, without the line and column
+    wxString m_nameFilter;
+    // the lower cased filter words
     wxArrayString m_userFilters;
     long m_lineNumber = wxNOT_FOUND;
     long m_column = wxNOT_FOUND;
@@ -110,7 +112,7 @@ protected:
 
     void DoPopulateList();
     void DoPopulateWorkspaceFile();
-    bool MatchesFilter(const wxString& name);
+    bool MatchesFilter(const wxString& name) const;
     void DoPopulateTags(const std::vector<LSP::SymbolInformation>& symbols);
     void DoSelectItem(const wxDataViewItem& item);
     void Clear();
@@ -0,0 +1,476 @@
+#include "CompilerOutputMatcher.hpp"
+#include "LSP/FileContentTracker.hpp"
+#include "clRowEntry.h"
+#include "cl_standard_paths.h"
+#include "compiler.h"
+#include "tester.hpp"
+#include "wxCodeCompletionBoxFilter.h"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <wx/filename.h>
+#include <wx/init.h>
+#include <wx/log.h>
+#include <wx/stopwatch.h>
+#include <wx/wxcrtvararg.h>
+
+TEST_FUNC(test_tree_rows_index)
+{
+    // a hidden root with 1000 folders, 500 files each
+    std::unique_ptr<clRowEntry> root(new clRowEntry(nullptr, "root"));
+    root->SetHidden(true);
+    root->SetExpanded(true);
+    std::vector<clRowEntry*> folders;
+    for (size_t i = 0; i < 1000; ++i) {
+        clRowEntry* folder = new clRowEntry(nullptr, "folder");
+        root->AddChild(folder);
+        folders.push_back(folder);
+        for (size_t j = 0; j < 500; ++j) {
+            folder->AddChild(new clRowEntry(nullptr, "file"));
+        }
+    }
+    CHECK_SIZE(root->GetSubtreeRows(), 1000);
+
+    for (auto folder : folders) {
+        folder->SetExpanded(true);
+    }
+    CHECK_SIZE(root->GetSubtreeRows(), 501000);
+
+    // scroll the tree, a page at a time
+    constexpr int PAGE_SIZE = 40;
+    size_t rows_count = 0;
+    bool indexes_match = true;
+    for (int row = 0; row < root->GetSubtreeRows(); row += PAGE_SIZE) {
+        clRowEntry* first = root->GetRowAt(row);
+        if (!first || first->GetRowIndex() != row) {
+            indexes_match = false;
+            break;
+        }
+        clRowEntry::Vec_t items;
+        first->GetNextItems(PAGE_SIZE, items);
+        rows_count += items.size();
+    }
+    CHECK_BOOL(indexes_match);
+    CHECK_SIZE(rows_count, 501000);
+
+    // compare with a walk over the visible items
+    auto nth_visible = [&](int index) -> clRowEntry* {
+        for (clRowEntry* current = root.get(); current; current = current->GetNext()) {
+            if (current->IsVisible() && index-- == 0) {
+                return current;
+            }
+        }
+        return nullptr;
+    };
+    for (int row : { 0, 1, 500, 501, 250000, 500999 }) {
+        CHECK_BOOL(root->GetRowAt(row) == nth_visible(row));
+    }
+    CHECK_BOOL(root->GetRowAt(501000) == nullptr);
+
+    // collapse a folder: its children are no longer counted
+    folders[500]->SetExpanded(false);
+    CHECK_SIZE(root->GetSubtreeRows(), 500500);
+    CHECK_SIZE(folders[500]->GetRowIndex(), 250500);
+    CHECK_SIZE(folders[501]->GetRowIndex(), 250501);
+    CHECK_SIZE(folders[500]->GetFirstChild()->GetRowIndex(), 250501);
+    CHECK_BOOL(root->GetRowAt(250501) == folders[501]);
+
+    // delete the first file
+    folders[0]->DeleteChild(folders[0]->GetFirstChild());
+    CHECK_SIZE(root->GetSubtreeRows(), 500499);
+    CHECK_SIZE(folders[501]->GetRowIndex(), 250500);
+    CHECK_BOOL(root->GetRowAt(1) == nth_visible(1));
+    CHECK_SIZE(folders[2]->GetIndexInParent(), 2);
+    return true;
+}
+
+TEST_FUNC(test_compiler_output_matcher)
+{
+    {
+        auto literals = CompilerOutputMatcher::GetRequiredLiterals(R"#(^(.+?):(\d+):(\d+)? (Note|Warning): (.*)$)#");
+        CHECK_SIZE(literals.size(), 2);
+        CHECK_STRING(literals[0], "note");
+        CHECK_STRING(literals[1], "warning");
+    }
+    {
+        auto literals = CompilerOutputMatcher::GetRequiredLiterals(R"#(make(.*?)(\*\*\*))#");
+        CHECK_SIZE(literals.size(), 1);
+        CHECK_STRING(literals[0], "make");
+    }
+    {
+        auto literals = CompilerOutputMatcher::GetRequiredLiterals("(LINK : fatal error)");
+        CHECK_SIZE(literals.size(), 1);
+        CHECK_STRING(literals[0], "link : fatal error");
+    }
+    {
+        // the digits of a character entry are not literals
+        auto literals = CompilerOutputMatcher::GetRequiredLiterals(R"#(\x1b\[[0-9;]*merror)#");
+        CHECK_SIZE(literals.size(), 1);
+        CHECK_STRING(literals[0], "merror");
+        literals = CompilerOutputMatcher::GetRequiredLiterals(R"#(\u0041BC)#");
+        CHECK_SIZE(literals.size(), 1);
+        CHECK_STRING(literals[0], "bc");
+        literals = CompilerOutputMatcher::GetRequiredLiterals(R"#(\101BC)#");
+        CHECK_SIZE(literals.size(), 1);
+        CHECK_STRING(literals[0], "bc");
+    }
+    // unsupported syntax or optional parts: no prefilter
+    CHECK_SIZE(CompilerOutputMatcher::GetRequiredLiterals("(?i)error").size(), 0);
+    CHECK_SIZE(CompilerOutputMatcher::GetRequiredLiterals("(error)?").size(), 0);
+    CHECK_SIZE(CompilerOutputMatcher::GetRequiredLiterals("error|.*").size(), 0);
+
+    Compiler gnu(nullptr, Compiler::kRegexGNU);
+    auto matcher = gnu.CreateOutputMatcher();
+    CHECK_SIZE(matcher->GetPatternsCount(), 6);
+
+    Compiler::PatternMatch match;
+    CHECK_BOOL(matcher->Matches("/src/main.cpp:12:5: error: 'foo' was not declared in this scope", &match));
+    CHECK_BOOL(match.sev == Compiler::kSevError);
+    CHECK_STRING(match.file_path, "/src/main.cpp");
+    CHECK_SIZE(match.line_number, 12);
+    CHECK_SIZE(match.column, 5);
+
+    match = {};
+    CHECK_BOOL(matcher->Matches("/src/main.cpp:7:1: WARNING: unused variable 'x'", &match));
+    CHECK_BOOL(match.sev == Compiler::kSevWarning);
+    CHECK_SIZE(match.line_number, 7);
+
+    match = {};
+    CHECK_BOOL(matcher->Matches("main.o: undefined reference to `bar()'", &match));
+    CHECK_BOOL(match.sev == Compiler::kSevError);
+    CHECK_BOOL(matcher->Matches("make[2]: *** [all] Error 2", &match));
+    CHECK_BOOL(!matcher->Matches("g++ -c /src/main.cpp -Werror -o main.o", &match));
+    CHECK_BOOL(!matcher->Matches("[ 50%] Building CXX object main.cpp.o", &match));
+
+    Compiler vc(nullptr, Compiler::kRegexVC);
+    auto vc_matcher = vc.CreateOutputMatcher();
+    match = {};
+    CHECK_BOOL(vc_matcher->Matches("C:\\src\\main.cpp(42): error C2065: 'foo': undeclared identifier", &match));
+    CHECK_BOOL(match.sev == Compiler::kSevError);
+    CHECK_SIZE(match.line_number, 42);
+
+    return true;
+}
+
+BENCHMARK_FUNC(benchmark_compiler_output_matcher)
+{
+    // a typical build: mostly command lines, a few diagnostics
+    std::vector<wxString> lines;
+    for (size_t i = 0; i < 100000; ++i) {
+        wxString line;
+        if (i % 1000 == 0) {
+            line << "/src/file" << i << ".cpp:" << (i % 100 + 1) << ":3: warning: comparison of integer expressions";
+        } else {
+            line << "g++ -c /src/file" << i << ".cpp -O2 -Wall -I/usr/include -o file" << i << ".o";
+        }
+        lines.push_back(line);
+    }
+
+    Compiler gnu(nullptr, Compiler::kRegexGNU);
+    auto matcher = gnu.CreateOutputMatcher();
+    wxStopWatch sw;
+    size_t warnings = 0;
+    for (const auto& line : lines) {
+        Compiler::PatternMatch line_match;
+        if (matcher->Matches(line, &line_match) && line_match.sev == Compiler::kSevWarning) {
+            ++warnings;
+        }
+    }
+    wxPrintf("Build output: matching %d lines took %ldms\n", (int)lines.size(), sw.Time());
+    CHECK_SIZE(warnings, 100);
+    return true;
+}
+
+TEST_FUNC(test_code_completion_box_filter)
+{
+    wxCodeCompletionBoxEntry::Vec_t entries;
+    for (const wxString& text : { "SetFileName", "GetFileName", "getName", "GetName", "FileNameGet", "unrelated" }) {
+        entries.push_back(wxCodeCompletionBoxEntry::New(text));
+    }
+    auto filter_texts = [&](const std::vector<wxCodeCompletionBoxFilter::Match>& matches) {
+        wxString texts;
+        for (const auto& match : matches) {
+            texts << entries[match.index]->GetText() << ",";
+        }
+        return texts;
+    };
+
+    // exact matches, then starts with, then contains, then fuzzy. The entries order is kept within a tier
+    wxCodeCompletionBoxFilter filter;
+    std::vector<wxCodeCompletionBoxFilter::Match> matches;
+    filter.Filter(entries, "Get", matches);
+    wxCodeCompletionBoxFilter::SortMatches(matches);
+    CHECK_WXSTRING(filter_texts(matches), "GetFileName,GetName,getName,FileNameGet,");
+    CHECK_SIZE(filter.GetCount(wxCodeCompletionBoxFilter::kExactMatch, wxCodeCompletionBoxFilter::kStartsWithI), 3);
+
+    // extending the filter only checks the previous matches, and finds the same entries as a new search
+    filter.Filter(entries, "GetName", matches);
+    wxCodeCompletionBoxFilter::SortMatches(matches);
+    CHECK_WXSTRING(filter_texts(matches), "GetName,getName,GetFileName,");
+
+    wxCodeCompletionBoxFilter new_filter;
+    new_filter.Filter(entries, "GetName", matches);
+    wxCodeCompletionBoxFilter::SortMatches(matches);
+    CHECK_WXSTRING(filter_texts(matches), "GetName,getName,GetFileName,");
+
+    // a shorter filter searches all the entries again
+    filter.Filter(entries, "name", matches);
+    CHECK_SIZE(matches.size(), 5);
+
+    // fuzzy matches only: there is no starts with or contains match, the list should be queried again
+    filter.Filter(entries, "gfn", matches);
+    wxCodeCompletionBoxFilter::SortMatches(matches);
+    CHECK_WXSTRING(filter_texts(matches), "GetFileName,");
+    CHECK_SIZE(filter.GetCount(wxCodeCompletionBoxFilter::kExactMatch, wxCodeCompletionBoxFilter::kContainsI), 0);
+    return true;
+}
+
+namespace
+{
+/// an editor text with the wxStyledTextCtrl positions (UTF-8 bytes) and line semantics
+class TestText : public FileContentTracker::IText
+{
+    std::string m_text;
+
+    bool IsLineStart(size_t pos) const
+    {
+        // a CRLF is a single line end
+        if (pos == 0 || pos > m_text.length()) {
+            return false;
+        }
+        return m_text[pos - 1] == '\n' ||
+               (m_text[pos - 1] == '\r' && (pos == m_text.length() || m_text[pos] != '\n'));
+    }
+
+public:
+    explicit TestText(const wxString& text)
+        : m_text(text.ToStdString(wxConvUTF8))
+    {
+    }
+
+    int LineFromPosition(int pos) const override
+    {
+        int line = 0;
+        for (int i = 1; i <= pos && i <= (int)m_text.length(); ++i) {
+            line += IsLineStart(i) ? 1 : 0;
+        }
+        return line;
+    }
+
+    int PositionFromLine(int line) const override
+    {
+        int pos = 0;
+        for (; line > 0 && pos < (int)m_text.length(); ++pos) {
+            line -= IsLineStart(pos + 1) ? 1 : 0;
+        }
+        return pos;
+    }
+
+    int GetCharAt(int pos) const override { return pos < (int)m_text.length() ? (unsigned char)m_text[pos] : 0; }
+
+    wxString GetTextRange(int start, int end) const override
+    {
+        end = std::min(end, (int)m_text.length());
+        return end > start ? wxString::FromUTF8(m_text.data() + start, end - start) : wxString();
+    }
+
+    /// the position of the character `index`
+    int PositionFromIndex(size_t index) const
+    {
+        size_t pos = 0;
+        for (; index > 0 && pos < m_text.length(); --index) {
+            // skip the continuation bytes of a UTF-8 sequence
+            for (++pos; pos < m_text.length() && (m_text[pos] & 0xC0) == 0x80; ++pos) {
+            }
+        }
+        return pos;
+    }
+
+    /// the number of characters
+    int GetCharCount() const
+    {
+        return std::count_if(m_text.begin(), m_text.end(), [](char ch) { return (ch & 0xC0) != 0x80; });
+    }
+
+    /// insert `text` at `pos`, return its length in bytes
+    int Insert(int pos, const wxString& text)
+    {
+        std::string utf8 = text.ToStdString(wxConvUTF8);
+        m_text.insert(pos, utf8);
+        return utf8.length();
+    }
+
+    void Delete(int pos, int length) { m_text.erase(pos, length); }
+    wxString GetText() const { return wxString::FromUTF8(m_text.data(), m_text.length()); }
+};
+
+/// apply `change` to `text` the way a server does: a line ends with CR, LF or CRLF, a character is a UTF-16 code unit
+/// and a character past the line end is the line end
+wxString apply_change(const wxString& text, const LSP::TextDocumentContentChangeEvent& change)
+{
+    auto to_offset = [&text](const LSP::Position& position) {
+        size_t offset = 0;
+        for (int line = 0; line < position.GetLine() && offset < text.length(); ++offset) {
+            bool crlf = text[offset] == '\r' && offset + 1 < text.length() && text[offset + 1] == '\n';
+            line += (text[offset] == '\n' || (text[offset] == '\r' && !crlf)) ? 1 : 0;
+        }
+        int units = 0;
+        for (; units < position.GetCharacter() && offset < text.length(); ++offset) {
+            if (text[offset] == '\r' || text[offset] == '\n') {
+                break;
+            }
+            units += ((wxUint32)text[offset] > 0xFFFF) ? 2 : 1;
+        }
+        return offset;
+    };
+    size_t start = to_offset(change.GetRange().GetStart());
+    size_t end = to_offset(change.GetRange().GetEnd());
+    return text.Mid(0, start) + change.GetText() + text.Mid(end);
+}
+
+bool is_change(const LSP::TextDocumentContentChangeEvent& change, const LSP::Position& start, const LSP::Position& end,
+               const wxString& text)
+{
+    return change.GetRange().GetStart() == start && change.GetRange().GetEnd() == end && change.GetText() == text;
+}
+} // namespace
+
+TEST_FUNC(test_lsp_file_content_tracker)
+{
+    FileContentTracker tracker;
+    std::vector<LSP::TextDocumentContentChangeEvent> changes;
+    LSP::TextDocumentContentChangeEvent change;
+    change.SetText("x");
+
+    // the changes of a file are recorded once its content was sent
+    tracker.start_tracking_changes("/src/main.cpp");
+    CHECK_BOOL(!tracker.is_tracking_changes("/src/main.cpp"));
+    tracker.update_content("/src/main.cpp", "int main() {}\n");
+    tracker.add_change("/src/main.cpp", change);
+    CHECK_BOOL(!tracker.take_changes("/src/main.cpp", &changes));
+    tracker.start_tracking_changes("/src/main.cpp");
+    CHECK_BOOL(tracker.is_tracking_changes("/src/main.cpp"));
+
+    for (int i = 0; i < 3; ++i) {
+        change.SetText(wxString() << i);
+        tracker.add_change("/src/main.cpp", change);
+    }
+    CHECK_BOOL(tracker.take_changes("/src/main.cpp", &changes));
+    CHECK_SIZE(changes.size(), 3);
+    CHECK_WXSTRING(changes[2].GetText(), "2");
+    CHECK_BOOL(tracker.take_changes("/src/main.cpp", &changes));
+    CHECK_SIZE(changes.size(), 0);
+
+    // too many changes: the log overflows and stays so until it is reset
+    change.SetText("x");
+    for (int i = 0; i < 1000; ++i) {
+        tracker.add_change("/src/main.cpp", change);
+    }
+    CHECK_BOOL(tracker.take_changes("/src/main.cpp", &changes));
+    CHECK_SIZE(changes.size(), 1000);
+    for (int i = 0; i < 1001; ++i) {
+        tracker.add_change("/src/main.cpp", change);
+    }
+    CHECK_BOOL(!tracker.take_changes("/src/main.cpp", &changes));
+    tracker.add_change("/src/main.cpp", change);
+    CHECK_BOOL(!tracker.take_changes("/src/main.cpp", &changes));
+    tracker.reset_changes("/src/main.cpp");
+    tracker.add_change("/src/main.cpp", change);
+    CHECK_BOOL(tracker.take_changes("/src/main.cpp", &changes));
+    CHECK_SIZE(changes.size(), 1);
+
+    // too much text
+    change.SetText(wxString(1024 * 1024 + 1, 'x'));
+    tracker.add_change("/src/main.cpp", change);
+    CHECK_BOOL(!tracker.take_changes("/src/main.cpp", &changes));
+    tracker.reset_changes("/src/main.cpp");
+    CHECK_BOOL(tracker.take_changes("/src/main.cpp", &changes));
+    CHECK_SIZE(changes.size(), 0);
+
+    tracker.erase("/src/main.cpp");
+    CHECK_BOOL(!tracker.exists("/src/main.cpp"));
+    CHECK_BOOL(!tracker.is_tracking_changes("/src/main.cpp"));
+    return true;
+}
+
+TEST_FUNC(test_lsp_change_ranges)
+{
+    // "é" is 2 bytes and 1 UTF-16 unit, the emoji is 4 bytes and 2 UTF-16 units
+    const wxString content = wxString::FromUTF8("h\xC3\xA9llo\r\nw\xF0\x9F\x98\x80rld\nend");
+    TestText text(content);
+
+    // an insertion is reported after the text was inserted
+    int length = text.Insert(13, "X");
+    CHECK_BOOL(is_change(FileContentTracker::insert_change(text, 13, length), { 1, 3 }, { 1, 3 }, "X"));
+    text.Delete(13, length);
+    length = text.Insert(3, wxString::FromUTF8("\xF0\x9F\x98\x80"));
+    CHECK_BOOL(is_change(FileContentTracker::insert_change(text, 3, length), { 0, 2 }, { 0, 2 },
+                         wxString::FromUTF8("\xF0\x9F\x98\x80")));
+    text.Delete(3, length);
+
+    // a deletion before the text is removed
+    CHECK_BOOL(is_change(FileContentTracker::delete_change(text, 1, 2), { 0, 1 }, { 0, 2 }, ""));
+    CHECK_BOOL(is_change(FileContentTracker::delete_change(text, 9, 4), { 1, 1 }, { 1, 3 }, ""));
+    CHECK_BOOL(is_change(FileContentTracker::delete_change(text, 5, 10), { 0, 4 }, { 1, 5 }, ""));
+    CHECK_BOOL(is_change(FileContentTracker::delete_change(text, 16, 2), { 1, 6 }, { 2, 1 }, ""));
+
+    // a CRLF split by the change: it is replaced with what is left of it
+    CHECK_BOOL(is_change(FileContentTracker::delete_change(text, 7, 1), { 0, 5 }, { 1, 0 }, "\r"));
+    CHECK_BOOL(is_change(FileContentTracker::delete_change(text, 5, 2), { 0, 4 }, { 1, 0 }, "\n"));
+    CHECK_BOOL(is_change(FileContentTracker::delete_change(text, 4, 3), { 0, 3 }, { 1, 0 }, "\n"));
+    length = text.Insert(7, "ab");
+    CHECK_BOOL(is_change(FileContentTracker::insert_change(text, 7, length), { 0, 5 }, { 1, 0 }, "\rab\n"));
+    CHECK_WXSTRING(apply_change(content, FileContentTracker::insert_change(text, 7, length)), text.GetText());
+    text.Delete(7, length);
+
+    // an insertion after a lone CR is at the start of the next line
+    text.Delete(7, 1);
+    length = text.Insert(7, "ab");
+    CHECK_BOOL(is_change(FileContentTracker::insert_change(text, 7, length), { 1, 0 }, { 1, 0 }, "ab"));
+    return true;
+}
+
+TEST_FUNC(test_lsp_change_ranges_random_edits)
+{
+    TestText text("");
+    wxString server_content;
+
+    // the document as the server sees it stays the same as the editor text
+    const wxString pieces[] = { "a", " ", "\r", "\n", "\r\n", wxString::FromUTF8("\xC3\xA9"),
+                                wxString::FromUTF8("\xF0\x9F\x98\x80") };
+    std::mt19937 generator(1);
+    for (size_t i = 0; i < 2000; ++i) {
+        int length = text.GetCharCount();
+        if (length > 0 && generator() % 3 == 0) {
+            int index = generator() % length;
+            int pos = text.PositionFromIndex(index);
+            int end = text.PositionFromIndex(index + 1 + generator() % std::min(length - index, 4));
+            server_content = apply_change(server_content, FileContentTracker::delete_change(text, pos, end - pos));
+            text.Delete(pos, end - pos);
+        } else {
+            wxString inserted;
+            for (size_t count = 1 + generator() % 3; count > 0; --count) {
+                inserted << pieces[generator() % 7];
+            }
+            int pos = text.PositionFromIndex(length > 0 ? generator() % (length + 1) : 0);
+            int bytes = text.Insert(pos, inserted);
+            server_content = apply_change(server_content, FileContentTracker::insert_change(text, pos, bytes));
+        }
+        CHECK_WXSTRING(server_content, text.GetText());
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    wxInitializer initializer(argc, argv);
+    wxLogNull NOLOG;
+
+    // ensure that the user data dir exists
+    wxFileName::Mkdir(clStandardPaths::Get().GetUserDataDir(), wxPosixPermissions::wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+    bool benchmarks = argc > 1 && wxString(argv[1]) == "--benchmark";
+    return Tester::Instance()->RunTests(benchmarks);
+}
@@ -16,6 +16,7 @@
 #include "macros.h"
 #include "wxCodeCompletionBoxManager.h"
 
+#include <algorithm>
 #include <wx/app.h>
 #include <wx/dcbuffer.h>
 #include <wx/dcclient.h>
@@ -26,6 +27,8 @@
 #include <wx/stc/stc.h>
 
 const size_t MAX_TOOLTIP_SIZE = 1 << 10; // 1KB
+// the number of entries added to the list before it is shown, the rest are added right after
+const size_t MAX_INITIAL_ENTRIES = 100;
 
 wxCodeCompletionBox::BmpVec_t wxCodeCompletionBox::m_defaultBitmaps;
 thread_local bool strip_html_tags = false;
@@ -168,9 +171,13 @@ void wxCodeCompletionBox::Reset(wxEvtHandler* eventObject, size_t flags)
     m_startPos = wxNOT_FOUND;
     m_stc = nullptr;
     m_entries.clear();
+    ClearFilterCandidates();
+    ++m_populateGeneration;
     m_list->DeleteAllItems();
 }
 
+void wxCodeCompletionBox::ClearFilterCandidates() { m_filter.Clear(); }
+
 void wxCodeCompletionBox::ShowCompletionBox(wxStyledTextCtrl* ctrl,
                                             const wxCodeCompletionBoxEntry::Vec_t& entries,
                                             const wxSize& control_size)
@@ -194,6 +201,7 @@ void wxCodeCompletionBox::ShowCompletionBox(wxStyledTextCtrl* ctrl,
     }
     // Filter all duplicate entries from the list (based on simple string match)
     RemoveDuplicateEntries();
+    ClearFilterCandidates();
 
     // Filter results based on user input
     size_t startsWithCount = 0;
@@ -326,64 +334,39 @@ bool wxCodeCompletionBox::FilterResults(bool updateEntries,
 {
     containsCount = 0;
     startsWithCount = 0;
+    exactMatchCount = 0;
     wxString word = GetFilter();
     if (word.empty()) {
         if (updateEntries) {
             m_entries = m_allEntries;
         }
+        ClearFilterCandidates();
         return false;
     }
 
-    if (updateEntries) {
-        m_entries.clear();
-    }
-    wxString lcFilter = word.Lower();
+    std::vector<wxCodeCompletionBoxFilter::Match> matches;
+    m_filter.Filter(m_allEntries, word, matches);
+    startsWithCount =
+        m_filter.GetCount(wxCodeCompletionBoxFilter::kExactMatch, wxCodeCompletionBoxFilter::kStartsWithI);
+    containsCount = m_filter.GetCount(wxCodeCompletionBoxFilter::kExactMatch, wxCodeCompletionBoxFilter::kContainsI);
+    exactMatchCount =
+        m_filter.GetCount(wxCodeCompletionBoxFilter::kExactMatch, wxCodeCompletionBoxFilter::kExactMatch);
+
     // Smart sorting:
     // We preare the list of matches in the following order:
     // Exact matches
     // Starts with
     // Contains
-    wxCodeCompletionBoxEntry::Vec_t exactMatches, exactMatchesI, startsWith, startsWithI, contains, containsI;
-    for (size_t i = 0; i < m_allEntries.size(); ++i) {
-        wxString entryText = m_allEntries.at(i)->GetText();
-        entryText.Trim().Trim(false);
-        wxString lcEntryText = entryText.Lower();
-
-        // Exact match:
-        if (word == entryText) {
-            exactMatches.push_back(m_allEntries.at(i));
-
-        } else if (lcEntryText == lcFilter) {
-            exactMatchesI.push_back(m_allEntries.at(i));
-
-        } else if (entryText.StartsWith(word)) {
-            startsWith.push_back(m_allEntries.at(i));
-
-        } else if (lcEntryText.StartsWith(lcFilter)) {
-            startsWithI.push_back(m_allEntries.at(i));
-
-        } else if (entryText.Contains(word)) {
-            contains.push_back(m_allEntries.at(i));
-
-        } else if (lcEntryText.Contains(lcFilter)) {
-            containsI.push_back(m_allEntries.at(i));
+    // Fuzzy matches (best score first)
+    if (updateEntries) {
+        wxCodeCompletionBoxFilter::SortMatches(matches);
+        m_entries.clear();
+        m_entries.reserve(matches.size());
+        for (const auto& match : matches) {
+            m_entries.push_back(m_allEntries[match.index]);
         }
     }
-
-    startsWithCount = startsWith.size() + startsWithI.size() + exactMatches.size() + exactMatchesI.size();
-    containsCount = startsWithCount + contains.size() + containsI.size();
-    exactMatchCount = exactMatches.size();
-
-    // Merge the results
-    if (updateEntries) {
-        m_entries.insert(m_entries.end(), exactMatches.begin(), exactMatches.end());
-        m_entries.insert(m_entries.end(), exactMatchesI.begin(), exactMatchesI.end());
-        m_entries.insert(m_entries.end(), startsWith.begin(), startsWith.end());
-        m_entries.insert(m_entries.end(), startsWithI.begin(), startsWithI.end());
-        m_entries.insert(m_entries.end(), contains.begin(), contains.end());
-        m_entries.insert(m_entries.end(), containsI.begin(), containsI.end());
-    }
-    return exactMatches.empty() && exactMatchesI.empty() && startsWith.empty() && startsWithI.empty();
+    return startsWithCount == 0;
 }
 
 void wxCodeCompletionBox::InsertSelection(wxCodeCompletionBoxEntry::Ptr_t entry)
@@ -484,7 +467,6 @@ void wxCodeCompletionBox::DoUpdateList()
     size_t exactMatchCount = 0;
 
     bool refreshList = FilterResults(true, startsWithCount, containsCount, exactMatchCount);
-    wxUnusedVar(containsCount);
     wxUnusedVar(refreshList);
 
     // If there a single entry exact match hide the cc box
@@ -497,10 +479,11 @@ void wxCodeCompletionBox::DoUpdateList()
     }
 
     // int curpos = m_stc->GetCurrentPos();
-    if (!GetFilter().empty() && (m_entries.empty() && !m_allEntries.empty())) {
+    if (!GetFilter().empty() && (containsCount == 0 && !m_allEntries.empty())) {
         // the CC might not reported all possible matches
         // (we have a limit to the number of matches we display)
-        // trigger another CC action
+        // trigger another CC action. Fuzzy matches alone do not count: they are almost always found, even when the
+        // list no longer contains the entry the user is typing
         wxCommandEvent event(wxEVT_MENU, XRCID("complete_word"));
         wxTheApp->GetTopWindow()->GetEventHandler()->AddPendingEvent(event);
         DoDestroy();
@@ -797,21 +780,46 @@ int wxCodeCompletionBox::GetImageId(LSP::CompletionItem::Ptr_t entry) const
 void wxCodeCompletionBox::DoPopulateList()
 {
     // Fill the control with the entries
+    ++m_populateGeneration;
     m_list->DeleteAllItems();
 
+    // add the top matches so the list can be painted right away, the remaining entries are added afterwards
+    DoAppendEntries(0, MAX_INITIAL_ENTRIES);
+    if (m_entries.size() > MAX_INITIAL_ENTRIES) {
+        CallAfter(&wxCodeCompletionBox::DoPopulateRemainingEntries, m_populateGeneration);
+    }
+
+    // Select the first item
+    if (m_list->GetItemCount()) {
+        m_list->Select(m_list->RowToItem(0));
+    }
+}
+
+void wxCodeCompletionBox::DoAppendEntries(size_t from, size_t count)
+{
+    size_t last = std::min(m_entries.size(), from + count);
+    if (from >= last) {
+        return;
+    }
+
     m_list->Begin();
     wxVector<wxVariant> cols;
-    for (size_t i = 0; i < m_entries.size(); ++i) {
+    for (size_t i = from; i < last; ++i) {
         wxCodeCompletionBoxEntry::Ptr_t cc_item = m_entries[i];
         cols.clear();
         cols.push_back(::MakeBitmapIndexText(cc_item->GetText(), cc_item->GetImgIndex()));
         m_list->AppendItem(cols, (wxUIntPtr)i);
     }
     m_list->Commit();
-    // Select the first item
-    if (m_list->GetItemCount()) {
-        m_list->Select(m_list->RowToItem(0));
+}
+
+void wxCodeCompletionBox::DoPopulateRemainingEntries(size_t generation)
+{
+    if (generation != m_populateGeneration) {
+        // the list was re-populated (or reset) since
+        return;
     }
+    DoAppendEntries(m_list->GetItemCount(), m_entries.size());
 }
 
 void wxCodeCompletionBox::OnSelectionActivated(wxDataViewEvent& event)
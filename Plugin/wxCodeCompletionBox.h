@@ -30,6 +30,7 @@
 #include "database/entry.h"
 #include "wxCodeCompletionBoxBase.h"
 #include "wxCodeCompletionBoxEntry.hpp"
+#include "wxCodeCompletionBoxFilter.h"
 #include "wxStringHash.h"
 
 #include <vector>
@@ -93,6 +94,12 @@ protected:
     wxBitmap m_bmpDownEnabled;
     wxTimer* m_tooltipTimer = nullptr;
 
+    /// Matches m_allEntries against the filter, remembers the last matches
+    wxCodeCompletionBoxFilter m_filter;
+
+    /// Incremented whenever the list is populated, so a deferred population of a stale list is ignored
+    size_t m_populateGeneration = 0;
+
 protected:
     void StcModified(wxStyledTextEvent& event);
     void StcCharAdded(wxStyledTextEvent& event);
@@ -100,6 +107,9 @@ protected:
     void StcKeyDown(wxKeyEvent& event);
     static void InitializeDefaultBitmaps();
     void DoPopulateList();
+    void DoAppendEntries(size_t from, size_t count);
+    void DoPopulateRemainingEntries(size_t generation);
+    void ClearFilterCandidates();
 
 public:
     /**
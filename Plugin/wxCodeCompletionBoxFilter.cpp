@@ -0,0 +1,164 @@
+#include "wxCodeCompletionBoxFilter.h"
+
+#include <algorithm>
+
+namespace
+{
+inline bool IsWordStart(const wxString& text, size_t pos)
+{
+    if (pos == 0) {
+        return true;
+    }
+    wxChar prev = text[pos - 1];
+    wxChar ch = text[pos];
+    return prev == '_' || (wxIsupper(ch) && !wxIsupper(prev)) || (wxIsdigit(ch) && !wxIsdigit(prev));
+}
+
+/// Match the filter characters, in order, against the entry text. Matches at the start of a word (camel case or
+/// snake case) and consecutive matches are rewarded, gaps are penalised
+bool FuzzyMatch(const wxString& text, const wxString& lcText, const wxString& lcFilter, int* score)
+{
+    // forward: find where the first occurrence ends
+    size_t n = 0;
+    size_t end = wxString::npos;
+    for (size_t i = 0; i < lcText.length(); ++i) {
+        if (lcText[i] == lcFilter[n] && ++n == lcFilter.length()) {
+            end = i;
+            break;
+        }
+    }
+    if (end == wxString::npos) {
+        return false;
+    }
+
+    // backward: the shortest window ending there
+    size_t start = end;
+    n = lcFilter.length();
+    for (size_t i = end + 1; i-- > 0;) {
+        if (lcText[i] == lcFilter[n - 1] && --n == 0) {
+            start = i;
+            break;
+        }
+    }
+
+    // return true if lcFilter[filter_pos...] is found, in order, in lcText[pos...]
+    auto matches_from = [&](size_t pos, size_t filter_pos) {
+        for (size_t i = pos; i < lcText.length() && filter_pos < lcFilter.length(); ++i) {
+            if (lcText[i] == lcFilter[filter_pos]) {
+                ++filter_pos;
+            }
+        }
+        return filter_pos == lcFilter.length();
+    };
+
+    // score the window, preferring word starts over other occurrences
+    int total = 0;
+    size_t prev = wxString::npos;
+    n = 0;
+    for (size_t i = start; i < lcText.length() && n < lcFilter.length(); ++i) {
+        if (lcText[i] != lcFilter[n]) {
+            continue;
+        }
+        if (!IsWordStart(text, i)) {
+            // use a later word start instead, if the rest of the filter can still be matched after it
+            for (size_t j = i + 1; j < lcText.length(); ++j) {
+                if (lcText[j] == lcFilter[n] && IsWordStart(text, j) && matches_from(j + 1, n + 1)) {
+                    i = j;
+                    break;
+                }
+            }
+        }
+        total += 16;
+        if (IsWordStart(text, i)) {
+            total += 8;
+        } else if (prev != wxString::npos && i == prev + 1) {
+            total += 4;
+        }
+        if (prev != wxString::npos && i > prev + 1) {
+            total -= 2;
+        }
+        prev = i;
+        ++n;
+    }
+    *score = total;
+    return true;
+}
+} // namespace
+
+void wxCodeCompletionBoxFilter::Clear()
+{
+    m_lastFilter.clear();
+    m_candidates.clear();
+    m_hasCandidates = false;
+    std::fill(std::begin(m_tierCounts), std::end(m_tierCounts), 0);
+}
+
+void wxCodeCompletionBoxFilter::Filter(const wxCodeCompletionBoxEntry::Vec_t& entries, const wxString& word,
+                                       std::vector<Match>& matches)
+{
+    wxString lcFilter = word.Lower();
+
+    // Every entry that matches the filter contains its characters in order. So when the user extends the filter,
+    // only the entries that matched the previous filter need to be checked
+    bool narrow = m_hasCandidates && lcFilter.StartsWith(m_lastFilter);
+    const size_t count = narrow ? m_candidates.size() : entries.size();
+
+    matches.clear();
+    std::fill(std::begin(m_tierCounts), std::end(m_tierCounts), 0);
+    for (size_t i = 0; i < count; ++i) {
+        size_t index = narrow ? m_candidates[i] : i;
+        const wxCodeCompletionBoxEntry::Ptr_t& entry = entries[index];
+        const wxString& entryText = entry->GetFilterText();
+        const wxString& lcEntryText = entry->GetLcFilterText();
+
+        eMatchTier tier;
+        int score = 0;
+        if (word == entryText) {
+            tier = kExactMatch;
+        } else if (lcEntryText == lcFilter) {
+            tier = kExactMatchI;
+        } else if (entryText.StartsWith(word)) {
+            tier = kStartsWith;
+        } else if (lcEntryText.StartsWith(lcFilter)) {
+            tier = kStartsWithI;
+        } else if (entryText.Contains(word)) {
+            tier = kContains;
+        } else if (lcEntryText.Contains(lcFilter)) {
+            tier = kContainsI;
+        } else if (FuzzyMatch(entryText, lcEntryText, lcFilter, &score)) {
+            tier = kFuzzy;
+        } else {
+            continue;
+        }
+        matches.push_back({ tier, score, index });
+        ++m_tierCounts[tier];
+    }
+
+    // keep the matches for the next call
+    m_candidates.clear();
+    m_candidates.reserve(matches.size());
+    for (const auto& match : matches) {
+        m_candidates.push_back(match.index);
+    }
+    m_lastFilter.swap(lcFilter);
+    m_hasCandidates = true;
+}
+
+void wxCodeCompletionBoxFilter::SortMatches(std::vector<Match>& matches)
+{
+    std::stable_sort(matches.begin(), matches.end(), [](const Match& a, const Match& b) {
+        if (a.tier != b.tier) {
+            return a.tier < b.tier;
+        }
+        return a.score > b.score;
+    });
+}
+
+size_t wxCodeCompletionBoxFilter::GetCount(eMatchTier first, eMatchTier last) const
+{
+    size_t count = 0;
+    for (int tier = first; tier <= last; ++tier) {
+        count += m_tierCounts[tier];
+    }
+    return count;
+}
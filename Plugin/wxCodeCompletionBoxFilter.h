@@ -0,0 +1,68 @@
+#ifndef WXCODECOMPLETIONBOXFILTER_H
+#define WXCODECOMPLETIONBOXFILTER_H
+
+#include "codelite_exports.h"
+#include "wxCodeCompletionBoxEntry.hpp"
+
+#include <vector>
+#include <wx/string.h>
+
+/**
+ * @class wxCodeCompletionBoxFilter
+ * @brief matches the code completion entries against the word typed by the user. It remembers the entries that
+ * matched the last filter: when the user extends the filter, only these entries are checked
+ */
+class WXDLLIMPEXP_SDK wxCodeCompletionBoxFilter
+{
+public:
+    /// The entry categories, in the order they are displayed
+    enum eMatchTier {
+        kExactMatch,
+        kExactMatchI,
+        kStartsWith,
+        kStartsWithI,
+        kContains,
+        kContainsI,
+        kFuzzy, // the filter characters are found in order (e.g. "gfn" -> "GetFileName")
+    };
+
+    struct Match {
+        eMatchTier tier;
+        int score;
+        size_t index; ///< index in the filtered entries
+    };
+
+private:
+    /// The lower case filter used by the last Filter() call and the indexes of all the entries that matched it
+    wxString m_lastFilter;
+    std::vector<size_t> m_candidates;
+    bool m_hasCandidates = false;
+    size_t m_tierCounts[kFuzzy + 1] = {};
+
+public:
+    wxCodeCompletionBoxFilter() = default;
+    ~wxCodeCompletionBoxFilter() = default;
+
+    /**
+     * @brief forget the last filter. Must be called whenever the entries change
+     */
+    void Clear();
+
+    /**
+     * @brief match `word` against `entries`. The matches are returned in the order of `entries`, see SortMatches()
+     * @param word a non empty filter
+     */
+    void Filter(const wxCodeCompletionBoxEntry::Vec_t& entries, const wxString& word, std::vector<Match>& matches);
+
+    /**
+     * @brief sort the matches by tier, and by score within the fuzzy tier. The entries order is kept otherwise
+     */
+    static void SortMatches(std::vector<Match>& matches);
+
+    /**
+     * @brief the number of matches of the last Filter() call in the tiers [first, last]
+     */
+    size_t GetCount(eMatchTier first, eMatchTier last) const;
+};
+
+#endif // WXCODECOMPLETIONBOXFILTER_H
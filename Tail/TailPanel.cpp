@@ -77,7 +77,7 @@ void TailPanel::OnFileModified(clFileSystemEvent& event)
                 DoAppendText(content);
             }
             wxDELETEA(buffer);
-        } else {
+        } else if (cursize < m_lastPos) {
             DoAppendText(_("\n>>> File truncated <<<\n"));
         }
         m_lastPos = cursize;
@@ -5,13 +5,32 @@
 #include "globals.h"
 #include "ieditor.h"
 #include "imanager.h"
+#include <unordered_set>
 #include <wx/stc/stc.h>
 
+namespace
+{
+class EditorText : public WordDocument::IText
+{
+    wxStyledTextCtrl* m_ctrl;
+
+public:
+    EditorText(wxStyledTextCtrl* ctrl)
+        : m_ctrl(ctrl)
+    {
+    }
+    int LineFromPosition(int pos) const override { return m_ctrl->LineFromPosition(pos); }
+    int PositionFromLine(int line) const override { return m_ctrl->PositionFromLine(line); }
+    int GetLineEndPosition(int line) const override { return m_ctrl->GetLineEndPosition(line); }
+    wxString GetTextRange(int start, int end) const override { return m_ctrl->GetTextRange(start, end); }
+};
+} // namespace
+
 WordCompletionDictionary::WordCompletionDictionary()
 {
     EventNotifier::Get()->Bind(wxEVT_ACTIVE_EDITOR_CHANGED, &WordCompletionDictionary::OnEditorChanged, this);
+    EventNotifier::Get()->Bind(wxEVT_EDITOR_CLOSING, &WordCompletionDictionary::OnEditorClosing, this);
     EventNotifier::Get()->Bind(wxEVT_ALL_EDITORS_CLOSED, &WordCompletionDictionary::OnAllEditorsClosed, this);
-    EventNotifier::Get()->Bind(wxEVT_FILE_SAVED, &WordCompletionDictionary::OnFileSaved, this);
 
     m_thread = new WordCompletionThread(this);
     m_thread->Start();
@@ -20,8 +39,17 @@ WordCompletionDictionary::WordCompletionDictionary()
 WordCompletionDictionary::~WordCompletionDictionary()
 {
     EventNotifier::Get()->Unbind(wxEVT_ACTIVE_EDITOR_CHANGED, &WordCompletionDictionary::OnEditorChanged, this);
+    EventNotifier::Get()->Unbind(wxEVT_EDITOR_CLOSING, &WordCompletionDictionary::OnEditorClosing, this);
     EventNotifier::Get()->Unbind(wxEVT_ALL_EDITORS_CLOSED, &WordCompletionDictionary::OnAllEditorsClosed, this);
-    EventNotifier::Get()->Unbind(wxEVT_FILE_SAVED, &WordCompletionDictionary::OnFileSaved, this);
+
+    // Stop tracking the editors that are still open (the others are already destroyed)
+    IEditor::List_t allEditors;
+    ::clGetManager()->GetAllEditors(allEditors);
+    for (IEditor* editor : allEditors) {
+        if(m_documents.count(editor->GetCtrl())) {
+            editor->GetCtrl()->Unbind(wxEVT_STC_MODIFIED, &WordCompletionDictionary::OnEditorModified, this);
+        }
+    }
 
     m_thread->Stop();   // Stop the thread
     wxDELETE(m_thread); // Delete it
@@ -31,93 +59,122 @@ void WordCompletionDictionary::OnEditorChanged(wxCommandEvent& event)
 {
     event.Skip();
 
-    // 1) Get a list of all open editors and set the compare it to the current cached files
-    //    and delete all "closed" editors
+    // 1) Get a list of all open editors, and forget the cached editors that are no longer open
     // 2) Request to cache the newly opened file's words
     IEditor::List_t allEditors;
-    wxArrayString openEditors, cachedEditors, closedEditors;
     ::clGetManager()->GetAllEditors(allEditors);
 
+    std::unordered_set<wxStyledTextCtrl*> openEditors;
     for (IEditor* editor : allEditors) {
-        openEditors.Add(editor->GetFileName().GetFullPath());
+        openEditors.insert(editor->GetCtrl());
     }
 
-    for (const auto& p : m_files) {
-        cachedEditors.Add(p.first);
+    std::vector<wxStyledTextCtrl*> closedEditors;
+    for (const auto& p : m_documents) {
+        if(openEditors.count(p.first) == 0) {
+            closedEditors.push_back(p.first);
+        }
     }
 
-    // std::set_difference requires that both arrays will be sorted
-    openEditors.Sort();
-    cachedEditors.Sort();
-
-    // Create a new array "closedEditors" which contains list of files that exists
-    // in the cachedEditors but not in openEditors list
-    std::set_difference(cachedEditors.begin(),
-                        cachedEditors.end(),
-                        openEditors.begin(),
-                        openEditors.end(),
-                        std::back_inserter(closedEditors));
-
-    for (const auto& closedEditorName : closedEditors) {
-        m_files.erase(closedEditorName);
+    for (wxStyledTextCtrl* ctrl : closedEditors) {
+        DoRemoveDocument(ctrl);
     }
 
     // 2: cache the active editor
-    DoCacheActiveEditor(false);
+    DoCacheActiveEditor();
 }
 
-void WordCompletionDictionary::OnSuggestThread(const WordCompletionThreadReply& reply)
+void WordCompletionDictionary::OnEditorClosing(wxCommandEvent& event)
 {
-    // Remove the current file's dictionary
-    std::map<wxString, wxStringSet_t>::iterator iter = m_files.find(reply.filename.GetFullPath());
-    if(iter != m_files.end()) m_files.erase(iter);
+    event.Skip();
+    IEditor* editor = (IEditor*)event.GetClientData();
+    CHECK_PTR_RET(editor);
+
+    wxStyledTextCtrl* ctrl = editor->GetCtrl();
+    if(m_documents.count(ctrl)) {
+        ctrl->Unbind(wxEVT_STC_MODIFIED, &WordCompletionDictionary::OnEditorModified, this);
+        DoRemoveDocument(ctrl);
+    }
+}
 
-    // Keep the words
-    m_files.insert(std::make_pair(reply.filename.GetFullPath(), reply.suggest));
+void WordCompletionDictionary::OnSuggestThread(const WordCompletionThreadReply& reply)
+{
+    auto iter = std::find_if(m_documents.begin(), m_documents.end(),
+                             [&](const auto& p) { return p.second->GetId() == reply.documentId; });
+    if(iter == m_documents.end()) {
+        // the editor was closed
+        return;
+    }
+    iter->second->SetParsedWords(reply.words);
 }
 
 void WordCompletionDictionary::OnAllEditorsClosed(wxCommandEvent& event)
 {
     event.Skip();
-    m_files.clear();
+    m_documents.clear();
+    m_index.Clear();
 }
 
-void WordCompletionDictionary::DoCacheActiveEditor(bool overwrite)
+void WordCompletionDictionary::DoCacheActiveEditor()
 {
     // Step 2: cache the active editor (if not already cached)
     IEditor* activeEditor = ::clGetManager()->GetActiveEditor();
     CHECK_PTR_RET(activeEditor);
 
-    if(!overwrite && m_files.count(activeEditor->GetFileName().GetFullPath()))
-        return; // we already have this file in the cache
-        
-    m_files.erase(activeEditor->GetFileName().GetFullPath());
-    
-    // Insert a dummy entry, so we won't queue this file if not needed
-    m_files.insert(std::make_pair(activeEditor->GetFileName().GetFullPath(), wxStringSet_t()));
-    
-    // Queue this file
     wxStyledTextCtrl* stc = activeEditor->GetCtrl();
-    
-    // Invoke the thread to parse and suggest words for this file
+    CHECK_PTR_RET(stc);
+    if(m_documents.count(stc))
+        return; // we already have this file in the cache, it is kept up to date by OnEditorModified()
+
+    // From now on, record the changes made to the editor
+    WordDocument* document = new WordDocument(m_index, m_nextDocumentId++);
+    m_documents[stc].reset(document);
+    stc->Bind(wxEVT_STC_MODIFIED, &WordCompletionDictionary::OnEditorModified, this);
+
+    // Invoke the thread to parse the current content of the file
     WordCompletionThreadRequest* req = new WordCompletionThreadRequest;
     req->buffer = stc->GetText();
     req->filename = activeEditor->GetFileName();
-    req->filter = "filter";
+    req->documentId = document->GetId();
     m_thread->Add(req);
 }
 
-void WordCompletionDictionary::OnFileSaved(clCommandEvent& event)
+void WordCompletionDictionary::DoRemoveDocument(wxStyledTextCtrl* ctrl)
 {
-    event.Skip();
-    DoCacheActiveEditor(true);
+    auto iter = m_documents.find(ctrl);
+    if(iter == m_documents.end()) {
+        return;
+    }
+
+    iter->second->RemoveFromIndex();
+    m_documents.erase(iter);
 }
 
-wxStringSet_t WordCompletionDictionary::GetWords() const
+void WordCompletionDictionary::OnEditorModified(wxStyledTextEvent& event)
 {
-    wxStringSet_t words;
-    for (const auto& p : m_files) {
-        words.insert(p.second.begin(), p.second.end());
+    event.Skip();
+    int type = event.GetModificationType();
+    bool inserted = (type & wxSTC_MOD_INSERTTEXT);
+    bool deleting = (type & wxSTC_MOD_BEFOREDELETE);
+    bool deleted = (type & wxSTC_MOD_DELETETEXT);
+    if(!inserted && !deleting && !deleted) {
+        return;
+    }
+
+    wxStyledTextCtrl* ctrl = dynamic_cast<wxStyledTextCtrl*>(event.GetEventObject());
+    CHECK_PTR_RET(ctrl);
+    auto iter = m_documents.find(ctrl);
+    if(iter == m_documents.end()) {
+        return;
+    }
+
+    EditorText text(ctrl);
+    if(inserted) {
+        iter->second->OnInserted(text, event.GetPosition(), event.GetLength());
+    } else if(deleting) {
+        // the text is still in the editor
+        iter->second->OnDeleting(text, event.GetPosition(), event.GetLength());
+    } else {
+        iter->second->OnDeleted(text, event.GetPosition());
     }
-    return words;
 }
@@ -26,40 +26,52 @@
 #ifndef WORDCOMPLETIONDICTIONARY_H
 #define WORDCOMPLETIONDICTIONARY_H
 
-#include "macros.h"
-#include <wx/string.h>
-#include <wx/event.h>
-#include "WordCompletionThread.h"
 #include "WordCompletionRequestReply.h"
+#include "WordCompletionThread.h"
+#include "WordDocument.h"
+#include "WordIndex.h"
 #include "cl_command_event.h"
+#include "macros.h"
+
+#include <memory>
+#include <unordered_map>
+#include <wx/event.h>
+#include <wx/stc/stc.h>
+#include <wx/string.h>
 
 class WordCompletionDictionary : public wxEvtHandler
 {
-    std::map<wxString, wxStringSet_t> m_files;
+    /// the words of all the open editors
+    WordIndex m_index;
+    /// the open editors, the index is updated as they are modified
+    std::unordered_map<wxStyledTextCtrl*, std::unique_ptr<WordDocument>> m_documents;
+    size_t m_nextDocumentId = 1;
     WordCompletionThread* m_thread;
 
 protected:
     void OnEditorChanged(wxCommandEvent& event);
+    void OnEditorClosing(wxCommandEvent& event);
     void OnAllEditorsClosed(wxCommandEvent& event);
-    void OnFileSaved(clCommandEvent& event);
+    void OnEditorModified(wxStyledTextEvent& event);
 
 private:
-    void DoCacheActiveEditor(bool overwrite);
+    void DoCacheActiveEditor();
+    void DoRemoveDocument(wxStyledTextCtrl* ctrl);
 
 public:
     WordCompletionDictionary();
     virtual ~WordCompletionDictionary();
-    
+
     /**
      * @brief this function is called by the word completion thread when parsing phase is done
      * @param reply
      */
     void OnSuggestThread(const WordCompletionThreadReply& reply);
-    
+
     /**
-     * @brief return a set of words from the current editors
+     * @brief return the words of the open editors, including the unsaved changes
      */
-    wxStringSet_t GetWords() const;
+    const WordIndex& GetIndex() const { return m_index; }
 };
 
 #endif // WORDCOMPLETIONDICTIONARY_H
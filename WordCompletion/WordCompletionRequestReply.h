@@ -26,20 +26,19 @@
 #ifndef WordCompletionRequestReply_H__
 #define WordCompletionRequestReply_H__
 
+#include "WordIndex.h"
 #include "worker_thread.h"
 
 struct WordCompletionThreadRequest : public ThreadRequest {
     wxString buffer;
-    wxString filter;
     wxFileName filename;
-    bool insertSingleMatch;
+    size_t documentId = 0;
 };
 
 struct WordCompletionThreadReply {
-    wxStringSet_t suggest;
+    WordIndex::Counts_t words;
     wxFileName filename;
-    wxString filter;
-    bool insertSingleMatch;
+    size_t documentId = 0;
 };
 
 #endif
@@ -2,12 +2,10 @@
 
 #include "WordCompletionDictionary.h"
 #include "WordCompletionSettings.h"
-#include "WordTokenizerAPI.h"
+#include "WordDocument.h"
 #include "macros.h"
 #include "wordcompletion.h"
 
-#include <wx/strconv.h>
-
 WordCompletionThread::WordCompletionThread(WordCompletionDictionary* dict)
     : m_dict(dict)
 {
@@ -18,55 +16,10 @@ void WordCompletionThread::ProcessRequest(ThreadRequest* request)
     WordCompletionThreadRequest* req = dynamic_cast<WordCompletionThreadRequest*>(request);
     CHECK_PTR_RET(req);
 
-    wxStringSet_t suggestions;
-    ParseBuffer(req->buffer, suggestions);
-
     // Parse and send back the reply
     WordCompletionThreadReply reply;
+    WordDocument::Parse(req->buffer, reply.words);
     reply.filename = req->filename;
-    reply.filter = req->filter;
-    reply.insertSingleMatch = req->insertSingleMatch;
-    reply.suggest.swap(suggestions);
+    reply.documentId = req->documentId;
     m_dict->CallAfter(&WordCompletionDictionary::OnSuggestThread, reply);
 }
-
-void WordCompletionThread::ParseBuffer(const wxString& buffer, wxStringSet_t& suggest)
-{
-#if 0
-    wxArrayString filteredWords;
-    wxArrayString words = ::wxStringTokenize(buffer, "\r\n \t->./\\'\"[]()<>*&^%#!@+=:,;{}|/", wxTOKEN_STRTOK);
-    for(size_t i=0; i<words.size(); ++i) {
-        if(!wxIsdigit(words.Item(i).at(0))) {
-            filteredWords.Add(words.Item(i));
-        }
-    }
-    suggest.insert(filteredWords.begin(), filteredWords.end());
-#else
-    WordScanner_t scanner = ::WordLexerNew(buffer);
-    if(!scanner)
-        return;
-    WordLexerToken token;
-    std::string curword;
-    while(::WordLexerNext(scanner, token)) {
-        switch(token.type) {
-        case kWordDelim:
-            if(!curword.empty()) {
-                suggest.insert(wxString(curword.c_str(), wxConvUTF8, curword.length()));
-            }
-            curword.clear();
-            break;
-
-        case kWordNumber: {
-            if(!curword.empty()) {
-                curword += token.text;
-            }
-            break;
-        }
-        default:
-            curword += token.text;
-            break;
-        }
-    }
-    ::WordLexerDestroy(&scanner);
-#endif
-}
@@ -43,11 +43,6 @@ public:
     WordCompletionThread(WordCompletionDictionary* dict);
     ~WordCompletionThread() = default;
     virtual void ProcessRequest(ThreadRequest* request);
-    
-    /**
-     * @brief parse 'buffer' and return set of words to complete
-     */
-    static void ParseBuffer(const wxString& buffer, wxStringSet_t& suggest);
 };
 
 #endif // WORDCOMPLETIONTHREAD_H
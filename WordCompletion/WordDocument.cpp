@@ -0,0 +1,136 @@
+#include "WordDocument.h"
+
+#include "WordTokenizerAPI.h"
+
+#include <algorithm>
+#include <string>
+#include <wx/strconv.h>
+
+WordDocument::WordDocument(WordIndex& index, size_t id)
+    : m_index(index)
+    , m_id(id)
+{
+}
+
+void WordDocument::Parse(const wxString& buffer, WordIndex::Counts_t& words, int weight)
+{
+    WordScanner_t scanner = ::WordLexerNew(buffer);
+    if(!scanner)
+        return;
+    WordLexerToken token;
+    std::string curword;
+    while(::WordLexerNext(scanner, token)) {
+        switch(token.type) {
+        case kWordDelim:
+            if(!curword.empty()) {
+                words[wxString(curword.c_str(), wxConvUTF8, curword.length())] += weight;
+            }
+            curword.clear();
+            break;
+
+        case kWordNumber: {
+            if(!curword.empty()) {
+                curword += token.text;
+            }
+            break;
+        }
+        default:
+            curword += token.text;
+            break;
+        }
+    }
+
+    // the buffer does not have to end with a delimiter (e.g. a single line)
+    if(!curword.empty()) {
+        words[wxString(curword.c_str(), wxConvUTF8, curword.length())] += weight;
+    }
+    ::WordLexerDestroy(&scanner);
+}
+
+void WordDocument::DoUpdate(const WordIndex::Counts_t& changes)
+{
+    for(const auto& [word, count] : changes) {
+        if(count == 0) {
+            continue;
+        }
+
+        int& total = m_words[word];
+        total += count;
+        if(m_indexed) {
+            if(count > 0) {
+                m_index.Add(word, count);
+            } else {
+                m_index.Remove(word, -count);
+            }
+        }
+
+        if(total == 0) {
+            m_words.erase(word);
+        }
+    }
+}
+
+void WordDocument::OnInserted(const IText& text, int pos, int length)
+{
+    int start = text.PositionFromLine(text.LineFromPosition(pos));
+    // the inserted text may end in the middle of a CRLF
+    int end = std::max(text.GetLineEndPosition(text.LineFromPosition(pos + length)), pos + length);
+
+    // the lines before the insertion are the current lines without the inserted text
+    WordIndex::Counts_t changes;
+    Parse(text.GetTextRange(start, pos) + text.GetTextRange(pos + length, end), changes, -1);
+    Parse(text.GetTextRange(start, end), changes, 1);
+    DoUpdate(changes);
+}
+
+void WordDocument::OnDeleting(const IText& text, int pos, int length)
+{
+    // the text after the start of the first line is re-parsed by OnDeleted(). Remember this position: once the
+    // deletion joined a CR with a LF (or split a CRLF), the line of `pos` no longer starts there
+    m_deletedStart = text.PositionFromLine(text.LineFromPosition(pos));
+    int end = std::max(text.GetLineEndPosition(text.LineFromPosition(pos + length)), pos + length);
+
+    WordIndex::Counts_t changes;
+    Parse(text.GetTextRange(m_deletedStart, end), changes, -1);
+    DoUpdate(changes);
+}
+
+void WordDocument::OnDeleted(const IText& text, int pos)
+{
+    int start = (m_deletedStart == wxNOT_FOUND) ? text.PositionFromLine(text.LineFromPosition(pos)) : m_deletedStart;
+    // `pos` may now be in the middle of a CRLF
+    int end = std::max(text.GetLineEndPosition(text.LineFromPosition(pos)), pos);
+    m_deletedStart = wxNOT_FOUND;
+
+    WordIndex::Counts_t changes;
+    Parse(text.GetTextRange(start, end), changes, 1);
+    DoUpdate(changes);
+}
+
+void WordDocument::SetParsedWords(const WordIndex::Counts_t& words)
+{
+    // add up the changes recorded so far to get the current words
+    for(const auto& [word, count] : words) {
+        m_words[word] += count;
+    }
+
+    for(auto iter = m_words.begin(); iter != m_words.end();) {
+        if(iter->second > 0) {
+            m_index.Add(iter->first, iter->second);
+            ++iter;
+        } else {
+            iter = m_words.erase(iter);
+        }
+    }
+    m_indexed = true;
+}
+
+void WordDocument::RemoveFromIndex()
+{
+    if(m_indexed) {
+        for(const auto& [word, count] : m_words) {
+            m_index.Remove(word, count);
+        }
+    }
+    m_indexed = false;
+}
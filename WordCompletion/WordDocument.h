@@ -0,0 +1,84 @@
+#ifndef WORDDOCUMENT_H
+#define WORDDOCUMENT_H
+
+#include "WordIndex.h"
+
+#include <wx/string.h>
+
+/**
+ * @class WordDocument
+ * @brief the words of one editor, kept up to date as the editor is modified. A word never spans lines, so only the
+ * lines touched by a change are parsed: their words as they were before the change are removed and their words as they
+ * are now are added. The words are added to the shared index once the worker thread parsed the whole document
+ */
+class WordDocument
+{
+public:
+    /**
+     * @brief the editor text, with the wxStyledTextCtrl line semantics (a line ends with CR, LF or CRLF)
+     */
+    class IText
+    {
+    public:
+        virtual ~IText() = default;
+        virtual int LineFromPosition(int pos) const = 0;
+        virtual int PositionFromLine(int line) const = 0;
+        /// the position of the line end, before its EOL characters
+        virtual int GetLineEndPosition(int line) const = 0;
+        virtual wxString GetTextRange(int start, int end) const = 0;
+    };
+
+private:
+    WordIndex& m_index;
+    size_t m_id = 0;
+    /// the words of the document. Until the thread parsed the document, these are the changes made since the buffer
+    /// was sent to the thread, and they are not in the index
+    WordIndex::Counts_t m_words;
+    bool m_indexed = false;
+    /// the start of the lines removed by OnDeleting()
+    int m_deletedStart = wxNOT_FOUND;
+
+private:
+    void DoUpdate(const WordIndex::Counts_t& changes);
+
+public:
+    WordDocument(WordIndex& index, size_t id);
+    ~WordDocument() = default;
+
+    /**
+     * @brief parse `buffer` and add `weight` to the number of occurrences of each of its words
+     */
+    static void Parse(const wxString& buffer, WordIndex::Counts_t& words, int weight = 1);
+
+    /**
+     * @brief `length` characters were inserted at `pos`, `text` contains them
+     */
+    void OnInserted(const IText& text, int pos, int length);
+
+    /**
+     * @brief `length` characters are about to be deleted at `pos`, `text` still contains them
+     */
+    void OnDeleting(const IText& text, int pos, int length);
+
+    /**
+     * @brief the characters reported by OnDeleting() were deleted
+     */
+    void OnDeleted(const IText& text, int pos);
+
+    /**
+     * @brief the words parsed by the worker thread, from the buffer taken before the changes recorded so far. Add the
+     * document to the index
+     */
+    void SetParsedWords(const WordIndex::Counts_t& words);
+
+    /**
+     * @brief remove the words of the document from the index
+     */
+    void RemoveFromIndex();
+
+    size_t GetId() const { return m_id; }
+    bool IsIndexed() const { return m_indexed; }
+    const WordIndex::Counts_t& GetWords() const { return m_words; }
+};
+
+#endif // WORDDOCUMENT_H
@@ -0,0 +1,144 @@
+#include "WordIndex.h"
+
+#include <algorithm>
+
+namespace
+{
+template <typename NodePtrVec> auto LowerBound(NodePtrVec& children, wchar_t ch)
+{
+    return std::lower_bound(children.begin(), children.end(), ch,
+                            [](const auto& child, wchar_t c) { return child->ch < c; });
+}
+} // namespace
+
+std::wstring WordIndex::ToKey(const wxString& word) { return word.Lower().ToStdWstring(); }
+
+const WordIndex::Node* WordIndex::FindNode(const std::wstring& key) const
+{
+    const Node* node = &m_root;
+    for(wchar_t ch : key) {
+        auto iter = LowerBound(node->children, ch);
+        if(iter == node->children.end() || (*iter)->ch != ch) {
+            return nullptr;
+        }
+        node = iter->get();
+    }
+    return node;
+}
+
+void WordIndex::Add(const wxString& word, size_t count)
+{
+    if(word.empty() || count == 0) {
+        return;
+    }
+
+    Node* node = &m_root;
+    for(wchar_t ch : ToKey(word)) {
+        auto iter = LowerBound(node->children, ch);
+        if(iter == node->children.end() || (*iter)->ch != ch) {
+            auto child = std::make_unique<Node>();
+            child->ch = ch;
+            iter = node->children.insert(iter, std::move(child));
+        }
+        node = iter->get();
+    }
+
+    auto iter = std::find_if(node->words.begin(), node->words.end(), [&](const auto& p) { return p.first == word; });
+    if(iter != node->words.end()) {
+        iter->second += count;
+    } else {
+        node->words.push_back({ word, count });
+        ++m_wordsCount;
+    }
+}
+
+bool WordIndex::DoRemove(Node* node, const wxString& word, const std::wstring& key, size_t depth, size_t count)
+{
+    if(depth == key.length()) {
+        auto iter =
+            std::find_if(node->words.begin(), node->words.end(), [&](const auto& p) { return p.first == word; });
+        if(iter != node->words.end()) {
+            if(iter->second > count) {
+                iter->second -= count;
+            } else {
+                node->words.erase(iter);
+                --m_wordsCount;
+            }
+        }
+
+    } else {
+        auto iter = LowerBound(node->children, key[depth]);
+        if(iter != node->children.end() && (*iter)->ch == key[depth] &&
+           DoRemove(iter->get(), word, key, depth + 1, count)) {
+            // prune the branches that no longer lead to a word
+            node->children.erase(iter);
+        }
+    }
+    return node->words.empty() && node->children.empty();
+}
+
+void WordIndex::Remove(const wxString& word, size_t count)
+{
+    if(word.empty() || count == 0) {
+        return;
+    }
+    DoRemove(&m_root, word, ToKey(word), 0, count);
+}
+
+size_t WordIndex::GetCount(const wxString& word) const
+{
+    const Node* node = FindNode(ToKey(word));
+    if(!node) {
+        return 0;
+    }
+
+    auto iter = std::find_if(node->words.begin(), node->words.end(), [&](const auto& p) { return p.first == word; });
+    return iter == node->words.end() ? 0 : iter->second;
+}
+
+void WordIndex::DoCollect(const Node* node, wxStringSet_t& words) const
+{
+    for(const auto& p : node->words) {
+        words.insert(p.first);
+    }
+    for(const auto& child : node->children) {
+        DoCollect(child.get(), words);
+    }
+}
+
+void WordIndex::FindByPrefix(const wxString& prefix, wxStringSet_t& words) const
+{
+    const Node* node = FindNode(ToKey(prefix));
+    if(node) {
+        DoCollect(node, words);
+    }
+}
+
+void WordIndex::DoCollectContaining(const Node* node, std::wstring& path, const std::wstring& filter,
+                                    wxStringSet_t& words) const
+{
+    if(!node->words.empty() && path.find(filter) != std::wstring::npos) {
+        for(const auto& p : node->words) {
+            words.insert(p.first);
+        }
+    }
+
+    for(const auto& child : node->children) {
+        path.push_back(child->ch);
+        DoCollectContaining(child.get(), path, filter, words);
+        path.pop_back();
+    }
+}
+
+void WordIndex::FindContaining(const wxString& filter, wxStringSet_t& words) const
+{
+    std::wstring path;
+    DoCollectContaining(&m_root, path, ToKey(filter), words);
+}
+
+void WordIndex::Clear()
+{
+    m_root.children.clear();
+    m_root.words.clear();
+    m_wordsCount = 0;
+}
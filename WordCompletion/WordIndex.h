@@ -0,0 +1,75 @@
+#ifndef WORDINDEX_H
+#define WORDINDEX_H
+
+#include "macros.h"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <wx/string.h>
+
+/**
+ * @class WordIndex
+ * @brief the words of the open editors with their number of occurrences. The words are stored in a case insensitive
+ * prefix trie, so the cost of a completion request depends on the number of matches, not on the size of the files
+ */
+class WordIndex
+{
+public:
+    /// word -> number of occurrences (negative when used to remove words)
+    typedef std::unordered_map<wxString, int> Counts_t;
+
+private:
+    struct Node {
+        wchar_t ch = 0;
+        /// sorted by `ch`
+        std::vector<std::unique_ptr<Node>> children;
+        /// the words (in their original case) whose lower case spelling ends here, with their number of occurrences
+        std::vector<std::pair<wxString, size_t>> words;
+    };
+
+    Node m_root;
+    size_t m_wordsCount = 0;
+
+private:
+    static std::wstring ToKey(const wxString& word);
+    const Node* FindNode(const std::wstring& key) const;
+    /// remove `count` occurrences of `word` from the subtree, return true if `node` is left empty
+    bool DoRemove(Node* node, const wxString& word, const std::wstring& key, size_t depth, size_t count);
+    void DoCollect(const Node* node, wxStringSet_t& words) const;
+    void DoCollectContaining(const Node* node, std::wstring& path, const std::wstring& filter,
+                             wxStringSet_t& words) const;
+
+public:
+    WordIndex() = default;
+    ~WordIndex() = default;
+
+    void Add(const wxString& word, size_t count = 1);
+    void Remove(const wxString& word, size_t count = 1);
+
+    /**
+     * @brief return the number of occurrences of `word` (case sensitive)
+     */
+    size_t GetCount(const wxString& word) const;
+
+    /**
+     * @brief add to `words` the words that start with `prefix` (case insensitive)
+     */
+    void FindByPrefix(const wxString& prefix, wxStringSet_t& words) const;
+
+    /**
+     * @brief add to `words` the words that contain `filter` (case insensitive). This visits all the words
+     */
+    void FindContaining(const wxString& filter, wxStringSet_t& words) const;
+
+    /**
+     * @brief the number of distinct words
+     */
+    size_t GetWordsCount() const { return m_wordsCount; }
+
+    void Clear();
+};
+
+#endif // WORDINDEX_H
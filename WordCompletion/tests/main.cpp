@@ -0,0 +1,288 @@
+#include "WordDocument.h"
+#include "WordIndex.h"
+#include "tester.hpp"
+
+#include <random>
+#include <wx/init.h>
+#include <wx/log.h>
+
+namespace
+{
+/// an editor text with the wxStyledTextCtrl line semantics, that reports its changes to a document the way
+/// wxEVT_STC_MODIFIED does
+class TestEditor : public WordDocument::IText
+{
+    wxString m_text;
+    WordDocument& m_document;
+
+    bool IsLineStart(size_t pos) const
+    {
+        // a CRLF is a single line end
+        if(pos == 0 || pos > m_text.length()) {
+            return false;
+        }
+        return m_text[pos - 1] == '\n' ||
+               (m_text[pos - 1] == '\r' && (pos == m_text.length() || m_text[pos] != '\n'));
+    }
+
+public:
+    TestEditor(WordDocument& document, const wxString& text)
+        : m_text(text)
+        , m_document(document)
+    {
+    }
+
+    int LineFromPosition(int pos) const override
+    {
+        int line = 0;
+        for(int i = 1; i <= pos && i <= (int)m_text.length(); ++i) {
+            line += IsLineStart(i) ? 1 : 0;
+        }
+        return line;
+    }
+
+    int PositionFromLine(int line) const override
+    {
+        int pos = 0;
+        for(; line > 0 && pos < (int)m_text.length(); ++pos) {
+            line -= IsLineStart(pos + 1) ? 1 : 0;
+        }
+        return pos;
+    }
+
+    int GetLineEndPosition(int line) const override
+    {
+        int pos = PositionFromLine(line);
+        while(pos < (int)m_text.length() && m_text[pos] != '\r' && m_text[pos] != '\n') {
+            ++pos;
+        }
+        return pos;
+    }
+
+    wxString GetTextRange(int start, int end) const override
+    {
+        return end > start ? m_text.Mid(start, end - start) : wxString();
+    }
+
+    void Insert(int pos, const wxString& text)
+    {
+        m_text.insert(pos, text);
+        m_document.OnInserted(*this, pos, text.length());
+    }
+
+    void Delete(int pos, int length)
+    {
+        m_document.OnDeleting(*this, pos, length);
+        m_text.erase(pos, length);
+        m_document.OnDeleted(*this, pos);
+    }
+
+    const wxString& GetText() const { return m_text; }
+};
+
+/// the document and the index have the words of the whole editor text
+bool has_editor_words(const WordDocument& document, const WordIndex& index, const TestEditor& editor)
+{
+    WordIndex::Counts_t expected;
+    WordDocument::Parse(editor.GetText(), expected);
+    if(document.GetWords() != expected || index.GetWordsCount() != expected.size()) {
+        return false;
+    }
+    for(const auto& [word, count] : expected) {
+        if(index.GetCount(word) != (size_t)count) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// a document that was parsed by the worker thread
+void parse_document(WordDocument& document, const wxString& text)
+{
+    WordIndex::Counts_t words;
+    WordDocument::Parse(text, words);
+    document.SetParsedWords(words);
+}
+} // namespace
+
+TEST_FUNC(test_word_document_parse)
+{
+    WordIndex::Counts_t words;
+    WordDocument::Parse("int count = m_count + count2;\nreturn count", words);
+    CHECK_SIZE(words.size(), 5);
+    CHECK_SIZE(words["count"], 2);
+    CHECK_SIZE(words["count2"], 1);
+    CHECK_SIZE(words["m_count"], 1);
+
+    // removing words
+    WordDocument::Parse("return count", words, -1);
+    CHECK_SIZE(words["count"], 1);
+    CHECK_SIZE(words["return"], 0);
+    return true;
+}
+
+TEST_FUNC(test_word_document_typing_inside_word)
+{
+    WordIndex index;
+    WordDocument document(index, 1);
+    TestEditor editor(document, "int fooBar = 0;\nreturn fooBar;\n");
+    parse_document(document, editor.GetText());
+
+    // type "Baz" in the middle of the first "fooBar", one character at a time
+    editor.Insert(7, "B");
+    CHECK_SIZE(index.GetCount("fooBBar"), 1);
+    editor.Insert(8, "a");
+    editor.Insert(9, "z");
+    CHECK_BOOL(has_editor_words(document, index, editor));
+    CHECK_SIZE(index.GetCount("fooBazBar"), 1);
+    CHECK_SIZE(index.GetCount("fooBar"), 1);
+
+    // split the word with a space, then join it again with a backspace
+    editor.Insert(7, " ");
+    CHECK_SIZE(index.GetCount("foo"), 1);
+    CHECK_SIZE(index.GetCount("BazBar"), 1);
+    CHECK_SIZE(index.GetCount("fooBazBar"), 0);
+    editor.Delete(7, 1);
+    CHECK_BOOL(has_editor_words(document, index, editor));
+
+    // delete the whole word
+    editor.Delete(4, 9);
+    CHECK_BOOL(has_editor_words(document, index, editor));
+    CHECK_SIZE(index.GetCount("fooBazBar"), 0);
+    return true;
+}
+
+TEST_FUNC(test_word_document_crlf)
+{
+    WordIndex index;
+    WordDocument document(index, 1);
+    TestEditor editor(document, "alpha\r\nbeta\r\n");
+    parse_document(document, editor.GetText());
+
+    // insert a word between the CR and the LF: it is on a line of its own
+    editor.Insert(6, "gamma");
+    CHECK_WXSTRING(editor.GetText(), "alpha\rgamma\nbeta\r\n");
+    CHECK_BOOL(has_editor_words(document, index, editor));
+    CHECK_SIZE(index.GetCount("gamma"), 1);
+    editor.Delete(6, 5);
+    CHECK_BOOL(has_editor_words(document, index, editor));
+
+    // split the CRLF by deleting its LF, then join it again
+    editor.Delete(6, 1);
+    CHECK_WXSTRING(editor.GetText(), "alpha\rbeta\r\n");
+    CHECK_BOOL(has_editor_words(document, index, editor));
+    CHECK_SIZE(index.GetCount("alpha"), 1);
+    editor.Insert(6, "\n");
+    CHECK_BOOL(has_editor_words(document, index, editor));
+
+    // the same with its CR
+    editor.Delete(5, 1);
+    CHECK_WXSTRING(editor.GetText(), "alpha\nbeta\r\n");
+    CHECK_BOOL(has_editor_words(document, index, editor));
+    editor.Insert(5, "\r");
+    CHECK_BOOL(has_editor_words(document, index, editor));
+
+    // delete a word so its line end joins the CR of the previous line
+    editor.Insert(6, "delta");
+    editor.Insert(11, "\n");
+    CHECK_WXSTRING(editor.GetText(), "alpha\rdelta\n\nbeta\r\n");
+    editor.Delete(6, 5);
+    CHECK_WXSTRING(editor.GetText(), "alpha\r\n\nbeta\r\n");
+    CHECK_BOOL(has_editor_words(document, index, editor));
+    CHECK_SIZE(index.GetCount("delta"), 0);
+    return true;
+}
+
+TEST_FUNC(test_word_document_multiline_paste_and_delete)
+{
+    WordIndex index;
+    WordDocument document(index, 1);
+    TestEditor editor(document, "first line\nheadtail\r\nlast line\n");
+    parse_document(document, editor.GetText());
+
+    // paste lines in the middle of a word
+    editor.Insert(15, "One two\nthree\r\n\nfour");
+    CHECK_WXSTRING(editor.GetText(), "first line\nheadOne two\nthree\r\n\nfourtail\r\nlast line\n");
+    CHECK_BOOL(has_editor_words(document, index, editor));
+    CHECK_SIZE(index.GetCount("headOne"), 1);
+    CHECK_SIZE(index.GetCount("fourtail"), 1);
+    CHECK_SIZE(index.GetCount("headtail"), 0);
+
+    // delete the lines from the middle of a word to the middle of another
+    editor.Delete(13, 23);
+    CHECK_WXSTRING(editor.GetText(), "first line\nheail\r\nlast line\n");
+    CHECK_BOOL(has_editor_words(document, index, editor));
+    CHECK_SIZE(index.GetCount("heail"), 1);
+    CHECK_SIZE(index.GetCount("three"), 0);
+
+    // undo the paste
+    editor.Delete(0, editor.GetText().length());
+    CHECK_BOOL(has_editor_words(document, index, editor));
+    CHECK_SIZE(index.GetWordsCount(), 0);
+    return true;
+}
+
+TEST_FUNC(test_word_document_changes_before_parse)
+{
+    WordIndex index;
+    WordDocument document(index, 1);
+    TestEditor editor(document, "int value = compute();\nreturn value;\n");
+
+    // the buffer sent to the worker thread, the editor is modified before the reply
+    wxString buffer = editor.GetText();
+    editor.Insert(23, "log(value);\n");
+    editor.Delete(12, 7);
+    editor.Insert(12, "other");
+    CHECK_WXSTRING(editor.GetText(), "int value = other();\nlog(value);\nreturn value;\n");
+    CHECK_BOOL(!document.IsIndexed());
+    CHECK_SIZE(index.GetWordsCount(), 0);
+
+    parse_document(document, buffer);
+    CHECK_BOOL(has_editor_words(document, index, editor));
+    CHECK_SIZE(index.GetCount("value"), 3);
+    CHECK_SIZE(index.GetCount("compute"), 0);
+
+    // from now on, the index is updated with the document
+    editor.Delete(0, 4);
+    CHECK_BOOL(has_editor_words(document, index, editor));
+    CHECK_SIZE(index.GetCount("int"), 0);
+
+    document.RemoveFromIndex();
+    CHECK_SIZE(index.GetWordsCount(), 0);
+    return true;
+}
+
+TEST_FUNC(test_word_document_random_edits)
+{
+    WordIndex index;
+    WordDocument document(index, 1);
+    TestEditor editor(document, "");
+    parse_document(document, editor.GetText());
+
+    // short words and all kinds of line ends
+    const wxString pieces[] = { "a", "b", "ab", " ", "\r", "\n", "\r\n", "x1", "\n\r" };
+    std::mt19937 generator(1);
+    for(size_t i = 0; i < 2000; ++i) {
+        int length = editor.GetText().length();
+        if(length > 0 && generator() % 3 == 0) {
+            int pos = generator() % length;
+            editor.Delete(pos, 1 + generator() % std::min(length - pos, 4));
+        } else {
+            wxString text;
+            for(size_t count = 1 + generator() % 3; count > 0; --count) {
+                text << pieces[generator() % 9];
+            }
+            editor.Insert(length > 0 ? generator() % (length + 1) : 0, text);
+        }
+        CHECK_BOOL(has_editor_words(document, index, editor));
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    wxInitializer initializer(argc, argv);
+    wxLogNull NOLOG;
+    bool benchmarks = argc > 1 && wxString(argv[1]) == "--benchmark";
+    return Tester::Instance()->RunTests(benchmarks);
+}
@@ -4,7 +4,6 @@
 #include "Keyboard/clKeyboardManager.h"
 #include "WordCompletionDictionary.h"
 #include "WordCompletionSettingsDlg.h"
-#include "WordCompletionThread.h"
 #include "cl_command_event.h"
 #include "event_notifier.h"
 #include "globals.h"
@@ -103,21 +102,20 @@ void WordCompletionPlugin::OnWordComplete(clCodeCompletionEvent& event)
 
     wxString filter = event.GetWord().Lower(); // stc->GetTextRange(start, curPos);
 
-    wxStringSet_t words = m_dictionary->GetWords();
-    // Parse the current buffer (if modified), to include non saved words
-    if(activeEditor->IsEditorModified()) {
-        // For performance (this parsing is done in the main thread)
-        // only parse the visible area of the document
-        wxStringSet_t unsavedBufferWords;
-        wxStyledTextCtrl* stc = activeEditor->GetCtrl();
-        int startPos = stc->PositionFromLine(stc->GetFirstVisibleLine());
-        int endPos = stc->GetCurrentPos();
-
-        wxString buffer = stc->GetTextRange(startPos, endPos);
-        WordCompletionThread::ParseBuffer(buffer, unsavedBufferWords);
-
-        // Merge the results
-        words.insert(unsavedBufferWords.begin(), unsavedBufferWords.end());
+    // The index is kept up to date with the editors content (including the unsaved changes), so we only need to
+    // look up the matching words
+    const WordIndex& index = m_dictionary->GetIndex();
+    wxStringSet_t words;
+    if(settings.GetComparisonMethod() == WordCompletionSettings::kComparisonStartsWith) {
+        index.FindByPrefix(filter, words);
+    } else {
+        index.FindContaining(filter, words);
+    }
+
+    // The word being typed is in the index as well: don't suggest it, unless it also appears elsewhere
+    const wxString& typedWord = event.GetWord();
+    if(!typedWord.IsEmpty() && index.GetCount(typedWord) <= 1) {
+        words.erase(typedWord);
     }
 
     // Get the editor keywords and add them
@@ -128,28 +126,20 @@ void WordCompletionPlugin::OnWordComplete(clCodeCompletionEvent& event)
             keywords << lexer->GetKeyWords(i) << " ";
         }
         wxArrayString langWords = ::wxStringTokenize(keywords, "\n\t \r", wxTOKEN_STRTOK);
-        words.insert(langWords.begin(), langWords.end());
-    }
-
-    wxStringSet_t filteredSet;
-    if(filter.IsEmpty()) {
-        filteredSet.swap(words);
-    } else {
-        for (const auto& word : words) {
+        for (const auto& word : langWords) {
             wxString lcWord = word.Lower();
-            if(settings.GetComparisonMethod() == WordCompletionSettings::kComparisonStartsWith) {
-                if(lcWord.StartsWith(filter) && filter != word) {
-                    filteredSet.insert(word);
-                }
-            } else {
-                if(lcWord.Contains(filter) && filter != word) {
-                    filteredSet.insert(word);
-                }
+            bool matches = settings.GetComparisonMethod() == WordCompletionSettings::kComparisonStartsWith
+                               ? lcWord.StartsWith(filter)
+                               : lcWord.Contains(filter);
+            if(matches) {
+                words.insert(word);
             }
         }
     }
+
+    words.erase(filter);
     wxCodeCompletionBoxEntry::Vec_t entries;
-    for (const auto& text : filteredSet) {
+    for (const auto& text : words) {
         entries.push_back(wxCodeCompletionBoxEntry::New(text, sBmp));
     }
     event.GetEntries().insert(event.GetEntries().end(), entries.begin(), entries.end());
@@ -1,6 +1,5 @@
 #include "Channel.hpp"
 
-#include "LSP/Message.h"
 #include "file_logger.h"
 
 #include <iostream>
@@ -20,7 +19,7 @@ eReadSome ChannelSocket::read_some()
     size_t bytes_read = 0;
     switch(client->Read(buffer, sizeof(buffer), bytes_read)) {
     case clSocketBase::kSuccess:
-        m_buffer.append(buffer, bytes_read);
+        m_framer.Append(buffer, bytes_read);
         return eReadSome::kSuccess;
     case clSocketBase::kTimeout:
         return eReadSome::kTimeout;
@@ -56,7 +55,7 @@ bool ChannelSocket::write_reply(const wxString& message)
 std::unique_ptr<JSON> ChannelSocket::read_message()
 {
     while(true) {
-        auto msg = LSP::Message::GetJSONPayload(m_buffer);
+        auto msg = m_framer.NextJSON();
         if(msg) {
             return msg;
         }
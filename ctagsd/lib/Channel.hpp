@@ -2,6 +2,7 @@
 #define CHANNEL_HPP
 
 #include "JSON.h"
+#include "LSP/MessageFramer.hpp"
 #include "SocketAPI/clSocketServer.h"
 
 #include <memory>
@@ -27,7 +28,7 @@ public:
 // socket based channel
 class ChannelSocket : public Channel
 {
-    std::string m_buffer;
+    LSP::MessageFramer m_framer;
     wxString m_ip;
     int m_port = -1;
     clSocketBase::Ptr_t client;
@@ -3,6 +3,7 @@
 #include "SimpleTokenizer.hpp"
 #include "macros.h"
 
+#include <algorithm>
 #include <array>
 
 void LSPUtils::encode_semantic_tokens(const std::vector<TokenWrapper>& tokens_vec, std::vector<int>* encoded_arr)
@@ -47,6 +48,32 @@ void LSPUtils::encode_semantic_tokens(const std::vector<TokenWrapper>& tokens_ve
     }
 }
 
+bool LSPUtils::diff_semantic_tokens(const std::vector<int>& prev, const std::vector<int>& curr, size_t* start,
+                                    size_t* delete_count, std::vector<int>* data)
+{
+    // skip the common prefix and suffix, everything in between is the edit
+    size_t prefix = 0;
+    size_t max_prefix = std::min(prev.size(), curr.size());
+    while(prefix < max_prefix && prev[prefix] == curr[prefix]) {
+        ++prefix;
+    }
+
+    if(prefix == prev.size() && prefix == curr.size()) {
+        return false;
+    }
+
+    size_t suffix = 0;
+    size_t max_suffix = max_prefix - prefix;
+    while(suffix < max_suffix && prev[prev.size() - suffix - 1] == curr[curr.size() - suffix - 1]) {
+        ++suffix;
+    }
+
+    *start = prefix;
+    *delete_count = prev.size() - prefix - suffix;
+    data->assign(curr.begin() + prefix, curr.end() - suffix);
+    return true;
+}
+
 LSP::eSymbolKind LSPUtils::get_symbol_kind(const TagEntry* tag)
 {
     LSP::eSymbolKind kind = LSP::eSymbolKind::kSK_Variable;
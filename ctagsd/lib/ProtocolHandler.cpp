@@ -20,16 +20,27 @@
 #include "fileextmanager.h"
 #include "tags_options_data.h"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <deque>
 #include <iostream>
+#include <mutex>
+#include <thread>
 #include <wx/filesys.h>
 #include <wx/stackwalk.h>
+#include <wx/stopwatch.h>
+#include <wx/thread.h>
 
 using LSP::CompletionItem;
 using LSP::eSymbolKind;
 
 namespace
 {
+// when the database is empty and we have at least this number of files to parse, store the tags first and build the
+// search indexes once, at the end (see ITagsStorage::BeginBulkLoad())
+constexpr size_t BULK_LOAD_MIN_FILES = 500;
+
 FileLogger& operator<<(FileLogger& logger, const TagEntry& tag)
 {
     wxString s;
@@ -72,6 +83,16 @@ inline size_t count_lines(const wxString& content)
     return lf_count;
 }
 
+/**
+ * @brief return true if editing `lines` might change the list of included files or the `using namespace`
+ * statements of the file
+ */
+inline bool may_change_preamble(const wxString& lines)
+{
+    return lines.Contains("#") || lines.Contains("using") || lines.Contains("/*") || lines.Contains("*/") ||
+           lines.Contains("\\");
+}
+
 /**
  * @brief given a list of files, remove all non c/c++ files from it
  */
@@ -213,21 +234,116 @@ void ProtocolHandler::parse_file(const wxFileName& filename, const CTagsdSetting
 void ProtocolHandler::do_parse_chunk(ITagsStoragePtr db,
                                      const std::vector<wxString>& file_list,
                                      size_t chunk_id,
-                                     const CTagsdSettings& settings)
+                                     const CTagsdSettings& settings,
+                                     const FingerprintMap_t& fingerprints)
 {
     std::vector<TagEntryPtr> tags;
     LOG_IF_DEBUG { clDEBUG() << "Parsing chunk (" << chunk_id << ") of" << file_list.size() << "files" << endl; }
+    wxStopWatch sw;
     if (CTags::ParseFiles(file_list, settings.GetCodeliteIndexer(), settings.GetMacroTable(), tags) == 0) {
         clDEBUG() << "0 tags generated. processed:" << file_list.size()
                   << "files. Indexer:" << settings.GetCodeliteIndexer() << endl;
         return;
     }
+    long parse_ms = sw.Time();
 
     LOG_IF_TRACE
     {
         clDEBUG1() << "Success" << endl;
         clDEBUG1() << "Updating symbols database..." << endl;
     }
+    sw.Start();
+    do_store_chunk(db, file_list, tags, fingerprints);
+    clDEBUG() << "Chunk (" << chunk_id << "):" << file_list.size() << "files," << tags.size()
+              << "tags. Parse:" << parse_ms << "ms, store:" << sw.Time() << "ms" << endl;
+}
+
+void ProtocolHandler::do_parse_chunks_parallel(ITagsStoragePtr db,
+                                               const std::vector<std::vector<wxString>>& chunks,
+                                               size_t threads,
+                                               const CTagsdSettings& settings,
+                                               const FingerprintMap_t& fingerprints)
+{
+    struct ParsedChunk {
+        size_t chunk_id = 0;
+        std::vector<TagEntryPtr> tags;
+        long parse_ms = 0;
+    };
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<ParsedChunk> parsed_chunks;
+    std::atomic_size_t next_chunk{ 0 };
+
+    // build these once, instead of once per chunk
+    const wxString codelite_indexer = settings.GetCodeliteIndexer();
+    const wxStringMap_t macro_table = settings.GetMacroTable();
+
+    auto parser = [&]() {
+        while (true) {
+            size_t chunk_id = next_chunk.fetch_add(1);
+            if (chunk_id >= chunks.size()) {
+                break;
+            }
+
+            ParsedChunk parsed;
+            parsed.chunk_id = chunk_id;
+            LOG_IF_DEBUG
+            {
+                clDEBUG() << "Parsing chunk (" << chunk_id << ") of" << chunks[chunk_id].size() << "files" << endl;
+            }
+            wxStopWatch sw;
+            CTags::ParseFiles(chunks[chunk_id], codelite_indexer, macro_table, parsed.tags);
+            parsed.parse_ms = sw.Time();
+
+            std::unique_lock<std::mutex> lk{ mutex };
+            // don't let the parsers run too far ahead of the writer, the tags are kept in memory until stored
+            cv.wait(lk, [&]() { return parsed_chunks.size() < threads; });
+            parsed_chunks.push_back(std::move(parsed));
+            cv.notify_all();
+        }
+    };
+
+    std::vector<std::thread> parsers;
+    parsers.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        parsers.emplace_back(parser);
+    }
+
+    // this thread is the only one writing to the database
+    for (size_t stored = 0; stored < chunks.size(); ++stored) {
+        ParsedChunk parsed;
+        {
+            std::unique_lock<std::mutex> lk{ mutex };
+            cv.wait(lk, [&]() { return !parsed_chunks.empty(); });
+            parsed = std::move(parsed_chunks.front());
+            parsed_chunks.pop_front();
+            cv.notify_all();
+        }
+
+        const auto& file_list = chunks[parsed.chunk_id];
+        if (parsed.tags.empty()) {
+            clDEBUG() << "0 tags generated. processed:" << file_list.size()
+                      << "files. Indexer:" << codelite_indexer << endl;
+            continue;
+        }
+
+        wxStopWatch sw;
+        do_store_chunk(db, file_list, parsed.tags, fingerprints);
+        clDEBUG() << "Chunk (" << parsed.chunk_id << "):" << file_list.size() << "files," << parsed.tags.size()
+                  << "tags. Parse:" << parsed.parse_ms << "ms, store:" << sw.Time() << "ms" << endl;
+    }
+
+    for (auto& parser_thread : parsers) {
+        parser_thread.join();
+    }
+}
+
+void ProtocolHandler::do_store_chunk(ITagsStoragePtr db,
+                                     const std::vector<wxString>& file_list,
+                                     const std::vector<TagEntryPtr>& tags,
+                                     const FingerprintMap_t& fingerprints)
+{
     LOG_IF_DEBUG { clDEBUG() << "Storing" << tags.size() << "tags" << endl; }
     db->Begin();
 
@@ -238,7 +354,13 @@ void ProtocolHandler::do_parse_chunk(ITagsStoragePtr db,
     // we do this here, since some files might not yield tags
     // but we still want to mark them as "parsed"
     for (const wxString& file : file_list) {
-        if (db->InsertFileEntry(file, (int)update_time) == TagExist) {
+        auto iter = fingerprints.find(file);
+        if (iter != fingerprints.end()) {
+            // keep the fingerprint taken before parsing the file, if it was modified since, we will parse it again
+            FileEntry entry = *iter->second;
+            entry.SetLastRetaggedTimestamp((int)update_time);
+            db->StoreFileEntry(entry);
+        } else if (db->InsertFileEntry(file, (int)update_time) == TagExist) {
             db->UpdateFileEntry(file, (int)update_time);
         }
     }
@@ -265,8 +387,16 @@ void ProtocolHandler::parse_files(const std::vector<wxString>& file_list, const
         files_to_parse.Add(file);
     }
 
-    TagsManagerST::Get()->FilterNonNeededFilesForRetaging(files_to_parse, db);
+    std::vector<FileEntryPtr> fingerprints_list;
+    TagsManagerST::Get()->FilterNonNeededFilesForRetaging(files_to_parse, db, &fingerprints_list);
     std::vector<wxString> filtered_file_list = {files_to_parse.begin(), files_to_parse.end()};
+
+    FingerprintMap_t fingerprints;
+    fingerprints.reserve(fingerprints_list.size());
+    for (auto& entry : fingerprints_list) {
+        wxString file = entry->GetFile();
+        fingerprints.insert({ file, std::move(entry) });
+    }
     clDEBUG() << "There are total of" << filtered_file_list.size() << "files that require parsing" << endl;
     clDEBUG() << "Generating ctags file..." << endl;
 
@@ -274,11 +404,20 @@ void ProtocolHandler::parse_files(const std::vector<wxString>& file_list, const
         return;
     }
 
+    size_t threads = settings.GetIndexerThreads();
+    if (threads == 0) {
+        threads = wxThread::GetCPUCount() > 0 ? wxThread::GetCPUCount() : 1;
+    }
+
     // don't parse all files at once, split them into chunks
-    // how many chunks?
+    // how many chunks? when running in parallel, use smaller chunks so all the indexers get work
     size_t chunk_size = 2500;
+    if (threads > 1) {
+        chunk_size = std::clamp<size_t>(filtered_file_list.size() / threads + 1, 250, chunk_size);
+    }
     size_t chunk_count = filtered_file_list.size() / chunk_size + 1;
-    clDEBUG() << "Parsing" << filtered_file_list.size() << "files..." << endl;
+    std::vector<std::vector<wxString>> chunks;
+    chunks.reserve(chunk_count);
     for (size_t i = 0; i < chunk_count; ++i) {
         // determine the start/end iterators for each range
         size_t start_offset = i * chunk_size;
@@ -293,10 +432,31 @@ void ProtocolHandler::parse_files(const std::vector<wxString>& file_list, const
         if ((start_offset + chunk_size) > filtered_file_list.size()) {
             iter_end = filtered_file_list.end();
         }
-        std::vector<wxString> chunk_vec{iter_start, iter_end};
-        do_parse_chunk(db, chunk_vec, i, settings);
+        chunks.emplace_back(iter_start, iter_end);
     }
-    clDEBUG() << "Success" << endl;
+
+    threads = std::min(threads, chunks.size());
+    clDEBUG() << "Parsing" << filtered_file_list.size() << "files in" << chunks.size() << "chunks using" << threads
+              << "indexers..." << endl;
+    wxStopWatch sw;
+    bool bulk_load = filtered_file_list.size() >= BULK_LOAD_MIN_FILES && !db->HasTags();
+    if (bulk_load) {
+        db->BeginBulkLoad();
+    }
+
+    if (threads > 1) {
+        do_parse_chunks_parallel(db, chunks, threads, settings, fingerprints);
+    } else {
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            do_parse_chunk(db, chunks[i], i, settings, fingerprints);
+        }
+    }
+
+    if (bulk_load) {
+        db->EndBulkLoad();
+    }
+    clSYSTEM() << "Success. Parsing" << filtered_file_list.size() << "files took" << sw.Time() << "ms ("
+               << (bulk_load ? "bulk load" : "incremental") << ")" << endl;
 }
 
 std::vector<wxString> ProtocolHandler::update_additional_scopes_for_file(const wxString& filepath)
@@ -365,7 +525,8 @@ bool ProtocolHandler::ensure_file_content_exists(const wxString& filepath, Chann
 
         // update the cache
         clDEBUG() << "Updated cache with non existing file:" << filepath << "is not opened" << endl;
-        m_filesOpened.insert({filepath, file_content});
+        m_filesOpened.insert({filepath, TextDocument{file_content}});
+        invalidate_semantic_tokens(filepath);
     }
     return true;
 }
@@ -440,10 +601,16 @@ void ProtocolHandler::on_initialize(std::unique_ptr<JSON>&& msg, Channel::ptr_t
     capabilities.addProperty("definitionProvider", true);
     capabilities.addProperty("documentSymbolProvider", true);
     capabilities.addProperty("hoverProvider", true);
+    auto textDocumentSync = capabilities.AddObject("textDocumentSync");
+    textDocumentSync.addProperty("openClose", true);
+    textDocumentSync.addProperty("change", 2); // TextDocumentSyncKind.Incremental
+    auto save = textDocumentSync.AddObject("save");
+    save.addProperty("includeText", true);
     auto semanticTokensProvider = capabilities.AddObject("semanticTokensProvider");
     auto full = semanticTokensProvider.AddObject("full");
     auto legend = semanticTokensProvider.AddObject("legend");
     full.addProperty("delta", true);
+    semanticTokensProvider.addProperty("range", true);
 
     legend.AddArray("tokenModifiers"); // empty array
     auto tokenTypes = legend.AddArray("tokenTypes");
@@ -560,7 +727,8 @@ void ProtocolHandler::on_did_open(std::unique_ptr<JSON>&& msg, Channel::ptr_t ch
     parse_file(filepath, m_settings);
 
     // keep the file content in-cache
-    m_filesOpened.insert({filepath, file_content});
+    m_filesOpened.insert({filepath, TextDocument{file_content}});
+    invalidate_semantic_tokens(filepath);
 }
 
 // Notification -->
@@ -577,6 +745,7 @@ void ProtocolHandler::on_did_close(std::unique_ptr<JSON>&& msg, Channel::ptr_t c
     m_comments_cache.erase(filepath);
     m_parsed_files_info.erase(filepath);
     m_additional_scopes.erase(filepath);
+    m_semantic_tokens_cache.erase(filepath);
 }
 
 // Notification -->
@@ -592,32 +761,55 @@ void ProtocolHandler::on_did_change(std::unique_ptr<JSON>&& msg, Channel::ptr_t
     filepath = wxFileSystem::URLToFileName(filepath).GetFullPath();
 
     // Check if a real change was made that requires parsing
-    size_t line_count_before = 0;
-    size_t line_count_after = 0;
-    if (m_filesOpened.count(filepath)) {
-        line_count_before = count_lines(m_filesOpened[filepath]);
-    }
-    wxString file_content = json["params"]["contentChanges"][0]["text"].toString();
-    line_count_after = count_lines(file_content);
+    auto& document = m_filesOpened[filepath];
+    size_t line_count_before = document.GetLineFeedsCount();
+    invalidate_semantic_tokens(filepath);
+
+    // apply the changes. With incremental sync, each change is a range edit, otherwise the change contains the
+    // entire document
+    clDEBUG() << "textDocument/didChange: updating content for file:" << filepath << endl;
+    bool preamble_changed = false;
+    auto content_changes = json["params"]["contentChanges"];
+    int changes_count = content_changes.arraySize();
+    for (int i = 0; i < changes_count; ++i) {
+        auto change = content_changes[i];
+        wxString text = change["text"].toString();
+        if (!change.hasNamedObject("range")) {
+            document.SetText(text);
+            preamble_changed = true;
+            continue;
+        }
 
-    // update the new content
-    clDEBUG() << "textDocument/didChange: caching new content for file:" << filepath << endl;
-    m_filesOpened.erase(filepath);
+        auto range = change["range"];
+        size_t start_line = range["start"]["line"].toSize_t();
+        size_t start_character = range["start"]["character"].toSize_t();
+        size_t end_line = range["end"]["line"].toSize_t();
+        size_t end_character = range["end"]["character"].toSize_t();
+
+        // check the lines touched by this edit, before and after the change
+        preamble_changed = preamble_changed || may_change_preamble(document.GetLines(start_line, end_line));
+        document.Replace(start_line, start_character, end_line, end_character, text);
+        preamble_changed =
+            preamble_changed || may_change_preamble(document.GetLines(start_line, start_line + count_lines(text)));
+    }
+    size_t line_count_after = document.GetLineFeedsCount();
     m_comments_cache.erase(filepath);
-    m_filesOpened.insert({filepath, file_content});
-    clDEBUG() << "Updating content for file:" << filepath << endl;
 
     // we compare the preamble of both before and after the file
     // modification
     // if we see a difference, i.e. new header file was added
-
-    // Note: we make a copy here since the call to `parse_buffer_for_includes_and_using_namespace()`
-    // will update `m_parsed_files_info[filepath].included_files`
-    auto prev_preamble = m_parsed_files_info.count(filepath) ? m_parsed_files_info[filepath].included_files : empty_set;
-    parse_buffer_for_includes_and_using_namespace(filepath, file_content);
-    const auto& curr_preabmle = m_parsed_files_info[filepath].included_files;
-    auto diff = setdiff(curr_preabmle, prev_preamble);
     wxArrayString new_includes;
+    wxStringSet_t diff;
+    if (preamble_changed || m_parsed_files_info.count(filepath) == 0) {
+        // Note: we make a copy here since the call to `parse_buffer_for_includes_and_using_namespace()`
+        // will update `m_parsed_files_info[filepath].included_files`
+        auto prev_preamble =
+            m_parsed_files_info.count(filepath) ? m_parsed_files_info[filepath].included_files : empty_set;
+        parse_buffer_for_includes_and_using_namespace(filepath, document.GetText());
+        const auto& curr_preabmle = m_parsed_files_info[filepath].included_files;
+        diff = setdiff(curr_preabmle, prev_preamble);
+    }
+
     if (!diff.empty()) {
         // curr_preabmle contains new headers that do not exist in the
         // previous preamble - parse them
@@ -634,6 +826,7 @@ void ProtocolHandler::on_did_change(std::unique_ptr<JSON>&& msg, Channel::ptr_t
         clDEBUG() << "Re-parsing file:" << filepath << endl;
         wxString indexer_path = m_settings.GetCodeliteIndexer();
         wxString settings_folder = m_settings_folder;
+        wxString file_content = document.GetText();
         ParseThreadTaskFunc buffer_parse_task = [=, this]() {
             clDEBUG() << "on_did_change(): parsing file task" << filepath << endl;
             ProtocolHandler::parse_buffer(filepath, file_content, m_settings);
@@ -676,7 +869,7 @@ wxString ProtocolHandler::minimize_buffer(const wxString& filepath,
     auto curr_function_tag = m_completer->get_current_function_tag();
     if (curr_function_tag) {
         // remove all the text from the start of text -> scope starting position
-        const wxString& orig_text = m_filesOpened[filepath];
+        const wxString& orig_text = m_filesOpened[filepath].GetText();
 
         wxArrayString lines = ::wxStringTokenize(orig_text, "\n", wxTOKEN_RET_EMPTY_ALL);
         if ((size_t)curr_function_tag->GetLine() < lines.size()) {
@@ -693,7 +886,7 @@ wxString ProtocolHandler::minimize_buffer(const wxString& filepath,
         }
     } else {
         // use the entire file content
-        text = helper.truncate_file_to_location(m_filesOpened[filepath], line, character, flag);
+        text = helper.truncate_file_to_location(m_filesOpened[filepath].GetText(), line, character, flag);
         LOG_IF_TRACE { clDEBUG1() << "Unable to minimize the buffer, using the complete buffer" << endl; }
     }
     return text;
@@ -719,7 +912,7 @@ void ProtocolHandler::on_completion(std::unique_ptr<JSON>&& msg, Channel::ptr_t
     wxString last_word;
     CompletionHelper helper;
     wxString suffix;
-    const wxString& full_buffer = m_filesOpened[filepath];
+    const wxString& full_buffer = m_filesOpened[filepath].GetText();
     bool is_include_completion = false;
     wxString file_name;
     std::vector<TagEntryPtr> candidates;
@@ -866,7 +1059,8 @@ void ProtocolHandler::on_did_save(std::unique_ptr<JSON>&& msg, Channel::ptr_t ch
     clDEBUG() << "new file content size is:" << file_content.size() << endl;
 
     m_filesOpened.erase(filepath);
-    m_filesOpened.insert({filepath, file_content});
+    m_filesOpened.insert({filepath, TextDocument{file_content}});
+    invalidate_semantic_tokens(filepath);
 
     // update the file using namespace
     clDEBUG() << "did_save: collecting files to parse..." << endl;
@@ -920,22 +1114,24 @@ void add_to_types_set(const wxString& name, wxStringSet_t& types, const wxString
 }
 } // namespace
 
-// Request <-->
-void ProtocolHandler::on_semantic_tokens(std::unique_ptr<JSON>&& msg, Channel::ptr_t channel)
+SemanticTokensCache& ProtocolHandler::get_semantic_tokens(const wxString& filepath)
 {
-    JSONItem json = msg->toElement();
-    LOG_IF_TRACE { clDEBUG1() << json.format() << endl; }
-    wxString filepath_uri = json["params"]["textDocument"]["uri"].toString();
-    wxString filepath = wxFileSystem::URLToFileName(filepath_uri).GetFullPath();
-    clDEBUG() << "textDocument/semanticTokens/full: for file" << filepath << endl;
+    auto& cache = m_semantic_tokens_cache[filepath];
+    if (cache.valid) {
+        clDEBUG() << "Using cached semantic tokens for file" << filepath << endl;
+        return cache;
+    }
 
     // use CTags to gather local variables
     wxString tmpdir = clStandardPaths::Get().GetTempDir();
     std::vector<TagEntryPtr> tags;
 
     // get list of local tags
-    CTags::ParseLocals(
-        filepath, m_filesOpened[filepath], m_settings.GetCodeliteIndexer(), m_settings.GetMacroTable(), tags);
+    CTags::ParseLocals(filepath,
+                       m_filesOpened[filepath].GetText(),
+                       m_settings.GetCodeliteIndexer(),
+                       m_settings.GetMacroTable(),
+                       tags);
 
     LOG_IF_TRACE { clDEBUG1() << "File tags:" << tags.size() << endl; }
     wxStringSet_t locals_set;
@@ -980,7 +1176,7 @@ void ProtocolHandler::on_semantic_tokens(std::unique_ptr<JSON>&& msg, Channel::p
     LOG_IF_TRACE { clDEBUG1() << "Locals:" << locals_set << endl; }
     LOG_IF_TRACE { clDEBUG1() << "Types:" << types_set << endl; }
 
-    const wxString& buffer = m_filesOpened[filepath];
+    const wxString& buffer = m_filesOpened[filepath].GetText();
 
     // collect all interesting tokens from the document
     SimpleTokenizer tokenizer(buffer);
@@ -1059,17 +1255,151 @@ void ProtocolHandler::on_semantic_tokens(std::unique_ptr<JSON>&& msg, Channel::p
         tokens_vec.emplace_back(vt.second);
     }
 
+    // keep the type of each word, for range requests
+    cache.types.clear();
+    cache.types.reserve(tokens_vec.size());
+    for (const auto& token : tokens_vec) {
+        cache.types.insert({ token.token.to_string(buffer), token.type });
+    }
+
+    // the delta and range requests expect the tokens sorted by their position
+    std::sort(tokens_vec.begin(), tokens_vec.end(), [](const TokenWrapper& a, const TokenWrapper& b) {
+        return a.token.line() < b.token.line() ||
+               (a.token.line() == b.token.line() && a.token.column() < b.token.column());
+    });
+    cache.tokens.swap(tokens_vec);
+    cache.valid = true;
+
+    clDEBUG() << "Found" << cache.tokens.size() << "semantic tokens" << endl;
+    return cache;
+}
+
+void ProtocolHandler::invalidate_semantic_tokens(const wxString& filepath)
+{
+    auto iter = m_semantic_tokens_cache.find(filepath);
+    if (iter != m_semantic_tokens_cache.end()) {
+        // keep the last result, it is the base for the next delta request
+        iter->second.valid = false;
+        iter->second.types.clear();
+        iter->second.tokens.clear();
+    }
+}
+
+// Request <-->
+void ProtocolHandler::on_semantic_tokens(std::unique_ptr<JSON>&& msg, Channel::ptr_t channel)
+{
+    JSONItem json = msg->toElement();
+    LOG_IF_TRACE { clDEBUG1() << json.format() << endl; }
+    wxString filepath_uri = json["params"]["textDocument"]["uri"].toString();
+    wxString filepath = wxFileSystem::URLToFileName(filepath_uri).GetFullPath();
+    clDEBUG() << "textDocument/semanticTokens/full: for file" << filepath << endl;
+
+    auto& cache = get_semantic_tokens(filepath);
+    cache.data.clear();
+    LSPUtils::encode_semantic_tokens(cache.tokens, &cache.data);
+    cache.result_id.clear();
+    cache.result_id << ++m_semantic_tokens_result_id;
+
     // build the response
     size_t id = json["id"].toSize_t();
     JSON root(cJSON_Object);
     JSONItem response = root.toElement();
     auto result = build_result(response, id, cJSON_Object);
+    result.addProperty("resultId", cache.result_id);
+    result.addProperty("data", cache.data);
+    LOG_IF_TRACE { clDEBUG1() << response.format() << endl; }
+    channel->write_reply(response);
+}
+
+// Request <-->
+void ProtocolHandler::on_semantic_tokens_delta(std::unique_ptr<JSON>&& msg, Channel::ptr_t channel)
+{
+    JSONItem json = msg->toElement();
+    LOG_IF_TRACE { clDEBUG1() << json.format() << endl; }
+    wxString filepath_uri = json["params"]["textDocument"]["uri"].toString();
+    wxString filepath = wxFileSystem::URLToFileName(filepath_uri).GetFullPath();
+    wxString previous_result_id = json["params"]["previousResultId"].toString();
+    clDEBUG() << "textDocument/semanticTokens/full/delta: for file" << filepath << endl;
+
+    auto& cache = get_semantic_tokens(filepath);
+    bool send_edits = !cache.result_id.empty() && cache.result_id == previous_result_id;
 
     std::vector<int> encoding;
-    encoding.reserve(5 * tokens_vec.size());
+    LSPUtils::encode_semantic_tokens(cache.tokens, &encoding);
 
-    clDEBUG() << "Found" << tokens_vec.size() << "semantic tokens" << endl;
+    size_t id = json["id"].toSize_t();
+    JSON root(cJSON_Object);
+    JSONItem response = root.toElement();
+    auto result = build_result(response, id, cJSON_Object);
+
+    cache.result_id.clear();
+    cache.result_id << ++m_semantic_tokens_result_id;
+    result.addProperty("resultId", cache.result_id);
+
+    if (send_edits) {
+        // the client has the previous result, send only what changed
+        auto edits = result.AddArray("edits");
+        size_t start = 0;
+        size_t delete_count = 0;
+        std::vector<int> data;
+        if (LSPUtils::diff_semantic_tokens(cache.data, encoding, &start, &delete_count, &data)) {
+            auto edit = JSONItem::createObject();
+            edit.addProperty("start", start);
+            edit.addProperty("deleteCount", delete_count);
+            edit.addProperty("data", data);
+            edits.arrayAppend(edit);
+        }
+        clDEBUG() << "Sending semantic tokens edit:" << data.size() << "of" << encoding.size() << "integers" << endl;
+    } else {
+        result.addProperty("data", encoding);
+    }
+    cache.data.swap(encoding);
+
+    LOG_IF_TRACE { clDEBUG1() << response.format() << endl; }
+    channel->write_reply(response);
+}
+
+// Request <-->
+void ProtocolHandler::on_semantic_tokens_range(std::unique_ptr<JSON>&& msg, Channel::ptr_t channel)
+{
+    JSONItem json = msg->toElement();
+    LOG_IF_TRACE { clDEBUG1() << json.format() << endl; }
+    wxString filepath_uri = json["params"]["textDocument"]["uri"].toString();
+    wxString filepath = wxFileSystem::URLToFileName(filepath_uri).GetFullPath();
+    auto range = json["params"]["range"];
+    long from_line = range["start"]["line"].toInt(0);
+    long to_line = range["end"]["line"].toInt(0);
+    clDEBUG() << "textDocument/semanticTokens/range: for file" << filepath << "lines:" << from_line << "-" << to_line
+              << endl;
+
+    const auto& cache = get_semantic_tokens(filepath);
+
+    // tokenize the requested lines only, reporting the first occurrence of each known word
+    std::vector<TokenWrapper> tokens_vec;
+    if (from_line >= 0 && to_line >= from_line) {
+        wxString lines = m_filesOpened[filepath].GetLines(from_line, to_line);
+        SimpleTokenizer tokenizer(lines);
+        TokenWrapper token_wrapper;
+        wxStringSet_t visited;
+        while (tokenizer.next(&token_wrapper.token)) {
+            auto word = token_wrapper.token.to_string(lines);
+            auto iter = cache.types.find(word);
+            if (iter == cache.types.end() || !visited.insert(word).second) {
+                continue;
+            }
+            token_wrapper.type = iter->second;
+            token_wrapper.token.set_line(token_wrapper.token.line() + from_line);
+            tokens_vec.emplace_back(token_wrapper);
+        }
+    }
+
+    std::vector<int> encoding;
     LSPUtils::encode_semantic_tokens(tokens_vec, &encoding);
+
+    size_t id = json["id"].toSize_t();
+    JSON root(cJSON_Object);
+    JSONItem response = root.toElement();
+    auto result = build_result(response, id, cJSON_Object);
     result.addProperty("data", encoding);
     LOG_IF_TRACE { clDEBUG1() << response.format() << endl; }
     channel->write_reply(response);
@@ -1118,8 +1448,11 @@ void ProtocolHandler::on_document_symbol(std::unique_ptr<JSON>&& msg, Channel::p
 
     // parse hte buffer
     std::vector<TagEntryPtr> tags;
-    CTags::ParseBuffer(
-        filepath, m_filesOpened[filepath], m_settings.GetCodeliteIndexer(), m_settings.GetMacroTable(), tags);
+    CTags::ParseBuffer(filepath,
+                       m_filesOpened[filepath].GetText(),
+                       m_settings.GetCodeliteIndexer(),
+                       m_settings.GetMacroTable(),
+                       tags);
     if (tags.empty()) {
         clDEBUG() << "no tags were found in file:" << filepath << endl;
     }
@@ -1169,8 +1502,8 @@ void ProtocolHandler::on_document_signature_help(std::unique_ptr<JSON>&& msg, Ch
     wxString last_word;
     CompletionHelper helper;
 
-    wxString text =
-        minimize_buffer(filepath, line, character, m_filesOpened[filepath], CompletionHelper::TRUNCATE_EXACT_POS);
+    wxString text = minimize_buffer(
+        filepath, line, character, m_filesOpened[filepath].GetText(), CompletionHelper::TRUNCATE_EXACT_POS);
     wxString expression = helper.get_expression(text, true, &last_word);
 
     std::vector<TagEntryPtr> candidates;
@@ -1387,15 +1720,15 @@ size_t ProtocolHandler::do_find_definition_tags(std::unique_ptr<JSON>&& msg,
 
     CompletionHelper helper;
     wxString last_word;
-    wxString text =
-        minimize_buffer(filepath, line, character, m_filesOpened[filepath], CompletionHelper::TRUNCATE_COMPLETE_WORDS);
+    wxString text = minimize_buffer(
+        filepath, line, character, m_filesOpened[filepath].GetText(), CompletionHelper::TRUNCATE_COMPLETE_WORDS);
     wxString expression = helper.get_expression(text, false, &last_word);
 
     // get the last line
     wxString suffix;
 
     wxString text2 = helper.truncate_file_to_location(
-        m_filesOpened[filepath], line, character, CompletionHelper::TRUNCATE_COMPLETE_LINES);
+        m_filesOpened[filepath].GetText(), line, character, CompletionHelper::TRUNCATE_COMPLETE_LINES);
     bool is_include_completion = false;
 
     if (file_match) {
@@ -5,9 +5,11 @@
 #include "CompletionHelper.hpp"
 #include "Cxx/CxxCodeCompletion.hpp"
 #include "JSON.h"
+#include "LSPUtils.hpp"
 #include "ParseThread.hpp"
 #include "Scanner.hpp"
 #include "Settings.hpp"
+#include "TextDocument.hpp"
 #include "database/istorage.h"
 #include "macros.h"
 
@@ -27,21 +29,36 @@ struct ParsedFileInfo {
     wxStringSet_t using_namespace;
 };
 
+struct SemanticTokensCache {
+    // word -> type, valid until the file changes
+    std::unordered_map<wxString, eTokenType> types;
+    // the tokens of the whole file, sorted by their position
+    std::vector<TokenWrapper> tokens;
+    bool valid = false;
+    // the last result sent to the client, used for computing the delta
+    wxString result_id;
+    std::vector<int> data;
+};
+
 class ProtocolHandler
 {
 public:
     typedef void (ProtocolHandler::*CallbackFunc)(std::unique_ptr<JSON>&& msg, Channel::ptr_t channel);
+    // file name -> the file fingerprint before it was parsed
+    typedef std::unordered_map<wxString, FileEntryPtr> FingerprintMap_t;
 
 private:
     CTagsdSettings m_settings;
     wxString m_root_folder;
     wxString m_settings_folder;
-    wxStringMap_t m_filesOpened;
+    std::unordered_map<wxString, TextDocument> m_filesOpened;
 
     // cached parsed comments file <-> comments
     std::unordered_map<wxString, CachedComment::Map_t> m_comments_cache;
     std::unordered_map<wxString, ParsedFileInfo> m_parsed_files_info;
     std::unordered_map<wxString, std::vector<wxString>> m_additional_scopes;
+    std::unordered_map<wxString, SemanticTokensCache> m_semantic_tokens_cache;
+    size_t m_semantic_tokens_result_id = 0;
     wxArrayString m_search_paths;
     Scanner m_file_scanner;
     CxxCodeCompletion::ptr_t m_completer;
@@ -50,6 +67,12 @@ private:
 private:
     JSONItem build_result(JSONItem& reply, size_t id, int result_kind);
 
+    /**
+     * @brief return the semantic tokens of `filepath`, computing them if the file was modified since the last call
+     */
+    SemanticTokensCache& get_semantic_tokens(const wxString& filepath);
+    void invalidate_semantic_tokens(const wxString& filepath);
+
     /**
      * @brief parse source file
      */
@@ -65,7 +88,15 @@ private:
 
     // helper method for parsing a chunk of files
     static void do_parse_chunk(ITagsStoragePtr db, const std::vector<wxString>& files, size_t chunk_id,
-                               const CTagsdSettings& settings);
+                               const CTagsdSettings& settings, const FingerprintMap_t& fingerprints);
+    // parse the chunks using `threads` codelite-indexer processes in parallel. The results are stored into the
+    // database by the calling thread only
+    static void do_parse_chunks_parallel(ITagsStoragePtr db, const std::vector<std::vector<wxString>>& chunks,
+                                         size_t threads, const CTagsdSettings& settings,
+                                         const FingerprintMap_t& fingerprints);
+    // store the tags of a parsed chunk and mark its files as parsed
+    static void do_store_chunk(ITagsStoragePtr db, const std::vector<wxString>& files,
+                               const std::vector<TagEntryPtr>& tags, const FingerprintMap_t& fingerprints);
 
     bool ensure_file_content_exists(const wxString& filepath, Channel::ptr_t channel, size_t req_id);
     void update_comments_for_file(const wxString& filepath, const wxString& file_content);
@@ -114,6 +145,8 @@ public:
     void on_did_close(std::unique_ptr<JSON>&& msg, Channel::ptr_t channel);
     void on_did_save(std::unique_ptr<JSON>&& msg, Channel::ptr_t channel);
     void on_semantic_tokens(std::unique_ptr<JSON>&& msg, Channel::ptr_t channel);
+    void on_semantic_tokens_delta(std::unique_ptr<JSON>&& msg, Channel::ptr_t channel);
+    void on_semantic_tokens_range(std::unique_ptr<JSON>&& msg, Channel::ptr_t channel);
     void on_document_symbol(std::unique_ptr<JSON>&& msg, Channel::ptr_t channel);
     void on_document_signature_help(std::unique_ptr<JSON>&& msg, Channel::ptr_t channel);
     void on_definition(std::unique_ptr<JSON>&& msg, Channel::ptr_t channel);
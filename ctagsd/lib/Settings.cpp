@@ -71,6 +71,7 @@ void CTagsdSettings::Load(const wxFileName& filepath)
         m_ignore_spec = config["ignore_spec"].toString(m_ignore_spec);
         m_codelite_indexer = config["codelite_indexer"].toString();
         m_limit_results = config["limit_results"].toSize_t(m_limit_results);
+        m_indexer_threads = config["indexer_threads"].toSize_t(m_indexer_threads);
         CreateDefault(filepath); // generate the default tokens and types
     }
 
@@ -86,6 +87,7 @@ void CTagsdSettings::Load(const wxFileName& filepath)
     LOG_IF_TRACE { clDEBUG1() << "codelite_indexer......:" << m_codelite_indexer << endl; }
     LOG_IF_TRACE { clDEBUG1() << "ignore_spec...........:" << m_ignore_spec << endl; }
     LOG_IF_TRACE { clDEBUG1() << "limit_results.........:" << m_limit_results << endl; }
+    LOG_IF_TRACE { clDEBUG1() << "indexer_threads.......:" << m_indexer_threads << endl; }
     LOG_IF_TRACE { clDEBUG1() << "Settings dir is set to:" << m_settings_dir << endl; }
 
     // convert the tokens to wxArrayString
@@ -110,6 +112,7 @@ void CTagsdSettings::Save(const wxFileName& filepath)
     config.addProperty("ignore_spec", m_ignore_spec);
     config.addProperty("codelite_indexer", m_codelite_indexer);
     config.addProperty("limit_results", m_limit_results);
+    config.addProperty("indexer_threads", m_indexer_threads);
     config.addProperty("search_path", m_search_path);
 
     auto types = config.AddArray("types");
@@ -16,6 +16,7 @@ class CTagsdSettings
     wxString m_codelite_indexer;
     wxString m_ignore_spec = "/.git/;/.svn/;/build/;/build-;/CPack_Packages/;/CMakeFiles/";
     size_t m_limit_results = 150;
+    size_t m_indexer_threads = 0;
     wxString m_settings_dir;
 
 private:
@@ -31,6 +32,9 @@ public:
 
     void SetLimitResults(size_t limit_results) { this->m_limit_results = limit_results; }
     size_t GetLimitResults() const { return m_limit_results; }
+    /// number of codelite-indexer processes to run in parallel. 0 means: one per CPU
+    void SetIndexerThreads(size_t indexer_threads) { this->m_indexer_threads = indexer_threads; }
+    size_t GetIndexerThreads() const { return m_indexer_threads; }
     void SetCodeliteIndexer(const wxString& codelite_indexer) { this->m_codelite_indexer = codelite_indexer; }
     void SetFileMask(const wxString& file_mask) { this->m_file_mask = file_mask; }
     void SetIgnoreSpec(const wxString& ignore_spec) { this->m_ignore_spec = ignore_spec; }
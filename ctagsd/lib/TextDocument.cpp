@@ -0,0 +1,216 @@
+#include "TextDocument.hpp"
+
+#include <algorithm>
+
+namespace
+{
+// once the document is split into this many pieces, it is merged back into a single buffer
+constexpr size_t MAX_PIECES = 1000;
+
+void collect_line_feeds(const wxString& text, size_t base_offset, std::vector<size_t>& line_feeds)
+{
+    size_t offset = base_offset;
+    for (wxChar ch : text) {
+        if (ch == '\n') {
+            line_feeds.push_back(offset);
+        }
+        ++offset;
+    }
+}
+} // namespace
+
+TextDocument::TextDocument(const wxString& text) { SetText(text); }
+
+void TextDocument::SetText(const wxString& text)
+{
+    m_original = text;
+    m_original_lf.clear();
+    collect_line_feeds(m_original, 0, m_original_lf);
+
+    m_added.clear();
+    m_added_lf.clear();
+
+    m_pieces.clear();
+    if (!m_original.empty()) {
+        m_pieces.push_back(Piece{ false, 0, m_original.length(), m_original_lf.size() });
+    }
+    m_length = m_original.length();
+    m_line_feeds = m_original_lf.size();
+
+    // GetText() returns m_original as long as the document is not modified
+    m_text.clear();
+    m_text_valid = false;
+}
+
+const wxString& TextDocument::GetText() const
+{
+    if (m_pieces.size() == 1 && !m_pieces[0].added && m_pieces[0].length == m_original.length()) {
+        return m_original;
+    }
+
+    if (!m_text_valid) {
+        m_text.clear();
+        m_text.reserve(m_length);
+        for (const auto& piece : m_pieces) {
+            const wxString& buffer = piece.added ? m_added : m_original;
+            m_text.append(buffer, piece.start, piece.length);
+        }
+        m_text_valid = true;
+    }
+    return m_text;
+}
+
+size_t TextDocument::count_line_feeds(bool added, size_t start, size_t length) const
+{
+    const auto& line_feeds = added ? m_added_lf : m_original_lf;
+    auto first = std::lower_bound(line_feeds.begin(), line_feeds.end(), start);
+    auto last = std::lower_bound(first, line_feeds.end(), start + length);
+    return last - first;
+}
+
+size_t TextDocument::split_at(size_t offset)
+{
+    size_t piece_offset = 0;
+    for (size_t i = 0; i < m_pieces.size(); ++i) {
+        if (piece_offset == offset) {
+            return i;
+        }
+
+        Piece& piece = m_pieces[i];
+        if (offset < piece_offset + piece.length) {
+            Piece tail = piece;
+            piece.length = offset - piece_offset;
+            piece.line_feeds = count_line_feeds(piece.added, piece.start, piece.length);
+            tail.start += piece.length;
+            tail.length -= piece.length;
+            tail.line_feeds -= piece.line_feeds;
+            m_pieces.insert(m_pieces.begin() + i + 1, tail);
+            return i + 1;
+        }
+        piece_offset += piece.length;
+    }
+    return m_pieces.size();
+}
+
+size_t TextDocument::get_line_start(size_t line) const
+{
+    if (line == 0) {
+        return 0;
+    }
+
+    if (line > m_line_feeds) {
+        return m_length;
+    }
+
+    size_t piece_offset = 0;
+    size_t line_feeds_before = 0;
+    for (const auto& piece : m_pieces) {
+        if (line_feeds_before + piece.line_feeds >= line) {
+            // the line feed that terminates the previous line is in this piece
+            const auto& line_feeds = piece.added ? m_added_lf : m_original_lf;
+            auto iter = std::lower_bound(line_feeds.begin(), line_feeds.end(), piece.start);
+            size_t lf_offset = *(iter + (line - line_feeds_before - 1));
+            return piece_offset + (lf_offset - piece.start) + 1;
+        }
+        line_feeds_before += piece.line_feeds;
+        piece_offset += piece.length;
+    }
+    return m_length;
+}
+
+size_t TextDocument::get_offset(size_t line, size_t character) const
+{
+    size_t line_start = get_line_start(line);
+    size_t line_end = line < m_line_feeds ? get_line_start(line + 1) - 1 : m_length;
+    size_t offset = std::min(line_start + character, line_end);
+    if (sizeof(wxChar) == 2) {
+        // wxString is UTF-16 already
+        return offset;
+    }
+
+    // a char outside of the BMP is 2 UTF-16 code units, so the position can only be before `offset`
+    wxString prefix = get_text_range(line_start, offset);
+    size_t units = 0;
+    offset = line_start;
+    for (wxChar ch : prefix) {
+        if (units >= character) {
+            break;
+        }
+        units += ((wxUint32)ch > 0xFFFF) ? 2 : 1;
+        ++offset;
+    }
+    return offset;
+}
+
+wxString TextDocument::get_text_range(size_t from, size_t to) const
+{
+    wxString text;
+    size_t piece_offset = 0;
+    for (const auto& piece : m_pieces) {
+        if (piece_offset >= to) {
+            break;
+        }
+
+        size_t piece_end = piece_offset + piece.length;
+        if (piece_end > from) {
+            size_t start = std::max(from, piece_offset);
+            size_t end = std::min(to, piece_end);
+            const wxString& buffer = piece.added ? m_added : m_original;
+            text.append(buffer, piece.start + (start - piece_offset), end - start);
+        }
+        piece_offset = piece_end;
+    }
+    return text;
+}
+
+wxString TextDocument::GetLines(size_t from_line, size_t to_line) const
+{
+    return get_text_range(get_line_start(from_line), get_line_start(to_line + 1));
+}
+
+void TextDocument::Replace(size_t start_line, size_t start_character, size_t end_line, size_t end_character,
+                           const wxString& text)
+{
+    size_t from = get_offset(start_line, start_character);
+    size_t to = std::max(from, get_offset(end_line, end_character));
+
+    // splitting at `to` can only add pieces after `first`
+    size_t first = split_at(from);
+    size_t last = split_at(to);
+    for (size_t i = first; i < last; ++i) {
+        m_length -= m_pieces[i].length;
+        m_line_feeds -= m_pieces[i].line_feeds;
+    }
+    m_pieces.erase(m_pieces.begin() + first, m_pieces.begin() + last);
+
+    if (!text.empty()) {
+        size_t line_feeds_before = m_added_lf.size();
+        collect_line_feeds(text, m_added.length(), m_added_lf);
+        size_t line_feeds = m_added_lf.size() - line_feeds_before;
+
+        if (first > 0 && m_pieces[first - 1].added &&
+            m_pieces[first - 1].start + m_pieces[first - 1].length == m_added.length()) {
+            // typing: the previous piece ends where the new text starts, extend it
+            m_pieces[first - 1].length += text.length();
+            m_pieces[first - 1].line_feeds += line_feeds;
+        } else {
+            m_pieces.insert(m_pieces.begin() + first, Piece{ true, m_added.length(), text.length(), line_feeds });
+        }
+        m_added.append(text);
+        m_length += text.length();
+        m_line_feeds += line_feeds;
+    }
+    m_text_valid = false;
+
+    // keep the edits cheap: merge the pieces once there are too many of them, or once most of the added text is
+    // no longer used
+    if (m_pieces.size() > MAX_PIECES || m_added.length() > 2 * m_length + 4096) {
+        compact();
+    }
+}
+
+void TextDocument::compact()
+{
+    wxString text = GetText();
+    SetText(text);
+}
@@ -0,0 +1,79 @@
+#ifndef TEXTDOCUMENT_HPP
+#define TEXTDOCUMENT_HPP
+
+#include <vector>
+#include <wx/string.h>
+
+/**
+ * @class TextDocument
+ * @brief the content of a file opened by the client, stored as a piece table.
+ * Range edits (textDocument/didChange with incremental sync) only touch the pieces around the edit. The complete text
+ * is built on demand by `GetText()` and cached until the next edit.
+ * Positions are expressed as line/character, where `character` is counted in UTF-16 code units (the LSP default
+ * position encoding, also used by the CodeLite client)
+ */
+class TextDocument
+{
+    struct Piece {
+        bool added = false; // true: the text is in m_added, false: in m_original
+        size_t start = 0;
+        size_t length = 0;
+        size_t line_feeds = 0;
+    };
+
+    wxString m_original;
+    wxString m_added;
+    // offsets of the line feeds in m_original / m_added (sorted)
+    std::vector<size_t> m_original_lf;
+    std::vector<size_t> m_added_lf;
+    std::vector<Piece> m_pieces;
+    size_t m_length = 0;
+    size_t m_line_feeds = 0;
+    mutable wxString m_text;
+    mutable bool m_text_valid = false;
+
+private:
+    size_t count_line_feeds(bool added, size_t start, size_t length) const;
+    /// split the piece that contains `offset`. Return the index of the piece starting at `offset`
+    size_t split_at(size_t offset);
+    /// return the offset of the first char of `line`
+    size_t get_line_start(size_t line) const;
+    /// convert line/character (UTF-16 code units) into offset. The character is clamped to the line length
+    size_t get_offset(size_t line, size_t character) const;
+    wxString get_text_range(size_t from, size_t to) const;
+    void compact();
+
+public:
+    TextDocument() = default;
+    explicit TextDocument(const wxString& text);
+    ~TextDocument() = default;
+
+    /**
+     * @brief replace the entire content of the document
+     */
+    void SetText(const wxString& text);
+
+    /**
+     * @brief return the complete document content
+     */
+    const wxString& GetText() const;
+
+    /**
+     * @brief replace the text in the range [start, end) with `text`
+     */
+    void Replace(size_t start_line, size_t start_character, size_t end_line, size_t end_character,
+                 const wxString& text);
+
+    /**
+     * @brief return the text of the lines [from_line, to_line] including their line terminators
+     */
+    wxString GetLines(size_t from_line, size_t to_line) const;
+
+    /**
+     * @brief number of '\n' in the document
+     */
+    size_t GetLineFeedsCount() const { return m_line_feeds; }
+    size_t GetLength() const { return m_length; }
+};
+
+#endif // TEXTDOCUMENT_HPP
@@ -4,6 +4,7 @@
 #include "ctags_manager.h"
 #include "file_logger.h"
 
+#include <csignal>
 #include <unordered_map>
 #include <wx/cmdline.h>
 #include <wx/filename.h>
@@ -21,6 +22,8 @@ std::unordered_map<wxString, ProtocolHandler::CallbackFunc> function_table = {
     { "textDocument/didClose", &ProtocolHandler::on_did_close },
     { "textDocument/didSave", &ProtocolHandler::on_did_save },
     { "textDocument/semanticTokens/full", &ProtocolHandler::on_semantic_tokens },
+    { "textDocument/semanticTokens/full/delta", &ProtocolHandler::on_semantic_tokens_delta },
+    { "textDocument/semanticTokens/range", &ProtocolHandler::on_semantic_tokens_range },
     { "textDocument/signatureHelp", &ProtocolHandler::on_document_signature_help },
     { "textDocument/definition", &ProtocolHandler::on_definition },
     { "textDocument/declaration", &ProtocolHandler::on_declaration },
@@ -37,6 +40,10 @@ std::unordered_map<wxString, ProtocolHandler::CallbackFunc> function_table = {
 int main(int argc, char** argv)
 {
     wxInitializer initializer(argc, argv);
+#ifndef __WXMSW__
+    // writing to a resident codelite-indexer that exited must not terminate ctagsd
+    signal(SIGPIPE, SIG_IGN);
+#endif
     wxFileName logdir(clStandardPaths::Get().GetUserDataDir(), wxEmptyString);
     logdir.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
 
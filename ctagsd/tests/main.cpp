@@ -8,6 +8,7 @@
 #include "LSPUtils.hpp"
 #include "Settings.hpp"
 #include "SimpleTokenizer.hpp"
+#include "TextDocument.hpp"
 #include "clFilesCollector.h"
 #include "ctags_manager.h"
 #include "database/tags_storage_sqlite3.h"
@@ -19,6 +20,7 @@
 #include <iostream>
 #include <wx/init.h>
 #include <wx/log.h>
+#include <wx/stopwatch.h>
 #include <wx/wxcrtvararg.h>
 
 using namespace std;
@@ -111,9 +113,106 @@ wxString get_sample_file(const wxString& filename)
     test_file.AppendDir("samples");
     return test_file.GetFullPath();
 }
-
 } // namespace
 
+TEST_FUNC(test_text_document_incremental_changes)
+{
+    TextDocument document("#include <vector>\nint main() {\n    return 0;\n}\n");
+    CHECK_SIZE(document.GetLineFeedsCount(), 4);
+
+    // insert a line
+    document.Replace(2, 0, 2, 0, "    int x = 1;\n");
+    CHECK_SIZE(document.GetLineFeedsCount(), 5);
+    CHECK_STRING(document.GetLines(2, 2), "    int x = 1;\n");
+
+    // replace a word
+    document.Replace(3, 11, 3, 12, "x");
+    CHECK_STRING(document.GetLines(3, 3), "    return x;\n");
+
+    // typing, one char at a time
+    document.Replace(0, 17, 0, 17, " ");
+    document.Replace(0, 18, 0, 18, "/");
+    document.Replace(0, 19, 0, 19, "/");
+    CHECK_STRING(document.GetLines(0, 0), "#include <vector> //\n");
+
+    // delete lines, the character is clamped to the line length
+    document.Replace(1, 0, 2, 100, "");
+    CHECK_SIZE(document.GetLineFeedsCount(), 4);
+    CHECK_STRING(document.GetText(), "#include <vector> //\n\n    return x;\n}\n");
+
+    // ranges past the end of the document
+    document.Replace(100, 0, 100, 0, "// EOF");
+    CHECK_STRING(document.GetText(), "#include <vector> //\n\n    return x;\n}\n// EOF");
+
+    // the character is counted in UTF-16 code units: U+1F600 takes 2 of them
+    document.SetText(wxString::FromUTF8("s = \"\xF0\x9F\x98\x80\";\n"));
+    document.Replace(0, 8, 0, 9, ",");
+    CHECK_WXSTRING(document.GetText(), wxString::FromUTF8("s = \"\xF0\x9F\x98\x80\",\n"));
+    return true;
+}
+
+TEST_FUNC(test_ctags_resident_indexer)
+{
+    ENSURE_DB_LOADED();
+    if(!wxFileName::FileExists(settings.GetCodeliteIndexer())) {
+        cout << "codelite-indexer not found, skipping" << endl;
+        return true;
+    }
+
+    wxString content;
+    FileUtils::ReadFileContent(get_sample_file("locals.hpp"), content);
+
+    // a new codelite-indexer process per request
+    CTags::SetResidentIndexerEnabled(false);
+    vector<TagEntryPtr> expected;
+    CTags::ParseLocals({}, content, settings.GetCodeliteIndexer(), settings.GetMacroTable(), expected);
+
+    // the resident codelite-indexer, twice to reuse the running process
+    CTags::SetResidentIndexerEnabled(true);
+    for(size_t i = 0; i < 2; ++i) {
+        vector<TagEntryPtr> tags;
+        CTags::ParseLocals({}, content, settings.GetCodeliteIndexer(), settings.GetMacroTable(), tags);
+        CHECK_SIZE(tags.size(), expected.size());
+        bool tags_match = true;
+        for(size_t j = 0; j < tags.size(); ++j) {
+            tags_match = tags_match && *tags[j] == *expected[j];
+        }
+        CHECK_BOOL(tags_match);
+    }
+    return true;
+}
+
+BENCHMARK_FUNC(benchmark_ctags_resident_indexer)
+{
+    ENSURE_DB_LOADED();
+    if(!wxFileName::FileExists(settings.GetCodeliteIndexer())) {
+        cout << "codelite-indexer not found, skipping" << endl;
+        return true;
+    }
+
+    wxString content;
+    FileUtils::ReadFileContent(get_sample_file("locals.hpp"), content);
+    constexpr size_t REQUESTS = 20;
+
+    // a new codelite-indexer process per request
+    CTags::SetResidentIndexerEnabled(false);
+    vector<TagEntryPtr> tags;
+    wxStopWatch sw;
+    for(size_t i = 0; i < REQUESTS; ++i) {
+        CTags::ParseLocals({}, content, settings.GetCodeliteIndexer(), settings.GetMacroTable(), tags);
+    }
+    long process_time = sw.Time();
+
+    CTags::SetResidentIndexerEnabled(true);
+    sw.Start();
+    for(size_t i = 0; i < REQUESTS; ++i) {
+        CTags::ParseLocals({}, content, settings.GetCodeliteIndexer(), settings.GetMacroTable(), tags);
+    }
+    wxPrintf("CTags: %zu ParseLocals requests took %ldms (%ldms starting codelite-indexer per request)\n", REQUESTS,
+             sw.Time(), process_time);
+    return true;
+}
+
 TEST_FUNC(test_lexing_raw_strings)
 {
     wxString fullpath;
@@ -430,6 +529,40 @@ TEST_FUNC(TestSimeplTokenizer_2)
     return true;
 }
 
+TEST_FUNC(test_semantic_tokens_delta)
+{
+    vector<int> prev = { 0, 1, 4, 0, 99, 0, 6, 3, 1, 0, 2, 0, 5, 2, 99 };
+    size_t start = 0;
+    size_t delete_count = 0;
+    vector<int> data;
+
+    // identical arrays: no edit
+    CHECK_BOOL(!LSPUtils::diff_semantic_tokens(prev, prev, &start, &delete_count, &data));
+
+    // a token was inserted in the middle
+    vector<int> curr = { 0, 1, 4, 0, 99, 0, 6, 3, 1, 0, 0, 5, 3, 0, 0, 2, 0, 5, 2, 99 };
+    CHECK_BOOL(LSPUtils::diff_semantic_tokens(prev, curr, &start, &delete_count, &data));
+    vector<int> patched = prev;
+    patched.erase(patched.begin() + start, patched.begin() + start + delete_count);
+    patched.insert(patched.begin() + start, data.begin(), data.end());
+    CHECK_BOOL(patched == curr);
+    CHECK_BOOL(data.size() < curr.size());
+
+    // the last token was removed
+    curr.assign(prev.begin(), prev.begin() + 10);
+    CHECK_BOOL(LSPUtils::diff_semantic_tokens(prev, curr, &start, &delete_count, &data));
+    CHECK_SIZE(start, 10);
+    CHECK_SIZE(delete_count, 5);
+    CHECK_SIZE(data.size(), 0);
+
+    // everything was removed
+    curr.clear();
+    CHECK_BOOL(LSPUtils::diff_semantic_tokens(prev, curr, &start, &delete_count, &data));
+    CHECK_SIZE(start, 0);
+    CHECK_SIZE(delete_count, prev.size());
+    return true;
+}
+
 TEST_FUNC(TestSimeplTokenizer)
 {
     {
@@ -1557,5 +1690,6 @@ int main(int argc, char** argv)
 
     // ensure that the user data dir exists
     wxFileName::Mkdir(clStandardPaths::Get().GetUserDataDir(), wxPosixPermissions::wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
-    return Tester::Instance()->RunTests();
+    bool benchmarks = argc > 1 && wxString(argv[1]) == "--benchmark";
+    return Tester::Instance()->RunTests(benchmarks);
 }
@@ -27,10 +27,19 @@ void Tester::Release()
     ms_instance = 0;
 }
 
-void Tester::AddTest(ITest* t) { m_tests.push_back(t); }
+void Tester::AddTest(ITest* t, bool benchmark)
+{
+    if(benchmark) {
+        m_benchmarks.push_back(t);
+    } else {
+        m_tests.push_back(t);
+    }
+}
 
-std::size_t Tester::RunTests()
+std::size_t Tester::RunTests(bool benchmarks)
 {
+    const std::vector<ITest*>& tests = benchmarks ? m_benchmarks : m_tests;
+
 #ifdef _WIN32
     SetConsoleMode(GetStdHandle(STD_OUTPUT_HANDLE), ENABLE_VIRTUAL_TERMINAL_PROCESSING | ENABLE_PROCESSED_OUTPUT);
 #endif
@@ -40,8 +49,8 @@ std::size_t Tester::RunTests()
 
     std::vector<wxString> failures;
     size_t total_checks = 0;
-    for(size_t i = 0; i < m_tests.size(); i++) {
-        ITest* test = m_tests[i];
+    for(size_t i = 0; i < tests.size(); i++) {
+        ITest* test = tests[i];
         if(test->test()) {
             builder.Add(wxString() << test->name() << "....", AnsiColours::NormalText());
             builder.Add("OK", AnsiColours::Green());
@@ -66,7 +75,7 @@ std::size_t Tester::RunTests()
         builder.Add("All tests completed ", AnsiColours::NormalText());
         builder.Add("successfully", AnsiColours::Green());
         builder.Add(wxString() << ". Total of ", AnsiColours::NormalText());
-        builder.Add(wxString() << m_tests.size(), AnsiColours::NormalText(), true);
+        builder.Add(wxString() << tests.size(), AnsiColours::NormalText(), true);
         builder.Add(wxString() << " tests and ", AnsiColours::NormalText());
         builder.Add(wxString() << total_checks, AnsiColours::NormalText(), true);
         builder.Add(wxString() << " checks ", AnsiColours::NormalText());
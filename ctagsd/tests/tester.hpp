@@ -42,13 +42,18 @@ class Tester
 {
     static Tester* ms_instance;
     std::vector<ITest*> m_tests;
+    std::vector<ITest*> m_benchmarks;
 
 public:
     static Tester* Instance();
     static void Release();
 
-    void AddTest(ITest* t);
-    std::size_t RunTests();
+    void AddTest(ITest* t, bool benchmark = false);
+
+    /**
+     * @brief run the tests, or the benchmarks (they are not part of the default run)
+     */
+    std::size_t RunTests(bool benchmarks = false);
 
 private:
     Tester() = default;
@@ -73,10 +78,10 @@ protected:
     int m_line = 0;
 
 public:
-    ITest()
+    ITest(bool benchmark = false)
         : m_testCount(0)
     {
-        Tester::Instance()->AddTest(this);
+        Tester::Instance()->AddTest(this, benchmark);
     }
     virtual ~ITest() = default;
     virtual bool test() = 0;
@@ -111,6 +116,44 @@ public:
     bool Test_##Name::test() { return Name(); } \
     bool Test_##Name::Name()
 
+/// like TEST_FUNC, but the test only runs when the tests are started with --benchmark
+#define BENCHMARK_FUNC(Name)                    \
+    class Test_##Name : public ITest            \
+    {                                           \
+    public:                                     \
+        Test_##Name()                           \
+            : ITest(true)                       \
+        {                                       \
+        }                                       \
+        virtual bool test();                    \
+        virtual bool Name();                    \
+    };                                          \
+    Test_##Name theTest##Name;                  \
+    bool Test_##Name::test() { return Name(); } \
+    bool Test_##Name::Name()
+
+/**
+ * @class TestTempDir
+ * @brief a folder under the temp folder, deleted with its content when the test ends
+ */
+class TestTempDir
+{
+    wxFileName m_dir;
+
+public:
+    TestTempDir(const wxString& name)
+        : m_dir(wxFileName::GetTempDir(), wxEmptyString)
+    {
+        m_dir.AppendDir(name);
+        m_dir.Rmdir(wxPATH_RMDIR_RECURSIVE);
+        m_dir.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+    }
+    ~TestTempDir() { m_dir.Rmdir(wxPATH_RMDIR_RECURSIVE); }
+
+    wxString GetPath() const { return m_dir.GetPath(); }
+    wxFileName GetFile(const wxString& fullname) const { return wxFileName(m_dir.GetPath(), fullname); }
+};
+
 // Check values macros
 
 #define SET_FILE_LINE_NAME()           \